@@ -1,14 +1,25 @@
 set(headers
   include/databento/batch.hpp
+  include/databento/columnar_file.hpp
   include/databento/compat.hpp
   include/databento/constants.hpp
   include/databento/datetime.hpp
   include/databento/dbn.hpp
+  include/databento/dbn_columnar_reader.hpp
+  include/databento/dbn_csv_encoder.hpp
   include/databento/dbn_decoder.hpp
   include/databento/dbn_encoder.hpp
   include/databento/dbn_file_store.hpp
+  include/databento/dbn_json_encoder.hpp
+  include/databento/dbn_stream_decoder.hpp
+  include/databento/detail/aligned_allocator.hpp
+  include/databento/detail/concurrent_http_streams.hpp
+  include/databento/detail/file_system.hpp
   include/databento/detail/http_client.hpp
   include/databento/detail/json_helpers.hpp
+  include/databento/detail/parallel_zstd_stream.hpp
+  include/databento/detail/prefetch_stream.hpp
+  include/databento/detail/ring_buffer.hpp
   include/databento/detail/scoped_fd.hpp
   include/databento/detail/scoped_thread.hpp
   include/databento/detail/shared_channel.hpp
@@ -20,6 +31,7 @@ set(headers
   include/databento/fixed_price.hpp
   include/databento/flag_set.hpp
   include/databento/historical.hpp
+  include/databento/instrument_index.hpp
   include/databento/ireadable.hpp
   include/databento/live.hpp
   include/databento/live_blocking.hpp
@@ -28,26 +40,43 @@ set(headers
   include/databento/metadata.hpp
   include/databento/publishers.hpp
   include/databento/record.hpp
+  include/databento/record_filter.hpp
+  include/databento/record_visit.hpp
   include/databento/symbol_map.hpp
   include/databento/symbology.hpp
   include/databento/timeseries.hpp
+  include/databento/timeseries_cache.hpp
+  include/databento/ts_index.hpp
   include/databento/v1.hpp
   include/databento/v2.hpp
   include/databento/v3.hpp
   include/databento/with_ts_out.hpp
+  include/databento/zstd_compress_options.hpp
+  include/databento/zstd_dictionary.hpp
   src/stream_op_helper.hpp
+  src/text_format.hpp
 )
 
 set(sources
   src/batch.cpp
+  src/columnar_file.cpp
   src/datetime.cpp
   src/dbn.cpp
+  src/dbn_columnar_reader.cpp
   src/dbn_constants.hpp
+  src/dbn_csv_encoder.cpp
   src/dbn_decoder.cpp
   src/dbn_encoder.cpp
   src/dbn_file_store.cpp
+  src/dbn_json_encoder.cpp
+  src/dbn_stream_decoder.cpp
+  src/detail/concurrent_http_streams.cpp
+  src/detail/file_system.cpp
   src/detail/http_client.cpp
   src/detail/json_helpers.cpp
+  src/detail/parallel_zstd_stream.cpp
+  src/detail/prefetch_stream.cpp
+  src/detail/ring_buffer.cpp
   src/detail/scoped_fd.cpp
   src/detail/shared_channel.cpp
   src/detail/tcp_client.cpp
@@ -58,6 +87,7 @@ set(sources
   src/fixed_price.cpp
   src/flag_set.cpp
   src/historical.cpp
+  src/instrument_index.cpp
   src/live.cpp
   src/live_blocking.cpp
   src/live_threaded.cpp
@@ -65,8 +95,12 @@ set(sources
   src/metadata.cpp
   src/publishers.cpp
   src/record.cpp
+  src/record_filter.cpp
   src/symbol_map.cpp
   src/symbology.cpp
+  src/timeseries_cache.cpp
+  src/ts_index.cpp
   src/v1.cpp
   src/v3.cpp
+  src/zstd_dictionary.cpp
 )
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <zstd.h>
+
+#include <cstddef>  // size_t
+#include <cstdint>
+#include <fstream>  // ifstream
+#include <memory>   // unique_ptr
+#include <string>
+#include <vector>
+
+#include "databento/dbn.hpp"                  // Metadata
+#include "databento/dbn_columnar_reader.hpp"  // Column, MboColumns, Mbp1Columns, OhlcvColumns, TradeColumns
+#include "databento/file_stream.hpp"          // OutFileStream
+#include "databento/log.hpp"
+
+namespace databento {
+enum class ColumnEncoding : std::uint8_t {
+  // The values compressed with Zstd.
+  Zstd = 0,
+  // The differences between consecutive values compressed with Zstd. Used for
+  // 8-byte columns like timestamps, prices, and order IDs.
+  DeltaZstd = 1,
+};
+
+// The location and statistics of one column within a row group.
+struct ColumnChunkInfo {
+  std::uint64_t offset;
+  std::uint64_t compressed_size;
+  ColumnEncoding encoding;
+  // Whether the column holds unsigned values, e.g. timestamps, order IDs, and
+  // sizes. Their statistics are in `unsigned_min` and `unsigned_max` so they
+  // keep their full range.
+  bool is_unsigned;
+  // The minimum and maximum values of a signed column converted to
+  // `std::int64_t`, e.g. prices. Both are 0 for an empty row group or an
+  // unsigned column.
+  std::int64_t min;
+  std::int64_t max;
+  // The minimum and maximum values of an unsigned column converted to
+  // `std::uint64_t`, e.g. timestamps as nanoseconds since the UNIX epoch. Both
+  // are 0 for an empty row group or a signed column.
+  std::uint64_t unsigned_min;
+  std::uint64_t unsigned_max;
+};
+
+struct RowGroupInfo {
+  std::uint64_t row_count;
+  // In the order of `ColumnarFileReader::ColumnNames`
+  std::vector<ColumnChunkInfo> columns;
+};
+
+// Writes a column-chunked file from chunks of columns such as those produced
+// by `DbnColumnarReader`. Each call to `WriteRowGroup` writes one row group
+// with every column compressed separately along with its minimum and maximum
+// values, so readers can skip row groups and columns they don't need. The
+// file begins with the DBN `Metadata` and ends with a footer locating every
+// column chunk.
+class ColumnarFileWriter {
+ public:
+  ColumnarFileWriter(ILogReceiver* log_receiver, const std::string& file_path,
+                     const Metadata& metadata);
+  // `compression_level` is the Zstd compression level used for every column.
+  ColumnarFileWriter(ILogReceiver* log_receiver, const std::string& file_path,
+                     const Metadata& metadata, int compression_level);
+  ColumnarFileWriter(const ColumnarFileWriter&) = delete;
+  ColumnarFileWriter& operator=(const ColumnarFileWriter&) = delete;
+  ColumnarFileWriter(ColumnarFileWriter&&) = delete;
+  ColumnarFileWriter& operator=(ColumnarFileWriter&&) = delete;
+  // Calls `Finish` if it hasn't already been called, logging any error.
+  ~ColumnarFileWriter();
+
+  // Every row group in a file must have the same type of columns.
+  void WriteRowGroup(const MboColumns& columns);
+  void WriteRowGroup(const TradeColumns& columns);
+  void WriteRowGroup(const Mbp1Columns& columns);
+  void WriteRowGroup(const OhlcvColumns& columns);
+  // Writes the footer. No more row groups can be written after.
+  void Finish();
+
+ private:
+  template <typename C>
+  void WriteColumns(std::uint8_t column_set, const C& columns);
+  template <typename T>
+  ColumnChunkInfo WriteColumn(const Column<T>& column);
+  void Write(const std::uint8_t* buffer, std::size_t length);
+
+  ILogReceiver* log_receiver_;
+  OutFileStream output_;
+  std::uint64_t offset_{};
+  int compression_level_;
+  std::unique_ptr<ZSTD_CCtx, std::size_t (*)(ZSTD_CCtx*)> z_cctx_;
+  // 0 until the first row group is written
+  std::uint8_t column_set_{};
+  std::vector<std::string> column_names_;
+  std::vector<std::uint8_t> column_widths_;
+  std::vector<RowGroupInfo> row_groups_;
+  std::vector<std::uint64_t> delta_buffer_;
+  std::vector<std::uint8_t> compressed_buffer_;
+  bool is_finished_{false};
+};
+
+// Reads files written by `ColumnarFileWriter`. Only the selected columns of the
+// requested row groups are read and decompressed.
+class ColumnarFileReader {
+ public:
+  explicit ColumnarFileReader(const std::string& file_path);
+  ColumnarFileReader(const ColumnarFileReader&) = delete;
+  ColumnarFileReader& operator=(const ColumnarFileReader&) = delete;
+  ColumnarFileReader(ColumnarFileReader&&) = delete;
+  ColumnarFileReader& operator=(ColumnarFileReader&&) = delete;
+  ~ColumnarFileReader() = default;
+
+  const Metadata& GetMetadata() const { return metadata_; }
+  const std::vector<std::string>& ColumnNames() const { return column_names_; }
+  const std::vector<RowGroupInfo>& RowGroups() const { return row_groups_; }
+  // Returns the index of the column `name` in `ColumnNames` and
+  // `RowGroupInfo::columns`.
+  std::size_t ColumnIndex(const std::string& name) const;
+  // Limits the columns read by `ReadRowGroup` to `column_names`, leaving the
+  // others empty. An empty `column_names` selects every column.
+  void SelectColumns(const std::vector<std::string>& column_names);
+  // Replaces the contents of `columns` with the selected columns of row group
+  // `idx`. The type of `columns` must match the one the file was written with.
+  void ReadRowGroup(std::size_t idx, MboColumns* columns);
+  void ReadRowGroup(std::size_t idx, TradeColumns* columns);
+  void ReadRowGroup(std::size_t idx, Mbp1Columns* columns);
+  void ReadRowGroup(std::size_t idx, OhlcvColumns* columns);
+
+ private:
+  void ReadFooter();
+  void ReadAt(std::uint64_t offset, std::uint8_t* buffer, std::size_t length);
+  template <typename C>
+  void ReadColumns(std::uint8_t column_set, std::size_t idx, C* columns);
+  template <typename T>
+  void ReadColumn(const ColumnChunkInfo& chunk, std::uint64_t row_count,
+                  Column<T>* column);
+
+  std::ifstream input_;
+  Metadata metadata_{};
+  std::uint8_t column_set_{};
+  std::vector<std::string> column_names_;
+  std::vector<std::uint8_t> column_widths_;
+  std::vector<RowGroupInfo> row_groups_;
+  // Indexed like `column_names_`
+  std::vector<bool> is_selected_;
+  std::unique_ptr<ZSTD_DCtx, std::size_t (*)(ZSTD_DCtx*)> z_dctx_;
+  std::vector<std::uint8_t> compressed_buffer_;
+};
+}  // namespace databento
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <charconv>  // to_chars_result
 #include <chrono>
+#include <cstddef>  // size_t
 #include <cstdint>
 #include <ratio>  // nano
 #include <string>
@@ -18,6 +20,20 @@ std::string ToString(UnixNanos unix_nanos);
 // YYYY-MM-DDTHH:MM:SS.fffffffffZ
 std::string ToIso8601(UnixNanos unix_nanos);
 std::string ToString(TimeDeltaNanos td_nanos);
+
+// The number of characters written by `ToIso8601` for a defined timestamp.
+constexpr std::size_t kIso8601Len = 30;
+// The following functions format into [first, last) like `std::to_chars`. On
+// success, they return the end of the written characters. Otherwise they
+// return `last` with `std::errc::value_too_large`.
+
+// Formats the UNIX timestamp as nanoseconds like `ToString`.
+std::to_chars_result ToChars(char* first, char* last, UnixNanos unix_nanos);
+// Formats the UNIX timestamp like `ToIso8601`. The date is cached per thread,
+// so formatting timestamps from the same day only formats the time of day.
+// Never fails when the range is at least `kIso8601Len` characters.
+std::to_chars_result ToIso8601(char* first, char* last, UnixNanos unix_nanos);
+std::to_chars_result ToChars(char* first, char* last, TimeDeltaNanos td_nanos);
 // Converts a YYYYMMDD integer to a YYYY-MM-DD string.
 std::string DateFromIso8601Int(std::uint32_t date_int);
 
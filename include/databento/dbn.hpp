@@ -86,6 +86,12 @@ struct Metadata {
   TsSymbolMap CreateSymbolMap() const;
   // Upgrades the metadata according to `upgrade_policy` if necessary.
   void Upgrade(VersionUpgradePolicy upgrade_policy);
+  // Merges the metadata of another response to the same query over a
+  // different time range or subset of the symbols, such as when a request is
+  // split to be fetched concurrently. The time range is widened to cover both,
+  // symbols and mapping intervals are combined, and a symbol is only
+  // `not_found` if it wasn't found in any response that requested it.
+  void Merge(const Metadata& other);
 };
 
 inline bool operator==(const MappingInterval& lhs, const MappingInterval& rhs) {
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>
+#include <memory>  // unique_ptr
+#include <string>
+#include <vector>
+
+#include "databento/datetime.hpp"  // UnixNanos, TimeDeltaNanos
+#include "databento/dbn.hpp"       // Metadata
+#include "databento/dbn_decoder.hpp"
+#include "databento/detail/aligned_allocator.hpp"
+#include "databento/enums.hpp"  // Action, Side
+#include "databento/flag_set.hpp"
+#include "databento/ireadable.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"  // MboMsg, Mbp1Msg, OhlcvMsg, TradeMsg
+
+namespace databento {
+// Alignment in bytes of the start of every column, the size of a cache line
+// and an AVX-512 register.
+constexpr std::size_t kColumnAlignment = 64;
+
+template <typename T>
+using Column = std::vector<T, detail::AlignedAllocator<T, kColumnAlignment>>;
+
+// The fields of a chunk of `MboMsg` records, one column per field.
+struct MboColumns {
+  std::size_t Size() const { return ts_recv.size(); }
+  void Clear();
+  void Reserve(std::size_t capacity);
+  void Append(const MboMsg& mbo);
+
+  // Calls `f(name, column)` for every column of `columns`, which may be
+  // const.
+  template <typename C, typename F>
+  static void ForEachColumn(C& columns, F&& f) {
+    f("publisher_id", columns.publisher_id);
+    f("instrument_id", columns.instrument_id);
+    f("ts_event", columns.ts_event);
+    f("order_id", columns.order_id);
+    f("price", columns.price);
+    f("size", columns.size);
+    f("flags", columns.flags);
+    f("channel_id", columns.channel_id);
+    f("action", columns.action);
+    f("side", columns.side);
+    f("ts_recv", columns.ts_recv);
+    f("ts_in_delta", columns.ts_in_delta);
+    f("sequence", columns.sequence);
+  }
+
+  Column<std::uint16_t> publisher_id;
+  Column<std::uint32_t> instrument_id;
+  Column<UnixNanos> ts_event;
+  Column<std::uint64_t> order_id;
+  Column<std::int64_t> price;
+  Column<std::uint32_t> size;
+  Column<FlagSet> flags;
+  Column<std::uint8_t> channel_id;
+  Column<Action> action;
+  Column<Side> side;
+  Column<UnixNanos> ts_recv;
+  Column<TimeDeltaNanos> ts_in_delta;
+  Column<std::uint32_t> sequence;
+};
+
+// The fields of a chunk of `TradeMsg` records, one column per field.
+struct TradeColumns {
+  std::size_t Size() const { return ts_recv.size(); }
+  void Clear();
+  void Reserve(std::size_t capacity);
+  void Append(const TradeMsg& trade);
+
+  // Calls `f(name, column)` for every column of `columns`.
+  template <typename C, typename F>
+  static void ForEachColumn(C& columns, F&& f) {
+    f("publisher_id", columns.publisher_id);
+    f("instrument_id", columns.instrument_id);
+    f("ts_event", columns.ts_event);
+    f("price", columns.price);
+    f("size", columns.size);
+    f("action", columns.action);
+    f("side", columns.side);
+    f("flags", columns.flags);
+    f("depth", columns.depth);
+    f("ts_recv", columns.ts_recv);
+    f("ts_in_delta", columns.ts_in_delta);
+    f("sequence", columns.sequence);
+  }
+
+  Column<std::uint16_t> publisher_id;
+  Column<std::uint32_t> instrument_id;
+  Column<UnixNanos> ts_event;
+  Column<std::int64_t> price;
+  Column<std::uint32_t> size;
+  Column<Action> action;
+  Column<Side> side;
+  Column<FlagSet> flags;
+  Column<std::uint8_t> depth;
+  Column<UnixNanos> ts_recv;
+  Column<TimeDeltaNanos> ts_in_delta;
+  Column<std::uint32_t> sequence;
+};
+
+// The fields of a chunk of `Mbp1Msg` or `TbboMsg` records, one column per
+// field with the top level flattened.
+struct Mbp1Columns {
+  std::size_t Size() const { return ts_recv.size(); }
+  void Clear();
+  void Reserve(std::size_t capacity);
+  void Append(const Mbp1Msg& mbp1);
+
+  // Calls `f(name, column)` for every column of `columns`.
+  template <typename C, typename F>
+  static void ForEachColumn(C& columns, F&& f) {
+    f("publisher_id", columns.publisher_id);
+    f("instrument_id", columns.instrument_id);
+    f("ts_event", columns.ts_event);
+    f("price", columns.price);
+    f("size", columns.size);
+    f("action", columns.action);
+    f("side", columns.side);
+    f("flags", columns.flags);
+    f("depth", columns.depth);
+    f("ts_recv", columns.ts_recv);
+    f("ts_in_delta", columns.ts_in_delta);
+    f("sequence", columns.sequence);
+    f("bid_px", columns.bid_px);
+    f("ask_px", columns.ask_px);
+    f("bid_sz", columns.bid_sz);
+    f("ask_sz", columns.ask_sz);
+    f("bid_ct", columns.bid_ct);
+    f("ask_ct", columns.ask_ct);
+  }
+
+  Column<std::uint16_t> publisher_id;
+  Column<std::uint32_t> instrument_id;
+  Column<UnixNanos> ts_event;
+  Column<std::int64_t> price;
+  Column<std::uint32_t> size;
+  Column<Action> action;
+  Column<Side> side;
+  Column<FlagSet> flags;
+  Column<std::uint8_t> depth;
+  Column<UnixNanos> ts_recv;
+  Column<TimeDeltaNanos> ts_in_delta;
+  Column<std::uint32_t> sequence;
+  Column<std::int64_t> bid_px;
+  Column<std::int64_t> ask_px;
+  Column<std::uint32_t> bid_sz;
+  Column<std::uint32_t> ask_sz;
+  Column<std::uint32_t> bid_ct;
+  Column<std::uint32_t> ask_ct;
+};
+
+// The fields of a chunk of `OhlcvMsg` records, one column per field.
+struct OhlcvColumns {
+  std::size_t Size() const { return ts_event.size(); }
+  void Clear();
+  void Reserve(std::size_t capacity);
+  void Append(const OhlcvMsg& ohlcv);
+
+  // Calls `f(name, column)` for every column of `columns`.
+  template <typename C, typename F>
+  static void ForEachColumn(C& columns, F&& f) {
+    f("publisher_id", columns.publisher_id);
+    f("instrument_id", columns.instrument_id);
+    f("ts_event", columns.ts_event);
+    f("open", columns.open);
+    f("high", columns.high);
+    f("low", columns.low);
+    f("close", columns.close);
+    f("volume", columns.volume);
+  }
+
+  Column<std::uint16_t> publisher_id;
+  Column<std::uint32_t> instrument_id;
+  Column<UnixNanos> ts_event;
+  Column<std::int64_t> open;
+  Column<std::int64_t> high;
+  Column<std::int64_t> low;
+  Column<std::int64_t> close;
+  Column<std::uint64_t> volume;
+};
+
+// Decodes DBN data directly into columns, one per record field, in chunks of a
+// fixed number of records. Passing the same columns to each call of
+// `NextChunk` reuses their storage. Records of other types than the one
+// requested are skipped.
+class DbnColumnarReader {
+ public:
+  DbnColumnarReader(ILogReceiver* log_receiver, const std::string& file_path,
+                    std::size_t chunk_size);
+  DbnColumnarReader(ILogReceiver* log_receiver,
+                    std::unique_ptr<IReadable> input, std::size_t chunk_size);
+
+  std::size_t ChunkSize() const { return chunk_size_; }
+  const Metadata& GetMetadata();
+  // Replaces the contents of `columns` with up to `ChunkSize()` records.
+  // Returns false once the end of the input has been reached and `columns` is
+  // empty.
+  bool NextChunk(MboColumns* columns);
+  bool NextChunk(TradeColumns* columns);
+  bool NextChunk(Mbp1Columns* columns);
+  bool NextChunk(OhlcvColumns* columns);
+
+ private:
+  template <typename R, typename C>
+  bool FillChunk(C* columns);
+  void MaybeDecodeMetadata();
+
+  DbnDecoder decoder_;
+  std::size_t chunk_size_;
+  Metadata metadata_{};
+  bool has_decoded_metadata_{false};
+};
+}  // namespace databento
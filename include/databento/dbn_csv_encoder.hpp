@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <string>
+#include <vector>
+
+#include "databento/dbn.hpp"         // Metadata
+#include "databento/enums.hpp"       // Schema
+#include "databento/exceptions.hpp"  // InvalidArgumentError
+#include "databento/iwritable.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "databento/with_ts_out.hpp"
+
+namespace databento {
+// Encodes records of a single schema as CSV with a header line. Fields are
+// formatted directly into a reusable buffer which is written to the output
+// once it fills up, when `Flush` is called, and on destruction.
+//
+// Supports every schema. Records of other types than the schema's are
+// skipped, as are definitions of other DBN versions than the current one.
+class DbnCsvEncoder {
+ public:
+  // Buffers the header line for `schema`.
+  DbnCsvEncoder(ILogReceiver* log_receiver, Schema schema, IWritable* output);
+  // If `pretty_px` is true, prices are formatted as decimals instead of
+  // fixed-precision integers. If `pretty_ts` is true, timestamps are formatted
+  // as ISO 8601 instead of UNIX nanoseconds. Undefined prices and timestamps
+  // are left empty when pretty.
+  DbnCsvEncoder(ILogReceiver* log_receiver, Schema schema, IWritable* output,
+                bool pretty_px, bool pretty_ts);
+  // If `ts_out` is true, each line ends with a `ts_out` column holding the
+  // gateway send timestamp appended to each record. It's left empty for
+  // records without one.
+  DbnCsvEncoder(ILogReceiver* log_receiver, Schema schema, IWritable* output,
+                bool pretty_px, bool pretty_ts, bool ts_out);
+  // Uses the schema and `ts_out` of `metadata`, which can't have a mixed
+  // schema.
+  DbnCsvEncoder(ILogReceiver* log_receiver, const Metadata& metadata,
+                IWritable* output, bool pretty_px, bool pretty_ts);
+  DbnCsvEncoder(const DbnCsvEncoder&) = delete;
+  DbnCsvEncoder& operator=(const DbnCsvEncoder&) = delete;
+  DbnCsvEncoder(DbnCsvEncoder&&) = delete;
+  DbnCsvEncoder& operator=(DbnCsvEncoder&&) = delete;
+  // Flushes any buffered output, logging any error.
+  ~DbnCsvEncoder();
+
+  template <typename R>
+  void EncodeRecord(const R& record) {
+    static_assert(
+        has_header<R>::value,
+        "must be a DBN record struct with an `hd` RecordHeader field");
+    EncodeRecord(Record{const_cast<RecordHeader*>(&record.hd)});
+  }
+  // Throws `InvalidArgumentError` if the encoder wasn't created with
+  // `ts_out`.
+  template <typename R>
+  void EncodeRecord(const WithTsOut<R>& record) {
+    if (!ts_out_) {
+      throw InvalidArgumentError{"DbnCsvEncoder::EncodeRecord", "record",
+                                 "Encoder has no ts_out column"};
+    }
+    EncodeRecord(Record{const_cast<RecordHeader*>(&record.rec.hd)});
+  }
+  void EncodeRecord(const Record& record);
+  // Encodes a batch of records such as those returned by
+  // `DbnDecoder::DecodeRecords`.
+  void EncodeRecords(const std::vector<Record>& records);
+  // Splits `records` into up to `thread_count` contiguous blocks which are
+  // formatted concurrently and then written in order. Small batches are
+  // formatted on the calling thread.
+  void EncodeRecords(const std::vector<Record>& records,
+                     std::size_t thread_count);
+  // Writes any buffered output.
+  void Flush();
+
+ private:
+  using EncodeLineFn = char* (*)(const Record& record, bool pretty_px,
+                                 bool pretty_ts, bool ts_out, char* out);
+
+  // Formatted lines. `data` only grows so isn't zeroed for every line.
+  struct Block {
+    std::vector<char> data;
+    std::size_t size{};
+  };
+
+  void EncodeBlock(std::vector<Record>::const_iterator first,
+                   std::vector<Record>::const_iterator last, Block* block,
+                   bool can_flush);
+  void EncodeLine(const Record& record, Block* block);
+
+  ILogReceiver* log_receiver_;
+  IWritable* output_;
+  bool pretty_px_;
+  bool pretty_ts_;
+  bool ts_out_;
+  // Formats a record of the schema's type, returning `out` for other records
+  EncodeLineFn encode_line_;
+  Block buffer_;
+  // Used by threads other than the calling one in `EncodeRecords`
+  std::vector<Block> thread_blocks_;
+};
+}  // namespace databento
@@ -4,18 +4,52 @@
 #include <cstdint>  // uint8_t
 #include <memory>   // unique_ptr
 #include <string>
+#include <vector>
 
 #include "databento/dbn.hpp"
+#include "databento/detail/ring_buffer.hpp"
 #include "databento/detail/shared_channel.hpp"
 #include "databento/enums.hpp"  // Upgrade Policy
 #include "databento/file_stream.hpp"
 #include "databento/ireadable.hpp"
 #include "databento/log.hpp"
 #include "databento/record.hpp"  // Record, RecordHeader
+#include "databento/record_filter.hpp"
+#include "databento/zstd_dictionary.hpp"  // ZstdDictionarySet
 
 namespace databento {
+// Settings for `DbnDecoder`. The defaults match the constructors without
+// options.
+struct DbnDecoderOptions {
+  VersionUpgradePolicy upgrade_policy{VersionUpgradePolicy::UpgradeToV2};
+  // The size in bytes of the buffer records are read into, which may be
+  // rounded up to a multiple of the page size. Larger buffers reduce the number
+  // of reads from the input when replaying large amounts of data. 0 selects
+  // the default size.
+  std::size_t buffer_size{};
+  // If nonzero, the input is read and decompressed on a background thread into
+  // a queue of up to `prefetch_block_count` blocks of `buffer_size` bytes,
+  // overlapping it with decoding.
+  std::size_t prefetch_block_count{};
+  // Zstd frames compressed with a dictionary are decompressed with the one in
+  // `dictionaries` matching the ID in the frame header. Must outlive the
+  // decoder.
+  const ZstdDictionarySet* dictionaries{};
+  // Accepts Zstd frames with a window of up to 2^`zstd_window_log_max` bytes,
+  // such as those written with a large `ZstdCompressOptions::window_log`. 0
+  // keeps the Zstd default limit of 2^27 bytes. Decompression allocates the
+  // window the input asks for, so only raise it for input from a trusted
+  // source, such as files written by the caller.
+  int zstd_window_log_max{};
+};
+
 // DBN decoder. Set upgrade_policy to control how DBN version 1 data should be
 // handled. Defaults to upgrading DBNv1 data to version 2 (the current version).
+//
+// Uncompressed records of a `MappedFileStream` input are decoded directly from
+// the memory mapping without copying them into an intermediate buffer when
+// they're 8-byte aligned within the file, as in all files written by
+// `DbnEncoder`.
 class DbnDecoder {
  public:
   DbnDecoder(ILogReceiver* log_receiver, detail::SharedChannel channel);
@@ -23,6 +57,8 @@ class DbnDecoder {
   DbnDecoder(ILogReceiver* log_receiver, std::unique_ptr<IReadable> input);
   DbnDecoder(ILogReceiver* log_receiver, std::unique_ptr<IReadable> input,
              VersionUpgradePolicy upgrade_policy);
+  DbnDecoder(ILogReceiver* log_receiver, std::unique_ptr<IReadable> input,
+             const DbnDecoderOptions& options);
 
   static std::pair<std::uint8_t, std::size_t> DecodeMetadataVersionAndSize(
       const std::uint8_t* buffer, std::size_t size);
@@ -40,6 +76,37 @@ class DbnDecoder {
   // Lifetime of returned Record is until next call to DecodeRecord. Returns
   // nullptr once the end of the input has been reached.
   const Record* DecodeRecord();
+  // Decodes up to `max_count` records at once. The returned records point
+  // directly into the read buffer or memory mapping, only records that are
+  // upgraded are copied. Lifetime of the returned records is until the next
+  // call to DecodeRecord or DecodeRecords. Returns an empty batch once the
+  // end of the input has been reached.
+  const std::vector<Record>& DecodeRecords(std::size_t max_count);
+  // Like the above, but stops before the first record at or after
+  // `end_offset` in the decompressed input.
+  const std::vector<Record>& DecodeRecords(std::size_t max_count,
+                                           std::uint64_t end_offset);
+  // Returns the offset in the decompressed input of the next record to be
+  // decoded, before any upgrade. Can be used for indexing records.
+  std::uint64_t NextRecordOffset() const { return next_record_offset_; }
+  // Replaces the input after the metadata has been decoded, discarding any
+  // buffered records. `input` must be uncompressed and positioned at the start
+  // of a record at `offset` in the decompressed DBN stream, but is only read
+  // after the previous input has been destroyed. With prefetching, `input` is
+  // also read on a background thread.
+  void ResetInput(std::unique_ptr<IReadable> input, std::uint64_t offset);
+  // Repositions an uncompressed memory-mapped input to the record at `offset`,
+  // forwards or backwards, discarding any buffered records. Returns false
+  // without doing anything if the records aren't decoded from a mapping.
+  bool SeekMapped(std::uint64_t offset);
+  // Skips forward to the record at `offset` in the decompressed input, which
+  // must be at or after `NextRecordOffset()`, discarding the data before it
+  // without decoding it. Invalidates any previously returned records.
+  void SkipTo(std::uint64_t offset);
+  // Skips records not matching `filter` in DecodeRecord and DecodeRecords.
+  // Records are checked against their header before any upgrade, so rejected
+  // records are never copied.
+  void SetFilter(RecordFilter filter);
 
  private:
   static std::string DecodeSymbol(
@@ -58,6 +125,11 @@ class DbnDecoder {
       std::vector<std::uint8_t>::const_iterator& buffer_it,
       std::vector<std::uint8_t>::const_iterator buffer_end_it);
   bool DetectCompression();
+  RecordHeader* ConsumeMappedRecord();
+  RecordHeader* ConsumeBufferedRecord();
+  bool BatchBufferedRecords(std::size_t max_count, std::uint64_t end_offset);
+  void BatchMappedRecords(std::size_t max_count, std::uint64_t end_offset);
+  void UpgradeBatch();
   std::size_t FillBuffer();
   std::size_t GetReadBufferSize() const;
   RecordHeader* BufferRecordHeader();
@@ -65,13 +137,26 @@ class DbnDecoder {
   ILogReceiver* log_receiver_;
   std::uint8_t version_{};
   VersionUpgradePolicy upgrade_policy_;
+  std::size_t prefetch_block_count_;
   bool ts_out_{};
   std::unique_ptr<IReadable> input_;
+  // Set when `input_` is an uncompressed memory-mapped file
+  MappedFileStream* mapped_input_{};
+  // Used for decoding the metadata
   std::vector<std::uint8_t> read_buffer_;
-  std::size_t buffer_idx_{};
+  detail::RingBuffer record_buffer_;
+  std::uint64_t next_record_offset_{};
+  RecordFilter filter_;
   // Must be 8-byte aligned for records
   alignas(
       RecordHeader) std::array<std::uint8_t, kMaxRecordLen> compat_buffer_{};
   Record current_record_{nullptr};
+  struct alignas(RecordHeader) CompatBuffer {
+    std::array<std::uint8_t, kMaxRecordLen> data;
+  };
+  std::vector<Record> record_batch_;
+  // Indices into `record_batch_` of upgraded records
+  std::vector<std::size_t> upgraded_idxs_;
+  std::vector<CompatBuffer> batch_compat_buffers_;
 };
 }  // namespace databento
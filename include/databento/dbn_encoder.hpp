@@ -1,16 +1,30 @@
 #pragma once
 
 #include <cstdint>  // uint32_t
+#include <memory>   // unique_ptr
 
 #include "databento/dbn.hpp"  // Metadata
+#include "databento/detail/zstd_stream.hpp"
+#include "databento/instrument_index.hpp"
 #include "databento/iwritable.hpp"
 #include "databento/record.hpp"
+#include "databento/ts_index.hpp"
 #include "databento/with_ts_out.hpp"
+#include "databento/zstd_compress_options.hpp"
 
 namespace databento {
 class DbnEncoder {
  public:
   explicit DbnEncoder(const Metadata& metadata, IWritable* output);
+  // Also adds each encoded record to `index`, which must outlive the encoder.
+  DbnEncoder(const Metadata& metadata, IWritable* output, TsIndex* index);
+  // Any of the indexes can be null.
+  DbnEncoder(const Metadata& metadata, IWritable* output, TsIndex* ts_index,
+             InstrumentIndex* instrument_index);
+  // Zstd-compresses the DBN with `compression` before writing it to `output`.
+  // The compressed stream is finished when the encoder is destroyed.
+  DbnEncoder(const Metadata& metadata, IWritable* output,
+             const ZstdCompressOptions& compression);
 
   static void EncodeMetadata(const Metadata& metadata, IWritable* output);
   static void EncodeRecord(const Record& record, IWritable* output);
@@ -34,6 +48,12 @@ class DbnEncoder {
  private:
   static std::uint32_t CalcLength(const Metadata& metadata);
 
+  // Only set when compressing
+  std::unique_ptr<detail::ZstdCompressStream> compressor_;
   IWritable* output_;
+  TsIndex* ts_index_{};
+  InstrumentIndex* instrument_index_{};
+  // Offset of the next record in the output
+  std::uint64_t offset_;
 };
 }  // namespace databento
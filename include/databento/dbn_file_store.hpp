@@ -1,15 +1,60 @@
 #pragma once
 
+#include <cstddef>  // size_t
+#include <cstdint>  // uint32_t, uint64_t
+#include <memory>   // unique_ptr
 #include <string>
+#include <utility>  // forward
+#include <vector>
 
+#include "databento/datetime.hpp"     // UnixNanos
 #include "databento/dbn.hpp"          // DecodeMetadata
 #include "databento/dbn_decoder.hpp"  // DbnDecoder
+#include "databento/detail/zstd_stream.hpp"  // ZstdSeekableDecodeStream
 #include "databento/enums.hpp"        // VersionUpgradePolicy
+#include "databento/file_stream.hpp"  // InFileStream, MappedFileStream
+#include "databento/instrument_index.hpp"
+#include "databento/ireadable.hpp"
 #include "databento/log.hpp"
 #include "databento/record.hpp"
-#include "databento/timeseries.hpp"  // MetadataCallback, RecordCallback
+#include "databento/record_filter.hpp"
+#include "databento/timeseries.hpp"  // KeepGoing, MetadataCallback, RecordBatchCallback
+#include "databento/ts_index.hpp"
+#include "databento/zstd_dictionary.hpp"  // ZstdDictionarySet
 
 namespace databento {
+// Settings for `DbnFileStore`. The defaults match the constructors without
+// options, and every combination of settings is supported.
+struct DbnFileStoreOptions {
+  VersionUpgradePolicy upgrade_policy{VersionUpgradePolicy::UpgradeToV2};
+  // See `DbnDecoderOptions`.
+  std::size_t buffer_size{};
+  // Reading and decompressing the file happens on a background thread feeding
+  // up to `prefetch_block_count` decompressed blocks to the decoder, leaving
+  // the calling thread to decode records and run callbacks.
+  std::size_t prefetch_block_count{};
+  // Reads the file through a memory mapping. Uncompressed records are decoded
+  // in place, avoiding copying them into an intermediate buffer.
+  bool mapped{};
+  // If nonzero, Zstd files made up of multiple frames, such as those in the
+  // seekable format, are decompressed on this many worker threads while the
+  // records are returned in order. At most two frames per thread are held in
+  // memory. Single-frame files are decompressed as usual.
+  std::size_t decompress_thread_count{};
+  // Decompresses Zstd frames compressed with a dictionary with the one in
+  // `dictionaries` matching the ID in the frame header. Must outlive the
+  // store.
+  const ZstdDictionarySet* dictionaries{};
+  // An index of the file used to support `SeekTo`. Must outlive the store.
+  const TsIndex* ts_index{};
+  // An index of the file used to support `SelectInstruments`. Must outlive
+  // the store.
+  const InstrumentIndex* instrument_index{};
+  // See `DbnDecoderOptions`. Also applies to parallel decompression and
+  // repositioning by `SeekTo` and `SelectInstruments`.
+  int zstd_window_log_max{};
+};
+
 // A reader for DBN files. This class provides both a callback API similar to
 // TimeseriesGetRange in historical data and LiveThreaded for live data as well
 // as a blocking API similar to that of LiveBlocking. Only one API should be
@@ -19,22 +64,101 @@ class DbnFileStore {
   explicit DbnFileStore(const std::string& file_path);
   DbnFileStore(ILogReceiver* log_receiver, const std::string& file_path,
                VersionUpgradePolicy upgrade_policy);
+  DbnFileStore(ILogReceiver* log_receiver, const std::string& file_path,
+               const DbnFileStoreOptions& options);
 
-  // Callback API: calling Replay consumes the input.
+  // Callback API: calling Replay consumes the input. `record_callback` can be
+  // any callable with the signature of `RecordCallback` and is called
+  // directly rather than through a `std::function`.
+  template <typename F, detail::EnableIfRecordCallback<F> = 0>
+  void Replay(const MetadataCallback& metadata_callback, F&& record_callback) {
+    MaybeDecodeMetadata();
+    if (metadata_callback) {
+      metadata_callback(Metadata{metadata_});
+    }
+    const Record* record;
+    while ((record = DecodeRecord()) != nullptr) {
+      if (record_callback(*record) == KeepGoing::Stop) {
+        break;
+      }
+    }
+  }
+  template <typename F, detail::EnableIfRecordCallback<F> = 0>
+  void Replay(F&& record_callback) {
+    Replay({}, std::forward<F>(record_callback));
+  }
+  // Replays only the records of type `T`, e.g. `Replay<MboMsg>(callback)`,
+  // where `record_callback` takes a `const T&` and returns `KeepGoing`.
+  template <typename T, typename F>
+  void Replay(const MetadataCallback& metadata_callback, F&& record_callback) {
+    Replay(metadata_callback,
+           detail::MakeTypedRecordCallback<T>(std::forward<F>(record_callback)));
+  }
+  template <typename T, typename F>
+  void Replay(F&& record_callback) {
+    Replay<T>({}, std::forward<F>(record_callback));
+  }
+  // Replays the records in batches of up to `kMaxRecordBatchSize`. After
+  // `SeekTo`, the first batch contains a single record.
   void Replay(const MetadataCallback& metadata_callback,
-              const RecordCallback& record_callback);
-  void Replay(const RecordCallback& record_callback);
+              const RecordBatchCallback& record_batch_callback);
+  void Replay(const RecordBatchCallback& record_batch_callback);
 
   // Blocking API
   const Metadata& GetMetadata();
   // Returns the next record or `nullptr` if there are no remaining records.
   const Record* NextRecord();
 
+  // Positions the store so the next record returned or replayed is the first
+  // with an index timestamp at or after `ts`, only decoding the records of one
+  // index block before it. Requires `DbnFileStoreOptions::ts_index`. Can be
+  // called multiple times.
+  void SeekTo(UnixNanos ts);
+  // Limits the records returned or replayed from the current position to those
+  // for `instrument_ids`, skipping the blocks of the file without any of them.
+  // Requires `DbnFileStoreOptions::instrument_index`. An empty
+  // `instrument_ids` removes the selection.
+  void SelectInstruments(std::vector<std::uint32_t> instrument_ids);
+  // Skips records not matching `filter` based on their header alone. See
+  // `DbnDecoder::SetFilter`.
+  void SetFilter(RecordFilter filter);
+
  private:
   void MaybeDecodeMetadata();
+  const Record* DecodeRecord();
+  const std::vector<Record>& DecodeRecords();
+  const Record* DecodeUnselectedRecord();
+  bool MoveToNextSelectedBlock();
+  // Positions the decoder at the record at `offset` in the decompressed file.
+  void MoveTo(std::uint64_t offset);
+  void DetectInputKind();
+  bool IsSelected(const Record& record) const;
 
   DbnDecoder decoder_;
   Metadata metadata_{};
   bool has_decoded_metadata_{false};
+  std::string file_path_;
+  const ZstdDictionarySet* dictionaries_{};
+  int zstd_window_log_max_{};
+  // Set on the first move by `SeekTo` or `SelectInstruments`
+  bool is_input_kind_known_{};
+  bool is_compressed_{};
+  // Only set for uncompressed files, reused for every move
+  std::unique_ptr<InFileStream> file_input_;
+  // Only set for Zstd files in the seekable format, reused for every move
+  std::unique_ptr<detail::ZstdSeekableDecodeStream> seekable_input_;
+  const TsIndex* ts_index_{};
+  const InstrumentIndex* instrument_index_{};
+  // Set by `SeekTo`
+  const Record* seek_record_{};
+  bool is_seek_past_end_{};
+  // Set by `SelectInstruments`. Both are sorted.
+  std::vector<std::uint32_t> selected_ids_;
+  std::vector<std::size_t> selected_blocks_;
+  std::size_t next_selected_block_{};
+  std::uint64_t block_end_offset_{};
+  // Used for batches filtered by the instrument selection or of the single
+  // record found by `SeekTo`
+  std::vector<Record> record_batch_;
 };
 }  // namespace databento
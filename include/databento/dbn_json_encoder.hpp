@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>  // size_t
+
+#include "databento/record.hpp"
+#include "databento/with_ts_out.hpp"
+
+namespace databento {
+// The minimum buffer size for `DbnJsonEncoder::EncodeRecord`, large enough for
+// a line of any supported record type.
+constexpr std::size_t kMaxJsonLineLen = 4096;
+
+// Encodes records as JSON lines, one object per record with the header nested
+// under "hd" and book levels as an array under "levels". Fields are formatted
+// directly into a caller-provided buffer without allocating.
+//
+// As in the Historical API's JSON encoding, 64-bit integers like prices and
+// timestamps are quoted to avoid a loss of precision in JSON parsers.
+//
+// Supports the record types of every schema, as well as `ErrorMsg`,
+// `SymbolMappingMsg`, and `SystemMsg`. DBN version 1 records are upgraded to
+// version 2. Version 3 definitions aren't supported.
+class DbnJsonEncoder {
+ public:
+  DbnJsonEncoder() = default;
+  // If `pretty_px` is true, prices are formatted as decimals instead of
+  // fixed-precision integers. If `pretty_ts` is true, timestamps are formatted
+  // as ISO 8601 instead of UNIX nanoseconds. Undefined prices and timestamps
+  // are null when pretty.
+  DbnJsonEncoder(bool pretty_px, bool pretty_ts)
+      : pretty_px_{pretty_px}, pretty_ts_{pretty_ts} {}
+  // If `ts_out` is true, records passed as `Record` with a gateway send
+  // timestamp appended have it written as "ts_out".
+  DbnJsonEncoder(bool pretty_px, bool pretty_ts, bool ts_out)
+      : pretty_px_{pretty_px}, pretty_ts_{pretty_ts}, ts_out_{ts_out} {}
+
+  template <typename R>
+  std::size_t EncodeRecord(const R& record, char* buffer,
+                           std::size_t buffer_size) const {
+    static_assert(
+        has_header<R>::value,
+        "must be a DBN record struct with an `hd` RecordHeader field");
+    return EncodeRecord(Record{const_cast<RecordHeader*>(&record.hd)},
+                        buffer, buffer_size);
+  }
+  // Also writes the "ts_out" of `record`.
+  template <typename R>
+  std::size_t EncodeRecord(const WithTsOut<R>& record, char* buffer,
+                           std::size_t buffer_size) const {
+    return Encode(Record{const_cast<RecordHeader*>(&record.rec.hd)}, true,
+                  buffer, buffer_size);
+  }
+  // Writes `record` to `buffer` as a JSON object followed by a newline.
+  // `buffer_size` must be at least `kMaxJsonLineLen`. Returns the number of
+  // characters written. Throws `InvalidArgumentError` for unsupported record
+  // types.
+  std::size_t EncodeRecord(const Record& record, char* buffer,
+                           std::size_t buffer_size) const;
+
+ private:
+  std::size_t Encode(const Record& record, bool ts_out, char* buffer,
+                     std::size_t buffer_size) const;
+
+  bool pretty_px_{false};
+  bool pretty_ts_{false};
+  bool ts_out_{false};
+};
+}  // namespace databento
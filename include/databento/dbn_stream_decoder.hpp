@@ -0,0 +1,106 @@
+#pragma once
+
+#include <zstd.h>
+
+#include <array>
+#include <cstddef>  // size_t
+#include <cstdint>  // uint8_t
+#include <memory>   // unique_ptr
+#include <vector>
+
+#include "databento/dbn.hpp"  // Metadata
+#include "databento/detail/aligned_allocator.hpp"
+#include "databento/detail/zstd_stream.hpp"  // ZstdFrameDictionaries
+#include "databento/enums.hpp"  // VersionUpgradePolicy
+#include "databento/log.hpp"
+#include "databento/record.hpp"  // kMaxRecordLen, Record, RecordHeader
+#include "databento/zstd_dictionary.hpp"  // ZstdDictionarySet
+
+namespace databento {
+// Decodes DBN pushed to it in chunks as they arrive, such as the body of an
+// HTTP response, rather than pulling it from an `IReadable`. Zstd-compressed
+// input is detected and decompressed as it's fed. Because decoding happens on
+// the thread feeding the data, no background thread or channel is needed
+// between receiving and decoding.
+class DbnStreamDecoder {
+ public:
+  explicit DbnStreamDecoder(ILogReceiver* log_receiver);
+  DbnStreamDecoder(ILogReceiver* log_receiver,
+                   VersionUpgradePolicy upgrade_policy);
+  // Zstd frames compressed with a dictionary are decompressed with the one in
+  // `dictionaries` matching the ID in the frame header. `dictionaries` must
+  // outlive the decoder.
+  DbnStreamDecoder(ILogReceiver* log_receiver,
+                   VersionUpgradePolicy upgrade_policy,
+                   const ZstdDictionarySet* dictionaries);
+
+  // Appends the next `length` bytes of the stream. Invalidates any records
+  // previously returned by DecodeRecord or DecodeRecords.
+  void Feed(const std::uint8_t* data, std::size_t length);
+  // Signals the end of the stream. Throws if it ended before the metadata and
+  // logs a warning if it ended with a partial record. With dictionaries, a
+  // final Zstd frame too short to hold a whole frame header is only
+  // decompressed here.
+  void Finish();
+  // Returns true once the whole metadata has been fed.
+  bool HasMetadata() const;
+  // Should be called exactly once, after HasMetadata returns true.
+  Metadata DecodeMetadata();
+  // Returns the next complete record fed, or nullptr if more data needs to be
+  // fed. Lifetime of the returned Record is until the next call to Feed,
+  // DecodeRecord, or DecodeRecords.
+  const Record* DecodeRecord();
+  // Decodes up to `max_count` complete records already fed, returning an empty
+  // batch if more data needs to be fed. Only records that are upgraded are
+  // copied. Lifetime of the returned records is until the next call to Feed,
+  // DecodeRecord, or DecodeRecords.
+  const std::vector<Record>& DecodeRecords(std::size_t max_count);
+
+ private:
+  struct alignas(RecordHeader) CompatBuffer {
+    std::array<std::uint8_t, kMaxRecordLen> data;
+  };
+
+  void DetectCompression();
+  void Decompress(const std::uint8_t* data, std::size_t length);
+  // Decompresses `z_in_buffer` up to the end of the current frame.
+  void DecompressFrame(ZSTD_inBuffer* z_in_buffer);
+  void Append(const std::uint8_t* data, std::size_t length);
+  void Reserve(std::size_t length);
+  // Moves any unread data to the front of `buffer_`, aligning the next record
+  void Compact();
+  std::size_t UnreadSize() const { return write_pos_ - read_pos_; }
+  // Returns nullptr if there's no complete record
+  RecordHeader* ConsumeRecord();
+  void UpgradeBatch();
+
+  ILogReceiver* log_receiver_;
+  VersionUpgradePolicy upgrade_policy_;
+  std::uint8_t version_{};
+  bool ts_out_{};
+  bool is_compression_detected_{};
+  bool is_metadata_decoded_{};
+  // Only set for Zstd-compressed input
+  std::unique_ptr<ZSTD_DStream, std::size_t (*)(ZSTD_DStream*)> z_dstream_;
+  // Only set when decompressing with dictionaries
+  std::unique_ptr<detail::ZstdFrameDictionaries> dictionaries_;
+  bool is_frame_start_{true};
+  bool is_finished_{};
+  // Compressed input fed before the whole frame header it starts, which is
+  // needed to find the frame's dictionary
+  std::vector<std::uint8_t> pending_input_;
+  // The decompressed stream, aligned for records. Bytes before `read_pos_`
+  // have been decoded and bytes from `write_pos_` on are unused capacity.
+  std::vector<std::uint8_t,
+              detail::AlignedAllocator<std::uint8_t, alignof(RecordHeader)>>
+      buffer_;
+  std::size_t read_pos_{};
+  std::size_t write_pos_{};
+  CompatBuffer compat_buffer_{};
+  Record current_record_{nullptr};
+  std::vector<Record> record_batch_;
+  // Indices into `record_batch_` of upgraded records
+  std::vector<std::size_t> upgraded_idxs_;
+  std::vector<CompatBuffer> batch_compat_buffers_;
+};
+}  // namespace databento
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <httplib.h>
+
+#include <cstddef>    // size_t
+#include <exception>  // exception_ptr
+#include <functional>
+#include <memory>  // unique_ptr
+#include <string>
+#include <vector>
+
+#include "databento/detail/http_client.hpp"
+#include "databento/detail/scoped_thread.hpp"
+#include "databento/detail/shared_channel.hpp"
+
+namespace databento {
+namespace detail {
+// Requests several streams at once, each on its own connection and thread,
+// writing each response into its own `SharedChannel` of at most
+// `max_buffered_size` bytes to be read on another thread. A request is paused
+// while its channel is full.
+class ConcurrentHttpStreams {
+ public:
+  using ClientFactory = std::function<std::unique_ptr<HttpClient>()>;
+
+  ConcurrentHttpStreams(const ClientFactory& make_client,
+                        const std::string& path,
+                        const std::vector<httplib::Params>& params_list,
+                        std::size_t max_buffered_size);
+  ConcurrentHttpStreams(const ConcurrentHttpStreams&) = delete;
+  ConcurrentHttpStreams& operator=(const ConcurrentHttpStreams&) = delete;
+  ConcurrentHttpStreams(ConcurrentHttpStreams&&) = delete;
+  ConcurrentHttpStreams& operator=(ConcurrentHttpStreams&&) = delete;
+  // Cancels any incomplete requests and waits for their threads.
+  ~ConcurrentHttpStreams();
+
+  std::size_t Size() const { return streams_.size(); }
+  // The channel of the response to the request at `idx` in `params_list`. The
+  // channel of a failed request ends early: call `Stop` and then
+  // `RethrowError` to get the cause.
+  const SharedChannel& Channel(std::size_t idx) const {
+    return streams_[idx]->channel;
+  }
+  // Cancels any incomplete requests and waits for all threads to return.
+  void Stop();
+  // Rethrows the exception of the first request that failed, if any. Should
+  // only be called after `Stop`.
+  void RethrowError() const;
+
+ private:
+  struct Stream {
+    SharedChannel channel;
+    std::exception_ptr exception;
+    ScopedThread thread;
+  };
+
+  std::vector<std::unique_ptr<Stream>> streams_;
+};
+}  // namespace detail
+}  // namespace databento
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+
+namespace databento {
+namespace detail {
+// Creates the directory `dir_name` if it doesn't already exist, including when
+// another process creates it concurrently. Does nothing if `dir_name` is
+// empty.
+void TryCreateDir(const std::string& dir_name);
+// Joins `path` to `dir` with a single separator.
+std::string PathJoin(const std::string& dir, const std::string& path);
+}  // namespace detail
+}  // namespace databento
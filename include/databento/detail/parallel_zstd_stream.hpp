@@ -0,0 +1,92 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>    // size_t
+#include <cstdint>    // uint8_t
+#include <exception>  // exception_ptr
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "databento/detail/scoped_thread.hpp"
+#include "databento/file_stream.hpp"  // MappedFileStream
+#include "databento/ireadable.hpp"
+#include "databento/zstd_dictionary.hpp"  // ZstdDictionarySet
+
+namespace databento {
+namespace detail {
+// Returns whether the Zstd file at `file_path` is made up of more than one
+// frame of data, so it can be decompressed by `ParallelZstdDecodeStream`.
+bool HasMultipleZstdFrames(const std::string& file_path);
+
+// Decompresses a file made up of multiple independent Zstd frames, such as one
+// written in the Zstd seekable format, on `thread_count` worker threads. Each
+// worker decompresses a whole frame at a time, the decompressed frames are read
+// back in order. At most two frames per thread are held in memory at once, so
+// this is only suited to files with frames of a bounded size, not single-frame
+// files. See `HasMultipleZstdFrames`.
+class ParallelZstdDecodeStream : public IReadable {
+ public:
+  ParallelZstdDecodeStream(const std::string& file_path,
+                           std::size_t thread_count);
+  // Frames compressed with a dictionary are decompressed with the one in
+  // `dictionaries` matching the ID in the frame header. `dictionaries` must
+  // outlive the stream.
+  ParallelZstdDecodeStream(const std::string& file_path,
+                           std::size_t thread_count,
+                           const ZstdDictionarySet* dictionaries);
+  // See `ZstdDecodeStream::SetWindowLogMax`.
+  ParallelZstdDecodeStream(const std::string& file_path,
+                           std::size_t thread_count,
+                           const ZstdDictionarySet* dictionaries,
+                           int window_log_max);
+  ParallelZstdDecodeStream(const ParallelZstdDecodeStream&) = delete;
+  ParallelZstdDecodeStream& operator=(const ParallelZstdDecodeStream&) = delete;
+  ParallelZstdDecodeStream(ParallelZstdDecodeStream&&) = delete;
+  ParallelZstdDecodeStream& operator=(ParallelZstdDecodeStream&&) = delete;
+  ~ParallelZstdDecodeStream() override;
+
+  // Read exactly `length` bytes into `buffer`.
+  void ReadExact(std::uint8_t* buffer, std::size_t length) override;
+  // Read at most `length` bytes. Returns the number of bytes read. Will only
+  // return 0 if the end of the stream is reached.
+  std::size_t ReadSome(std::uint8_t* buffer, std::size_t max_length) override;
+
+ private:
+  struct Frame {
+    // Sized to its capacity to be reused between frames
+    std::vector<std::uint8_t> data;
+    std::size_t size;
+    bool is_ready;
+    std::exception_ptr exception;
+  };
+
+  void Work();
+  bool IsEnd() const;
+
+  MappedFileStream file_;
+  const ZstdDictionarySet* dictionaries_;
+  int window_log_max_;
+  const std::uint8_t* compressed_;
+  std::size_t compressed_size_;
+  std::vector<Frame> frames_;
+  // Offset into the frame at `read_count_`. Only accessed by the reader.
+  std::size_t read_pos_{};
+  // protects all following data members and the `is_ready` and `exception`
+  // fields of `frames_`
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // Offset of the next frame in `compressed_` to be claimed by a worker
+  std::size_t next_offset_{};
+  // Monotonic frame counts
+  std::size_t claim_count_{};
+  std::size_t read_count_{};
+  bool is_stopped_{};
+  // Set if the next frame couldn't be located
+  std::exception_ptr exception_;
+  // Must be last so the threads are joined before the other members are
+  // destroyed
+  std::vector<ScopedThread> threads_;
+};
+}  // namespace detail
+}  // namespace databento
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>    // size_t
+#include <cstdint>    // uint8_t
+#include <exception>  // exception_ptr
+#include <memory>     // unique_ptr
+#include <mutex>
+#include <vector>
+
+#include "databento/detail/scoped_thread.hpp"
+#include "databento/ireadable.hpp"
+
+namespace databento {
+namespace detail {
+// Reads `input` on a background thread into a bounded queue of `block_count`
+// blocks of `block_size` bytes, so that reading and decompressing the input
+// overlaps with consuming it. Exceptions thrown by `input` are rethrown from
+// `ReadSome` once the blocks read before it have been consumed.
+class PrefetchStream : public IReadable {
+ public:
+  PrefetchStream(std::unique_ptr<IReadable> input, std::size_t block_size,
+                 std::size_t block_count);
+  PrefetchStream(const PrefetchStream&) = delete;
+  PrefetchStream& operator=(const PrefetchStream&) = delete;
+  PrefetchStream(PrefetchStream&&) = delete;
+  PrefetchStream& operator=(PrefetchStream&&) = delete;
+  // Waits for any in-progress read of `input` to complete.
+  ~PrefetchStream() override;
+
+  // Read exactly `length` bytes into `buffer`.
+  void ReadExact(std::uint8_t* buffer, std::size_t length) override;
+  // Read at most `length` bytes. Returns the number of bytes read. Will only
+  // return 0 if the end of the stream is reached.
+  std::size_t ReadSome(std::uint8_t* buffer, std::size_t max_length) override;
+
+ private:
+  struct Block {
+    std::vector<std::uint8_t> data;
+    std::size_t size;
+  };
+
+  void Prefetch();
+
+  std::unique_ptr<IReadable> input_;
+  std::vector<Block> blocks_;
+  // Offset into the block at `read_count_`. Only accessed by the reader.
+  std::size_t read_pos_{};
+  // protects all following data members
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // Monotonic block counts, the difference is the number of filled blocks
+  std::size_t read_count_{};
+  std::size_t write_count_{};
+  bool is_finished_{};
+  bool is_stopped_{};
+  std::exception_ptr exception_;
+  // Must be last so the thread is joined before the other members are
+  // destroyed
+  ScopedThread thread_;
+};
+}  // namespace detail
+}  // namespace databento
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint8_t
+#include <vector>
+
+namespace databento {
+namespace detail {
+// A byte ring buffer whose storage is mapped twice into adjacent virtual
+// memory so the readable and writable regions are always contiguous, even when
+// they wrap around the end of the buffer. If the mirrored mapping can't be
+// created, falls back to a linear buffer that moves unread bytes to the front
+// in `Compact`.
+class RingBuffer {
+ public:
+  // `min_capacity` is rounded up to a multiple of the page size (allocation
+  // granularity on Windows) when the buffer is mirrored.
+  explicit RingBuffer(std::size_t min_capacity);
+  RingBuffer(const RingBuffer&) = delete;
+  RingBuffer& operator=(const RingBuffer&) = delete;
+  RingBuffer(RingBuffer&& other) noexcept;
+  RingBuffer& operator=(RingBuffer&& rhs) noexcept;
+  ~RingBuffer();
+
+  std::size_t Capacity() const { return capacity_; }
+  bool IsMirrored() const { return is_mirrored_; }
+  // Start of the `ReadableSize()` contiguous bytes that have been committed
+  // but not yet consumed.
+  std::uint8_t* ReadBegin() const { return data_ + read_pos_; }
+  std::size_t ReadableSize() const { return write_pos_ - read_pos_; }
+  // Start of the `WritableSize()` contiguous bytes free for writing.
+  std::uint8_t* WriteBegin() const { return data_ + write_pos_; }
+  std::size_t WritableSize() const {
+    return is_mirrored_ ? capacity_ - ReadableSize() : capacity_ - write_pos_;
+  }
+  // Marks `length` bytes written at `WriteBegin()` as readable.
+  void Commit(std::size_t length) { write_pos_ += length; }
+  // Marks `length` bytes at `ReadBegin()` as read.
+  void Consume(std::size_t length);
+  // Discards all unread bytes.
+  void Clear() {
+    read_pos_ = 0;
+    write_pos_ = 0;
+  }
+  // Makes all free space writable. Only moves unread bytes when the buffer
+  // isn't mirrored.
+  void Compact();
+
+ private:
+  bool Mirror(std::size_t min_capacity);
+  void Unmap();
+
+  std::uint8_t* data_{};
+  std::size_t capacity_{};
+  std::size_t read_pos_{};
+  // Always within `capacity_` of `read_pos_`
+  std::size_t write_pos_{};
+  bool is_mirrored_{};
+  // Storage when not mirrored
+  std::vector<std::uint8_t> fallback_;
+};
+}  // namespace detail
+}  // namespace databento
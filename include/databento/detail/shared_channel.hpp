@@ -8,15 +8,33 @@
 
 namespace databento {
 namespace detail {
-// Copyable, thread-safe, unidirectional channel.
+// Copyable, thread-safe, unidirectional channel between one writer and one
+// reader. Data is passed through a bounded ring of `chunk_size * chunk_count`
+// bytes whose chunks are allocated as they're first written to. Writes are
+// appended to the partly-filled tail chunk and become readable as soon as each
+// `Write` has copied them. Reads and writes don't take a lock unless they need
+// to wait.
+//
+// Once `chunk_size * chunk_count` bytes are buffered, `Write` blocks until the
+// reader catches up, so writing more than that before reading from the same
+// thread never returns. The default constructor buffers up to 4 MiB.
 class SharedChannel : public IReadable {
  public:
+  static constexpr std::size_t kDefaultChunkSize = 16 * 1024;
+  static constexpr std::size_t kDefaultChunkCount = 256;
+
   SharedChannel();
+  SharedChannel(std::size_t chunk_size, std::size_t chunk_count);
 
-  // Write `data` of `length` bytes to the channel.
-  void Write(const std::uint8_t* data, std::size_t length);
+  // Write `data` of `length` bytes to the channel, blocking while the channel
+  // is full. Returns false without writing the rest of `data` if the channel
+  // was cancelled.
+  bool Write(const std::uint8_t* data, std::size_t length);
   // Signal the end of input.
   void Finish();
+  // Signal the reader will stop reading, unblocking and failing any current
+  // and future writes.
+  void Cancel();
   // Read exactly `length` bytes.
   void ReadExact(std::uint8_t* buffer, std::size_t length) override;
   // Read at most `length` bytes. Returns the number of bytes read. Will only
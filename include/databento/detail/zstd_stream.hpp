@@ -3,22 +3,70 @@
 #include <zstd.h>
 
 #include <cstddef>  // size_t
-#include <cstdint>  // uint8_t
-#include <memory>   // unique_ptr
+#include <cstdint>  // uint8_t, uint32_t
+#include <map>
+#include <memory>  // unique_ptr
+#include <string>
 #include <vector>
 
+#include "databento/file_stream.hpp"  // InFileStream
 #include "databento/ireadable.hpp"
 #include "databento/iwritable.hpp"
 #include "databento/log.hpp"
+#include "databento/zstd_compress_options.hpp"
+#include "databento/zstd_dictionary.hpp"
 
 namespace databento {
 namespace detail {
+// Finds the dictionary each frame was compressed with in a
+// `ZstdDictionarySet`, digesting each one on first use.
+class ZstdFrameDictionaries {
+ public:
+  // The largest possible Zstd frame header, from `ZSTD_FRAMEHEADERSIZE_MAX`
+  static constexpr std::size_t kMaxFrameHeaderSize = 18;
+
+  // `dictionaries` must outlive this object.
+  explicit ZstdFrameDictionaries(const ZstdDictionarySet* dictionaries);
+
+  // References the dictionary for the frame whose header is at the start of
+  // `frame` for decompressing the frame with `z_dstream`. Frames without a
+  // dictionary ID and skippable frames are left unchanged. `size` should be at
+  // least `kMaxFrameHeaderSize` unless the input ends sooner.
+  void RefFrameDictionary(ZSTD_DStream* z_dstream, const std::uint8_t* frame,
+                          std::size_t size);
+
+ private:
+  const ZstdDictionarySet* dictionaries_;
+  // Digested dictionaries by ID, created on first use
+  std::map<std::uint32_t,
+           std::unique_ptr<ZSTD_DDict, std::size_t (*)(ZSTD_DDict*)>>
+      ddicts_;
+};
+
 class ZstdDecodeStream : public IReadable {
  public:
   explicit ZstdDecodeStream(std::unique_ptr<IReadable> input);
   ZstdDecodeStream(std::unique_ptr<IReadable> input,
                    std::vector<std::uint8_t>&& in_buffer);
+  // Frames compressed with a dictionary are decompressed with the one in
+  // `dictionaries` matching the ID in the frame header. `dictionaries` must
+  // outlive the stream.
+  ZstdDecodeStream(std::unique_ptr<IReadable> input,
+                   const ZstdDictionarySet* dictionaries);
+  ZstdDecodeStream(std::unique_ptr<IReadable> input,
+                   std::vector<std::uint8_t>&& in_buffer,
+                   const ZstdDictionarySet* dictionaries);
 
+  // Starts decompressing a new stream from `input`, reusing the decompression
+  // context, buffer, and digested dictionaries. Any unread data from the
+  // previous input is discarded.
+  void Reset(std::unique_ptr<IReadable> input);
+  // Accepts frames with a window of up to 2^`window_log_max` bytes, such as
+  // those compressed with a large `ZstdCompressOptions::window_log`, instead
+  // of the Zstd default limit of 2^27 bytes. The window is allocated based on
+  // the frame header, so only raise it for trusted input. 0 restores the
+  // default.
+  void SetWindowLogMax(int window_log_max);
   // Read exactly `length` bytes into `buffer`.
   void ReadExact(std::uint8_t* buffer, std::size_t length) override;
   // Read at most `length` bytes. Returns the number of bytes read. Will only
@@ -26,17 +74,87 @@ class ZstdDecodeStream : public IReadable {
   std::size_t ReadSome(std::uint8_t* buffer, std::size_t max_length) override;
 
  private:
+  // Moves any unread input to the front of `in_buffer_` and fills the rest
+  // from `input_`. Returns false at the end of the input.
+  bool Refill();
+
   std::unique_ptr<IReadable> input_;
   std::unique_ptr<ZSTD_DStream, std::size_t (*)(ZSTD_DStream*)> z_dstream_;
   std::size_t read_suggestion_;
+  // Fixed-size, consumed in place and only refilled once empty
   std::vector<std::uint8_t> in_buffer_;
   ZSTD_inBuffer z_in_buffer_;
+  // Only set when decompressing with dictionaries
+  std::unique_ptr<ZstdFrameDictionaries> dictionaries_;
+  bool is_frame_start_{true};
+  bool is_input_end_{};
+  // Set when the last output buffer was filled, so Zstd may have more
+  bool is_output_pending_{};
+};
+
+// The location of a frame in a file written in the Zstd seekable format.
+struct ZstdSeekableFrame {
+  std::uint64_t compressed_offset;
+  std::uint64_t decompressed_offset;
+  std::uint32_t compressed_size;
+  std::uint32_t decompressed_size;
+};
+
+// Parses the seek table at the end of a file written in the Zstd seekable
+// format.
+std::vector<ZstdSeekableFrame> ReadZstdSeekTable(const std::string& file_path);
+
+// Reads a file written in the Zstd seekable format, allowing decompression to
+// start from any offset in the decompressed data by only decompressing the
+// frame containing it.
+class ZstdSeekableDecodeStream : public IReadable {
+ public:
+  explicit ZstdSeekableDecodeStream(const std::string& file_path);
+  ZstdSeekableDecodeStream(const std::string& file_path,
+                           const ZstdDictionarySet* dictionaries);
+  // The decompression stream reads from `file_`, so the object can't move
+  ZstdSeekableDecodeStream(const ZstdSeekableDecodeStream&) = delete;
+  ZstdSeekableDecodeStream& operator=(const ZstdSeekableDecodeStream&) = delete;
+  ZstdSeekableDecodeStream(ZstdSeekableDecodeStream&&) = delete;
+  ZstdSeekableDecodeStream& operator=(ZstdSeekableDecodeStream&&) = delete;
+
+  const std::vector<ZstdSeekableFrame>& Frames() const { return frames_; }
+  std::uint64_t DecompressedSize() const;
+  // Positions the stream so the next read begins at `decompressed_offset`.
+  void Seek(std::uint64_t decompressed_offset);
+  // See `ZstdDecodeStream::SetWindowLogMax`.
+  void SetWindowLogMax(int window_log_max);
+
+  // Read exactly `length` bytes into `buffer`.
+  void ReadExact(std::uint8_t* buffer, std::size_t length) override;
+  // Read at most `length` bytes. Returns the number of bytes read. Will only
+  // return 0 if the end of the stream is reached.
+  std::size_t ReadSome(std::uint8_t* buffer, std::size_t max_length) override;
+
+ private:
+  // Opened once and repositioned by every seek
+  InFileStream file_;
+  const ZstdDictionarySet* dictionaries_;
+  std::vector<ZstdSeekableFrame> frames_;
+  std::unique_ptr<ZstdDecodeStream> stream_;
 };
 
 class ZstdCompressStream : public IWritable {
  public:
   explicit ZstdCompressStream(IWritable* output);
   ZstdCompressStream(ILogReceiver* log_receiver, IWritable* output);
+  // Writes the Zstd seekable format: a new independent frame is started once
+  // at least `frame_size` bytes have been written to the current one, and a
+  // seek table is appended on destruction. Frames only end between calls to
+  // `WriteAll`, so with `DbnEncoder` every frame holds whole records.
+  ZstdCompressStream(ILogReceiver* log_receiver, IWritable* output,
+                     std::size_t frame_size);
+  ZstdCompressStream(ILogReceiver* log_receiver, IWritable* output,
+                     const ZstdCompressOptions& options);
+  // A `frame_size` of 0 disables the seekable format.
+  ZstdCompressStream(ILogReceiver* log_receiver, IWritable* output,
+                     std::size_t frame_size,
+                     const ZstdCompressOptions& options);
   ZstdCompressStream(const ZstdCompressStream&) = delete;
   ZstdCompressStream& operator=(const ZstdCompressStream&) = delete;
   ZstdCompressStream(ZstdCompressStream&&) = delete;
@@ -46,6 +164,13 @@ class ZstdCompressStream : public IWritable {
   void WriteAll(const std::uint8_t* buffer, std::size_t length) override;
 
  private:
+  void SetParameter(ZSTD_cParameter param, int value, const char* param_name);
+  // Compresses until `z_in_buffer_` has been consumed and, with `ZSTD_e_end`,
+  // the frame is complete, forwarding all output.
+  void Flush(ZSTD_EndDirective directive);
+  void EndFrame();
+  void WriteSeekTable();
+
   ILogReceiver* log_receiver_;
   IWritable* output_;
   std::unique_ptr<ZSTD_CStream, std::size_t (*)(ZSTD_CStream*)> z_cstream_;
@@ -53,6 +178,11 @@ class ZstdCompressStream : public IWritable {
   ZSTD_inBuffer z_in_buffer_;
   std::size_t in_size_;
   std::vector<std::uint8_t> out_buffer_;
+  // 0 when not writing the seekable format
+  std::size_t frame_size_{};
+  std::size_t frame_in_size_{};
+  std::size_t frame_out_size_{};
+  std::vector<ZstdSeekableFrame> frames_;
 };
 }  // namespace detail
 }  // namespace databento
@@ -18,11 +18,51 @@ class InFileStream : public IReadable {
   // Read at most `length` bytes. Returns the number of bytes read. Will only
   // return 0 if the end of the stream is reached.
   std::size_t ReadSome(std::uint8_t* buffer, std::size_t max_length) override;
+  // Moves the read position to `offset` bytes from the start of the file.
+  void Seek(std::uint64_t offset);
 
  private:
   std::ifstream stream_;
 };
 
+// A read-only memory mapping of a file. In addition to the copying `IReadable`
+// interface, it allows the bytes to be read in place, which `DbnDecoder` uses
+// to avoid copying uncompressed records. The mapping is advised for sequential
+// access.
+class MappedFileStream : public IReadable {
+ public:
+  explicit MappedFileStream(const std::string& file_path);
+  MappedFileStream(const MappedFileStream&) = delete;
+  MappedFileStream& operator=(const MappedFileStream&) = delete;
+  MappedFileStream(MappedFileStream&& other) noexcept;
+  MappedFileStream& operator=(MappedFileStream&& rhs) noexcept;
+  ~MappedFileStream() override;
+
+  // Read exactly `length` bytes into `buffer`.
+  void ReadExact(std::uint8_t* buffer, std::size_t length) override;
+  // Read at most `length` bytes. Returns the number of bytes read. Will only
+  // return 0 if the end of the stream is reached.
+  std::size_t ReadSome(std::uint8_t* buffer, std::size_t max_length) override;
+
+  // Returns a pointer to the unread bytes. The pointer is valid for the
+  // lifetime of the stream.
+  std::uint8_t* Peek() const { return data_ + pos_; }
+  // Returns the number of unread bytes.
+  std::size_t RemainingSize() const { return size_ - pos_; }
+  // Marks `length` bytes as read without copying them.
+  void Consume(std::size_t length);
+  // Moves the read position to `offset` bytes from the start of the file.
+  void Seek(std::size_t offset);
+  std::size_t Size() const { return size_; }
+
+ private:
+  void Unmap();
+
+  std::uint8_t* data_{};
+  std::size_t size_{};
+  std::size_t pos_{};
+};
+
 class OutFileStream : public IWritable {
  public:
   explicit OutFileStream(const std::string& file_path);
@@ -1,12 +1,17 @@
 #pragma once
 
+#include <charconv>  // to_chars_result
+#include <cstddef>   // size_t
 #include <cstdint>
-#include <sstream>
+#include <ostream>
 #include <string>
 
 #include "databento/constants.hpp"
 
 namespace databento {
+// The maximum number of characters written by `ToChars` for a `FixPx`.
+constexpr std::size_t kMaxFixPxLen = 21;
+
 // A fixed-precision price.
 struct FixPx {
   bool IsUndefined() const { return val == databento::kUndefPrice; }
@@ -16,10 +21,13 @@ struct FixPx {
 
 std::ostream& operator<<(std::ostream& stream, FixPx fix_px);
 
+// Formats a fixed-precision price as a decimal with 9 fractional digits, or
+// "kUndefPrice", into [first, last) like `std::to_chars`. On success, returns
+// the end of the written characters. Otherwise returns `last` with
+// `std::errc::value_too_large` and the contents of the range are unspecified.
+// Never fails when the range is at least `kMaxFixPxLen` characters.
+std::to_chars_result ToChars(char* first, char* last, FixPx fix_px);
+
 // Convert a fixed-precision price to a formatted string.
-inline std::string PxToString(std::int64_t px) {
-  std::ostringstream ss;
-  ss << FixPx{px};
-  return ss.str();
-}
+std::string PxToString(std::int64_t px);
 }  // namespace databento
@@ -1,18 +1,25 @@
 #pragma once
 
 #include <cstdint>
-#include <map>  // multimap
+#include <functional>  // function
+#include <map>         // multimap
+#include <memory>      // unique_ptr
 #include <string>
+#include <utility>  // forward, move
 #include <vector>
 
 #include "databento/batch.hpp"     // BatchJob
 #include "databento/datetime.hpp"  // DateRange, DateTimeRange, UnixNanos
+#include "databento/dbn_decoder.hpp"
 #include "databento/dbn_file_store.hpp"
+#include "databento/dbn_stream_decoder.hpp"
 #include "databento/detail/http_client.hpp"  // HttpClient
 #include "databento/enums.hpp"  // BatchState, Delivery, DurationInterval, Schema, SType
 #include "databento/metadata.hpp"  // DatasetConditionDetail, DatasetRange, FieldDetail, PublisherDetail, UnitPricesForMode
 #include "databento/symbology.hpp"  // SymbologyResolution
-#include "databento/timeseries.hpp"  // KeepGoing, MetadataCallback, RecordCallback
+#include "databento/timeseries.hpp"  // KeepGoing, MetadataCallback, RecordBatchCallback, TimeseriesParallelOptions, TimeseriesShardOptions
+#include "databento/timeseries_cache.hpp"
+#include "databento/zstd_compress_options.hpp"
 
 namespace databento {
 class ILogReceiver;
@@ -162,39 +169,185 @@ class Historical {
 
   // Stream historical market data to `record_callback`. This method will
   // return only after all data has been returned or `record_callback` returns
-  // `KeepGoing::Stop`.
+  // `KeepGoing::Stop`. `record_callback` can be any callable with the
+  // signature of `RecordCallback` and is called directly rather than through a
+  // `std::function`.
   //
-  // NOTE: This method spawns a thread, however, the callbacks will be called
-  // from the current thread.
+  // NOTE: The callbacks are called from the current thread. Requests with a
+  // `limit` of at most 10,000 records are decoded as they're received. Larger
+  // and unbounded requests are received on a separate thread that buffers up
+  // to 64 MiB ahead of the callbacks.
+  template <typename F, detail::EnableIfRecordCallback<F> = 0>
   void TimeseriesGetRange(const std::string& dataset,
                           const DateTimeRange<UnixNanos>& datetime_range,
                           const std::vector<std::string>& symbols,
-                          Schema schema, const RecordCallback& record_callback);
+                          Schema schema, F&& record_callback) {
+    this->TimeseriesGetRange(
+        TimeseriesGetRangeParams(dataset, datetime_range, symbols, schema),
+        MetadataCallback{}, record_callback);
+  }
+  template <typename F, detail::EnableIfRecordCallback<F> = 0>
   void TimeseriesGetRange(const std::string& dataset,
                           const DateTimeRange<std::string>& datetime_range,
                           const std::vector<std::string>& symbols,
-                          Schema schema, const RecordCallback& record_callback);
+                          Schema schema, F&& record_callback) {
+    this->TimeseriesGetRange(
+        TimeseriesGetRangeParams(dataset, datetime_range, symbols, schema),
+        MetadataCallback{}, record_callback);
+  }
+  // Stream historical market data of type `T` to `record_callback`, which
+  // takes a `const T&` and returns `KeepGoing`, e.g.
+  // `TimeseriesGetRange<MboMsg>(...)`. Records of other types are skipped.
+  template <typename T, typename F>
+  void TimeseriesGetRange(const std::string& dataset,
+                          const DateTimeRange<UnixNanos>& datetime_range,
+                          const std::vector<std::string>& symbols,
+                          Schema schema, F&& record_callback) {
+    this->TimeseriesGetRange(
+        dataset, datetime_range, symbols, schema,
+        detail::MakeTypedRecordCallback<T>(std::forward<F>(record_callback)));
+  }
+  template <typename T, typename F>
+  void TimeseriesGetRange(const std::string& dataset,
+                          const DateTimeRange<std::string>& datetime_range,
+                          const std::vector<std::string>& symbols,
+                          Schema schema, F&& record_callback) {
+    this->TimeseriesGetRange(
+        dataset, datetime_range, symbols, schema,
+        detail::MakeTypedRecordCallback<T>(std::forward<F>(record_callback)));
+  }
   // Stream historical market data to `record_callback`. `metadata_callback`
   // will be called exactly once, before any calls to `record_callback`.
   // This method will return only after all data has been returned or
   // `record_callback` returns `KeepGoing::Stop`.
   //
-  // NOTE: This method spawns a thread, however, the callbacks will be called
-  // from the current thread.
+  // NOTE: The callbacks are called from the current thread. Requests with a
+  // `limit` of at most 10,000 records are decoded as they're received. Larger
+  // and unbounded requests are received on a separate thread that buffers up
+  // to 64 MiB ahead of the callbacks.
+  template <typename F, detail::EnableIfRecordCallback<F> = 0>
+  void TimeseriesGetRange(const std::string& dataset,
+                          const DateTimeRange<UnixNanos>& datetime_range,
+                          const std::vector<std::string>& symbols,
+                          Schema schema, SType stype_in, SType stype_out,
+                          std::uint64_t limit,
+                          const MetadataCallback& metadata_callback,
+                          F&& record_callback) {
+    this->TimeseriesGetRange(
+        TimeseriesGetRangeParams(dataset, datetime_range, symbols, schema,
+                                 stype_in, stype_out, limit),
+        metadata_callback, record_callback);
+  }
+  template <typename F, detail::EnableIfRecordCallback<F> = 0>
+  void TimeseriesGetRange(const std::string& dataset,
+                          const DateTimeRange<std::string>& datetime_range,
+                          const std::vector<std::string>& symbols,
+                          Schema schema, SType stype_in, SType stype_out,
+                          std::uint64_t limit,
+                          const MetadataCallback& metadata_callback,
+                          F&& record_callback) {
+    this->TimeseriesGetRange(
+        TimeseriesGetRangeParams(dataset, datetime_range, symbols, schema,
+                                 stype_in, stype_out, limit),
+        metadata_callback, record_callback);
+  }
+  // Stream historical market data to `record_batch_callback` in batches of up
+  // to `kMaxRecordBatchSize` records, containing every record already received
+  // and decoded.
+  //
+  // NOTE: The callbacks are called from the current thread. Requests with a
+  // `limit` of at most 10,000 records are decoded as they're received. Larger
+  // and unbounded requests are received on a separate thread that buffers up
+  // to 64 MiB ahead of the callbacks.
+  void TimeseriesGetRange(const std::string& dataset,
+                          const DateTimeRange<UnixNanos>& datetime_range,
+                          const std::vector<std::string>& symbols,
+                          Schema schema,
+                          const RecordBatchCallback& record_batch_callback);
+  void TimeseriesGetRange(const std::string& dataset,
+                          const DateTimeRange<std::string>& datetime_range,
+                          const std::vector<std::string>& symbols,
+                          Schema schema,
+                          const RecordBatchCallback& record_batch_callback);
   void TimeseriesGetRange(const std::string& dataset,
                           const DateTimeRange<UnixNanos>& datetime_range,
                           const std::vector<std::string>& symbols,
                           Schema schema, SType stype_in, SType stype_out,
                           std::uint64_t limit,
                           const MetadataCallback& metadata_callback,
-                          const RecordCallback& record_callback);
+                          const RecordBatchCallback& record_batch_callback);
   void TimeseriesGetRange(const std::string& dataset,
                           const DateTimeRange<std::string>& datetime_range,
                           const std::vector<std::string>& symbols,
                           Schema schema, SType stype_in, SType stype_out,
                           std::uint64_t limit,
                           const MetadataCallback& metadata_callback,
-                          const RecordCallback& record_callback);
+                          const RecordBatchCallback& record_batch_callback);
+  // Splits `datetime_range` into `options.slice_count` consecutive slices that
+  // are requested concurrently, each on its own connection, and passes their
+  // records to `record_callback` in time order. `metadata_callback` is called
+  // once with the metadata of every slice combined with `Metadata::Merge`.
+  // `datetime_range.end` must be set. This method will return only after all
+  // data has been returned or `record_callback` returns `KeepGoing::Stop`.
+  //
+  // NOTE: This method spawns a thread per slice, however, the callbacks will be
+  // called from the current thread.
+  void TimeseriesGetRangeParallel(
+      const std::string& dataset,
+      const DateTimeRange<UnixNanos>& datetime_range,
+      const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+      SType stype_out, const TimeseriesParallelOptions& options,
+      const MetadataCallback& metadata_callback,
+      const RecordCallback& record_callback);
+  // `datetime_range.start` and `datetime_range.end` must be UNIX nanoseconds
+  // or ISO 8601 so the range can be sliced.
+  void TimeseriesGetRangeParallel(
+      const std::string& dataset,
+      const DateTimeRange<std::string>& datetime_range,
+      const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+      SType stype_out, const TimeseriesParallelOptions& options,
+      const MetadataCallback& metadata_callback,
+      const RecordCallback& record_callback);
+  // Splits `symbols` into `options.shard_count` shards that are requested
+  // concurrently, each on its own connection and decoder, and merges the
+  // records of the shards by index timestamp so `record_callback` receives
+  // them in the same order as from a single request. `metadata_callback` is
+  // called once with the metadata of every shard combined with
+  // `Metadata::Merge`. This method will return only after all data has been
+  // returned or `record_callback` returns `KeepGoing::Stop`.
+  //
+  // NOTE: This method spawns a thread per shard, however, the callbacks will be
+  // called from the current thread.
+  void TimeseriesGetRangeSharded(
+      const std::string& dataset,
+      const DateTimeRange<UnixNanos>& datetime_range,
+      const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+      SType stype_out, const TimeseriesShardOptions& options,
+      const MetadataCallback& metadata_callback,
+      const RecordCallback& record_callback);
+  void TimeseriesGetRangeSharded(
+      const std::string& dataset,
+      const DateTimeRange<std::string>& datetime_range,
+      const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+      SType stype_out, const TimeseriesShardOptions& options,
+      const MetadataCallback& metadata_callback,
+      const RecordCallback& record_callback);
+  // Like `TimeseriesGetRange`, but replays the parts of `datetime_range`
+  // already in `cache` from disk and only requests the rest, adding each
+  // response to `cache`. `metadata_callback` is called once with the metadata
+  // of every part combined with `Metadata::Merge`. The end of `datetime_range`
+  // must be set.
+  //
+  // Data may still be added after the end of the dataset's available range,
+  // so uncached parts of `datetime_range` past it aren't requested or cached
+  // and the end of the metadata is truncated to it. Throws
+  // `InvalidArgumentError` if nothing before it remains.
+  void TimeseriesGetRangeCached(
+      const TimeseriesCache& cache, const std::string& dataset,
+      const DateTimeRange<UnixNanos>& datetime_range,
+      const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+      SType stype_out, const MetadataCallback& metadata_callback,
+      const RecordCallback& record_callback);
   // Stream historical market data to a file at `path`. Returns a `DbnFileStore`
   // object for replaying the data in `file_path`.
   //
@@ -219,9 +372,26 @@ class Historical {
       const DateTimeRange<std::string>& datetime_range,
       const std::vector<std::string>& symbols, Schema schema, SType stype_in,
       SType stype_out, std::uint64_t limit, const std::string& file_path);
+  // Requests uncompressed DBN and compresses it locally with `compression`,
+  // e.g. to use a higher level or long distance matching for archival, or to
+  // move compression to background threads.
+  DbnFileStore TimeseriesGetRangeToFile(
+      const std::string& dataset,
+      const DateTimeRange<UnixNanos>& datetime_range,
+      const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+      SType stype_out, std::uint64_t limit, const std::string& file_path,
+      const ZstdCompressOptions& compression);
+  DbnFileStore TimeseriesGetRangeToFile(
+      const std::string& dataset,
+      const DateTimeRange<std::string>& datetime_range,
+      const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+      SType stype_out, std::uint64_t limit, const std::string& file_path,
+      const ZstdCompressOptions& compression);
 
  private:
   using HttplibParams = std::multimap<std::string, std::string>;
+  using DecodersCallback =
+      std::function<void(const std::vector<std::unique_ptr<DbnDecoder>>&)>;
 
   BatchJob BatchSubmitJob(const HttplibParams& params);
   void StreamToFile(const std::string& url_path, const HttplibParams& params,
@@ -233,15 +403,101 @@ class Historical {
   std::uint64_t MetadataGetRecordCount(const HttplibParams& params);
   std::uint64_t MetadataGetBillableSize(const HttplibParams& params);
   double MetadataGetCost(const HttplibParams& params);
+  static HttplibParams TimeseriesGetRangeParams(
+      const std::string& dataset,
+      const DateTimeRange<UnixNanos>& datetime_range,
+      const std::vector<std::string>& symbols, Schema schema);
+  static HttplibParams TimeseriesGetRangeParams(
+      const std::string& dataset,
+      const DateTimeRange<std::string>& datetime_range,
+      const std::vector<std::string>& symbols, Schema schema);
+  static HttplibParams TimeseriesGetRangeParams(
+      const std::string& dataset,
+      const DateTimeRange<UnixNanos>& datetime_range,
+      const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+      SType stype_out, std::uint64_t limit);
+  static HttplibParams TimeseriesGetRangeParams(
+      const std::string& dataset,
+      const DateTimeRange<std::string>& datetime_range,
+      const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+      SType stype_out, std::uint64_t limit);
+  // Feeds the response of a timeseries.get_range request to a
+  // `DbnStreamDecoder` as it's received, passing the metadata to
+  // `metadata_callback` and then calling `decode_records` after each chunk to
+  // take the records decoded from it. The request is cancelled once
+  // `decode_records` returns `KeepGoing::Stop`.
+  void StreamTimeseries(
+      const HttplibParams& params, const MetadataCallback& metadata_callback,
+      const std::function<KeepGoing(DbnStreamDecoder&)>& decode_records);
+  // Returns whether a request is small enough to decode on the thread
+  // receiving it, i.e. it has a small `limit`.
+  static bool IsInlineDecodable(const HttplibParams& params);
+  // Passes each chunk of the response to `consume` as it's received. The
+  // request is cancelled once `consume` returns false.
+  using ChunkCallback = std::function<bool(const std::uint8_t*, std::size_t)>;
+  void ReceiveTimeseriesInline(const HttplibParams& params,
+                               const ChunkCallback& consume);
+  // Receives the response on a separate thread, buffering it so a slow
+  // `consume` doesn't stall the connection, and passes it to `consume` on the
+  // current thread. The request is cancelled once `consume` returns false.
+  void ReceiveTimeseriesThreaded(const HttplibParams& params,
+                                 const ChunkCallback& consume);
+  template <typename F>
   void TimeseriesGetRange(const HttplibParams& params,
                           const MetadataCallback& metadata_callback,
-                          const RecordCallback& record_callback);
+                          F& record_callback) {
+    StreamTimeseries(params, metadata_callback,
+                     [&record_callback](DbnStreamDecoder& decoder) {
+                       const Record* record;
+                       while ((record = decoder.DecodeRecord()) != nullptr) {
+                         if (record_callback(*record) == KeepGoing::Stop) {
+                           return KeepGoing::Stop;
+                         }
+                       }
+                       return KeepGoing::Continue;
+                     });
+  }
+  void TimeseriesGetRangeBatches(
+      const HttplibParams& params, const MetadataCallback& metadata_callback,
+      const RecordBatchCallback& record_batch_callback);
+  // Returns the boundaries of the slices of `datetime_range` for
+  // `TimeseriesGetRangeParallel`, from its start to its end.
+  std::vector<UnixNanos> TimeseriesSliceBoundaries(
+      const std::string& dataset,
+      const DateTimeRange<UnixNanos>& datetime_range,
+      const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+      const TimeseriesParallelOptions& options);
+  // Posts each of `params_list` to the metadata `path` on up to
+  // `max_connection_count` connections and returns the sizes in the same
+  // order.
+  std::vector<std::uint64_t> MetadataGetSizesConcurrently(
+      const std::string& path, const std::string& endpoint,
+      const std::vector<HttplibParams>& params_list,
+      std::size_t max_connection_count);
+  // Requests each of `params_list` concurrently and passes a decoder for each
+  // response, in the same order, to `consume` on the current thread.
+  void StreamTimeseriesConcurrently(
+      const std::vector<HttplibParams>& params_list,
+      std::size_t max_buffered_size, const DecodersCallback& consume);
+  // Requests each of `params_list` concurrently and merges the records of the
+  // responses by index timestamp.
+  void TimeseriesGetRangeMerged(const std::vector<HttplibParams>& params_list,
+                                std::size_t max_buffered_size,
+                                const MetadataCallback& metadata_callback,
+                                const RecordCallback& record_callback);
+  // Creates a new connection to the gateway.
+  std::unique_ptr<detail::HttpClient> MakeClient() const;
   DbnFileStore TimeseriesGetRangeToFile(const HttplibParams& params,
                                         const std::string& file_path);
+  DbnFileStore TimeseriesGetRangeToFile(HttplibParams params,
+                                        const std::string& file_path,
+                                        const ZstdCompressOptions& compression);
 
   ILogReceiver* log_receiver_;
   const std::string key_;
   const std::string gateway_;
+  // 0 when the default port for `gateway_` is used
+  const std::uint16_t port_;
   detail::HttpClient client_;
 };
 
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint32_t, uint64_t
+#include <map>
+#include <string>
+#include <vector>
+
+#include "databento/record.hpp"
+
+namespace databento {
+// An index of which blocks of a DBN stream contain records for each
+// instrument. Records are grouped into blocks of about `block_size` bytes of
+// the decompressed stream and each instrument ID maps to a posting list of the
+// blocks containing it. The index is saved as a sidecar file and used by
+// `DbnFileStore::SelectInstruments` to skip blocks without any of the requested
+// instruments.
+class InstrumentIndex {
+ public:
+  struct Block {
+    // The offset of the first record of the block in the decompressed stream.
+    std::uint64_t offset;
+    // The offset following the last record of the block.
+    std::uint64_t end_offset;
+  };
+
+  explicit InstrumentIndex(std::uint64_t block_size);
+  // Builds an index in a single pass over the records in an existing DBN file.
+  static InstrumentIndex Build(const std::string& dbn_file_path,
+                               std::uint64_t block_size);
+  static InstrumentIndex ReadFromFile(const std::string& index_file_path);
+
+  void WriteToFile(const std::string& index_file_path) const;
+  // Adds a record located at `offset` in the decompressed stream. Records must
+  // be added in the order they appear in the stream.
+  void Add(const Record& record, std::uint64_t offset);
+  // Returns the indices of the blocks containing any of `instrument_ids` in
+  // ascending order.
+  std::vector<std::size_t> FindBlocks(
+      const std::vector<std::uint32_t>& instrument_ids) const;
+
+  std::uint64_t BlockSize() const { return block_size_; }
+  const std::vector<Block>& Blocks() const { return blocks_; }
+  const std::map<std::uint32_t, std::vector<std::uint32_t>>& PostingLists()
+      const {
+    return posting_lists_;
+  }
+
+ private:
+  std::uint64_t block_size_;
+  std::vector<Block> blocks_;
+  // Instrument ID to the ascending indices of the blocks containing it
+  std::map<std::uint32_t, std::vector<std::uint32_t>> posting_lists_;
+};
+
+bool operator==(const InstrumentIndex::Block& lhs,
+                const InstrumentIndex::Block& rhs);
+inline bool operator!=(const InstrumentIndex::Block& lhs,
+                       const InstrumentIndex::Block& rhs) {
+  return !(lhs == rhs);
+}
+}  // namespace databento
@@ -75,6 +75,13 @@ class LiveBlocking {
   //
   // This method should only be called after `Start`.
   const Record* NextRecord(std::chrono::milliseconds timeout);
+  // Block on getting the next records, returning every complete record already
+  // received at once. The returned records are valid until this method or
+  // `NextRecord` is called again. Will return an empty batch if the `timeout`
+  // is reached.
+  //
+  // This method should only be called after `Start`.
+  const std::vector<Record>& NextRecords(std::chrono::milliseconds timeout);
   // Stops the session with the gateway. Once stopped, the session cannot be
   // restarted.
   void Stop();
@@ -90,6 +97,10 @@ class LiveBlocking {
   std::uint64_t DecodeAuthResp();
   void Subscribe(const std::string& sub_msg,
                  const std::vector<std::string>& symbols, bool use_snapshot);
+  // Returns false if the `timeout` is reached before a complete record has
+  // been buffered.
+  bool BufferRecord(std::chrono::milliseconds timeout);
+  void UpgradeBatch();
   detail::TcpClient::Result FillBuffer(std::chrono::milliseconds timeout);
   RecordHeader* BufferRecordHeader();
 
@@ -114,5 +125,12 @@ class LiveBlocking {
       RecordHeader) std::array<std::uint8_t, kMaxRecordLen> compat_buffer_{};
   std::uint64_t session_id_;
   Record current_record_{nullptr};
+  struct alignas(RecordHeader) CompatBuffer {
+    std::array<std::uint8_t, kMaxRecordLen> data;
+  };
+  std::vector<Record> record_batch_;
+  // Indices into `record_batch_` of upgraded records
+  std::vector<std::size_t> upgraded_idxs_;
+  std::vector<CompatBuffer> batch_compat_buffers_;
 };
 }  // namespace databento
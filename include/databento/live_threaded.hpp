@@ -1,16 +1,19 @@
 #pragma once
 
 #include <chrono>
-#include <functional>  // function
-#include <memory>      // unique_ptr
+#include <exception>
+#include <functional>   // function
+#include <memory>       // unique_ptr
 #include <string>
-#include <utility>  // pair
+#include <type_traits>  // decay_t
+#include <utility>      // forward, move, pair
 #include <vector>
 
 #include "databento/datetime.hpp"              // UnixNanos
 #include "databento/detail/scoped_thread.hpp"  // ScopedThread
 #include "databento/enums.hpp"                 // Schema, SType
-#include "databento/timeseries.hpp"  // MetadataCallback, RecordCallback
+#include "databento/record.hpp"                // Record
+#include "databento/timeseries.hpp"  // KeepGoing, MetadataCallback, RecordBatchCallback
 
 namespace databento {
 class ILogReceiver;
@@ -78,11 +81,55 @@ class LiveThreaded {
   // `record_callback`. `record_callback` will be called for records from all
   // subscriptions.
   //
-  // This method should only be called once per instance.
-  void Start(RecordCallback record_callback);
+  // This method should only be called once per instance. `record_callback` can
+  // be any callable with the signature of `RecordCallback` and is called
+  // directly rather than through a `std::function`.
+  template <typename F, detail::EnableIfRecordCallback<F> = 0>
+  void Start(F&& record_callback) {
+    Start({}, std::forward<F>(record_callback), {});
+  }
+  template <typename F, detail::EnableIfRecordCallback<F> = 0>
+  void Start(MetadataCallback metadata_callback, F&& record_callback) {
+    Start(std::move(metadata_callback), std::forward<F>(record_callback), {});
+  }
+  template <typename F, detail::EnableIfRecordCallback<F> = 0>
+  void Start(MetadataCallback metadata_callback, F&& record_callback,
+             ExceptionCallback exception_callback) {
+    if (!CanStart()) {
+      return;
+    }
+    // Safe to pass raw pointer because `thread_` cannot outlive `impl_`
+    thread_ = detail::ScopedThread{
+        &LiveThreaded::ProcessingThread<std::decay_t<F>>, impl_.get(),
+        std::move(metadata_callback), std::forward<F>(record_callback),
+        std::move(exception_callback)};
+  }
+  // Only calls `record_callback` with records of type `T`, e.g.
+  // `Start<MboMsg>(callback)`, where `record_callback` takes a `const T&` and
+  // returns `KeepGoing`.
+  template <typename T, typename F>
+  void Start(F&& record_callback) {
+    Start<T>({}, std::forward<F>(record_callback), {});
+  }
+  template <typename T, typename F>
+  void Start(MetadataCallback metadata_callback, F&& record_callback) {
+    Start<T>(std::move(metadata_callback), std::forward<F>(record_callback),
+             {});
+  }
+  template <typename T, typename F>
+  void Start(MetadataCallback metadata_callback, F&& record_callback,
+             ExceptionCallback exception_callback) {
+    Start(std::move(metadata_callback),
+          detail::MakeTypedRecordCallback<T>(std::forward<F>(record_callback)),
+          std::move(exception_callback));
+  }
+  // Calls `record_batch_callback` with every complete record already received
+  // at once instead of once per record.
+  void Start(const RecordBatchCallback& record_batch_callback);
   void Start(MetadataCallback metadata_callback,
-             RecordCallback record_callback);
-  void Start(MetadataCallback metadata_callback, RecordCallback record_callback,
+             RecordBatchCallback record_batch_callback);
+  void Start(MetadataCallback metadata_callback,
+             RecordBatchCallback record_batch_callback,
              ExceptionCallback exception_callback);
   // Closes the current connection, and attempts to reconnect to the gateway.
   void Reconnect();
@@ -94,9 +141,60 @@ class LiveThreaded {
  private:
   struct Impl;
 
+  template <typename F>
   static void ProcessingThread(Impl* impl, MetadataCallback&& metadata_callback,
-                               RecordCallback&& record_callback,
-                               ExceptionCallback&& exception_callback);
+                               F&& record_callback,
+                               ExceptionCallback&& exception_callback) {
+    // Thread safety: non-const calls to `blocking` are only performed from
+    // this thread
+    RegisterProcessingThread(impl);
+    const auto metadata_cb{std::move(metadata_callback)};
+    F record_cb{std::move(record_callback)};
+    const auto exception_cb{std::move(exception_callback)};
+    // Start loop
+    while (StartSession(impl, metadata_cb, exception_cb)) {
+      // NextRecord loop
+      while (IsRunning(impl)) {
+        try {
+          const Record* rec = NextRecord(impl);
+          if (rec) {
+            if (record_cb(*rec) == KeepGoing::Stop) {
+              StopSession(impl);
+              return;
+            }
+          }  // else timeout
+        } catch (const std::exception& exc) {
+          if (ExceptionHandler(impl, exception_cb, exc,
+                               "LiveThreaded::ProcessingThread",
+                               "Caught exception reading next record: ") ==
+              ExceptionAction::Restart) {
+            break;  // break out of NextRecord loop, to restart Start loop
+          } else {
+            NotifyOfStop(impl);
+            return;
+          }
+        }
+      }
+    }
+  }
+  static void BatchProcessingThread(Impl* impl,
+                                    MetadataCallback&& metadata_callback,
+                                    RecordBatchCallback&& record_batch_callback,
+                                    ExceptionCallback&& exception_callback);
+  // Returns false and logs a warning if called from the callback thread, where
+  // starting would cause a deadlock.
+  bool CanStart() const;
+  static void RegisterProcessingThread(Impl* impl);
+  static bool IsRunning(const Impl* impl);
+  // Starts a session, restarting after exceptions as directed by
+  // `exception_callback`. Returns false if the thread should stop.
+  static bool StartSession(Impl* impl, const MetadataCallback& metadata_callback,
+                           const ExceptionCallback& exception_callback);
+  // Returns `nullptr` on timeout.
+  static const Record* NextRecord(Impl* impl);
+  // Stops the session and notifies any threads blocking for stop.
+  static void StopSession(Impl* impl);
+  static void NotifyOfStop(Impl* impl);
   static ExceptionAction ExceptionHandler(
       Impl* impl, const ExceptionCallback& exception_callback,
       const std::exception& exc, const char* pretty_function_name,
@@ -102,10 +102,29 @@ class Record {
   }
 
   std::size_t Size() const;
+  // The primary timestamp of the record, `ts_recv` if the record has it,
+  // otherwise `ts_event`. DBN data is sorted by this timestamp.
+  UnixNanos IndexTs() const;
   static std::size_t SizeOfSchema(Schema schema);
   static ::databento::RType RTypeFromSchema(Schema schema);
 
+  // Calls `visitor` with the record cast to its concrete type, switching once
+  // on the rtype. Record types with multiple DBN versions such as
+  // `InstrumentDefMsg` are distinguished by their size, so DBN version 1
+  // records are passed as e.g. `v1::InstrumentDefMsg`. Records of a type the
+  // visitor doesn't accept, including unknown rtypes, are passed as
+  // `const Record&` if it accepts that and are otherwise skipped. Use with
+  // `Overloaded` to combine handlers for multiple types. Defined in
+  // `databento/record_visit.hpp`.
+  template <typename F>
+  void Visit(F&& visitor) const;
+
  private:
+  template <typename T, typename F>
+  void VisitAs(F& visitor) const;
+  template <typename F>
+  void VisitRecord(F& visitor) const;
+
   RecordHeader* record_;
 };
 
@@ -784,6 +803,7 @@ std::string ToString(const SymbolMappingMsg& symbol_mapping_msg);
 std::ostream& operator<<(std::ostream& stream,
                          const SymbolMappingMsg& symbol_mapping_msg);
 
-// The length in bytes of the largest record type.
+// The length in bytes of the largest record type, checked against the
+// definition of `v3::InstrumentDefMsg`.
 static constexpr std::size_t kMaxRecordLen = 520 + 8;
 }  // namespace databento
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <algorithm>  // binary_search
+#include <array>
+#include <cstdint>  // uint8_t, uint32_t
+#include <vector>
+
+#include "databento/datetime.hpp"  // UnixNanos
+#include "databento/enums.hpp"     // RType
+#include "databento/record.hpp"    // RecordHeader
+
+namespace databento {
+// Selects records using only the fields of their `RecordHeader`, allowing
+// `DbnDecoder` to reject records before upgrading them or passing them on.
+class RecordFilter {
+ public:
+  // Matches every record.
+  RecordFilter() = default;
+  // Matches records with one of `rtypes`, one of `instrument_ids`, and a
+  // `ts_event` in the range [`start`, `end`). An empty `rtypes` or
+  // `instrument_ids` matches any value.
+  RecordFilter(const std::vector<RType>& rtypes,
+               std::vector<std::uint32_t> instrument_ids, UnixNanos start,
+               UnixNanos end);
+
+  bool MatchesAll() const { return matches_all_; }
+  bool Matches(const RecordHeader& header) const {
+    return matches_all_ ||
+           (rtypes_[static_cast<std::uint8_t>(header.rtype)] &&
+            header.ts_event >= start_ && header.ts_event < end_ &&
+            (instrument_ids_.empty() ||
+             std::binary_search(instrument_ids_.cbegin(),
+                                instrument_ids_.cend(),
+                                header.instrument_id)));
+  }
+
+ private:
+  bool matches_all_{true};
+  // Indexed by rtype
+  std::array<bool, 256> rtypes_{};
+  // Sorted
+  std::vector<std::uint32_t> instrument_ids_;
+  UnixNanos start_{};
+  UnixNanos end_{UnixNanos::max()};
+};
+}  // namespace databento
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <type_traits>  // is_invocable
+
+#include "databento/record.hpp"
+#include "databento/v1.hpp"
+#include "databento/v3.hpp"
+
+namespace databento {
+// Combines multiple function objects into one with all of their overloads for
+// use with `Record::Visit`.
+template <typename... Fs>
+struct Overloaded : Fs... {
+  using Fs::operator()...;
+};
+template <typename... Fs>
+Overloaded(Fs...) -> Overloaded<Fs...>;
+
+template <typename F>
+void Record::Visit(F&& visitor) const {
+  // Sizes of records from older DBN versions are smaller than their
+  // counterparts in later versions even with a `ts_out` suffix
+  switch (RType()) {
+    case RType::Mbo: {
+      return VisitAs<MboMsg>(visitor);
+    }
+    case RType::Mbp0: {
+      return VisitAs<TradeMsg>(visitor);
+    }
+    case RType::Mbp1: {
+      return VisitAs<Mbp1Msg>(visitor);
+    }
+    case RType::Mbp10: {
+      return VisitAs<Mbp10Msg>(visitor);
+    }
+    case RType::Bbo1S:  // fallthrough
+    case RType::Bbo1M: {
+      return VisitAs<BboMsg>(visitor);
+    }
+    case RType::Cmbp1:  // fallthrough
+    case RType::Tcbbo: {
+      return VisitAs<Cmbp1Msg>(visitor);
+    }
+    case RType::Cbbo1S:  // fallthrough
+    case RType::Cbbo1M: {
+      return VisitAs<CbboMsg>(visitor);
+    }
+    case RType::OhlcvDeprecated:  // fallthrough
+    case RType::Ohlcv1S:          // fallthrough
+    case RType::Ohlcv1M:          // fallthrough
+    case RType::Ohlcv1H:          // fallthrough
+    case RType::Ohlcv1D: {
+      return VisitAs<OhlcvMsg>(visitor);
+    }
+    case RType::Status: {
+      return VisitAs<StatusMsg>(visitor);
+    }
+    case RType::InstrumentDef: {
+      if (Size() < sizeof(InstrumentDefMsg)) {
+        return VisitAs<v1::InstrumentDefMsg>(visitor);
+      }
+      if (Size() < sizeof(v3::InstrumentDefMsg)) {
+        return VisitAs<InstrumentDefMsg>(visitor);
+      }
+      return VisitAs<v3::InstrumentDefMsg>(visitor);
+    }
+    case RType::Imbalance: {
+      return VisitAs<ImbalanceMsg>(visitor);
+    }
+    case RType::Statistics: {
+      return VisitAs<StatMsg>(visitor);
+    }
+    case RType::Error: {
+      if (Size() < sizeof(ErrorMsg)) {
+        return VisitAs<v1::ErrorMsg>(visitor);
+      }
+      return VisitAs<ErrorMsg>(visitor);
+    }
+    case RType::SymbolMapping: {
+      if (Size() < sizeof(SymbolMappingMsg)) {
+        return VisitAs<v1::SymbolMappingMsg>(visitor);
+      }
+      return VisitAs<SymbolMappingMsg>(visitor);
+    }
+    case RType::System: {
+      if (Size() < sizeof(SystemMsg)) {
+        return VisitAs<v1::SystemMsg>(visitor);
+      }
+      return VisitAs<SystemMsg>(visitor);
+    }
+    default: {
+      return VisitRecord(visitor);
+    }
+  }
+}
+
+template <typename T, typename F>
+void Record::VisitAs(F& visitor) const {
+  if constexpr (std::is_invocable<F&, const T&>::value) {
+    visitor(*reinterpret_cast<const T*>(record_));
+  } else {
+    VisitRecord(visitor);
+  }
+}
+
+template <typename F>
+void Record::VisitRecord(F& visitor) const {
+  if constexpr (std::is_invocable<F&, const Record&>::value) {
+    visitor(*this);
+  }
+}
+}  // namespace databento
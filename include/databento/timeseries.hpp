@@ -1,6 +1,11 @@
 #pragma once
 
-#include <functional>  // function
+#include <cstddef>      // size_t
+#include <cstdint>      // uint8_t
+#include <functional>   // function
+#include <type_traits>  // enable_if_t, is_invocable_r
+#include <utility>      // forward, move
+#include <vector>
 
 #include "databento/dbn.hpp"     // Metadata
 #include "databento/record.hpp"  // Record
@@ -13,4 +18,78 @@ enum KeepGoing : std::uint8_t {
 
 using MetadataCallback = std::function<void(Metadata&&)>;
 using RecordCallback = std::function<KeepGoing(const Record&)>;
+// Receives every record already decoded from the read buffer at once, paying
+// the cost of the call once per batch. The records are only valid until the
+// callback returns.
+using RecordBatchCallback =
+    std::function<KeepGoing(const std::vector<Record>&)>;
+
+// The maximum number of records passed to a `RecordBatchCallback` at once.
+constexpr std::size_t kMaxRecordBatchSize = 8192;
+
+// How the time range of a parallel timeseries request is split into slices.
+enum class SliceSizing : std::uint8_t {
+  // Slices of equal duration.
+  EqualTime,
+  // Slices with roughly equal record counts from metadata.get_record_count.
+  RecordCount,
+  // Slices with roughly equal sizes from metadata.get_billable_size.
+  BillableSize,
+};
+
+// Options for splitting a timeseries request into several requested
+// concurrently, each on its own connection.
+struct TimeseriesParallelOptions {
+  // The number of concurrent requests.
+  std::size_t slice_count{4};
+  SliceSizing sizing{SliceSizing::EqualTime};
+  // With `RecordCount` or `BillableSize` sizing, the number of equal-duration
+  // pieces per slice queried to place the slice boundaries.
+  std::size_t probes_per_slice{4};
+  // The number of bytes of each response buffered ahead of the callback. Once
+  // reached, reading that response is paused until the callback catches up.
+  std::size_t max_buffered_size{64 * 1024 * 1024};
+};
+
+// Options for splitting the symbols of a timeseries request into shards
+// requested concurrently, each on its own connection.
+struct TimeseriesShardOptions {
+  // The number of concurrent requests, limited to the number of symbols.
+  std::size_t shard_count{4};
+  // The number of bytes of each response buffered ahead of the callback. Once
+  // reached, reading that response is paused until the callback catches up.
+  std::size_t max_buffered_size{64 * 1024 * 1024};
+};
+
+namespace detail {
+// Enables the overloads taking any callable with the signature of
+// `RecordCallback`, which are called directly, allowing them to be inlined.
+template <typename F>
+using EnableIfRecordCallback = std::enable_if_t<
+    std::is_invocable_r<KeepGoing, F&, const Record&>::value, int>;
+
+// Adapts a callable taking a specific record type `T` to one taking any
+// `Record`, skipping records of other types.
+template <typename T, typename F>
+class TypedRecordCallback {
+ public:
+  explicit TypedRecordCallback(F callback) : callback_{std::move(callback)} {}
+
+  KeepGoing operator()(const Record& record) {
+    if (const auto* rec = record.GetIf<T>()) {
+      return callback_(*rec);
+    }
+    return KeepGoing::Continue;
+  }
+
+ private:
+  F callback_;
+};
+
+template <typename T, typename F>
+TypedRecordCallback<T, std::decay_t<F>> MakeTypedRecordCallback(
+    F&& callback) {
+  return TypedRecordCallback<T, std::decay_t<F>>{std::forward<F>(callback)};
+}
+}  // namespace detail
 }  // namespace databento
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "databento/datetime.hpp"  // UnixNanos
+
+namespace databento {
+// A local on-disk cache of the DBN responses to timeseries requests, stored as
+// returned by the gateway. Entries are grouped in a directory per query, named
+// after a hash of the canonical form of the request parameters other than the
+// time range, and each entry holds one time range of that query. A request
+// whose time range is only partly cached can therefore be split into cached
+// and uncached parts. Entries are written to a temporary file and renamed
+// into place once complete, so a cache directory can be shared between
+// processes.
+class TimeseriesCache {
+ public:
+  using Params = std::multimap<std::string, std::string>;
+  // A part of a time range. `file_path` is empty if the part isn't cached.
+  struct Entry {
+    UnixNanos start;
+    UnixNanos end;
+    std::string file_path;
+  };
+
+  explicit TimeseriesCache(std::string dir);
+
+  const std::string& Dir() const { return dir_; }
+  // Returns the canonical form of a request to `url_path` with `params`,
+  // ignoring the order of the parameters and of the symbols, and the time
+  // range.
+  static std::string CanonicalQuery(const std::string& url_path,
+                                    const Params& params);
+  // Splits [`start`, `end`) into contiguous parts, each either covered by a
+  // single cached entry or not cached. An entry may extend past the part it
+  // covers.
+  std::vector<Entry> Plan(const std::string& url_path, const Params& params,
+                          UnixNanos start, UnixNanos end) const;
+  // Adds an entry for [`start`, `end`) whose contents are written by `write`
+  // to the file path it's passed. Returns the entry.
+  Entry Store(const std::string& url_path, const Params& params,
+              UnixNanos start, UnixNanos end,
+              const std::function<void(const std::string&)>& write) const;
+
+ private:
+  // Returns the directory of the entries for the query, creating it if
+  // `create` is true.
+  std::string QueryDir(const std::string& canonical_query, bool create) const;
+
+  std::string dir_;
+};
+}  // namespace databento
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint64_t
+#include <string>
+#include <vector>
+
+#include "databento/datetime.hpp"  // UnixNanos
+#include "databento/record.hpp"
+
+namespace databento {
+// A sparse index of the records in a DBN stream by their index timestamp
+// (`ts_recv`, or `ts_event` for records without it). Records are grouped into
+// blocks of about `block_size` bytes, and each block maps to its offset in the
+// decompressed DBN stream, which for files in the Zstd seekable format also
+// identifies the frame. The index is saved as a sidecar file and used by
+// `DbnFileStore::SeekTo`.
+class TsIndex {
+ public:
+  struct Entry {
+    // The greatest index timestamp of the records in this and all earlier
+    // blocks.
+    UnixNanos max_ts;
+    // The offset of the first record of the block in the decompressed stream.
+    std::uint64_t offset;
+  };
+
+  explicit TsIndex(std::uint64_t block_size);
+  // Builds an index in a single pass over the records in an existing DBN file.
+  static TsIndex Build(const std::string& dbn_file_path,
+                       std::uint64_t block_size);
+  static TsIndex ReadFromFile(const std::string& index_file_path);
+
+  void WriteToFile(const std::string& index_file_path) const;
+  // Adds a record located at `offset` in the decompressed stream. Records must
+  // be added in the order they appear in the stream.
+  void Add(const Record& record, std::uint64_t offset);
+  // Returns the index of the first entry whose block may contain records with
+  // an index timestamp at or after `ts`, or the number of entries if there's
+  // no such block.
+  std::size_t Find(UnixNanos ts) const;
+
+  std::uint64_t BlockSize() const { return block_size_; }
+  const std::vector<Entry>& Entries() const { return entries_; }
+
+ private:
+  std::uint64_t block_size_;
+  std::vector<Entry> entries_;
+};
+
+bool operator==(const TsIndex::Entry& lhs, const TsIndex::Entry& rhs);
+inline bool operator!=(const TsIndex::Entry& lhs, const TsIndex::Entry& rhs) {
+  return !(lhs == rhs);
+}
+}  // namespace databento
@@ -33,6 +33,9 @@ using ErrorMsg = databento::ErrorMsg;
 using SymbolMappingMsg = databento::SymbolMappingMsg;
 using SystemMsg = databento::SystemMsg;
 
+// The size in bytes of `InstrumentDefMsg`.
+static constexpr std::size_t kInstrumentDefMsgSize = 520;
+
 // An instrument definition in DBN version 3.
 struct InstrumentDefMsg {
   static bool HasRType(RType rtype) { return rtype == RType::InstrumentDef; }
@@ -127,7 +130,7 @@ struct InstrumentDefMsg {
   // padding for alignment
   std::array<char, 21> reserved;
 };
-static_assert(sizeof(InstrumentDefMsg) == 520,
+static_assert(sizeof(InstrumentDefMsg) == kInstrumentDefMsgSize,
               "InstrumentDefMsg size must match Rust");
 static_assert(alignof(InstrumentDefMsg) == 8, "Must have 8-byte alignment");
 static_assert(kMaxRecordLen == sizeof(InstrumentDefMsg) + sizeof(UnixNanos),
@@ -0,0 +1,29 @@
+#pragma once
+
+namespace databento {
+class ZstdDictionary;
+
+// Settings for Zstd compression. The defaults match single-threaded `zstd`
+// command-line compression.
+struct ZstdCompressOptions {
+  // The compression level, from negative "fast" levels to 22. 0 selects the
+  // Zstd default of 3.
+  int level{0};
+  // The number of background threads to compress with. With 0, compression
+  // happens on the calling thread. Otherwise writes only buffer input for the
+  // workers, moving the cost of compression off the writing thread. Ignored
+  // with a warning when libzstd was built without multithreading support.
+  int worker_count{0};
+  // Long distance matching finds repeated data across a large window, which
+  // improves the ratio of large files with many similar records.
+  bool enable_long_distance_matching{false};
+  // Base-2 logarithm of the maximum back-reference distance. 0 lets Zstd choose
+  // based on the level. Values above 27 require readers to opt in to the
+  // larger window with `DbnFileStoreOptions::zstd_window_log_max`.
+  int window_log{0};
+  // Compresses every frame with this dictionary, which greatly improves the
+  // ratio of small frames. Only needs to live until the compressing stream has
+  // been constructed. Readers need the same dictionary.
+  const ZstdDictionary* dictionary{};
+};
+}  // namespace databento
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint8_t, uint32_t
+#include <map>
+#include <string>
+#include <vector>
+
+#include "databento/enums.hpp"  // Schema
+
+namespace databento {
+// A Zstd dictionary for compressing many small frames. Each frame otherwise
+// starts without any history, so frames of a few KiB compress poorly. Records
+// of the same schema share most of their bytes, so a dictionary trained on
+// samples of one schema recovers most of the ratio of large frames. The
+// dictionary's ID is recorded in the header of each frame compressed with it.
+class ZstdDictionary {
+ public:
+  // Takes the contents of a dictionary in the Zstd format, e.g. one created
+  // with `zstd --train`.
+  explicit ZstdDictionary(std::vector<std::uint8_t> data);
+  // Trains a dictionary of at most `max_size` bytes from the samples
+  // concatenated in `samples`, where `sample_sizes` holds the size of each.
+  // Samples should resemble the frames to be compressed.
+  static ZstdDictionary Train(const std::vector<std::uint8_t>& samples,
+                              const std::vector<std::size_t>& sample_sizes,
+                              std::size_t max_size);
+  // Trains a dictionary from the records of an existing DBN file, split into
+  // samples of whole records of about `sample_size` bytes. `sample_size`
+  // should match the frame size the dictionary will be used with.
+  static ZstdDictionary Train(const std::string& dbn_file_path,
+                              std::size_t sample_size, std::size_t max_size);
+  static ZstdDictionary ReadFromFile(const std::string& dict_file_path);
+
+  void WriteToFile(const std::string& dict_file_path) const;
+  // The ID recorded in frames compressed with this dictionary. 0 for raw
+  // content dictionaries, which don't have an ID.
+  std::uint32_t Id() const { return id_; }
+  const std::vector<std::uint8_t>& Data() const { return data_; }
+
+ private:
+  std::vector<std::uint8_t> data_;
+  std::uint32_t id_;
+};
+
+// Dictionaries by schema for writers and by ID for readers, which find the
+// dictionary for each frame from the ID in its header.
+class ZstdDictionarySet {
+ public:
+  // Replaces any existing dictionary for `schema`.
+  void Add(Schema schema, ZstdDictionary dictionary);
+  // Returns the dictionary for compressing records of `schema`, or null if
+  // there's none.
+  const ZstdDictionary* Find(Schema schema) const;
+  // Returns the dictionary with `id`, or null if there's none.
+  const ZstdDictionary* FindById(std::uint32_t id) const;
+
+ private:
+  std::map<Schema, ZstdDictionary> dictionaries_;
+};
+}  // namespace databento
@@ -0,0 +1,515 @@
+#include "databento/columnar_file.hpp"
+
+#include <algorithm>  // find, minmax_element
+#include <array>
+#include <cstring>      // memcmp, memcpy
+#include <ios>          // ios, streamoff, streamsize
+#include <type_traits>  // decay_t, is_enum, is_unsigned, underlying_type_t
+#include <utility>      // move
+
+#include "databento/datetime.hpp"  // TimeDeltaNanos, UnixNanos
+#include "databento/dbn_decoder.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/flag_set.hpp"
+#include "databento/iwritable.hpp"
+#include "dbn_constants.hpp"  // kMetadataPreludeSize
+
+using databento::ColumnarFileReader;
+using databento::ColumnarFileWriter;
+
+namespace {
+// Includes the format version. Also ends the file.
+constexpr auto kColumnarFilePrefix = "DBNCOL\x00\x01";
+constexpr std::size_t kColumnarFilePrefixLen = 8;
+// Footer offset followed by the prefix
+constexpr std::size_t kTrailerSize = sizeof(std::uint64_t) + 8;
+constexpr int kDefaultCompressionLevel = 3;
+
+// Identifies the type of columns in the file
+constexpr std::uint8_t kMboColumnSet = 1;
+constexpr std::uint8_t kTradeColumnSet = 2;
+constexpr std::uint8_t kMbp1ColumnSet = 3;
+constexpr std::uint8_t kOhlcvColumnSet = 4;
+
+class BufferWritable : public databento::IWritable {
+ public:
+  void WriteAll(const std::uint8_t* buffer, std::size_t length) override {
+    buffer_.insert(buffer_.end(), buffer, buffer + length);
+  }
+
+  const std::vector<std::uint8_t>& Buffer() const { return buffer_; }
+
+ private:
+  std::vector<std::uint8_t> buffer_;
+};
+
+template <typename T>
+void WriteAsBytes(T value, std::vector<std::uint8_t>* buffer) {
+  const auto* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+  buffer->insert(buffer->end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+T ReadAsBytes(const std::uint8_t*& buffer, const std::uint8_t* end) {
+  if (static_cast<std::size_t>(end - buffer) < sizeof(T)) {
+    throw databento::DbnResponseError{"Unexpected end of columnar file footer"};
+  }
+  T value{};
+  std::memcpy(&value, buffer, sizeof(T));
+  buffer += sizeof(T);
+  return value;
+}
+
+// Unsigned columns are compared as `std::uint64_t` so values above the
+// maximum `std::int64_t` don't wrap around.
+template <typename T>
+constexpr bool kIsUnsignedStat = std::is_unsigned<T>::value;
+template <>
+constexpr bool kIsUnsignedStat<databento::UnixNanos> = true;
+template <>
+constexpr bool kIsUnsignedStat<databento::FlagSet> = true;
+
+template <typename T>
+std::int64_t StatValue(T value) {
+  if constexpr (std::is_enum<T>::value) {
+    return static_cast<std::int64_t>(
+        static_cast<std::underlying_type_t<T>>(value));
+  } else {
+    return static_cast<std::int64_t>(value);
+  }
+}
+
+std::int64_t StatValue(databento::TimeDeltaNanos value) {
+  return value.count();
+}
+
+template <typename T>
+std::uint64_t UnsignedStatValue(T value) {
+  return static_cast<std::uint64_t>(value);
+}
+
+std::uint64_t UnsignedStatValue(databento::UnixNanos value) {
+  return value.time_since_epoch().count();
+}
+
+std::uint64_t UnsignedStatValue(databento::FlagSet value) {
+  return static_cast<std::uint8_t>(value);
+}
+
+// Signedness isn't stored in the file, it follows from the type of each column
+template <typename C>
+std::vector<bool> UnsignedColumns() {
+  C columns;
+  std::vector<bool> res;
+  C::ForEachColumn(columns, [&res](const char*, const auto& column) {
+    using T = typename std::decay_t<decltype(column)>::value_type;
+    res.emplace_back(kIsUnsignedStat<T>);
+  });
+  return res;
+}
+
+std::vector<bool> UnsignedColumns(std::uint8_t column_set) {
+  switch (column_set) {
+    case kMboColumnSet: {
+      return UnsignedColumns<databento::MboColumns>();
+    }
+    case kTradeColumnSet: {
+      return UnsignedColumns<databento::TradeColumns>();
+    }
+    case kMbp1ColumnSet: {
+      return UnsignedColumns<databento::Mbp1Columns>();
+    }
+    case kOhlcvColumnSet: {
+      return UnsignedColumns<databento::OhlcvColumns>();
+    }
+    default: {
+      throw databento::DbnResponseError{
+          "Unknown type of columns in columnar file"};
+    }
+  }
+}
+
+template <typename C>
+std::size_t ValueSize(const C&) {
+  return sizeof(typename C::value_type);
+}
+}  // namespace
+
+ColumnarFileWriter::ColumnarFileWriter(ILogReceiver* log_receiver,
+                                       const std::string& file_path,
+                                       const Metadata& metadata)
+    : ColumnarFileWriter{log_receiver, file_path, metadata,
+                         kDefaultCompressionLevel} {}
+
+ColumnarFileWriter::ColumnarFileWriter(ILogReceiver* log_receiver,
+                                       const std::string& file_path,
+                                       const Metadata& metadata,
+                                       int compression_level)
+    : log_receiver_{log_receiver},
+      output_{file_path},
+      compression_level_{compression_level},
+      z_cctx_{::ZSTD_createCCtx(), ::ZSTD_freeCCtx} {
+  Write(reinterpret_cast<const std::uint8_t*>(kColumnarFilePrefix),
+        kColumnarFilePrefixLen);
+  BufferWritable metadata_buffer;
+  DbnEncoder::EncodeMetadata(metadata, &metadata_buffer);
+  Write(metadata_buffer.Buffer().data(), metadata_buffer.Buffer().size());
+}
+
+ColumnarFileWriter::~ColumnarFileWriter() {
+  if (is_finished_) {
+    return;
+  }
+  try {
+    Finish();
+  } catch (const std::exception& exc) {
+    if (log_receiver_) {
+      log_receiver_->Receive(
+          LogLevel::Error,
+          std::string{"Error finishing columnar file: "} + exc.what());
+    }
+  }
+}
+
+void ColumnarFileWriter::WriteRowGroup(const MboColumns& columns) {
+  WriteColumns(kMboColumnSet, columns);
+}
+
+void ColumnarFileWriter::WriteRowGroup(const TradeColumns& columns) {
+  WriteColumns(kTradeColumnSet, columns);
+}
+
+void ColumnarFileWriter::WriteRowGroup(const Mbp1Columns& columns) {
+  WriteColumns(kMbp1ColumnSet, columns);
+}
+
+void ColumnarFileWriter::WriteRowGroup(const OhlcvColumns& columns) {
+  WriteColumns(kOhlcvColumnSet, columns);
+}
+
+void ColumnarFileWriter::Finish() {
+  if (is_finished_) {
+    throw Exception{"ColumnarFileWriter::Finish called more than once"};
+  }
+  is_finished_ = true;
+  const auto footer_offset = offset_;
+  std::vector<std::uint8_t> footer;
+  WriteAsBytes(column_set_, &footer);
+  WriteAsBytes(static_cast<std::uint32_t>(column_names_.size()), &footer);
+  for (std::size_t i = 0; i < column_names_.size(); ++i) {
+    WriteAsBytes(column_widths_[i], &footer);
+    WriteAsBytes(static_cast<std::uint8_t>(column_names_[i].size()), &footer);
+    footer.insert(footer.end(), column_names_[i].cbegin(),
+                  column_names_[i].cend());
+  }
+  WriteAsBytes<std::uint64_t>(row_groups_.size(), &footer);
+  for (const auto& row_group : row_groups_) {
+    WriteAsBytes(row_group.row_count, &footer);
+    for (const auto& chunk : row_group.columns) {
+      WriteAsBytes(chunk.offset, &footer);
+      WriteAsBytes(chunk.compressed_size, &footer);
+      WriteAsBytes(chunk.encoding, &footer);
+      if (chunk.is_unsigned) {
+        WriteAsBytes(chunk.unsigned_min, &footer);
+        WriteAsBytes(chunk.unsigned_max, &footer);
+      } else {
+        WriteAsBytes(chunk.min, &footer);
+        WriteAsBytes(chunk.max, &footer);
+      }
+    }
+  }
+  WriteAsBytes(footer_offset, &footer);
+  footer.insert(footer.end(), kColumnarFilePrefix,
+                kColumnarFilePrefix + kColumnarFilePrefixLen);
+  Write(footer.data(), footer.size());
+}
+
+template <typename C>
+void ColumnarFileWriter::WriteColumns(std::uint8_t column_set,
+                                      const C& columns) {
+  if (is_finished_) {
+    throw Exception{"ColumnarFileWriter::WriteRowGroup called after Finish"};
+  }
+  const auto row_count = columns.Size();
+  C::ForEachColumn(columns, [row_count](const char*, const auto& column) {
+    if (column.size() != row_count) {
+      throw InvalidArgumentError{"ColumnarFileWriter::WriteRowGroup",
+                                 "columns",
+                                 "All columns must have the same length"};
+    }
+  });
+  if (column_set_ == 0) {
+    column_set_ = column_set;
+    C::ForEachColumn(columns, [this](const char* name, const auto& column) {
+      column_names_.emplace_back(name);
+      column_widths_.emplace_back(
+          static_cast<std::uint8_t>(ValueSize(column)));
+    });
+  } else if (column_set != column_set_) {
+    throw InvalidArgumentError{"ColumnarFileWriter::WriteRowGroup", "columns",
+                               "Must be the same type as the previous row "
+                               "groups"};
+  }
+  RowGroupInfo row_group{row_count, {}};
+  C::ForEachColumn(columns, [this, &row_group](const char*,
+                                               const auto& column) {
+    row_group.columns.emplace_back(WriteColumn(column));
+  });
+  row_groups_.emplace_back(std::move(row_group));
+}
+
+template <typename T>
+databento::ColumnChunkInfo ColumnarFileWriter::WriteColumn(
+    const Column<T>& column) {
+  ColumnChunkInfo chunk{};
+  chunk.offset = offset_;
+  chunk.encoding = ColumnEncoding::Zstd;
+  chunk.is_unsigned = kIsUnsignedStat<T>;
+  if (!column.empty()) {
+    if constexpr (kIsUnsignedStat<T>) {
+      const auto min_max = std::minmax_element(
+          column.cbegin(), column.cend(), [](const T& lhs, const T& rhs) {
+            return UnsignedStatValue(lhs) < UnsignedStatValue(rhs);
+          });
+      chunk.unsigned_min = UnsignedStatValue(*min_max.first);
+      chunk.unsigned_max = UnsignedStatValue(*min_max.second);
+    } else {
+      const auto min_max = std::minmax_element(
+          column.cbegin(), column.cend(), [](const T& lhs, const T& rhs) {
+            return StatValue(lhs) < StatValue(rhs);
+          });
+      chunk.min = StatValue(*min_max.first);
+      chunk.max = StatValue(*min_max.second);
+    }
+  }
+  const void* src = column.data();
+  const std::size_t size = column.size() * sizeof(T);
+  if constexpr (sizeof(T) == sizeof(std::uint64_t)) {
+    chunk.encoding = ColumnEncoding::DeltaZstd;
+    delta_buffer_.resize(column.size());
+    std::uint64_t prev{};
+    for (std::size_t i = 0; i < column.size(); ++i) {
+      std::uint64_t value;
+      std::memcpy(&value, &column[i], sizeof(value));
+      // Wraps around for decreasing values
+      delta_buffer_[i] = value - prev;
+      prev = value;
+    }
+    src = delta_buffer_.data();
+  }
+  compressed_buffer_.resize(::ZSTD_compressBound(size));
+  const auto compressed_size =
+      ::ZSTD_compressCCtx(z_cctx_.get(), compressed_buffer_.data(),
+                          compressed_buffer_.size(), src, size,
+                          compression_level_);
+  if (::ZSTD_isError(compressed_size)) {
+    throw DbnResponseError{std::string{"Zstd error compressing column: "} +
+                           ::ZSTD_getErrorName(compressed_size)};
+  }
+  Write(compressed_buffer_.data(), compressed_size);
+  chunk.compressed_size = compressed_size;
+  return chunk;
+}
+
+void ColumnarFileWriter::Write(const std::uint8_t* buffer,
+                               std::size_t length) {
+  output_.WriteAll(buffer, length);
+  offset_ += length;
+}
+
+ColumnarFileReader::ColumnarFileReader(const std::string& file_path)
+    : input_{file_path, std::ios::binary},
+      z_dctx_{::ZSTD_createDCtx(), ::ZSTD_freeDCtx} {
+  if (input_.fail()) {
+    throw InvalidArgumentError{"ColumnarFileReader::ColumnarFileReader",
+                               "file_path", "Non-existent or invalid file"};
+  }
+  std::array<std::uint8_t, kColumnarFilePrefixLen> prefix{};
+  ReadAt(0, prefix.data(), prefix.size());
+  if (std::memcmp(prefix.data(), kColumnarFilePrefix,
+                  kColumnarFilePrefixLen) != 0) {
+    throw DbnResponseError{"Invalid or unsupported columnar file"};
+  }
+  std::array<std::uint8_t, kMetadataPreludeSize> prelude{};
+  ReadAt(kColumnarFilePrefixLen, prelude.data(), prelude.size());
+  const auto version_and_size =
+      DbnDecoder::DecodeMetadataVersionAndSize(prelude.data(), prelude.size());
+  std::vector<std::uint8_t> metadata_buffer(version_and_size.second);
+  ReadAt(kColumnarFilePrefixLen + kMetadataPreludeSize, metadata_buffer.data(),
+         metadata_buffer.size());
+  metadata_ =
+      DbnDecoder::DecodeMetadataFields(version_and_size.first, metadata_buffer);
+  ReadFooter();
+  is_selected_.assign(column_names_.size(), true);
+}
+
+std::size_t ColumnarFileReader::ColumnIndex(const std::string& name) const {
+  const auto it = std::find(column_names_.cbegin(), column_names_.cend(), name);
+  if (it == column_names_.cend()) {
+    throw InvalidArgumentError{"ColumnarFileReader::ColumnIndex", "name",
+                               "No column named " + name};
+  }
+  return static_cast<std::size_t>(it - column_names_.cbegin());
+}
+
+void ColumnarFileReader::SelectColumns(
+    const std::vector<std::string>& column_names) {
+  if (column_names.empty()) {
+    is_selected_.assign(column_names_.size(), true);
+    return;
+  }
+  std::vector<bool> is_selected(column_names_.size(), false);
+  for (const auto& name : column_names) {
+    is_selected[ColumnIndex(name)] = true;
+  }
+  is_selected_ = std::move(is_selected);
+}
+
+void ColumnarFileReader::ReadRowGroup(std::size_t idx, MboColumns* columns) {
+  ReadColumns(kMboColumnSet, idx, columns);
+}
+
+void ColumnarFileReader::ReadRowGroup(std::size_t idx, TradeColumns* columns) {
+  ReadColumns(kTradeColumnSet, idx, columns);
+}
+
+void ColumnarFileReader::ReadRowGroup(std::size_t idx, Mbp1Columns* columns) {
+  ReadColumns(kMbp1ColumnSet, idx, columns);
+}
+
+void ColumnarFileReader::ReadRowGroup(std::size_t idx, OhlcvColumns* columns) {
+  ReadColumns(kOhlcvColumnSet, idx, columns);
+}
+
+void ColumnarFileReader::ReadFooter() {
+  input_.seekg(0, std::ios::end);
+  const auto file_size = static_cast<std::uint64_t>(input_.tellg());
+  if (file_size < kColumnarFilePrefixLen + kTrailerSize) {
+    throw DbnResponseError{"File too small to contain a columnar file footer"};
+  }
+  std::array<std::uint8_t, kTrailerSize> trailer{};
+  ReadAt(file_size - kTrailerSize, trailer.data(), trailer.size());
+  if (std::memcmp(trailer.data() + sizeof(std::uint64_t), kColumnarFilePrefix,
+                  kColumnarFilePrefixLen) != 0) {
+    throw DbnResponseError{"Missing columnar file footer"};
+  }
+  std::uint64_t footer_offset{};
+  std::memcpy(&footer_offset, trailer.data(), sizeof(footer_offset));
+  if (footer_offset > file_size - kTrailerSize) {
+    throw DbnResponseError{"Columnar file footer offset is past its end"};
+  }
+  std::vector<std::uint8_t> footer(file_size - kTrailerSize - footer_offset);
+  ReadAt(footer_offset, footer.data(), footer.size());
+  const std::uint8_t* it = footer.data();
+  const std::uint8_t* end = footer.data() + footer.size();
+  column_set_ = ReadAsBytes<std::uint8_t>(it, end);
+  const auto column_count = ReadAsBytes<std::uint32_t>(it, end);
+  for (std::uint32_t i = 0; i < column_count; ++i) {
+    column_widths_.emplace_back(ReadAsBytes<std::uint8_t>(it, end));
+    const auto name_len = ReadAsBytes<std::uint8_t>(it, end);
+    if (static_cast<std::size_t>(end - it) < name_len) {
+      throw DbnResponseError{"Unexpected end of columnar file footer"};
+    }
+    column_names_.emplace_back(reinterpret_cast<const char*>(it), name_len);
+    it += name_len;
+  }
+  const auto is_unsigned = UnsignedColumns(column_set_);
+  if (is_unsigned.size() != column_count) {
+    throw DbnResponseError{"Unexpected number of columns in columnar file"};
+  }
+  const auto row_group_count = ReadAsBytes<std::uint64_t>(it, end);
+  for (std::uint64_t i = 0; i < row_group_count; ++i) {
+    RowGroupInfo row_group{ReadAsBytes<std::uint64_t>(it, end), {}};
+    for (std::uint32_t j = 0; j < column_count; ++j) {
+      ColumnChunkInfo chunk{};
+      chunk.offset = ReadAsBytes<std::uint64_t>(it, end);
+      chunk.compressed_size = ReadAsBytes<std::uint64_t>(it, end);
+      chunk.encoding = ReadAsBytes<ColumnEncoding>(it, end);
+      chunk.is_unsigned = is_unsigned[j];
+      if (chunk.is_unsigned) {
+        chunk.unsigned_min = ReadAsBytes<std::uint64_t>(it, end);
+        chunk.unsigned_max = ReadAsBytes<std::uint64_t>(it, end);
+      } else {
+        chunk.min = ReadAsBytes<std::int64_t>(it, end);
+        chunk.max = ReadAsBytes<std::int64_t>(it, end);
+      }
+      row_group.columns.emplace_back(chunk);
+    }
+    row_groups_.emplace_back(std::move(row_group));
+  }
+}
+
+void ColumnarFileReader::ReadAt(std::uint64_t offset, std::uint8_t* buffer,
+                                std::size_t length) {
+  input_.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+  input_.read(reinterpret_cast<char*>(buffer),
+              static_cast<std::streamsize>(length));
+  if (input_.fail()) {
+    throw DbnResponseError{"Unexpected end of columnar file"};
+  }
+}
+
+template <typename C>
+void ColumnarFileReader::ReadColumns(std::uint8_t column_set, std::size_t idx,
+                                     C* columns) {
+  if (column_set != column_set_) {
+    throw InvalidArgumentError{"ColumnarFileReader::ReadRowGroup", "columns",
+                               "Must be the type of columns in the file"};
+  }
+  if (idx >= row_groups_.size()) {
+    throw InvalidArgumentError{"ColumnarFileReader::ReadRowGroup", "idx",
+                               "Out of range"};
+  }
+  const auto& row_group = row_groups_[idx];
+  std::size_t column_idx{};
+  C::ForEachColumn(*columns, [this, &row_group, &column_idx](const char*,
+                                                             auto& column) {
+    if (column_widths_[column_idx] != ValueSize(column)) {
+      throw DbnResponseError{"Unexpected column width in columnar file"};
+    }
+    if (is_selected_[column_idx]) {
+      ReadColumn(row_group.columns[column_idx], row_group.row_count, &column);
+    } else {
+      column.clear();
+    }
+    ++column_idx;
+  });
+}
+
+template <typename T>
+void ColumnarFileReader::ReadColumn(const ColumnChunkInfo& chunk,
+                                    std::uint64_t row_count,
+                                    Column<T>* column) {
+  compressed_buffer_.resize(static_cast<std::size_t>(chunk.compressed_size));
+  ReadAt(chunk.offset, compressed_buffer_.data(), compressed_buffer_.size());
+  column->resize(row_count);
+  const std::size_t size = column->size() * sizeof(T);
+  const auto decompressed_size =
+      ::ZSTD_decompressDCtx(z_dctx_.get(), column->data(), size,
+                            compressed_buffer_.data(),
+                            compressed_buffer_.size());
+  if (::ZSTD_isError(decompressed_size)) {
+    throw DbnResponseError{std::string{"Zstd error decompressing column: "} +
+                           ::ZSTD_getErrorName(decompressed_size)};
+  }
+  if (decompressed_size != size) {
+    throw DbnResponseError{"Column chunk has an unexpected size"};
+  }
+  if (chunk.encoding == ColumnEncoding::Zstd) {
+    return;
+  }
+  if constexpr (sizeof(T) == sizeof(std::uint64_t)) {
+    if (chunk.encoding == ColumnEncoding::DeltaZstd) {
+      std::uint64_t prev{};
+      for (auto& elem : *column) {
+        std::uint64_t value;
+        std::memcpy(&value, static_cast<const void*>(&elem), sizeof(value));
+        prev += value;
+        std::memcpy(static_cast<void*>(&elem), &prev, sizeof(prev));
+      }
+      return;
+    }
+  }
+  throw DbnResponseError{"Unsupported column encoding"};
+}
@@ -1,46 +1,83 @@
 #include "databento/datetime.hpp"
 
-// NOLINTNEXTLINE(modernize-deprecated-headers): no thread-safe version in STL
-#include <time.h>  // gmtime_r or gmtime_s
-
 #include <array>
-#include <chrono>
-#include <ctime>    // localtime, strftime, tm
+#include <cstring>  // memcpy
 #include <iomanip>  // setw
+#include <limits>
 #include <sstream>  // ostringstream
+#include <system_error>
 
 #include "databento/constants.hpp"  // kUndefTimestamp
+#include "text_format.hpp"
+
+namespace {
+constexpr std::uint64_t kNanosPerSec = 1000000000;
+constexpr std::uint64_t kSecsPerDay = 86400;
+constexpr auto kUndefTimestampStr = "UNDEF_TIMESTAMP";
+constexpr std::size_t kUndefTimestampStrLen = 15;
+// YYYY-MM-DDT
+constexpr std::size_t kDatePrefixLen = 11;
+
+using databento::detail::WritePaddedUInt;
+
+// The date of the last formatted timestamp.
+struct DatePrefixCache {
+  std::uint64_t day{std::numeric_limits<std::uint64_t>::max()};
+  std::array<char, kDatePrefixLen> prefix{};
+};
+
+// Writes the civil date of `days` since the UNIX epoch as YYYY-MM-DD.
+char* WriteDate(char* out, std::uint64_t days) {
+  // http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+  // Simplified for dates after the epoch
+  const std::uint64_t z = days + 719468;
+  const std::uint64_t era = z / 146097;
+  const std::uint64_t doe = z - era * 146097;
+  const std::uint64_t yoe =
+      (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const std::uint64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const std::uint64_t mp = (5 * doy + 2) / 153;
+  const std::uint64_t day = doy - (153 * mp + 2) / 5 + 1;
+  const std::uint64_t month = mp < 10 ? mp + 3 : mp - 9;
+  const std::uint64_t year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+  out = WritePaddedUInt(out, year, 4);
+  *out++ = '-';
+  out = WritePaddedUInt(out, month, 2);
+  *out++ = '-';
+  return WritePaddedUInt(out, day, 2);
+}
+
+// `out` must have space for `kIso8601Len` characters.
+char* WriteIso8601(char* out, databento::UnixNanos unix_nanos) {
+  thread_local DatePrefixCache cache;
+  const std::uint64_t nanos = unix_nanos.time_since_epoch().count();
+  const std::uint64_t secs = nanos / kNanosPerSec;
+  const std::uint64_t day = secs / kSecsPerDay;
+  if (day != cache.day) {
+    WriteDate(cache.prefix.data(), day);
+    cache.prefix[kDatePrefixLen - 1] = 'T';
+    cache.day = day;
+  }
+  std::memcpy(out, cache.prefix.data(), kDatePrefixLen);
+  out += kDatePrefixLen;
+  const std::uint64_t secs_of_day = secs % kSecsPerDay;
+  out = WritePaddedUInt(out, secs_of_day / 3600, 2);
+  *out++ = ':';
+  out = WritePaddedUInt(out, secs_of_day / 60 % 60, 2);
+  *out++ = ':';
+  out = WritePaddedUInt(out, secs_of_day % 60, 2);
+  *out++ = '.';
+  out = WritePaddedUInt(out, nanos % kNanosPerSec, 9);
+  *out++ = 'Z';
+  return out;
+}
+}  // namespace
 
 namespace databento {
 std::string ToIso8601(UnixNanos unix_nanos) {
-  if (unix_nanos.time_since_epoch().count() == kUndefTimestamp) {
-    return "UNDEF_TIMESTAMP";
-  }
-  std::array<char, 80> buf{};
-  const std::time_t time = std::chrono::duration_cast<std::chrono::seconds>(
-                               unix_nanos.time_since_epoch())
-                               .count();
-  std::tm tm = {};
-#ifdef _WIN32
-  if (::gmtime_s(&tm, &time) != 0) {
-    // Fallback on printing nanos
-    return ToString(unix_nanos);
-  }
-#else
-  if (::gmtime_r(&time, &tm) == nullptr) {
-    // Fallback on printing nanos
-    return ToString(unix_nanos);
-  }
-#endif
-  const auto nanos = std::chrono::nanoseconds{
-      unix_nanos.time_since_epoch() %
-      std::chrono::nanoseconds{std::chrono::seconds{1}}};
-  const size_t count =
-      std::strftime(buf.data(), sizeof(buf), "%Y-%m-%dT%H:%M:%S", &tm);
-  std::ostringstream time_ss;
-  time_ss.write(buf.data(), static_cast<std::streamsize>(count));
-  time_ss << '.' << std::setw(9) << std::setfill('0') << nanos.count() << 'Z';
-  return time_ss.str();
+  std::array<char, kIso8601Len> buf;
+  const auto res = ToIso8601(buf.data(), buf.data() + buf.size(), unix_nanos);
+  return {buf.data(), res.ptr};
 }
 
 std::string ToString(UnixNanos unix_nanos) {
@@ -51,6 +88,29 @@ std::string ToString(TimeDeltaNanos td_nanos) {
   return std::to_string(td_nanos.count());
 }
 
+std::to_chars_result ToChars(char* first, char* last, UnixNanos unix_nanos) {
+  return std::to_chars(first, last, unix_nanos.time_since_epoch().count());
+}
+
+std::to_chars_result ToIso8601(char* first, char* last, UnixNanos unix_nanos) {
+  const auto len = static_cast<std::size_t>(last - first);
+  if (unix_nanos.time_since_epoch().count() == kUndefTimestamp) {
+    if (len < kUndefTimestampStrLen) {
+      return {last, std::errc::value_too_large};
+    }
+    std::memcpy(first, kUndefTimestampStr, kUndefTimestampStrLen);
+    return {first + kUndefTimestampStrLen, std::errc{}};
+  }
+  if (len < kIso8601Len) {
+    return {last, std::errc::value_too_large};
+  }
+  return {WriteIso8601(first, unix_nanos), std::errc{}};
+}
+
+std::to_chars_result ToChars(char* first, char* last, TimeDeltaNanos td_nanos) {
+  return std::to_chars(first, last, td_nanos.count());
+}
+
 std::string DateFromIso8601Int(std::uint32_t date_int) {
   const auto year = date_int / 10000;
   const auto remaining = date_int % 10000;
@@ -1,7 +1,9 @@
 #include "databento/dbn.hpp"
 
+#include <algorithm>  // find, find_if, sort
 #include <array>
 #include <sstream>  // ostringstream
+#include <utility>  // move
 
 #include "databento/constants.hpp"
 #include "databento/symbol_map.hpp"
@@ -23,6 +25,84 @@ void Metadata::Upgrade(VersionUpgradePolicy upgrade_policy) {
   }
 }
 
+namespace {
+bool Contains(const std::vector<std::string>& symbols,
+              const std::string& symbol) {
+  return std::find(symbols.begin(), symbols.end(), symbol) != symbols.end();
+}
+
+void AddUnique(std::vector<std::string>* symbols, const std::string& symbol) {
+  if (!Contains(*symbols, symbol)) {
+    symbols->emplace_back(symbol);
+  }
+}
+}  // namespace
+
+void Metadata::Merge(const Metadata& other) {
+  if (other.start < start) {
+    start = other.start;
+  }
+  if (other.end > end) {
+    end = other.end;
+  }
+  std::vector<std::string> merged_not_found;
+  for (const auto& symbol : not_found) {
+    // Found in `other`
+    if (Contains(other.symbols, symbol) && !Contains(other.not_found, symbol)) {
+      AddUnique(&partial, symbol);
+    } else {
+      merged_not_found.emplace_back(symbol);
+    }
+  }
+  for (const auto& symbol : other.not_found) {
+    // Found in `this`
+    if (Contains(symbols, symbol) && !Contains(not_found, symbol)) {
+      AddUnique(&partial, symbol);
+    } else {
+      AddUnique(&merged_not_found, symbol);
+    }
+  }
+  not_found = std::move(merged_not_found);
+  for (const auto& symbol : other.partial) {
+    AddUnique(&partial, symbol);
+  }
+  for (const auto& symbol : other.symbols) {
+    AddUnique(&symbols, symbol);
+  }
+  for (const auto& other_mapping : other.mappings) {
+    auto mapping_it = std::find_if(
+        mappings.begin(), mappings.end(), [&other_mapping](const auto& m) {
+          return m.raw_symbol == other_mapping.raw_symbol;
+        });
+    if (mapping_it == mappings.end()) {
+      mappings.emplace_back(other_mapping);
+      continue;
+    }
+    auto& intervals = mapping_it->intervals;
+    intervals.insert(intervals.end(), other_mapping.intervals.begin(),
+                     other_mapping.intervals.end());
+    std::sort(intervals.begin(), intervals.end(),
+              [](const MappingInterval& lhs, const MappingInterval& rhs) {
+                return lhs.start_date < rhs.start_date;
+              });
+    // Coalesce overlapping and adjacent intervals with the same symbol, such
+    // as the same day reported by two time slices
+    std::vector<MappingInterval> merged_intervals;
+    for (auto& interval : intervals) {
+      if (!merged_intervals.empty() &&
+          merged_intervals.back().symbol == interval.symbol &&
+          merged_intervals.back().end_date >= interval.start_date) {
+        if (interval.end_date > merged_intervals.back().end_date) {
+          merged_intervals.back().end_date = interval.end_date;
+        }
+      } else {
+        merged_intervals.emplace_back(std::move(interval));
+      }
+    }
+    intervals = std::move(merged_intervals);
+  }
+}
+
 std::string ToString(const Metadata& metadata) { return MakeString(metadata); }
 std::ostream& operator<<(std::ostream& stream, const Metadata& metadata) {
   auto helper = StreamOpBuilder{stream}
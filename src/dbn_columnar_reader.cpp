@@ -0,0 +1,183 @@
+#include "databento/dbn_columnar_reader.hpp"
+
+#include <utility>  // move
+
+#include "databento/enums.hpp"  // VersionUpgradePolicy
+#include "databento/exceptions.hpp"
+#include "databento/file_stream.hpp"
+
+using databento::DbnColumnarReader;
+using databento::MboColumns;
+using databento::Mbp1Columns;
+using databento::OhlcvColumns;
+using databento::TradeColumns;
+
+namespace {
+template <typename C>
+void ClearColumns(C* columns) {
+  C::ForEachColumn(*columns, [](const char*, auto& column) { column.clear(); });
+}
+
+template <typename C>
+void ReserveColumns(std::size_t capacity, C* columns) {
+  C::ForEachColumn(*columns, [capacity](const char*, auto& column) {
+    column.reserve(capacity);
+  });
+}
+}  // namespace
+
+void MboColumns::Clear() { ClearColumns(this); }
+
+void MboColumns::Reserve(std::size_t capacity) {
+  ReserveColumns(capacity, this);
+}
+
+void MboColumns::Append(const MboMsg& mbo) {
+  publisher_id.emplace_back(mbo.hd.publisher_id);
+  instrument_id.emplace_back(mbo.hd.instrument_id);
+  ts_event.emplace_back(mbo.hd.ts_event);
+  order_id.emplace_back(mbo.order_id);
+  price.emplace_back(mbo.price);
+  size.emplace_back(mbo.size);
+  flags.emplace_back(mbo.flags);
+  channel_id.emplace_back(mbo.channel_id);
+  action.emplace_back(mbo.action);
+  side.emplace_back(mbo.side);
+  ts_recv.emplace_back(mbo.ts_recv);
+  ts_in_delta.emplace_back(mbo.ts_in_delta);
+  sequence.emplace_back(mbo.sequence);
+}
+
+void TradeColumns::Clear() { ClearColumns(this); }
+
+void TradeColumns::Reserve(std::size_t capacity) {
+  ReserveColumns(capacity, this);
+}
+
+void TradeColumns::Append(const TradeMsg& trade) {
+  publisher_id.emplace_back(trade.hd.publisher_id);
+  instrument_id.emplace_back(trade.hd.instrument_id);
+  ts_event.emplace_back(trade.hd.ts_event);
+  price.emplace_back(trade.price);
+  size.emplace_back(trade.size);
+  action.emplace_back(trade.action);
+  side.emplace_back(trade.side);
+  flags.emplace_back(trade.flags);
+  depth.emplace_back(trade.depth);
+  ts_recv.emplace_back(trade.ts_recv);
+  ts_in_delta.emplace_back(trade.ts_in_delta);
+  sequence.emplace_back(trade.sequence);
+}
+
+void Mbp1Columns::Clear() { ClearColumns(this); }
+
+void Mbp1Columns::Reserve(std::size_t capacity) {
+  ReserveColumns(capacity, this);
+}
+
+void Mbp1Columns::Append(const Mbp1Msg& mbp1) {
+  publisher_id.emplace_back(mbp1.hd.publisher_id);
+  instrument_id.emplace_back(mbp1.hd.instrument_id);
+  ts_event.emplace_back(mbp1.hd.ts_event);
+  price.emplace_back(mbp1.price);
+  size.emplace_back(mbp1.size);
+  action.emplace_back(mbp1.action);
+  side.emplace_back(mbp1.side);
+  flags.emplace_back(mbp1.flags);
+  depth.emplace_back(mbp1.depth);
+  ts_recv.emplace_back(mbp1.ts_recv);
+  ts_in_delta.emplace_back(mbp1.ts_in_delta);
+  sequence.emplace_back(mbp1.sequence);
+  const auto& level = mbp1.levels[0];
+  bid_px.emplace_back(level.bid_px);
+  ask_px.emplace_back(level.ask_px);
+  bid_sz.emplace_back(level.bid_sz);
+  ask_sz.emplace_back(level.ask_sz);
+  bid_ct.emplace_back(level.bid_ct);
+  ask_ct.emplace_back(level.ask_ct);
+}
+
+void OhlcvColumns::Clear() { ClearColumns(this); }
+
+void OhlcvColumns::Reserve(std::size_t capacity) {
+  ReserveColumns(capacity, this);
+}
+
+void OhlcvColumns::Append(const OhlcvMsg& ohlcv) {
+  publisher_id.emplace_back(ohlcv.hd.publisher_id);
+  instrument_id.emplace_back(ohlcv.hd.instrument_id);
+  ts_event.emplace_back(ohlcv.hd.ts_event);
+  open.emplace_back(ohlcv.open);
+  high.emplace_back(ohlcv.high);
+  low.emplace_back(ohlcv.low);
+  close.emplace_back(ohlcv.close);
+  volume.emplace_back(ohlcv.volume);
+}
+
+DbnColumnarReader::DbnColumnarReader(ILogReceiver* log_receiver,
+                                     const std::string& file_path,
+                                     std::size_t chunk_size)
+    : DbnColumnarReader{log_receiver,
+                        std::unique_ptr<IReadable>{new InFileStream{file_path}},
+                        chunk_size} {}
+
+DbnColumnarReader::DbnColumnarReader(ILogReceiver* log_receiver,
+                                     std::unique_ptr<IReadable> input,
+                                     std::size_t chunk_size)
+    // The supported record types are the same in every DBN version
+    : decoder_{log_receiver, std::move(input),
+               VersionUpgradePolicy::UpgradeToV2},
+      chunk_size_{chunk_size} {
+  if (chunk_size == 0) {
+    throw InvalidArgumentError{"DbnColumnarReader::DbnColumnarReader",
+                               "chunk_size", "Must be greater than 0"};
+  }
+}
+
+const databento::Metadata& DbnColumnarReader::GetMetadata() {
+  MaybeDecodeMetadata();
+  return metadata_;
+}
+
+template <typename R, typename C>
+bool DbnColumnarReader::FillChunk(C* columns) {
+  MaybeDecodeMetadata();
+  columns->Clear();
+  // No-op after the first chunk
+  columns->Reserve(chunk_size_);
+  while (columns->Size() < chunk_size_) {
+    const auto& records = decoder_.DecodeRecords(chunk_size_ - columns->Size());
+    if (records.empty()) {
+      break;
+    }
+    for (const auto& record : records) {
+      if (const auto* rec = record.template GetIf<R>()) {
+        columns->Append(*rec);
+      }
+    }
+  }
+  return columns->Size() > 0;
+}
+
+bool DbnColumnarReader::NextChunk(MboColumns* columns) {
+  return FillChunk<MboMsg>(columns);
+}
+
+bool DbnColumnarReader::NextChunk(TradeColumns* columns) {
+  return FillChunk<TradeMsg>(columns);
+}
+
+bool DbnColumnarReader::NextChunk(Mbp1Columns* columns) {
+  return FillChunk<Mbp1Msg>(columns);
+}
+
+bool DbnColumnarReader::NextChunk(OhlcvColumns* columns) {
+  return FillChunk<OhlcvMsg>(columns);
+}
+
+void DbnColumnarReader::MaybeDecodeMetadata() {
+  if (!has_decoded_metadata_) {
+    metadata_ = decoder_.DecodeMetadata();
+    has_decoded_metadata_ = true;
+  }
+}
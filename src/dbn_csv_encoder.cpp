@@ -0,0 +1,685 @@
+#include "databento/dbn_csv_encoder.hpp"
+
+#include <algorithm>  // max, min
+#include <array>
+#include <cstdint>
+#include <cstring>  // memcpy, strnlen
+#include <exception>
+#include <string>
+#include <type_traits>  // is_enum, is_same, is_signed, underlying_type_t
+
+#include "databento/constants.hpp"  // kUndefPrice, kUndefTimestamp
+#include "databento/datetime.hpp"   // kIso8601Len, ToIso8601, UnixNanos
+#include "databento/dbn.hpp"        // Metadata
+#include "databento/detail/scoped_thread.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/fixed_price.hpp"  // FixPx, kMaxFixPxLen, ToChars
+#include "databento/flag_set.hpp"
+#include "databento/record_visit.hpp"  // Record::Visit
+#include "text_format.hpp"
+
+using databento::DbnCsvEncoder;
+
+namespace {
+// Large enough for a line of any supported schema, the longest being
+// definitions with every string quoted
+constexpr std::size_t kMaxLineLen = 4096;
+// Buffered output is written once it reaches this size
+constexpr std::size_t kFlushThreshold = 64 * 1024;
+// Blocks smaller than this aren't worth the overhead of another thread
+constexpr std::size_t kMinBlockLen = 1024;
+
+using databento::detail::WriteInt;
+using databento::detail::WriteUInt;
+
+// Writes the fields of a single line, each followed by a comma.
+class CsvLineWriter {
+ public:
+  CsvLineWriter(bool pretty_px, bool pretty_ts, char* out)
+      : pretty_px_{pretty_px}, pretty_ts_{pretty_ts}, out_{out} {}
+
+  template <typename T>
+  void Field(T value) {
+    if constexpr (std::is_enum<T>::value) {
+      Field(static_cast<std::underlying_type_t<T>>(value));
+      return;
+    } else if constexpr (std::is_same<T, char>::value) {
+      if (value != 0) {
+        *out_++ = value;
+      }
+    } else if constexpr (std::is_signed<T>::value) {
+      out_ = WriteInt(out_, value);
+    } else {
+      out_ = WriteUInt(out_, value);
+    }
+    *out_++ = ',';
+  }
+  void Field(databento::UnixNanos value) {
+    if (!pretty_ts_) {
+      Field(value.time_since_epoch().count());
+      return;
+    }
+    if (value.time_since_epoch().count() != databento::kUndefTimestamp) {
+      out_ = databento::ToIso8601(out_, out_ + databento::kIso8601Len, value)
+                 .ptr;
+    }
+    *out_++ = ',';
+  }
+  void Field(databento::TimeDeltaNanos value) { Field(value.count()); }
+  void Field(databento::FlagSet value) { Field(value.Raw()); }
+  // Writes a null-terminated string of at most `max_len` characters, quoted
+  // if it contains a separator, quote, or line break.
+  void String(const char* str, std::size_t max_len) {
+    const auto len = ::strnlen(str, max_len);
+    bool needs_quotes{};
+    for (std::size_t i = 0; i < len; ++i) {
+      const auto c = str[i];
+      if (c == ',' || c == '"' || c == '\n' || c == '\r') {
+        needs_quotes = true;
+        break;
+      }
+    }
+    if (needs_quotes) {
+      *out_++ = '"';
+      for (std::size_t i = 0; i < len; ++i) {
+        if (str[i] == '"') {
+          *out_++ = '"';
+        }
+        *out_++ = str[i];
+      }
+      *out_++ = '"';
+    } else {
+      std::memcpy(out_, str, len);
+      out_ += len;
+    }
+    *out_++ = ',';
+  }
+  template <std::size_t N>
+  void String(const std::array<char, N>& str) {
+    String(str.data(), N);
+  }
+  void Empty() { *out_++ = ','; }
+  void Px(std::int64_t px) {
+    if (!pretty_px_) {
+      Field(px);
+      return;
+    }
+    if (px != databento::kUndefPrice) {
+      out_ = databento::ToChars(out_, out_ + databento::kMaxFixPxLen,
+                              databento::FixPx{px})
+                 .ptr;
+    }
+    *out_++ = ',';
+  }
+  template <typename R>
+  void Header(const R& rec) {
+    Field(rec.hd.rtype);
+    Field(rec.hd.publisher_id);
+    Field(rec.hd.instrument_id);
+  }
+  template <typename L>
+  void Level(const L& level) {
+    Px(level.bid_px);
+    Px(level.ask_px);
+    Field(level.bid_sz);
+    Field(level.ask_sz);
+    Field(level.bid_ct);
+    Field(level.ask_ct);
+  }
+  void ConsolidatedLevel(const databento::ConsolidatedBidAskPair& level) {
+    Px(level.bid_px);
+    Px(level.ask_px);
+    Field(level.bid_sz);
+    Field(level.ask_sz);
+    Field(level.bid_pb);
+    Field(level.ask_pb);
+  }
+  // Replaces the trailing comma with a newline.
+  char* EndLine() {
+    *(out_ - 1) = '\n';
+    return out_;
+  }
+
+ private:
+  const bool pretty_px_;
+  const bool pretty_ts_;
+  char* out_;
+};
+
+void WriteFields(CsvLineWriter& writer, const databento::MboMsg& rec) {
+  writer.Field(rec.ts_recv);
+  writer.Field(rec.hd.ts_event);
+  writer.Header(rec);
+  writer.Field(rec.action);
+  writer.Field(rec.side);
+  writer.Px(rec.price);
+  writer.Field(rec.size);
+  writer.Field(rec.channel_id);
+  writer.Field(rec.order_id);
+  writer.Field(rec.flags);
+  writer.Field(rec.ts_in_delta);
+  writer.Field(rec.sequence);
+}
+
+void WriteFields(CsvLineWriter& writer, const databento::TradeMsg& rec) {
+  writer.Field(rec.ts_recv);
+  writer.Field(rec.hd.ts_event);
+  writer.Header(rec);
+  writer.Field(rec.action);
+  writer.Field(rec.side);
+  writer.Field(rec.depth);
+  writer.Px(rec.price);
+  writer.Field(rec.size);
+  writer.Field(rec.flags);
+  writer.Field(rec.ts_in_delta);
+  writer.Field(rec.sequence);
+}
+
+template <typename R>
+void WriteMbpFields(CsvLineWriter& writer, const R& rec) {
+  writer.Field(rec.ts_recv);
+  writer.Field(rec.hd.ts_event);
+  writer.Header(rec);
+  writer.Field(rec.action);
+  writer.Field(rec.side);
+  writer.Field(rec.depth);
+  writer.Px(rec.price);
+  writer.Field(rec.size);
+  writer.Field(rec.flags);
+  writer.Field(rec.ts_in_delta);
+  writer.Field(rec.sequence);
+  for (const auto& level : rec.levels) {
+    writer.Level(level);
+  }
+}
+
+void WriteFields(CsvLineWriter& writer, const databento::Mbp1Msg& rec) {
+  WriteMbpFields(writer, rec);
+}
+
+void WriteFields(CsvLineWriter& writer, const databento::Mbp10Msg& rec) {
+  WriteMbpFields(writer, rec);
+}
+
+void WriteFields(CsvLineWriter& writer, const databento::BboMsg& rec) {
+  writer.Field(rec.ts_recv);
+  writer.Field(rec.hd.ts_event);
+  writer.Header(rec);
+  writer.Field(rec.side);
+  writer.Px(rec.price);
+  writer.Field(rec.size);
+  writer.Field(rec.flags);
+  writer.Field(rec.sequence);
+  writer.Level(rec.levels[0]);
+}
+
+void WriteFields(CsvLineWriter& writer, const databento::Cmbp1Msg& rec) {
+  writer.Field(rec.ts_recv);
+  writer.Field(rec.hd.ts_event);
+  writer.Header(rec);
+  writer.Field(rec.action);
+  writer.Field(rec.side);
+  writer.Px(rec.price);
+  writer.Field(rec.size);
+  writer.Field(rec.flags);
+  writer.Field(rec.ts_in_delta);
+  writer.ConsolidatedLevel(rec.levels[0]);
+}
+
+void WriteFields(CsvLineWriter& writer, const databento::CbboMsg& rec) {
+  writer.Field(rec.ts_recv);
+  writer.Field(rec.hd.ts_event);
+  writer.Header(rec);
+  writer.Field(rec.side);
+  writer.Px(rec.price);
+  writer.Field(rec.size);
+  writer.Field(rec.flags);
+  writer.ConsolidatedLevel(rec.levels[0]);
+}
+
+void WriteFields(CsvLineWriter& writer, const databento::OhlcvMsg& rec) {
+  writer.Field(rec.hd.ts_event);
+  writer.Header(rec);
+  writer.Px(rec.open);
+  writer.Px(rec.high);
+  writer.Px(rec.low);
+  writer.Px(rec.close);
+  writer.Field(rec.volume);
+}
+
+void WriteFields(CsvLineWriter& writer, const databento::StatusMsg& rec) {
+  writer.Field(rec.ts_recv);
+  writer.Field(rec.hd.ts_event);
+  writer.Header(rec);
+  writer.Field(rec.action);
+  writer.Field(rec.reason);
+  writer.Field(rec.trading_event);
+  writer.Field(rec.is_trading);
+  writer.Field(rec.is_quoting);
+  writer.Field(rec.is_short_sell_restricted);
+}
+
+void WriteFields(CsvLineWriter& writer,
+                 const databento::InstrumentDefMsg& rec) {
+  writer.Field(rec.ts_recv);
+  writer.Field(rec.hd.ts_event);
+  writer.Header(rec);
+  writer.String(rec.raw_symbol);
+  writer.Field(rec.security_update_action);
+  writer.Field(rec.instrument_class);
+  writer.Px(rec.min_price_increment);
+  writer.Px(rec.display_factor);
+  writer.Field(rec.expiration);
+  writer.Field(rec.activation);
+  writer.Px(rec.high_limit_price);
+  writer.Px(rec.low_limit_price);
+  writer.Px(rec.max_price_variation);
+  writer.Px(rec.trading_reference_price);
+  writer.Px(rec.unit_of_measure_qty);
+  writer.Px(rec.min_price_increment_amount);
+  writer.Px(rec.price_ratio);
+  writer.Px(rec.strike_price);
+  writer.Field(rec.inst_attrib_value);
+  writer.Field(rec.underlying_id);
+  writer.Field(rec.raw_instrument_id);
+  writer.Field(rec.market_depth_implied);
+  writer.Field(rec.market_depth);
+  writer.Field(rec.market_segment_id);
+  writer.Field(rec.max_trade_vol);
+  writer.Field(rec.min_lot_size);
+  writer.Field(rec.min_lot_size_block);
+  writer.Field(rec.min_lot_size_round_lot);
+  writer.Field(rec.min_trade_vol);
+  writer.Field(rec.contract_multiplier);
+  writer.Field(rec.decay_quantity);
+  writer.Field(rec.original_contract_size);
+  writer.Field(rec.trading_reference_date);
+  writer.Field(rec.appl_id);
+  writer.Field(rec.maturity_year);
+  writer.Field(rec.decay_start_date);
+  writer.Field(rec.channel_id);
+  writer.String(rec.currency);
+  writer.String(rec.settl_currency);
+  writer.String(rec.secsubtype);
+  writer.String(rec.group);
+  writer.String(rec.exchange);
+  writer.String(rec.asset);
+  writer.String(rec.cfi);
+  writer.String(rec.security_type);
+  writer.String(rec.unit_of_measure);
+  writer.String(rec.underlying);
+  writer.String(rec.strike_price_currency);
+  writer.Field(rec.match_algorithm);
+  writer.Field(rec.md_security_trading_status);
+  writer.Field(rec.main_fraction);
+  writer.Field(rec.price_display_format);
+  writer.Field(rec.settl_price_type);
+  writer.Field(rec.sub_fraction);
+  writer.Field(rec.underlying_product);
+  writer.Field(rec.maturity_month);
+  writer.Field(rec.maturity_day);
+  writer.Field(rec.maturity_week);
+  writer.Field(rec.user_defined_instrument);
+  writer.Field(rec.contract_multiplier_unit);
+  writer.Field(rec.flow_schedule_type);
+  writer.Field(rec.tick_rule);
+}
+
+void WriteFields(CsvLineWriter& writer, const databento::ImbalanceMsg& rec) {
+  writer.Field(rec.ts_recv);
+  writer.Field(rec.hd.ts_event);
+  writer.Header(rec);
+  writer.Px(rec.ref_price);
+  writer.Field(rec.auction_time);
+  writer.Px(rec.cont_book_clr_price);
+  writer.Px(rec.auct_interest_clr_price);
+  writer.Px(rec.ssr_filling_price);
+  writer.Px(rec.ind_match_price);
+  writer.Px(rec.upper_collar);
+  writer.Px(rec.lower_collar);
+  writer.Field(rec.paired_qty);
+  writer.Field(rec.total_imbalance_qty);
+  writer.Field(rec.market_imbalance_qty);
+  writer.Field(rec.unpaired_qty);
+  writer.Field(rec.auction_type);
+  writer.Field(rec.side);
+  writer.Field(rec.auction_status);
+  writer.Field(rec.freeze_status);
+  writer.Field(rec.num_extensions);
+  writer.Field(rec.unpaired_side);
+  writer.Field(rec.significant_imbalance);
+}
+
+void WriteFields(CsvLineWriter& writer, const databento::StatMsg& rec) {
+  writer.Field(rec.ts_recv);
+  writer.Field(rec.hd.ts_event);
+  writer.Header(rec);
+  writer.Field(rec.ts_ref);
+  writer.Px(rec.price);
+  writer.Field(rec.quantity);
+  writer.Field(rec.sequence);
+  writer.Field(rec.ts_in_delta);
+  writer.Field(rec.stat_type);
+  writer.Field(rec.channel_id);
+  writer.Field(rec.update_action);
+  writer.Field(rec.stat_flags);
+}
+
+using EncodeLineFn = char* (*)(const databento::Record& record,
+                               bool pretty_px, bool pretty_ts, bool ts_out,
+                               char* out);
+
+template <typename R>
+char* EncodeLine(const databento::Record& record, bool pretty_px,
+                 bool pretty_ts, bool ts_out, char* out) {
+  char* end = out;
+  // Visited rather than checking the rtype so definitions of other DBN
+  // versions are skipped
+  record.Visit([&record, pretty_px, pretty_ts, ts_out, out,
+                &end](const R& rec) {
+    CsvLineWriter writer{pretty_px, pretty_ts, out};
+    WriteFields(writer, rec);
+    if (ts_out) {
+      if (record.Size() >= sizeof(databento::WithTsOut<R>)) {
+        writer.Field(
+            reinterpret_cast<const databento::WithTsOut<R>&>(rec).ts_out);
+      } else {
+        writer.Empty();
+      }
+    }
+    end = writer.EndLine();
+  });
+  return end;
+}
+
+std::string LevelsHeader(std::size_t level_count, const char* count_field) {
+  std::string header;
+  for (std::size_t i = 0; i < level_count; ++i) {
+    const std::string suffix = (i < 10 ? "_0" : "_") + std::to_string(i);
+    header += ",bid_px" + suffix + ",ask_px" + suffix + ",bid_sz" + suffix +
+              ",ask_sz" + suffix + ",bid_" + count_field + suffix + ",ask_" +
+              count_field + suffix;
+  }
+  return header;
+}
+
+std::string Header(databento::Schema schema) {
+  using databento::Schema;
+  constexpr auto kMbpFields =
+      "ts_recv,ts_event,rtype,publisher_id,instrument_id,action,side,depth,"
+      "price,size,flags,ts_in_delta,sequence";
+  switch (schema) {
+    case Schema::Mbo: {
+      return "ts_recv,ts_event,rtype,publisher_id,instrument_id,action,side,"
+             "price,size,channel_id,order_id,flags,ts_in_delta,sequence";
+    }
+    case Schema::Trades: {
+      return kMbpFields;
+    }
+    case Schema::Mbp1:  // fallthrough
+    case Schema::Tbbo: {
+      return kMbpFields + LevelsHeader(1, "ct");
+    }
+    case Schema::Mbp10: {
+      return kMbpFields + LevelsHeader(10, "ct");
+    }
+    case Schema::Bbo1S:  // fallthrough
+    case Schema::Bbo1M: {
+      return "ts_recv,ts_event,rtype,publisher_id,instrument_id,side,price,"
+             "size,flags,sequence" +
+             LevelsHeader(1, "ct");
+    }
+    case Schema::Cmbp1:  // fallthrough
+    case Schema::Tcbbo: {
+      return "ts_recv,ts_event,rtype,publisher_id,instrument_id,action,side,"
+             "price,size,flags,ts_in_delta" +
+             LevelsHeader(1, "pb");
+    }
+    case Schema::Cbbo1S:  // fallthrough
+    case Schema::Cbbo1M: {
+      return "ts_recv,ts_event,rtype,publisher_id,instrument_id,side,price,"
+             "size,flags" +
+             LevelsHeader(1, "pb");
+    }
+    case Schema::Ohlcv1S:  // fallthrough
+    case Schema::Ohlcv1M:  // fallthrough
+    case Schema::Ohlcv1H:  // fallthrough
+    case Schema::Ohlcv1D: {
+      return "ts_event,rtype,publisher_id,instrument_id,open,high,low,close,"
+             "volume";
+    }
+    case Schema::Status: {
+      return "ts_recv,ts_event,rtype,publisher_id,instrument_id,action,reason,"
+             "trading_event,is_trading,is_quoting,is_short_sell_restricted";
+    }
+    case Schema::Imbalance: {
+      return "ts_recv,ts_event,rtype,publisher_id,instrument_id,ref_price,"
+             "auction_time,cont_book_clr_price,auct_interest_clr_price,"
+             "ssr_filling_price,ind_match_price,upper_collar,lower_collar,"
+             "paired_qty,total_imbalance_qty,market_imbalance_qty,"
+             "unpaired_qty,auction_type,side,auction_status,freeze_status,"
+             "num_extensions,unpaired_side,significant_imbalance";
+    }
+    case Schema::Statistics: {
+      return "ts_recv,ts_event,rtype,publisher_id,instrument_id,ts_ref,price,"
+             "quantity,sequence,ts_in_delta,stat_type,channel_id,"
+             "update_action,stat_flags";
+    }
+    case Schema::Definition: {
+      return "ts_recv,ts_event,rtype,publisher_id,instrument_id,raw_symbol,"
+             "security_update_action,instrument_class,min_price_increment,"
+             "display_factor,expiration,activation,high_limit_price,"
+             "low_limit_price,max_price_variation,trading_reference_price,"
+             "unit_of_measure_qty,min_price_increment_amount,price_ratio,"
+             "strike_price,inst_attrib_value,underlying_id,raw_instrument_id,"
+             "market_depth_implied,market_depth,market_segment_id,"
+             "max_trade_vol,min_lot_size,min_lot_size_block,"
+             "min_lot_size_round_lot,min_trade_vol,contract_multiplier,"
+             "decay_quantity,original_contract_size,trading_reference_date,"
+             "appl_id,maturity_year,decay_start_date,channel_id,currency,"
+             "settl_currency,secsubtype,group,exchange,asset,cfi,"
+             "security_type,unit_of_measure,underlying,strike_price_currency,"
+             "match_algorithm,md_security_trading_status,main_fraction,"
+             "price_display_format,settl_price_type,sub_fraction,"
+             "underlying_product,maturity_month,maturity_day,maturity_week,"
+             "user_defined_instrument,contract_multiplier_unit,"
+             "flow_schedule_type,tick_rule";
+    }
+    default: {
+      throw databento::InvalidArgumentError{
+          "DbnCsvEncoder::DbnCsvEncoder", "schema",
+          std::string{"Unsupported schema "} + databento::ToString(schema)};
+    }
+  }
+}
+
+databento::Schema SingleSchema(const databento::Metadata& metadata) {
+  if (metadata.has_mixed_schema) {
+    throw databento::InvalidArgumentError{"DbnCsvEncoder::DbnCsvEncoder",
+                                          "metadata",
+                                          "Can't encode mixed schemas"};
+  }
+  return metadata.schema;
+}
+
+EncodeLineFn EncodeLineFnForSchema(databento::Schema schema) {
+  using databento::Schema;
+  switch (schema) {
+    case Schema::Mbo: {
+      return &EncodeLine<databento::MboMsg>;
+    }
+    case Schema::Trades: {
+      return &EncodeLine<databento::TradeMsg>;
+    }
+    case Schema::Mbp1:  // fallthrough
+    case Schema::Tbbo: {
+      return &EncodeLine<databento::Mbp1Msg>;
+    }
+    case Schema::Mbp10: {
+      return &EncodeLine<databento::Mbp10Msg>;
+    }
+    case Schema::Bbo1S:  // fallthrough
+    case Schema::Bbo1M: {
+      return &EncodeLine<databento::BboMsg>;
+    }
+    case Schema::Cmbp1:  // fallthrough
+    case Schema::Tcbbo: {
+      return &EncodeLine<databento::Cmbp1Msg>;
+    }
+    case Schema::Cbbo1S:  // fallthrough
+    case Schema::Cbbo1M: {
+      return &EncodeLine<databento::CbboMsg>;
+    }
+    case Schema::Ohlcv1S:  // fallthrough
+    case Schema::Ohlcv1M:  // fallthrough
+    case Schema::Ohlcv1H:  // fallthrough
+    case Schema::Ohlcv1D: {
+      return &EncodeLine<databento::OhlcvMsg>;
+    }
+    case Schema::Status: {
+      return &EncodeLine<databento::StatusMsg>;
+    }
+    case Schema::Imbalance: {
+      return &EncodeLine<databento::ImbalanceMsg>;
+    }
+    case Schema::Statistics: {
+      return &EncodeLine<databento::StatMsg>;
+    }
+    case Schema::Definition: {
+      return &EncodeLine<databento::InstrumentDefMsg>;
+    }
+    default: {
+      throw databento::InvalidArgumentError{
+          "DbnCsvEncoder::DbnCsvEncoder", "schema",
+          std::string{"Unsupported schema "} + databento::ToString(schema)};
+    }
+  }
+}
+}  // namespace
+
+DbnCsvEncoder::DbnCsvEncoder(ILogReceiver* log_receiver, Schema schema,
+                             IWritable* output)
+    : DbnCsvEncoder{log_receiver, schema, output, false, false} {}
+
+DbnCsvEncoder::DbnCsvEncoder(ILogReceiver* log_receiver, Schema schema,
+                             IWritable* output, bool pretty_px, bool pretty_ts)
+    : DbnCsvEncoder{log_receiver, schema, output, pretty_px, pretty_ts, false} {
+}
+
+DbnCsvEncoder::DbnCsvEncoder(ILogReceiver* log_receiver,
+                             const Metadata& metadata, IWritable* output,
+                             bool pretty_px, bool pretty_ts)
+    : DbnCsvEncoder{log_receiver, SingleSchema(metadata), output, pretty_px,
+                    pretty_ts, metadata.ts_out} {}
+
+DbnCsvEncoder::DbnCsvEncoder(ILogReceiver* log_receiver, Schema schema,
+                             IWritable* output, bool pretty_px, bool pretty_ts,
+                             bool ts_out)
+    : log_receiver_{log_receiver},
+      output_{output},
+      pretty_px_{pretty_px},
+      pretty_ts_{pretty_ts},
+      ts_out_{ts_out},
+      encode_line_{EncodeLineFnForSchema(schema)} {
+  const auto header = Header(schema) + (ts_out ? ",ts_out\n" : "\n");
+  buffer_.data.resize(std::max(kFlushThreshold, header.size()) + kMaxLineLen);
+  std::memcpy(buffer_.data.data(), header.data(), header.size());
+  buffer_.size = header.size();
+}
+
+DbnCsvEncoder::~DbnCsvEncoder() {
+  try {
+    Flush();
+  } catch (const std::exception& exc) {
+    if (log_receiver_) {
+      log_receiver_->Receive(
+          LogLevel::Error,
+          std::string{"Error flushing CSV output: "} + exc.what());
+    }
+  }
+}
+
+void DbnCsvEncoder::EncodeRecord(const Record& record) {
+  EncodeLine(record, &buffer_);
+  if (buffer_.size >= kFlushThreshold) {
+    Flush();
+  }
+}
+
+void DbnCsvEncoder::EncodeRecords(const std::vector<Record>& records) {
+  EncodeBlock(records.cbegin(), records.cend(), &buffer_, true);
+}
+
+void DbnCsvEncoder::EncodeRecords(const std::vector<Record>& records,
+                                  std::size_t thread_count) {
+  if (thread_count == 0) {
+    throw InvalidArgumentError{"DbnCsvEncoder::EncodeRecords", "thread_count",
+                               "Must be greater than 0"};
+  }
+  const auto block_count =
+      std::min(thread_count, records.size() / kMinBlockLen);
+  if (block_count <= 1) {
+    EncodeRecords(records);
+    return;
+  }
+  const auto block_len = (records.size() + block_count - 1) / block_count;
+  thread_blocks_.resize(block_count - 1);
+  {
+    std::vector<detail::ScopedThread> threads;
+    threads.reserve(block_count - 1);
+    for (std::size_t i = 1; i < block_count; ++i) {
+      const auto first = records.cbegin() + static_cast<std::ptrdiff_t>(
+                                                std::min(i * block_len,
+                                                         records.size()));
+      const auto last =
+          records.cbegin() + static_cast<std::ptrdiff_t>(
+                                 std::min((i + 1) * block_len, records.size()));
+      Block* block = &thread_blocks_[i - 1];
+      block->size = 0;
+      threads.emplace_back([this, first, last, block] {
+        EncodeBlock(first, last, block, false);
+      });
+    }
+    // The first block is formatted on this thread and can be written to the
+    // output while the others are still being formatted
+    EncodeBlock(records.cbegin(),
+                records.cbegin() + static_cast<std::ptrdiff_t>(block_len),
+                &buffer_, true);
+  }
+  Flush();
+  for (const auto& block : thread_blocks_) {
+    output_->WriteAll(reinterpret_cast<const std::uint8_t*>(block.data.data()),
+                      block.size);
+  }
+}
+
+void DbnCsvEncoder::Flush() {
+  if (buffer_.size == 0) {
+    return;
+  }
+  output_->WriteAll(reinterpret_cast<const std::uint8_t*>(buffer_.data.data()),
+                    buffer_.size);
+  buffer_.size = 0;
+}
+
+void DbnCsvEncoder::EncodeBlock(std::vector<Record>::const_iterator first,
+                                std::vector<Record>::const_iterator last,
+                                Block* block, bool can_flush) {
+  for (; first != last; ++first) {
+    EncodeLine(*first, block);
+    if (can_flush && block->size >= kFlushThreshold) {
+      Flush();
+    }
+  }
+}
+
+void DbnCsvEncoder::EncodeLine(const Record& record, Block* block) {
+  if (block->data.size() - block->size < kMaxLineLen) {
+    block->data.resize(std::max(block->data.size() * 2,
+                                block->size + kFlushThreshold + kMaxLineLen));
+  }
+  char* const start = block->data.data() + block->size;
+  char* const end =
+      encode_line_(record, pretty_px_, pretty_ts_, ts_out_, start);
+  block->size += static_cast<std::size_t>(end - start);
+}
@@ -2,13 +2,16 @@
 
 #include <date/date.h>
 
-#include <algorithm>  // copy
+#include <algorithm>  // copy, min
+#include <cstdint>    // uintptr_t
 #include <cstring>    // strncmp
+#include <limits>     // numeric_limits
 #include <vector>
 
 #include "databento/compat.hpp"
 #include "databento/constants.hpp"
 #include "databento/datetime.hpp"
+#include "databento/detail/prefetch_stream.hpp"
 #include "databento/detail/zstd_stream.hpp"
 #include "databento/enums.hpp"
 #include "databento/exceptions.hpp"
@@ -60,6 +63,20 @@ date::year_month_day DecodeIso8601Date(std::uint32_t yyyymmdd_int) {
   return {date::year{static_cast<std::int32_t>(year)}, date::month{month},
           date::day{day}};
 }
+
+std::size_t CheckBufferSize(std::size_t buffer_size) {
+  // Every record must fit in the buffer
+  constexpr auto kMaxEncodableRecordLen =
+      std::size_t{std::numeric_limits<std::uint8_t>::max()} *
+      databento::RecordHeader::kLengthMultiplier;
+  if (buffer_size < kMaxEncodableRecordLen) {
+    throw databento::InvalidArgumentError{
+        "DbnDecoder::DbnDecoder", "buffer_size",
+        "Must be at least " + std::to_string(kMaxEncodableRecordLen) +
+            " bytes"};
+  }
+  return buffer_size;
+}
 }  // namespace
 
 DbnDecoder::DbnDecoder(ILogReceiver* log_receiver,
@@ -80,14 +97,25 @@ DbnDecoder::DbnDecoder(ILogReceiver* log_receiver,
 DbnDecoder::DbnDecoder(ILogReceiver* log_receiver,
                        std::unique_ptr<IReadable> input,
                        VersionUpgradePolicy upgrade_policy)
+    : DbnDecoder(log_receiver, std::move(input),
+                 DbnDecoderOptions{upgrade_policy, 0, 0, nullptr}) {}
+
+DbnDecoder::DbnDecoder(ILogReceiver* log_receiver,
+                       std::unique_ptr<IReadable> input,
+                       const DbnDecoderOptions& options)
     : log_receiver_{log_receiver},
-      upgrade_policy_{upgrade_policy},
-      input_{std::move(input)} {
+      upgrade_policy_{options.upgrade_policy},
+      prefetch_block_count_{options.prefetch_block_count},
+      input_{std::move(input)},
+      record_buffer_{CheckBufferSize(
+          options.buffer_size == 0 ? kBufferCapacity : options.buffer_size)} {
   read_buffer_.reserve(kBufferCapacity);
   if (DetectCompression()) {
-    input_ =
-        std::unique_ptr<detail::ZstdDecodeStream>(new detail::ZstdDecodeStream(
-            std::move(input_), std::move(read_buffer_)));
+    std::unique_ptr<detail::ZstdDecodeStream> zstd_input{
+        new detail::ZstdDecodeStream(std::move(input_), std::move(read_buffer_),
+                                     options.dictionaries)};
+    zstd_input->SetWindowLogMax(options.zstd_window_log_max);
+    input_ = std::move(zstd_input);
     // Reinitialize buffer and get it into the same state as uncompressed input
     read_buffer_ = std::vector<std::uint8_t>();
     read_buffer_.reserve(kBufferCapacity);
@@ -98,6 +126,15 @@ DbnDecoder::DbnDecoder(ILogReceiver* log_receiver,
       throw DbnResponseError{"Found Zstd input, but not DBN prefix"};
     }
   }
+  // Wrap after detecting compression so decompression also happens on the
+  // background thread
+  if (prefetch_block_count_ > 0) {
+    input_ = std::unique_ptr<IReadable>{new detail::PrefetchStream{
+        std::move(input_), record_buffer_.Capacity(), prefetch_block_count_}};
+  }
+  // Only set if the input is still an uncompressed mapping, otherwise the
+  // records must go through `record_buffer_`
+  mapped_input_ = dynamic_cast<MappedFileStream*>(input_.get());
 }
 
 std::pair<std::uint8_t, std::size_t> DbnDecoder::DecodeMetadataVersionAndSize(
@@ -197,9 +234,18 @@ databento::Metadata DbnDecoder::DecodeMetadata() {
   version_ = version_and_size.first;
   read_buffer_.resize(version_and_size.second);
   input_->ReadExact(read_buffer_.data(), read_buffer_.size());
-  buffer_idx_ = read_buffer_.size();
+  next_record_offset_ = kMetadataPreludeSize + read_buffer_.size();
   auto metadata = DbnDecoder::DecodeMetadataFields(version_, read_buffer_);
   ts_out_ = metadata.ts_out;
+  // Records are only aligned within the mapping when the metadata length is a
+  // multiple of 8 bytes, otherwise fall back to reading them into the aligned
+  // read buffer
+  if (mapped_input_ != nullptr &&
+      reinterpret_cast<std::uintptr_t>(mapped_input_->Peek()) %
+              alignof(RecordHeader) !=
+          0) {
+    mapped_input_ = nullptr;
+  }
   metadata.Upgrade(upgrade_policy_);
   return metadata;
 }
@@ -247,6 +293,21 @@ databento::Record DbnDecoder::DecodeRecordCompat(
 
 // assumes DecodeMetadata has been called
 const databento::Record* DbnDecoder::DecodeRecord() {
+  RecordHeader* header;
+  do {
+    header = mapped_input_ != nullptr ? ConsumeMappedRecord()
+                                      : ConsumeBufferedRecord();
+    if (header == nullptr) {
+      return nullptr;
+    }
+  } while (!filter_.Matches(*header));
+  current_record_ = DbnDecoder::DecodeRecordCompat(
+      version_, upgrade_policy_, ts_out_, &compat_buffer_, Record{header});
+  return &current_record_;
+}
+
+// The returned header remains valid until the buffer is next filled
+databento::RecordHeader* DbnDecoder::ConsumeBufferedRecord() {
   // need some unread unread_bytes
   if (GetReadBufferSize() == 0) {
     if (FillBuffer() == 0) {
@@ -265,32 +326,204 @@ const databento::Record* DbnDecoder::DecodeRecord() {
       return nullptr;
     }
   }
-  current_record_ = Record{BufferRecordHeader()};
-  buffer_idx_ += current_record_.Size();
-  current_record_ = DbnDecoder::DecodeRecordCompat(
-      version_, upgrade_policy_, ts_out_, &compat_buffer_, current_record_);
-  return &current_record_;
+  auto* header = BufferRecordHeader();
+  record_buffer_.Consume(header->Size());
+  next_record_offset_ += header->Size();
+  return header;
+}
+
+databento::RecordHeader* DbnDecoder::ConsumeMappedRecord() {
+  const auto remaining = mapped_input_->RemainingSize();
+  if (remaining == 0) {
+    return nullptr;
+  }
+  auto* header = reinterpret_cast<RecordHeader*>(mapped_input_->Peek());
+  const auto rec_size = header->Size();
+  if (remaining < rec_size) {
+    log_receiver_->Receive(LogLevel::Warning,
+                           "Unexpected partial record remaining in stream: " +
+                               std::to_string(remaining) + " bytes");
+    mapped_input_->Consume(remaining);
+    return nullptr;
+  }
+  mapped_input_->Consume(rec_size);
+  next_record_offset_ += rec_size;
+  return header;
+}
+
+// assumes DecodeMetadata has been called
+const std::vector<databento::Record>& DbnDecoder::DecodeRecords(
+    std::size_t max_count) {
+  return DecodeRecords(max_count, std::numeric_limits<std::uint64_t>::max());
+}
+
+// assumes DecodeMetadata has been called
+const std::vector<databento::Record>& DbnDecoder::DecodeRecords(
+    std::size_t max_count, std::uint64_t end_offset) {
+  record_batch_.clear();
+  if (max_count == 0 || next_record_offset_ >= end_offset) {
+    return record_batch_;
+  }
+  if (mapped_input_ != nullptr) {
+    BatchMappedRecords(max_count, end_offset);
+  } else {
+    // Every buffered record may have been filtered out
+    while (BatchBufferedRecords(max_count, end_offset) &&
+           record_batch_.empty() && next_record_offset_ < end_offset) {
+    }
+  }
+  // Upgrading is a no-op for all other versions and policies
+  if (version_ == 1 && upgrade_policy_ == VersionUpgradePolicy::UpgradeToV2) {
+    UpgradeBatch();
+  }
+  return record_batch_;
+}
+
+// Returns false once the end of the input has been reached
+bool DbnDecoder::BatchBufferedRecords(std::size_t max_count,
+                                      std::uint64_t end_offset) {
+  // need some unread bytes
+  if (GetReadBufferSize() == 0) {
+    if (FillBuffer() == 0) {
+      return false;
+    }
+  }
+  // need at least one complete record
+  while (GetReadBufferSize() < BufferRecordHeader()->Size()) {
+    if (FillBuffer() == 0) {
+      if (GetReadBufferSize() > 0) {
+        log_receiver_->Receive(
+            LogLevel::Warning,
+            "Unexpected partial record remaining in stream: " +
+                std::to_string(GetReadBufferSize()) + " bytes");
+      }
+      return false;
+    }
+  }
+  // take every complete record already in the buffer without refilling it,
+  // which would move the records already in the batch
+  while (record_batch_.size() < max_count && next_record_offset_ < end_offset &&
+         GetReadBufferSize() > 0 &&
+         GetReadBufferSize() >= BufferRecordHeader()->Size()) {
+    auto* header = BufferRecordHeader();
+    record_buffer_.Consume(header->Size());
+    next_record_offset_ += header->Size();
+    if (filter_.Matches(*header)) {
+      record_batch_.emplace_back(header);
+    }
+  }
+  return true;
+}
+
+void DbnDecoder::BatchMappedRecords(std::size_t max_count,
+                                    std::uint64_t end_offset) {
+  while (record_batch_.size() < max_count && next_record_offset_ < end_offset) {
+    auto* header = ConsumeMappedRecord();
+    if (header == nullptr) {
+      return;
+    }
+    if (filter_.Matches(*header)) {
+      record_batch_.emplace_back(header);
+    }
+  }
+}
+
+void DbnDecoder::UpgradeBatch() {
+  upgraded_idxs_.clear();
+  batch_compat_buffers_.clear();
+  for (std::size_t i = 0; i < record_batch_.size(); ++i) {
+    const auto rec = DbnDecoder::DecodeRecordCompat(
+        version_, upgrade_policy_, ts_out_, &compat_buffer_, record_batch_[i]);
+    if (&rec.Header() != &record_batch_[i].Header()) {
+      upgraded_idxs_.emplace_back(i);
+      batch_compat_buffers_.emplace_back();
+      std::copy(compat_buffer_.cbegin(), compat_buffer_.cend(),
+                batch_compat_buffers_.back().data.begin());
+    }
+  }
+  // `batch_compat_buffers_` is no longer resized so its addresses are stable
+  for (std::size_t i = 0; i < upgraded_idxs_.size(); ++i) {
+    record_batch_[upgraded_idxs_[i]] = Record{
+        reinterpret_cast<RecordHeader*>(batch_compat_buffers_[i].data.data())};
+  }
+}
+
+void DbnDecoder::ResetInput(std::unique_ptr<IReadable> input,
+                            std::uint64_t offset) {
+  // Destroy the previous input first, including any prefetching thread still
+  // reading from a stream shared with `input`
+  input_.reset();
+  mapped_input_ = nullptr;
+  if (prefetch_block_count_ > 0) {
+    input_ = std::unique_ptr<IReadable>{new detail::PrefetchStream{
+        std::move(input), record_buffer_.Capacity(), prefetch_block_count_}};
+  } else {
+    input_ = std::move(input);
+  }
+  record_buffer_.Clear();
+  next_record_offset_ = offset;
+}
+
+bool DbnDecoder::SeekMapped(std::uint64_t offset) {
+  if (mapped_input_ == nullptr) {
+    return false;
+  }
+  mapped_input_->Seek(static_cast<std::size_t>(offset));
+  record_buffer_.Clear();
+  next_record_offset_ = offset;
+  return true;
+}
+
+void DbnDecoder::SkipTo(std::uint64_t offset) {
+  if (offset < next_record_offset_) {
+    throw InvalidArgumentError{"DbnDecoder::SkipTo", "offset",
+                               "Can't skip backwards"};
+  }
+  auto remaining = offset - next_record_offset_;
+  next_record_offset_ = offset;
+  if (mapped_input_ != nullptr) {
+    mapped_input_->Consume(static_cast<std::size_t>(std::min<std::uint64_t>(
+        remaining, mapped_input_->RemainingSize())));
+    return;
+  }
+  const auto buffered = static_cast<std::size_t>(
+      std::min<std::uint64_t>(remaining, record_buffer_.ReadableSize()));
+  record_buffer_.Consume(buffered);
+  remaining -= buffered;
+  // Read the rest through the empty buffer and discard it
+  while (remaining > 0) {
+    record_buffer_.Clear();
+    const auto read_size = input_->ReadSome(
+        record_buffer_.WriteBegin(),
+        static_cast<std::size_t>(std::min<std::uint64_t>(
+            remaining, record_buffer_.WritableSize())));
+    if (read_size == 0) {
+      break;
+    }
+    remaining -= read_size;
+  }
+}
+
+void DbnDecoder::SetFilter(RecordFilter filter) {
+  filter_ = std::move(filter);
 }
 
 size_t DbnDecoder::FillBuffer() {
-  // Shift data forward
-  std::copy(read_buffer_.cbegin() + static_cast<std::ptrdiff_t>(buffer_idx_),
-            read_buffer_.cend(), read_buffer_.begin());
-  const auto unread_size = read_buffer_.size() - buffer_idx_;
-  buffer_idx_ = 0;
-  read_buffer_.resize(kBufferCapacity);
-  const auto fill_size = input_->ReadSome(&read_buffer_[unread_size],
-                                          kBufferCapacity - unread_size);
-  read_buffer_.resize(unread_size + fill_size);
+  // A record straddling the end of a mirrored buffer is still contiguous, so
+  // unread data only needs to be moved when mirroring is unavailable
+  record_buffer_.Compact();
+  const auto fill_size = input_->ReadSome(record_buffer_.WriteBegin(),
+                                          record_buffer_.WritableSize());
+  record_buffer_.Commit(fill_size);
   return fill_size;
 }
 
 std::size_t DbnDecoder::GetReadBufferSize() const {
-  return read_buffer_.size() - buffer_idx_;
+  return record_buffer_.ReadableSize();
 }
 
 databento::RecordHeader* DbnDecoder::BufferRecordHeader() {
-  return reinterpret_cast<RecordHeader*>(&read_buffer_[buffer_idx_]);
+  return reinterpret_cast<RecordHeader*>(record_buffer_.ReadBegin());
 }
 
 bool DbnDecoder::DetectCompression() {
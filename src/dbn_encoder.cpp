@@ -12,6 +12,8 @@
 #include "databento/dbn.hpp"
 #include "databento/exceptions.hpp"
 #include "databento/iwritable.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"  // RecordHeader
 #include "dbn_constants.hpp"
 
 using databento::DbnEncoder;
@@ -80,10 +82,50 @@ void EncodeSymbolMappings(
     }
   }
 }
+
+std::size_t CalcUnpaddedLength(const databento::Metadata& metadata) {
+  const auto symbol_cstr_len = metadata.symbol_cstr_len;
+  const auto mapping_interval_len = sizeof(std::uint32_t) * 2 + symbol_cstr_len;
+  // schema_definition_length, symbols_count, partial_count, not_found_count,
+  // mappings_count
+  const auto var_len_counts_size = sizeof(std::uint32_t) * 5;
+
+  const auto c_str_count = metadata.symbols.size() + metadata.partial.size() +
+                           metadata.not_found.size();
+  const auto mappings_len = std::accumulate(
+      metadata.mappings.begin(), metadata.mappings.end(), std::size_t{0},
+      [symbol_cstr_len, mapping_interval_len](
+          std::size_t acc, const databento::SymbolMapping& m) {
+        return acc + symbol_cstr_len + sizeof(std::uint32_t) +
+               m.intervals.size() * mapping_interval_len;
+      });
+  return databento::kFixedMetadataLen + var_len_counts_size +
+         c_str_count * symbol_cstr_len + mappings_len;
+}
 }  // namespace
 
 DbnEncoder::DbnEncoder(const Metadata& metadata, IWritable* output)
-    : output_{output} {
+    : DbnEncoder{metadata, output, nullptr, nullptr} {}
+
+DbnEncoder::DbnEncoder(const Metadata& metadata, IWritable* output,
+                       TsIndex* index)
+    : DbnEncoder{metadata, output, index, nullptr} {}
+
+DbnEncoder::DbnEncoder(const Metadata& metadata, IWritable* output,
+                       TsIndex* ts_index, InstrumentIndex* instrument_index)
+    : output_{output},
+      ts_index_{ts_index},
+      instrument_index_{instrument_index},
+      offset_{kMetadataPreludeSize + CalcLength(metadata)} {
+  EncodeMetadata(metadata, output_);
+}
+
+DbnEncoder::DbnEncoder(const Metadata& metadata, IWritable* output,
+                       const ZstdCompressOptions& compression)
+    : compressor_{new detail::ZstdCompressStream{ILogReceiver::Default(),
+                                                 output, compression}},
+      output_{compressor_.get()},
+      offset_{kMetadataPreludeSize + CalcLength(metadata)} {
   EncodeMetadata(metadata, output_);
 }
 
@@ -132,6 +174,9 @@ void DbnEncoder::EncodeMetadata(const Metadata& metadata, IWritable* output) {
   EncodeRepeatedSymbolCStr(metadata.symbol_cstr_len, metadata.not_found,
                            output);
   EncodeSymbolMappings(metadata.symbol_cstr_len, metadata.mappings, output);
+  const std::vector<std::uint8_t> trailing_padding(
+      length - CalcUnpaddedLength(metadata));
+  output->WriteAll(trailing_padding.data(), trailing_padding.size());
 }
 
 void DbnEncoder::EncodeRecord(const Record& record, IWritable* output) {
@@ -141,25 +186,20 @@ void DbnEncoder::EncodeRecord(const Record& record, IWritable* output) {
 
 void DbnEncoder::EncodeRecord(const Record& record) {
   EncodeRecord(record, output_);
+  if (ts_index_ != nullptr) {
+    ts_index_->Add(record, offset_);
+  }
+  if (instrument_index_ != nullptr) {
+    instrument_index_->Add(record, offset_);
+  }
+  offset_ += record.Size();
 }
 
 std::uint32_t DbnEncoder::CalcLength(const Metadata& metadata) {
-  const auto symbol_cstr_len = metadata.symbol_cstr_len;
-  const auto mapping_interval_len = sizeof(std::uint32_t) * 2 + symbol_cstr_len;
-  // schema_definition_length, symbols_count, partial_count, not_found_count,
-  // mappings_count
-  const auto var_len_counts_size = sizeof(std::uint32_t) * 5;
-
-  const auto c_str_count = metadata.symbols.size() + metadata.partial.size() +
-                           metadata.not_found.size();
-  const auto mappings_len = std::accumulate(
-      metadata.mappings.begin(), metadata.mappings.end(), std::size_t{0},
-      [symbol_cstr_len, mapping_interval_len](std::size_t acc,
-                                              const SymbolMapping& m) {
-        return acc + symbol_cstr_len + sizeof(std::uint32_t) +
-               m.intervals.size() * mapping_interval_len;
-      });
-  return static_cast<std::uint32_t>(kFixedMetadataLen + var_len_counts_size +
-                                    c_str_count * symbol_cstr_len +
-                                    mappings_len);
+  // Padded so the records following the metadata are 8-byte aligned within
+  // the file, which allows decoding them in place from a memory mapping
+  const auto unpadded_len = CalcUnpaddedLength(metadata);
+  const auto alignment = alignof(RecordHeader);
+  return static_cast<std::uint32_t>((unpadded_len + alignment - 1) /
+                                    alignment * alignment);
 }
@@ -1,40 +1,128 @@
 #include "databento/dbn_file_store.hpp"
 
-#include <memory>   // unique_ptr
-#include <utility>  // move
+#include <algorithm>  // binary_search, copy_if, sort
+#include <cstdint>
+#include <cstring>    // memcpy
+#include <iterator>   // back_inserter
+#include <memory>     // unique_ptr
+#include <utility>    // move
+#include <vector>
 
+#include "databento/constants.hpp"  // kUndefTimestamp
+#include "databento/detail/parallel_zstd_stream.hpp"
+#include "databento/detail/zstd_stream.hpp"
+#include "databento/exceptions.hpp"
 #include "databento/file_stream.hpp"
 #include "databento/ireadable.hpp"
 #include "databento/record.hpp"
+#include "dbn_constants.hpp"  // kZstdMagicNumber
 
 using databento::DbnFileStore;
 
+namespace {
+// Reads from an input owned elsewhere, so it can be repositioned and handed to
+// the decoder again without being reopened. The input is only repositioned to
+// `offset` on the first read, after the decoder has released any previous
+// reader of it.
+template <typename S>
+class BorrowedReadable : public databento::IReadable {
+ public:
+  BorrowedReadable(S* input, std::uint64_t offset)
+      : input_{input}, offset_{offset} {}
+
+  void ReadExact(std::uint8_t* buffer, std::size_t length) override {
+    MaybeSeek();
+    input_->ReadExact(buffer, length);
+  }
+  std::size_t ReadSome(std::uint8_t* buffer, std::size_t max_length) override {
+    MaybeSeek();
+    return input_->ReadSome(buffer, max_length);
+  }
+
+ private:
+  void MaybeSeek() {
+    if (!is_positioned_) {
+      input_->Seek(offset_);
+      is_positioned_ = true;
+    }
+  }
+
+  S* input_;
+  std::uint64_t offset_;
+  bool is_positioned_{};
+};
+
+databento::DbnDecoderOptions DecoderOptions(
+    const databento::DbnFileStoreOptions& options) {
+  return {options.upgrade_policy, options.buffer_size,
+          options.prefetch_block_count, options.dictionaries,
+          options.zstd_window_log_max};
+}
+
+std::unique_ptr<databento::IReadable> OpenInput(
+    const std::string& file_path,
+    const databento::DbnFileStoreOptions& options) {
+  if (options.decompress_thread_count > 0) {
+    std::uint32_t magic{};
+    databento::InFileStream{file_path}.ReadExact(
+        reinterpret_cast<std::uint8_t*>(&magic), sizeof(magic));
+    // Single-frame files would be decompressed into memory by one worker, so
+    // they're left to the decoder to decompress while reading
+    if (magic == databento::kZstdMagicNumber &&
+        databento::detail::HasMultipleZstdFrames(file_path)) {
+      return std::unique_ptr<databento::IReadable>{
+          new databento::detail::ParallelZstdDecodeStream{
+              file_path, options.decompress_thread_count,
+              options.dictionaries, options.zstd_window_log_max}};
+    }
+  }
+  if (options.mapped) {
+    return std::unique_ptr<databento::IReadable>{
+        new databento::MappedFileStream{file_path}};
+  }
+  return std::unique_ptr<databento::IReadable>{
+      new databento::InFileStream{file_path}};
+}
+}  // namespace
+
 DbnFileStore::DbnFileStore(const std::string& file_path)
-    : decoder_{ILogReceiver::Default(), InFileStream{file_path}} {}
+    : DbnFileStore{ILogReceiver::Default(), file_path, DbnFileStoreOptions{}} {}
 
 DbnFileStore::DbnFileStore(ILogReceiver* log_receiver,
                            const std::string& file_path,
                            VersionUpgradePolicy upgrade_policy)
-    : decoder_{log_receiver,
-               std::unique_ptr<IReadable>{new InFileStream{file_path}},
-               upgrade_policy} {}
+    : DbnFileStore{log_receiver, file_path,
+                   DbnFileStoreOptions{upgrade_policy, 0, 0, false, 0,
+                                       nullptr, nullptr, nullptr}} {}
+
+DbnFileStore::DbnFileStore(ILogReceiver* log_receiver,
+                           const std::string& file_path,
+                           const DbnFileStoreOptions& options)
+    : decoder_{log_receiver, OpenInput(file_path, options),
+               DecoderOptions(options)},
+      file_path_{file_path},
+      dictionaries_{options.dictionaries},
+      zstd_window_log_max_{options.zstd_window_log_max},
+      ts_index_{options.ts_index},
+      instrument_index_{options.instrument_index} {}
 
 void DbnFileStore::Replay(const MetadataCallback& metadata_callback,
-                          const RecordCallback& record_callback) {
-  auto metadata = decoder_.DecodeMetadata();
+                          const RecordBatchCallback& record_batch_callback) {
+  MaybeDecodeMetadata();
   if (metadata_callback) {
-    metadata_callback(std::move(metadata));
+    metadata_callback(Metadata{metadata_});
   }
-  const databento::Record* record;
-  while ((record = decoder_.DecodeRecord()) != nullptr) {
-    if (record_callback(*record) == KeepGoing::Stop) {
+  while (true) {
+    const auto& records = DecodeRecords();
+    if (records.empty() ||
+        record_batch_callback(records) == KeepGoing::Stop) {
       break;
     }
   }
 }
 
-void DbnFileStore::Replay(const RecordCallback& record_callback) {
-  Replay({}, record_callback);
+void DbnFileStore::Replay(const RecordBatchCallback& record_batch_callback) {
+  Replay({}, record_batch_callback);
 }
 
 const databento::Metadata& DbnFileStore::GetMetadata() {
@@ -44,7 +132,57 @@ const databento::Metadata& DbnFileStore::GetMetadata() {
 
 const databento::Record* DbnFileStore::NextRecord() {
   MaybeDecodeMetadata();
-  return decoder_.DecodeRecord();
+  return DecodeRecord();
+}
+
+void DbnFileStore::SeekTo(UnixNanos ts) {
+  if (!ts_index_) {
+    throw Exception{
+        "DbnFileStore::SeekTo requires constructing the store with a TsIndex"};
+  }
+  MaybeDecodeMetadata();
+  seek_record_ = nullptr;
+  is_seek_past_end_ = false;
+  // Block selection restarts from the new position
+  next_selected_block_ = 0;
+  block_end_offset_ = 0;
+  const auto entry_idx = ts_index_->Find(ts);
+  if (entry_idx == ts_index_->Entries().size()) {
+    is_seek_past_end_ = true;
+    return;
+  }
+  const auto offset = ts_index_->Entries()[entry_idx].offset;
+  MoveTo(offset);
+  // The block may begin with earlier records or records without an index
+  // timestamp
+  const databento::Record* record;
+  while ((record = decoder_.DecodeRecord()) != nullptr) {
+    const auto index_ts = record->IndexTs();
+    if (index_ts >= ts &&
+        index_ts.time_since_epoch().count() != kUndefTimestamp) {
+      seek_record_ = record;
+      return;
+    }
+  }
+  is_seek_past_end_ = true;
+}
+
+void DbnFileStore::SelectInstruments(std::vector<std::uint32_t> instrument_ids) {
+  if (!instrument_index_) {
+    throw Exception{
+        "DbnFileStore::SelectInstruments requires constructing the store with "
+        "an InstrumentIndex"};
+  }
+  MaybeDecodeMetadata();
+  std::sort(instrument_ids.begin(), instrument_ids.end());
+  selected_blocks_ = instrument_index_->FindBlocks(instrument_ids);
+  selected_ids_ = std::move(instrument_ids);
+  next_selected_block_ = 0;
+  block_end_offset_ = 0;
+}
+
+void DbnFileStore::SetFilter(RecordFilter filter) {
+  decoder_.SetFilter(std::move(filter));
 }
 
 void DbnFileStore::MaybeDecodeMetadata() {
@@ -53,3 +191,150 @@ void DbnFileStore::MaybeDecodeMetadata() {
     has_decoded_metadata_ = true;
   }
 }
+
+const databento::Record* DbnFileStore::DecodeRecord() {
+  if (selected_ids_.empty()) {
+    return DecodeUnselectedRecord();
+  }
+  while (true) {
+    if (seek_record_ == nullptr && !is_seek_past_end_ &&
+        decoder_.NextRecordOffset() >= block_end_offset_ &&
+        !MoveToNextSelectedBlock()) {
+      return nullptr;
+    }
+    const auto* record = DecodeUnselectedRecord();
+    if (record == nullptr || IsSelected(*record)) {
+      return record;
+    }
+  }
+}
+
+const std::vector<databento::Record>& DbnFileStore::DecodeRecords() {
+  record_batch_.clear();
+  if (is_seek_past_end_) {
+    return record_batch_;
+  }
+  // The record found by `SeekTo` has already been decoded, so it's returned
+  // on its own
+  if (seek_record_ != nullptr) {
+    if (const auto* record = DecodeRecord()) {
+      record_batch_.emplace_back(*record);
+    }
+    return record_batch_;
+  }
+  if (selected_ids_.empty()) {
+    return decoder_.DecodeRecords(kMaxRecordBatchSize);
+  }
+  // Batches never extend past the end of the current selected block
+  while (record_batch_.empty()) {
+    if (decoder_.NextRecordOffset() >= block_end_offset_ &&
+        !MoveToNextSelectedBlock()) {
+      break;
+    }
+    const auto& records =
+        decoder_.DecodeRecords(kMaxRecordBatchSize, block_end_offset_);
+    if (records.empty() && decoder_.NextRecordOffset() < block_end_offset_) {
+      // End of the input
+      break;
+    }
+    std::copy_if(records.cbegin(), records.cend(),
+                 std::back_inserter(record_batch_),
+                 [this](const Record& record) { return IsSelected(record); });
+  }
+  return record_batch_;
+}
+
+const databento::Record* DbnFileStore::DecodeUnselectedRecord() {
+  if (seek_record_ != nullptr) {
+    const auto* record = seek_record_;
+    seek_record_ = nullptr;
+    return record;
+  }
+  if (is_seek_past_end_) {
+    return nullptr;
+  }
+  return decoder_.DecodeRecord();
+}
+
+bool DbnFileStore::MoveToNextSelectedBlock() {
+  const auto offset = decoder_.NextRecordOffset();
+  const auto& blocks = instrument_index_->Blocks();
+  while (next_selected_block_ < selected_blocks_.size() &&
+         blocks[selected_blocks_[next_selected_block_]].end_offset <= offset) {
+    ++next_selected_block_;
+  }
+  if (next_selected_block_ == selected_blocks_.size()) {
+    return false;
+  }
+  const auto& block = blocks[selected_blocks_[next_selected_block_]];
+  ++next_selected_block_;
+  // Consecutive selected blocks are read without repositioning
+  if (block.offset > offset) {
+    MoveTo(block.offset);
+  }
+  block_end_offset_ = block.end_offset;
+  return true;
+}
+
+bool DbnFileStore::IsSelected(const Record& record) const {
+  return std::binary_search(selected_ids_.cbegin(), selected_ids_.cend(),
+                            record.Header().instrument_id);
+}
+
+void DbnFileStore::MoveTo(std::uint64_t offset) {
+  // Uncompressed mappings are repositioned in place
+  if (decoder_.SeekMapped(offset)) {
+    return;
+  }
+  if (!is_input_kind_known_) {
+    DetectInputKind();
+  }
+  if (seekable_input_) {
+    // Only decompresses the frame containing `offset`
+    decoder_.ResetInput(
+        std::unique_ptr<IReadable>{
+            new BorrowedReadable<detail::ZstdSeekableDecodeStream>{
+                seekable_input_.get(), offset}},
+        offset);
+    return;
+  }
+  if (file_input_) {
+    decoder_.ResetInput(
+        std::unique_ptr<IReadable>{
+            new BorrowedReadable<InFileStream>{file_input_.get(), offset}},
+        offset);
+    return;
+  }
+  // Without a seek table, Zstd can only be decompressed from the start, so
+  // only restart for moving backwards
+  if (offset < decoder_.NextRecordOffset()) {
+    std::unique_ptr<detail::ZstdDecodeStream> input{
+        new detail::ZstdDecodeStream{
+            std::unique_ptr<IReadable>{new InFileStream{file_path_}},
+            dictionaries_}};
+    input->SetWindowLogMax(zstd_window_log_max_);
+    decoder_.ResetInput(std::move(input), 0);
+  }
+  decoder_.SkipTo(offset);
+}
+
+void DbnFileStore::DetectInputKind() {
+  is_input_kind_known_ = true;
+  std::unique_ptr<InFileStream> file{new InFileStream{file_path_}};
+  std::uint32_t magic{};
+  file->ReadExact(reinterpret_cast<std::uint8_t*>(&magic), sizeof(magic));
+  is_compressed_ = magic == kZstdMagicNumber;
+  if (!is_compressed_) {
+    // Kept open for all later moves
+    file_input_ = std::move(file);
+    return;
+  }
+  try {
+    // Reads the seek table once for all later moves
+    seekable_input_.reset(
+        new detail::ZstdSeekableDecodeStream{file_path_, dictionaries_});
+    seekable_input_->SetWindowLogMax(zstd_window_log_max_);
+  } catch (const DbnResponseError&) {
+    // Not in the seekable format
+  }
+}
@@ -0,0 +1,495 @@
+#include "databento/dbn_json_encoder.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>      // memcpy, strnlen
+#include <string>
+#include <type_traits>  // decay_t, is_enum, is_same, is_signed, void_t
+#include <utility>      // declval
+
+#include "databento/constants.hpp"  // kUndefPrice, kUndefTimestamp
+#include "databento/datetime.hpp"   // kIso8601Len, ToIso8601, UnixNanos
+#include "databento/exceptions.hpp"
+#include "databento/fixed_price.hpp"  // FixPx, kMaxFixPxLen, ToChars
+#include "databento/flag_set.hpp"
+#include "databento/record_visit.hpp"  // Record::Visit
+#include "databento/v1.hpp"
+#include "databento/with_ts_out.hpp"
+#include "text_format.hpp"
+
+using databento::DbnJsonEncoder;
+
+namespace {
+using databento::detail::WriteInt;
+using databento::detail::WriteUInt;
+
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+// Writes the members of JSON objects and arrays, tracking where separators are
+// needed.
+class JsonWriter {
+ public:
+  JsonWriter(bool pretty_px, bool pretty_ts, char* out)
+      : pretty_px_{pretty_px}, pretty_ts_{pretty_ts}, out_{out} {}
+
+  void BeginObject() {
+    Separator();
+    *out_++ = '{';
+    is_first_ = true;
+  }
+  template <std::size_t N>
+  void BeginObject(const char (&key)[N]) {
+    Key(key);
+    *out_++ = '{';
+    is_first_ = true;
+  }
+  void EndObject() {
+    *out_++ = '}';
+    is_first_ = false;
+  }
+  template <std::size_t N>
+  void BeginArray(const char (&key)[N]) {
+    Key(key);
+    *out_++ = '[';
+    is_first_ = true;
+  }
+  void EndArray() {
+    *out_++ = ']';
+    is_first_ = false;
+  }
+  template <std::size_t N, typename T>
+  void Field(const char (&key)[N], T value) {
+    Key(key);
+    Value(value);
+  }
+  template <std::size_t N>
+  void Px(const char (&key)[N], std::int64_t px) {
+    Key(key);
+    if (!pretty_px_) {
+      Value(px);
+    } else if (px == databento::kUndefPrice) {
+      Null();
+    } else {
+      *out_++ = '"';
+      out_ = databento::ToChars(out_, out_ + databento::kMaxFixPxLen,
+                              databento::FixPx{px})
+                 .ptr;
+      *out_++ = '"';
+    }
+  }
+  // Writes a null-terminated string of at most `max_len` characters.
+  template <std::size_t N>
+  void String(const char (&key)[N], const char* str, std::size_t max_len) {
+    Key(key);
+    EscapedString(str, ::strnlen(str, max_len));
+  }
+  template <std::size_t N, std::size_t M>
+  void String(const char (&key)[N], const std::array<char, M>& str) {
+    String(key, str.data(), M);
+  }
+  template <typename R>
+  void Header(const R& rec) {
+    BeginObject("hd");
+    Field("ts_event", rec.hd.ts_event);
+    Field("rtype", rec.hd.rtype);
+    Field("publisher_id", rec.hd.publisher_id);
+    Field("instrument_id", rec.hd.instrument_id);
+    EndObject();
+  }
+  template <typename L>
+  void Levels(const L& levels) {
+    BeginArray("levels");
+    for (const auto& level : levels) {
+      BeginObject();
+      Px("bid_px", level.bid_px);
+      Px("ask_px", level.ask_px);
+      Field("bid_sz", level.bid_sz);
+      Field("ask_sz", level.ask_sz);
+      Field("bid_ct", level.bid_ct);
+      Field("ask_ct", level.ask_ct);
+      EndObject();
+    }
+    EndArray();
+  }
+  template <typename L>
+  void ConsolidatedLevels(const L& levels) {
+    BeginArray("levels");
+    for (const auto& level : levels) {
+      BeginObject();
+      Px("bid_px", level.bid_px);
+      Px("ask_px", level.ask_px);
+      Field("bid_sz", level.bid_sz);
+      Field("ask_sz", level.ask_sz);
+      Field("bid_pb", level.bid_pb);
+      Field("ask_pb", level.ask_pb);
+      EndObject();
+    }
+    EndArray();
+  }
+  char* EndLine() {
+    *out_++ = '\n';
+    return out_;
+  }
+
+ private:
+  void Separator() {
+    if (!is_first_) {
+      *out_++ = ',';
+    }
+    is_first_ = false;
+  }
+  template <std::size_t N>
+  void Key(const char (&key)[N]) {
+    Separator();
+    *out_++ = '"';
+    std::memcpy(out_, key, N - 1);
+    out_ += N - 1;
+    *out_++ = '"';
+    *out_++ = ':';
+  }
+  void Null() {
+    std::memcpy(out_, "null", 4);
+    out_ += 4;
+  }
+  template <typename T>
+  void Value(T value) {
+    if constexpr (std::is_enum<T>::value) {
+      Value(static_cast<std::underlying_type_t<T>>(value));
+    } else if constexpr (std::is_same<T, char>::value) {
+      EscapedString(&value, value == 0 ? 0 : 1);
+    } else if constexpr (sizeof(T) == 8) {
+      // Quoted because many JSON parsers only have double precision
+      *out_++ = '"';
+      out_ = std::is_signed<T>::value
+                 ? WriteInt(out_, static_cast<std::int64_t>(value))
+                 : WriteUInt(out_, static_cast<std::uint64_t>(value));
+      *out_++ = '"';
+    } else if constexpr (std::is_signed<T>::value) {
+      out_ = WriteInt(out_, value);
+    } else {
+      out_ = WriteUInt(out_, value);
+    }
+  }
+  void Value(databento::UnixNanos value) {
+    if (!pretty_ts_) {
+      Value(value.time_since_epoch().count());
+    } else if (value.time_since_epoch().count() ==
+               databento::kUndefTimestamp) {
+      Null();
+    } else {
+      *out_++ = '"';
+      out_ = databento::ToIso8601(out_, out_ + databento::kIso8601Len, value)
+                 .ptr;
+      *out_++ = '"';
+    }
+  }
+  void Value(databento::TimeDeltaNanos value) { Value(value.count()); }
+  void Value(databento::FlagSet value) { Value(value.Raw()); }
+  void EscapedString(const char* str, std::size_t len) {
+    *out_++ = '"';
+    for (std::size_t i = 0; i < len; ++i) {
+      const auto c = str[i];
+      if (c == '"' || c == '\\') {
+        *out_++ = '\\';
+        *out_++ = c;
+      } else if (static_cast<unsigned char>(c) < 0x20) {
+        std::memcpy(out_, "\\u00", 4);
+        out_ += 4;
+        *out_++ = kHexDigits[c >> 4];
+        *out_++ = kHexDigits[c & 0xF];
+      } else {
+        *out_++ = c;
+      }
+    }
+    *out_++ = '"';
+  }
+
+  const bool pretty_px_;
+  const bool pretty_ts_;
+  char* out_;
+  bool is_first_{true};
+};
+
+void WriteFields(JsonWriter& writer, const databento::MboMsg& rec) {
+  writer.Field("ts_recv", rec.ts_recv);
+  writer.Header(rec);
+  writer.Field("action", rec.action);
+  writer.Field("side", rec.side);
+  writer.Px("price", rec.price);
+  writer.Field("size", rec.size);
+  writer.Field("channel_id", rec.channel_id);
+  writer.Field("order_id", rec.order_id);
+  writer.Field("flags", rec.flags);
+  writer.Field("ts_in_delta", rec.ts_in_delta);
+  writer.Field("sequence", rec.sequence);
+}
+
+template <typename R>
+void WriteMbpFields(JsonWriter& writer, const R& rec) {
+  writer.Field("ts_recv", rec.ts_recv);
+  writer.Header(rec);
+  writer.Field("action", rec.action);
+  writer.Field("side", rec.side);
+  writer.Field("depth", rec.depth);
+  writer.Px("price", rec.price);
+  writer.Field("size", rec.size);
+  writer.Field("flags", rec.flags);
+  writer.Field("ts_in_delta", rec.ts_in_delta);
+  writer.Field("sequence", rec.sequence);
+}
+
+void WriteFields(JsonWriter& writer, const databento::TradeMsg& rec) {
+  WriteMbpFields(writer, rec);
+}
+
+void WriteFields(JsonWriter& writer, const databento::Mbp1Msg& rec) {
+  WriteMbpFields(writer, rec);
+  writer.Levels(rec.levels);
+}
+
+void WriteFields(JsonWriter& writer, const databento::Mbp10Msg& rec) {
+  WriteMbpFields(writer, rec);
+  writer.Levels(rec.levels);
+}
+
+void WriteFields(JsonWriter& writer, const databento::BboMsg& rec) {
+  writer.Field("ts_recv", rec.ts_recv);
+  writer.Header(rec);
+  writer.Field("side", rec.side);
+  writer.Px("price", rec.price);
+  writer.Field("size", rec.size);
+  writer.Field("flags", rec.flags);
+  writer.Field("sequence", rec.sequence);
+  writer.Levels(rec.levels);
+}
+
+void WriteFields(JsonWriter& writer, const databento::Cmbp1Msg& rec) {
+  writer.Field("ts_recv", rec.ts_recv);
+  writer.Header(rec);
+  writer.Field("action", rec.action);
+  writer.Field("side", rec.side);
+  writer.Px("price", rec.price);
+  writer.Field("size", rec.size);
+  writer.Field("flags", rec.flags);
+  writer.Field("ts_in_delta", rec.ts_in_delta);
+  writer.ConsolidatedLevels(rec.levels);
+}
+
+void WriteFields(JsonWriter& writer, const databento::CbboMsg& rec) {
+  writer.Field("ts_recv", rec.ts_recv);
+  writer.Header(rec);
+  writer.Field("side", rec.side);
+  writer.Px("price", rec.price);
+  writer.Field("size", rec.size);
+  writer.Field("flags", rec.flags);
+  writer.ConsolidatedLevels(rec.levels);
+}
+
+void WriteFields(JsonWriter& writer, const databento::OhlcvMsg& rec) {
+  writer.Header(rec);
+  writer.Px("open", rec.open);
+  writer.Px("high", rec.high);
+  writer.Px("low", rec.low);
+  writer.Px("close", rec.close);
+  writer.Field("volume", rec.volume);
+}
+
+void WriteFields(JsonWriter& writer, const databento::StatusMsg& rec) {
+  writer.Field("ts_recv", rec.ts_recv);
+  writer.Header(rec);
+  writer.Field("action", rec.action);
+  writer.Field("reason", rec.reason);
+  writer.Field("trading_event", rec.trading_event);
+  writer.Field("is_trading", rec.is_trading);
+  writer.Field("is_quoting", rec.is_quoting);
+  writer.Field("is_short_sell_restricted", rec.is_short_sell_restricted);
+}
+
+void WriteFields(JsonWriter& writer, const databento::InstrumentDefMsg& rec) {
+  writer.Field("ts_recv", rec.ts_recv);
+  writer.Header(rec);
+  writer.String("raw_symbol", rec.raw_symbol);
+  writer.Field("security_update_action", rec.security_update_action);
+  writer.Field("instrument_class", rec.instrument_class);
+  writer.Px("min_price_increment", rec.min_price_increment);
+  writer.Px("display_factor", rec.display_factor);
+  writer.Field("expiration", rec.expiration);
+  writer.Field("activation", rec.activation);
+  writer.Px("high_limit_price", rec.high_limit_price);
+  writer.Px("low_limit_price", rec.low_limit_price);
+  writer.Px("max_price_variation", rec.max_price_variation);
+  writer.Px("trading_reference_price", rec.trading_reference_price);
+  writer.Px("unit_of_measure_qty", rec.unit_of_measure_qty);
+  writer.Px("min_price_increment_amount", rec.min_price_increment_amount);
+  writer.Px("price_ratio", rec.price_ratio);
+  writer.Px("strike_price", rec.strike_price);
+  writer.Field("inst_attrib_value", rec.inst_attrib_value);
+  writer.Field("underlying_id", rec.underlying_id);
+  writer.Field("raw_instrument_id", rec.raw_instrument_id);
+  writer.Field("market_depth_implied", rec.market_depth_implied);
+  writer.Field("market_depth", rec.market_depth);
+  writer.Field("market_segment_id", rec.market_segment_id);
+  writer.Field("max_trade_vol", rec.max_trade_vol);
+  writer.Field("min_lot_size", rec.min_lot_size);
+  writer.Field("min_lot_size_block", rec.min_lot_size_block);
+  writer.Field("min_lot_size_round_lot", rec.min_lot_size_round_lot);
+  writer.Field("min_trade_vol", rec.min_trade_vol);
+  writer.Field("contract_multiplier", rec.contract_multiplier);
+  writer.Field("decay_quantity", rec.decay_quantity);
+  writer.Field("original_contract_size", rec.original_contract_size);
+  writer.Field("trading_reference_date", rec.trading_reference_date);
+  writer.Field("appl_id", rec.appl_id);
+  writer.Field("maturity_year", rec.maturity_year);
+  writer.Field("decay_start_date", rec.decay_start_date);
+  writer.Field("channel_id", rec.channel_id);
+  writer.String("currency", rec.currency);
+  writer.String("settl_currency", rec.settl_currency);
+  writer.String("secsubtype", rec.secsubtype);
+  writer.String("group", rec.group);
+  writer.String("exchange", rec.exchange);
+  writer.String("asset", rec.asset);
+  writer.String("cfi", rec.cfi);
+  writer.String("security_type", rec.security_type);
+  writer.String("unit_of_measure", rec.unit_of_measure);
+  writer.String("underlying", rec.underlying);
+  writer.String("strike_price_currency", rec.strike_price_currency);
+  writer.Field("match_algorithm", rec.match_algorithm);
+  writer.Field("md_security_trading_status", rec.md_security_trading_status);
+  writer.Field("main_fraction", rec.main_fraction);
+  writer.Field("price_display_format", rec.price_display_format);
+  writer.Field("settl_price_type", rec.settl_price_type);
+  writer.Field("sub_fraction", rec.sub_fraction);
+  writer.Field("underlying_product", rec.underlying_product);
+  writer.Field("maturity_month", rec.maturity_month);
+  writer.Field("maturity_day", rec.maturity_day);
+  writer.Field("maturity_week", rec.maturity_week);
+  writer.Field("user_defined_instrument", rec.user_defined_instrument);
+  writer.Field("contract_multiplier_unit", rec.contract_multiplier_unit);
+  writer.Field("flow_schedule_type", rec.flow_schedule_type);
+  writer.Field("tick_rule", rec.tick_rule);
+}
+
+void WriteFields(JsonWriter& writer, const databento::ImbalanceMsg& rec) {
+  writer.Field("ts_recv", rec.ts_recv);
+  writer.Header(rec);
+  writer.Px("ref_price", rec.ref_price);
+  writer.Field("auction_time", rec.auction_time);
+  writer.Px("cont_book_clr_price", rec.cont_book_clr_price);
+  writer.Px("auct_interest_clr_price", rec.auct_interest_clr_price);
+  writer.Px("ssr_filling_price", rec.ssr_filling_price);
+  writer.Px("ind_match_price", rec.ind_match_price);
+  writer.Px("upper_collar", rec.upper_collar);
+  writer.Px("lower_collar", rec.lower_collar);
+  writer.Field("paired_qty", rec.paired_qty);
+  writer.Field("total_imbalance_qty", rec.total_imbalance_qty);
+  writer.Field("market_imbalance_qty", rec.market_imbalance_qty);
+  writer.Field("unpaired_qty", rec.unpaired_qty);
+  writer.Field("auction_type", rec.auction_type);
+  writer.Field("side", rec.side);
+  writer.Field("auction_status", rec.auction_status);
+  writer.Field("freeze_status", rec.freeze_status);
+  writer.Field("num_extensions", rec.num_extensions);
+  writer.Field("unpaired_side", rec.unpaired_side);
+  writer.Field("significant_imbalance", rec.significant_imbalance);
+}
+
+void WriteFields(JsonWriter& writer, const databento::StatMsg& rec) {
+  writer.Field("ts_recv", rec.ts_recv);
+  writer.Header(rec);
+  writer.Field("ts_ref", rec.ts_ref);
+  writer.Px("price", rec.price);
+  writer.Field("quantity", rec.quantity);
+  writer.Field("sequence", rec.sequence);
+  writer.Field("ts_in_delta", rec.ts_in_delta);
+  writer.Field("stat_type", rec.stat_type);
+  writer.Field("channel_id", rec.channel_id);
+  writer.Field("update_action", rec.update_action);
+  writer.Field("stat_flags", rec.stat_flags);
+}
+
+void WriteFields(JsonWriter& writer, const databento::ErrorMsg& rec) {
+  writer.Header(rec);
+  writer.String("err", rec.err.data(), rec.err.size());
+  writer.Field("code", rec.code);
+  writer.Field("is_last", rec.is_last);
+}
+
+void WriteFields(JsonWriter& writer, const databento::SymbolMappingMsg& rec) {
+  writer.Header(rec);
+  writer.Field("stype_in", rec.stype_in);
+  writer.String("stype_in_symbol", rec.stype_in_symbol.data(),
+                rec.stype_in_symbol.size());
+  writer.Field("stype_out", rec.stype_out);
+  writer.String("stype_out_symbol", rec.stype_out_symbol.data(),
+                rec.stype_out_symbol.size());
+  writer.Field("start_ts", rec.start_ts);
+  writer.Field("end_ts", rec.end_ts);
+}
+
+void WriteFields(JsonWriter& writer, const databento::SystemMsg& rec) {
+  writer.Header(rec);
+  writer.String("msg", rec.msg.data(), rec.msg.size());
+  writer.Field("code", rec.code);
+}
+
+// DBN version 1 records are upgraded as when decoding
+void WriteFields(JsonWriter& writer,
+                 const databento::v1::InstrumentDefMsg& rec) {
+  WriteFields(writer, rec.ToV2());
+}
+
+void WriteFields(JsonWriter& writer, const databento::v1::ErrorMsg& rec) {
+  WriteFields(writer, rec.ToV2());
+}
+
+void WriteFields(JsonWriter& writer,
+                 const databento::v1::SymbolMappingMsg& rec) {
+  WriteFields(writer, rec.ToV2());
+}
+
+void WriteFields(JsonWriter& writer, const databento::v1::SystemMsg& rec) {
+  WriteFields(writer, rec.ToV2());
+}
+
+template <typename R, typename = void>
+struct IsSupported : std::false_type {};
+template <typename R>
+struct IsSupported<R, std::void_t<decltype(WriteFields(
+                          std::declval<JsonWriter&>(),
+                          std::declval<const R&>()))>> : std::true_type {};
+}  // namespace
+
+std::size_t DbnJsonEncoder::EncodeRecord(const Record& record, char* buffer,
+                                         std::size_t buffer_size) const {
+  return Encode(record, ts_out_, buffer, buffer_size);
+}
+
+std::size_t DbnJsonEncoder::Encode(const Record& record, bool ts_out,
+                                   char* buffer,
+                                   std::size_t buffer_size) const {
+  if (buffer_size < kMaxJsonLineLen) {
+    throw InvalidArgumentError{"DbnJsonEncoder::EncodeRecord", "buffer_size",
+                               "Must be at least kMaxJsonLineLen"};
+  }
+  std::size_t size{};
+  record.Visit([this, &record, ts_out, buffer, &size](const auto& rec) {
+    using R = std::decay_t<decltype(rec)>;
+    if constexpr (IsSupported<R>::value) {
+      JsonWriter writer{pretty_px_, pretty_ts_, buffer};
+      writer.BeginObject();
+      WriteFields(writer, rec);
+      if (ts_out && record.Size() >= sizeof(WithTsOut<R>)) {
+        writer.Field("ts_out",
+                     reinterpret_cast<const WithTsOut<R>&>(rec).ts_out);
+      }
+      writer.EndObject();
+      size = static_cast<std::size_t>(writer.EndLine() - buffer);
+    } else {
+      throw InvalidArgumentError{
+          "DbnJsonEncoder::EncodeRecord", "record",
+          std::string{"Unsupported record type with rtype "} +
+              ToString(record.RType())};
+    }
+  });
+  return size;
+}
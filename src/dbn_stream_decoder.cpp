@@ -0,0 +1,253 @@
+#include "databento/dbn_stream_decoder.hpp"
+
+#include <algorithm>  // copy, max
+#include <cstring>    // memcpy, strncmp
+#include <string>
+#include <utility>  // move
+#include <vector>
+
+#include "databento/dbn_decoder.hpp"
+#include "databento/exceptions.hpp"
+#include "dbn_constants.hpp"
+
+using databento::DbnStreamDecoder;
+
+DbnStreamDecoder::DbnStreamDecoder(ILogReceiver* log_receiver)
+    : DbnStreamDecoder{log_receiver, VersionUpgradePolicy::UpgradeToV2} {}
+
+DbnStreamDecoder::DbnStreamDecoder(ILogReceiver* log_receiver,
+                                   VersionUpgradePolicy upgrade_policy)
+    : DbnStreamDecoder{log_receiver, upgrade_policy, nullptr} {}
+
+DbnStreamDecoder::DbnStreamDecoder(ILogReceiver* log_receiver,
+                                   VersionUpgradePolicy upgrade_policy,
+                                   const ZstdDictionarySet* dictionaries)
+    : log_receiver_{log_receiver},
+      upgrade_policy_{upgrade_policy},
+      z_dstream_{nullptr, ::ZSTD_freeDStream},
+      buffer_(kBufferCapacity) {
+  if (dictionaries != nullptr) {
+    dictionaries_.reset(new detail::ZstdFrameDictionaries{dictionaries});
+  }
+}
+
+void DbnStreamDecoder::Feed(const std::uint8_t* data, std::size_t length) {
+  Compact();
+  if (z_dstream_) {
+    Decompress(data, length);
+    return;
+  }
+  Append(data, length);
+  if (!is_compression_detected_ && UnreadSize() >= kMagicSize) {
+    DetectCompression();
+  }
+}
+
+void DbnStreamDecoder::Finish() {
+  is_finished_ = true;
+  if (!pending_input_.empty()) {
+    Compact();
+    Decompress(nullptr, 0);
+  }
+  if (!is_metadata_decoded_) {
+    if (!HasMetadata()) {
+      throw DbnResponseError{"DBN stream ended before the end of the metadata"};
+    }
+    return;
+  }
+  const auto unread_size = UnreadSize();
+  if (unread_size == 0) {
+    return;
+  }
+  // Complete records may have been left undecoded
+  const auto* header =
+      reinterpret_cast<const RecordHeader*>(&buffer_[read_pos_]);
+  if (unread_size < sizeof(RecordHeader) || unread_size < header->Size()) {
+    log_receiver_->Receive(LogLevel::Warning,
+                           "Unexpected partial record remaining in stream: " +
+                               std::to_string(unread_size) + " bytes");
+  }
+}
+
+bool DbnStreamDecoder::HasMetadata() const {
+  if (!is_compression_detected_ || UnreadSize() < kMetadataPreludeSize) {
+    return false;
+  }
+  const auto version_and_size = DbnDecoder::DecodeMetadataVersionAndSize(
+      &buffer_[read_pos_], UnreadSize());
+  return UnreadSize() >= kMetadataPreludeSize + version_and_size.second;
+}
+
+databento::Metadata DbnStreamDecoder::DecodeMetadata() {
+  if (!HasMetadata()) {
+    throw DbnResponseError{"The whole metadata hasn't been fed"};
+  }
+  const auto version_and_size = DbnDecoder::DecodeMetadataVersionAndSize(
+      &buffer_[read_pos_], UnreadSize());
+  version_ = version_and_size.first;
+  const auto* metadata_begin = &buffer_[read_pos_ + kMetadataPreludeSize];
+  const std::vector<std::uint8_t> metadata_buffer(
+      metadata_begin, metadata_begin + version_and_size.second);
+  read_pos_ += kMetadataPreludeSize + version_and_size.second;
+  auto metadata = DbnDecoder::DecodeMetadataFields(version_, metadata_buffer);
+  ts_out_ = metadata.ts_out;
+  is_metadata_decoded_ = true;
+  // The metadata length isn't necessarily a multiple of the record alignment
+  Compact();
+  metadata.Upgrade(upgrade_policy_);
+  return metadata;
+}
+
+// assumes DecodeMetadata has been called
+const databento::Record* DbnStreamDecoder::DecodeRecord() {
+  auto* header = ConsumeRecord();
+  if (header == nullptr) {
+    return nullptr;
+  }
+  current_record_ = DbnDecoder::DecodeRecordCompat(
+      version_, upgrade_policy_, ts_out_, &compat_buffer_.data,
+      Record{header});
+  return &current_record_;
+}
+
+// assumes DecodeMetadata has been called
+const std::vector<databento::Record>& DbnStreamDecoder::DecodeRecords(
+    std::size_t max_count) {
+  record_batch_.clear();
+  while (record_batch_.size() < max_count) {
+    auto* header = ConsumeRecord();
+    if (header == nullptr) {
+      break;
+    }
+    record_batch_.emplace_back(header);
+  }
+  // Upgrading is a no-op for all other versions and policies
+  if (version_ == 1 && upgrade_policy_ == VersionUpgradePolicy::UpgradeToV2) {
+    UpgradeBatch();
+  }
+  return record_batch_;
+}
+
+void DbnStreamDecoder::DetectCompression() {
+  is_compression_detected_ = true;
+  const auto* magic = &buffer_[read_pos_];
+  if (std::strncmp(reinterpret_cast<const char*>(magic), kDbnPrefix, 3) == 0) {
+    return;
+  }
+  std::uint32_t magic_number{};
+  std::memcpy(&magic_number, magic, sizeof(magic_number));
+  if (magic_number != kZstdMagicNumber) {
+    throw DbnResponseError{
+        "Couldn't detect input type. It doesn't appear to be Zstd or DBN."};
+  }
+  z_dstream_.reset(::ZSTD_createDStream());
+  ::ZSTD_initDStream(z_dstream_.get());
+  // Replace the compressed input buffered for detection with its
+  // decompressed contents
+  const std::vector<std::uint8_t> compressed(
+      buffer_.cbegin() + static_cast<std::ptrdiff_t>(read_pos_),
+      buffer_.cbegin() + static_cast<std::ptrdiff_t>(write_pos_));
+  read_pos_ = 0;
+  write_pos_ = 0;
+  Decompress(compressed.data(), compressed.size());
+}
+
+void DbnStreamDecoder::Decompress(const std::uint8_t* data,
+                                  std::size_t length) {
+  std::vector<std::uint8_t> input;
+  if (!pending_input_.empty()) {
+    input = std::move(pending_input_);
+    pending_input_.clear();
+    input.insert(input.end(), data, data + length);
+    data = input.data();
+    length = input.size();
+  }
+  ZSTD_inBuffer z_in_buffer{data, length, 0};
+  do {
+    if (is_frame_start_ && dictionaries_ && z_in_buffer.pos < length) {
+      const auto unread_size = length - z_in_buffer.pos;
+      if (unread_size < detail::ZstdFrameDictionaries::kMaxFrameHeaderSize &&
+          !is_finished_) {
+        // Wait for the rest of the frame header
+        pending_input_.assign(data + z_in_buffer.pos, data + length);
+        return;
+      }
+      dictionaries_->RefFrameDictionary(z_dstream_.get(),
+                                        data + z_in_buffer.pos, unread_size);
+    }
+    DecompressFrame(&z_in_buffer);
+  } while (z_in_buffer.pos < z_in_buffer.size);
+}
+
+void DbnStreamDecoder::DecompressFrame(ZSTD_inBuffer* z_in_buffer) {
+  ZSTD_outBuffer z_out_buffer{};
+  std::size_t res{};
+  // Keep going while output fills the buffer, Zstd may have more
+  do {
+    Reserve(::ZSTD_DStreamOutSize());
+    z_out_buffer = {&buffer_[write_pos_], buffer_.size() - write_pos_, 0};
+    res = ::ZSTD_decompressStream(z_dstream_.get(), &z_out_buffer, z_in_buffer);
+    if (::ZSTD_isError(res)) {
+      throw DbnResponseError{std::string{"Zstd error decompressing: "} +
+                             ::ZSTD_getErrorName(res)};
+    }
+    write_pos_ += z_out_buffer.pos;
+  } while (res != 0 && (z_in_buffer->pos < z_in_buffer->size ||
+                        z_out_buffer.pos == z_out_buffer.size));
+  // Zstd stops at the end of each frame
+  is_frame_start_ = res == 0;
+}
+
+void DbnStreamDecoder::Append(const std::uint8_t* data, std::size_t length) {
+  Reserve(length);
+  std::copy(data, data + length, &buffer_[write_pos_]);
+  write_pos_ += length;
+}
+
+void DbnStreamDecoder::Reserve(std::size_t length) {
+  if (buffer_.size() - write_pos_ < length) {
+    buffer_.resize(std::max(2 * buffer_.size(), write_pos_ + length));
+  }
+}
+
+void DbnStreamDecoder::Compact() {
+  if (read_pos_ == 0) {
+    return;
+  }
+  std::copy(buffer_.cbegin() + static_cast<std::ptrdiff_t>(read_pos_),
+            buffer_.cbegin() + static_cast<std::ptrdiff_t>(write_pos_),
+            buffer_.begin());
+  write_pos_ -= read_pos_;
+  read_pos_ = 0;
+}
+
+databento::RecordHeader* DbnStreamDecoder::ConsumeRecord() {
+  if (UnreadSize() < sizeof(RecordHeader)) {
+    return nullptr;
+  }
+  auto* header = reinterpret_cast<RecordHeader*>(&buffer_[read_pos_]);
+  if (UnreadSize() < header->Size()) {
+    return nullptr;
+  }
+  read_pos_ += header->Size();
+  return header;
+}
+
+void DbnStreamDecoder::UpgradeBatch() {
+  upgraded_idxs_.clear();
+  batch_compat_buffers_.clear();
+  for (std::size_t i = 0; i < record_batch_.size(); ++i) {
+    const auto rec = DbnDecoder::DecodeRecordCompat(
+        version_, upgrade_policy_, ts_out_, &compat_buffer_.data,
+        record_batch_[i]);
+    if (&rec.Header() != &record_batch_[i].Header()) {
+      upgraded_idxs_.emplace_back(i);
+      batch_compat_buffers_.emplace_back(compat_buffer_);
+    }
+  }
+  // `batch_compat_buffers_` is no longer resized so its addresses are stable
+  for (std::size_t i = 0; i < upgraded_idxs_.size(); ++i) {
+    record_batch_[upgraded_idxs_[i]] = Record{
+        reinterpret_cast<RecordHeader*>(batch_compat_buffers_[i].data.data())};
+  }
+}
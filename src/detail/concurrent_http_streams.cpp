@@ -0,0 +1,58 @@
+#include "databento/detail/concurrent_http_streams.hpp"
+
+#include <algorithm>  // max, min
+#include <cstdint>    // uint8_t
+
+using databento::detail::ConcurrentHttpStreams;
+
+ConcurrentHttpStreams::ConcurrentHttpStreams(
+    const ClientFactory& make_client, const std::string& path,
+    const std::vector<httplib::Params>& params_list,
+    std::size_t max_buffered_size) {
+  const auto chunk_size = std::max<std::size_t>(
+      std::min(max_buffered_size, SharedChannel::kDefaultChunkSize), 1);
+  const auto chunk_count =
+      std::max<std::size_t>(max_buffered_size / chunk_size, 1);
+  streams_.reserve(params_list.size());
+  for (const auto& params : params_list) {
+    streams_.emplace_back(
+        new Stream{SharedChannel{chunk_size, chunk_count}, {}, {}});
+    // `Stream` isn't moved once the thread has started
+    auto* stream = streams_.back().get();
+    stream->thread =
+        ScopedThread{[stream, make_client, path, params] {
+          try {
+            make_client()->GetRawStream(
+                path, params, [stream](const char* data, std::size_t length) {
+                  // Returns false once cancelled, cancelling the request
+                  return stream->channel.Write(
+                      reinterpret_cast<const std::uint8_t*>(data), length);
+                });
+          } catch (...) {
+            stream->exception = std::current_exception();
+          }
+          stream->channel.Finish();
+        }};
+  }
+}
+
+ConcurrentHttpStreams::~ConcurrentHttpStreams() { Stop(); }
+
+void ConcurrentHttpStreams::Stop() {
+  for (auto& stream : streams_) {
+    stream->channel.Cancel();
+  }
+  for (auto& stream : streams_) {
+    if (stream->thread.Joinable()) {
+      stream->thread.Join();
+    }
+  }
+}
+
+void ConcurrentHttpStreams::RethrowError() const {
+  for (const auto& stream : streams_) {
+    if (stream->exception) {
+      std::rethrow_exception(stream->exception);
+    }
+  }
+}
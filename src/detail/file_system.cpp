@@ -0,0 +1,49 @@
+#include "databento/detail/file_system.hpp"
+
+#include <dirent.h>  // closedir, opendir
+#ifdef _WIN32
+#include <direct.h>  // _mkdir
+#else
+#include <sys/stat.h>  // mkdir
+#endif
+
+#include <cerrno>
+#include <cstring>  // strerror
+#include <memory>   // unique_ptr
+
+#include "databento/exceptions.hpp"  // Exception
+
+namespace databento {
+namespace detail {
+void TryCreateDir(const std::string& dir_name) {
+  if (dir_name.empty()) {
+    return;
+  }
+  const std::unique_ptr<DIR, int (*)(DIR*)> dir{::opendir(dir_name.c_str()),
+                                                &::closedir};
+  if (dir == nullptr) {
+    const int ret =
+#ifdef _WIN32
+        ::_mkdir(dir_name.c_str());
+#else
+        ::mkdir(dir_name.c_str(), 0777);
+#endif
+    // Another process may have created it in the meantime
+    if (ret != 0 && errno != EEXIST) {
+      throw Exception{std::string{"Unable to create directory "} + dir_name +
+                      ": " + ::strerror(errno)};
+    }
+  }
+}
+
+std::string PathJoin(const std::string& dir, const std::string& path) {
+  if (dir.empty()) {
+    return path;
+  }
+  if (dir[dir.length() - 1] == '/') {
+    return dir + path;
+  }
+  return dir + '/' + path;
+}
+}  // namespace detail
+}  // namespace databento
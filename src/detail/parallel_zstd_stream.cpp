@@ -0,0 +1,242 @@
+#include "databento/detail/parallel_zstd_stream.hpp"
+
+#include <zstd.h>
+
+#include <algorithm>  // copy, max, min
+#include <memory>     // unique_ptr
+#include <sstream>
+#include <string>
+#include <utility>  // move
+#include <vector>
+
+#include "databento/detail/zstd_stream.hpp"  // ZstdFrameDictionaries
+#include "databento/exceptions.hpp"
+#include "databento/file_stream.hpp"  // MappedFileStream
+
+using databento::detail::ParallelZstdDecodeStream;
+using databento::detail::ZstdFrameDictionaries;
+
+namespace {
+// Frame content sizes are read from untrusted headers, so larger frames grow
+// their buffer as they're decompressed instead
+constexpr std::size_t kMaxFramePresize = 64 * 1024 * 1024;
+
+// Decompresses the frame at `src` into `data`, growing it as needed. Returns
+// the decompressed size.
+std::size_t DecompressFrame(ZSTD_DCtx* z_dctx,
+                            ZstdFrameDictionaries* dictionaries,
+                            const std::uint8_t* src, std::size_t src_size,
+                            std::vector<std::uint8_t>* data) {
+  // Also drops any dictionary referenced for the previous frame
+  ::ZSTD_initDStream(z_dctx);
+  if (dictionaries != nullptr) {
+    dictionaries->RefFrameDictionary(z_dctx, src, src_size);
+  }
+  const auto content_size = ::ZSTD_getFrameContentSize(src, src_size);
+  if (content_size != ZSTD_CONTENTSIZE_UNKNOWN &&
+      content_size != ZSTD_CONTENTSIZE_ERROR && content_size > data->size()) {
+    data->resize(static_cast<std::size_t>(
+        std::min<unsigned long long>(content_size, kMaxFramePresize)));
+  }
+  std::size_t size{};
+  ZSTD_inBuffer z_in_buffer{src, src_size, 0};
+  while (true) {
+    if (size == data->size()) {
+      data->resize(std::max(2 * data->size(), ::ZSTD_DStreamOutSize()));
+    }
+    ZSTD_outBuffer z_out_buffer{data->data() + size, data->size() - size, 0};
+    const auto ret =
+        ::ZSTD_decompressStream(z_dctx, &z_out_buffer, &z_in_buffer);
+    size += z_out_buffer.pos;
+    if (::ZSTD_isError(ret)) {
+      throw databento::DbnResponseError{
+          std::string{"Zstd error decompressing: "} + ::ZSTD_getErrorName(ret)};
+    }
+    if (ret == 0) {
+      return size;
+    }
+  }
+}
+}  // namespace
+
+bool databento::detail::HasMultipleZstdFrames(const std::string& file_path) {
+  try {
+    // Lists every frame without reading them
+    return ReadZstdSeekTable(file_path).size() > 1;
+  } catch (const DbnResponseError&) {
+    // Not in the seekable format
+  }
+  const MappedFileStream file{file_path};
+  // Only parses the frame and block headers of the first frame
+  const auto first_frame_size =
+      ::ZSTD_findFrameCompressedSize(file.Peek(), file.Size());
+  return !::ZSTD_isError(first_frame_size) && first_frame_size < file.Size();
+}
+
+ParallelZstdDecodeStream::ParallelZstdDecodeStream(
+    const std::string& file_path, std::size_t thread_count)
+    : ParallelZstdDecodeStream{file_path, thread_count, nullptr} {}
+
+ParallelZstdDecodeStream::ParallelZstdDecodeStream(
+    const std::string& file_path, std::size_t thread_count,
+    const ZstdDictionarySet* dictionaries)
+    : ParallelZstdDecodeStream{file_path, thread_count, dictionaries, 0} {}
+
+ParallelZstdDecodeStream::ParallelZstdDecodeStream(
+    const std::string& file_path, std::size_t thread_count,
+    const ZstdDictionarySet* dictionaries, int window_log_max)
+    : file_{file_path},
+      dictionaries_{dictionaries},
+      window_log_max_{window_log_max},
+      compressed_{file_.Peek()},
+      compressed_size_{file_.RemainingSize()} {
+  if (thread_count == 0) {
+    throw InvalidArgumentError{
+        "ParallelZstdDecodeStream::ParallelZstdDecodeStream", "thread_count",
+        "Must be at least 1"};
+  }
+  // Validated here because the workers can't report it until the first read
+  const auto bounds = ::ZSTD_dParam_getBounds(ZSTD_d_windowLogMax);
+  if (window_log_max != 0 && (window_log_max < bounds.lowerBound ||
+                              window_log_max > bounds.upperBound)) {
+    throw InvalidArgumentError{
+        "ParallelZstdDecodeStream::ParallelZstdDecodeStream", "window_log_max",
+        "Must be 0 or from " + std::to_string(bounds.lowerBound) + " to " +
+            std::to_string(bounds.upperBound)};
+  }
+  // Allow workers to run ahead of the reader by one frame each
+  frames_.resize(2 * thread_count, Frame{{}, 0, false, {}});
+  threads_.reserve(thread_count);
+  for (std::size_t i = 0; i < thread_count; ++i) {
+    threads_.emplace_back(&ParallelZstdDecodeStream::Work, this);
+  }
+}
+
+ParallelZstdDecodeStream::~ParallelZstdDecodeStream() {
+  const std::lock_guard<std::mutex> lock{mutex_};
+  is_stopped_ = true;
+  cv_.notify_all();
+}
+
+void ParallelZstdDecodeStream::ReadExact(std::uint8_t* buffer,
+                                         std::size_t length) {
+  std::size_t size{};
+  while (size < length) {
+    const auto read_size = ReadSome(&buffer[size], length - size);
+    if (read_size == 0) {
+      std::ostringstream err_msg;
+      err_msg << "Reached end of Zstd stream without " << length
+              << " bytes, only " << size << " bytes available";
+      throw DbnResponseError{err_msg.str()};
+    }
+    size += read_size;
+  }
+}
+
+std::size_t ParallelZstdDecodeStream::ReadSome(std::uint8_t* buffer,
+                                               std::size_t max_length) {
+  std::unique_lock<std::mutex> lock{mutex_};
+  while (true) {
+    cv_.wait(lock, [this] {
+      return (read_count_ < claim_count_ &&
+              frames_[read_count_ % frames_.size()].is_ready) ||
+             (read_count_ == claim_count_ && IsEnd());
+    });
+    if (read_count_ == claim_count_) {
+      if (exception_) {
+        std::rethrow_exception(exception_);
+      }
+      return 0;
+    }
+    auto& frame = frames_[read_count_ % frames_.size()];
+    if (frame.exception) {
+      std::rethrow_exception(frame.exception);
+    }
+    if (read_pos_ < frame.size) {
+      // Workers won't touch a ready frame until it's been released
+      lock.unlock();
+      const auto read_size = std::min(frame.size - read_pos_, max_length);
+      std::copy(frame.data.cbegin() + static_cast<std::ptrdiff_t>(read_pos_),
+                frame.data.cbegin() +
+                    static_cast<std::ptrdiff_t>(read_pos_ + read_size),
+                buffer);
+      read_pos_ += read_size;
+      if (read_pos_ == frame.size) {
+        lock.lock();
+        frame.is_ready = false;
+        read_pos_ = 0;
+        ++read_count_;
+        cv_.notify_all();
+      }
+      return read_size;
+    }
+    // Empty frame, e.g. the seek table of the Zstd seekable format
+    frame.is_ready = false;
+    read_pos_ = 0;
+    ++read_count_;
+    cv_.notify_all();
+  }
+}
+
+void ParallelZstdDecodeStream::Work() {
+  const std::unique_ptr<ZSTD_DCtx, std::size_t (*)(ZSTD_DCtx*)> z_dctx{
+      ::ZSTD_createDCtx(), ::ZSTD_freeDCtx};
+  ::ZSTD_DCtx_setParameter(z_dctx.get(), ZSTD_d_windowLogMax,
+                           window_log_max_);
+  // Each worker digests the dictionaries it needs, so they aren't shared
+  // between threads
+  std::unique_ptr<ZstdFrameDictionaries> dictionaries;
+  if (dictionaries_ != nullptr) {
+    dictionaries.reset(new ZstdFrameDictionaries{dictionaries_});
+  }
+  while (true) {
+    const std::uint8_t* src{};
+    std::size_t src_size{};
+    Frame* frame{};
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      cv_.wait(lock, [this] {
+        return is_stopped_ || IsEnd() ||
+               claim_count_ - read_count_ < frames_.size();
+      });
+      if (is_stopped_ || IsEnd()) {
+        return;
+      }
+      src = &compressed_[next_offset_];
+      // Only parses the frame and block headers
+      src_size = ::ZSTD_findFrameCompressedSize(
+          src, compressed_size_ - next_offset_);
+      if (::ZSTD_isError(src_size)) {
+        exception_ = std::make_exception_ptr(
+            DbnResponseError{std::string{"Zstd error finding frame: "} +
+                             ::ZSTD_getErrorName(src_size)});
+        cv_.notify_all();
+        return;
+      }
+      next_offset_ += src_size;
+      frame = &frames_[claim_count_ % frames_.size()];
+      ++claim_count_;
+      // Wake other workers if this was the last frame
+      cv_.notify_all();
+    }
+    frame->size = 0;
+    std::exception_ptr exception;
+    // Decoding errors, including failing to allocate the frame buffer, are
+    // rethrown to the reader
+    try {
+      frame->size = DecompressFrame(z_dctx.get(), dictionaries.get(), src,
+                                    src_size, &frame->data);
+    } catch (...) {
+      exception = std::current_exception();
+    }
+    const std::lock_guard<std::mutex> lock{mutex_};
+    frame->exception = exception;
+    frame->is_ready = true;
+    cv_.notify_all();
+  }
+}
+
+// `mutex_` must be held to call this method
+bool ParallelZstdDecodeStream::IsEnd() const {
+  return next_offset_ >= compressed_size_ || exception_ != nullptr;
+}
@@ -0,0 +1,114 @@
+#include "databento/detail/prefetch_stream.hpp"
+
+#include <algorithm>  // copy, min
+#include <sstream>
+#include <utility>  // move
+
+#include "databento/exceptions.hpp"  // DbnResponseError
+
+using databento::detail::PrefetchStream;
+
+PrefetchStream::PrefetchStream(std::unique_ptr<IReadable> input,
+                               std::size_t block_size, std::size_t block_count)
+    : input_{std::move(input)},
+      blocks_(block_count, Block{std::vector<std::uint8_t>(block_size), 0}),
+      thread_{&PrefetchStream::Prefetch, this} {}
+
+PrefetchStream::~PrefetchStream() {
+  const std::lock_guard<std::mutex> lock{mutex_};
+  is_stopped_ = true;
+  cv_.notify_all();
+}
+
+void PrefetchStream::ReadExact(std::uint8_t* buffer, std::size_t length) {
+  std::size_t size{};
+  while (size < length) {
+    const auto read_size = ReadSome(&buffer[size], length - size);
+    if (read_size == 0) {
+      std::ostringstream err_msg;
+      err_msg << "Unexpected end of input, expected " << length
+              << " bytes, got " << size;
+      throw DbnResponseError{err_msg.str()};
+    }
+    size += read_size;
+  }
+}
+
+std::size_t PrefetchStream::ReadSome(std::uint8_t* buffer,
+                                     std::size_t max_length) {
+  std::unique_lock<std::mutex> lock{mutex_};
+  cv_.wait(lock, [this] { return read_count_ < write_count_ || is_finished_; });
+  if (read_count_ == write_count_) {
+    if (exception_) {
+      std::rethrow_exception(exception_);
+    }
+    return 0;
+  }
+  // The writer won't touch a filled block until it's been released
+  const auto& block = blocks_[read_count_ % blocks_.size()];
+  lock.unlock();
+  const auto read_size = std::min(block.size - read_pos_, max_length);
+  std::copy(block.data.cbegin() + static_cast<std::ptrdiff_t>(read_pos_),
+            block.data.cbegin() +
+                static_cast<std::ptrdiff_t>(read_pos_ + read_size),
+            buffer);
+  read_pos_ += read_size;
+  if (read_pos_ == block.size) {
+    read_pos_ = 0;
+    lock.lock();
+    ++read_count_;
+    cv_.notify_all();
+  }
+  return read_size;
+}
+
+void PrefetchStream::Prefetch() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      cv_.wait(lock, [this] {
+        return write_count_ - read_count_ < blocks_.size() || is_stopped_;
+      });
+      if (is_stopped_) {
+        return;
+      }
+    }
+    // The reader won't touch an empty block until it's been filled
+    auto& block = blocks_[write_count_ % blocks_.size()];
+    block.size = 0;
+    bool is_eof = false;
+    try {
+      // Fill the whole block to reduce hand-offs between the threads
+      while (block.size < block.data.size()) {
+        const auto read_size = input_->ReadSome(
+            &block.data[block.size], block.data.size() - block.size);
+        if (read_size == 0) {
+          is_eof = true;
+          break;
+        }
+        block.size += read_size;
+      }
+    } catch (...) {
+      const std::lock_guard<std::mutex> lock{mutex_};
+      exception_ = std::current_exception();
+      // Deliver the bytes read before the exception first
+      if (block.size > 0) {
+        ++write_count_;
+      }
+      is_finished_ = true;
+      cv_.notify_all();
+      return;
+    }
+    const std::lock_guard<std::mutex> lock{mutex_};
+    if (block.size > 0) {
+      ++write_count_;
+    }
+    if (is_eof) {
+      is_finished_ = true;
+    }
+    cv_.notify_all();
+    if (is_finished_) {
+      return;
+    }
+  }
+}
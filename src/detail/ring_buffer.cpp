@@ -0,0 +1,200 @@
+#include "databento/detail/ring_buffer.hpp"
+
+#ifdef _WIN32
+#include <windows.h>  // CreateFileMappingA, MapViewOfFileEx, VirtualAlloc
+#else
+#include <fcntl.h>     // O_CREAT, O_EXCL, O_RDWR
+#include <sys/mman.h>  // memfd_create, mmap, munmap, shm_open, shm_unlink
+#include <unistd.h>    // close, ftruncate, getpid, sysconf
+#endif
+
+#include <algorithm>  // copy
+#include <atomic>
+#include <string>
+#include <utility>  // swap
+
+using databento::detail::RingBuffer;
+
+RingBuffer::RingBuffer(std::size_t min_capacity) {
+  if (!Mirror(min_capacity)) {
+    fallback_.resize(min_capacity);
+    data_ = fallback_.data();
+    capacity_ = min_capacity;
+  }
+}
+
+RingBuffer::RingBuffer(RingBuffer&& other) noexcept
+    : data_{other.data_},
+      capacity_{other.capacity_},
+      read_pos_{other.read_pos_},
+      write_pos_{other.write_pos_},
+      is_mirrored_{other.is_mirrored_},
+      fallback_{std::move(other.fallback_)} {
+  other.data_ = nullptr;
+  other.capacity_ = 0;
+  other.read_pos_ = 0;
+  other.write_pos_ = 0;
+  other.is_mirrored_ = false;
+}
+
+RingBuffer& RingBuffer::operator=(RingBuffer&& rhs) noexcept {
+  std::swap(data_, rhs.data_);
+  std::swap(capacity_, rhs.capacity_);
+  std::swap(read_pos_, rhs.read_pos_);
+  std::swap(write_pos_, rhs.write_pos_);
+  std::swap(is_mirrored_, rhs.is_mirrored_);
+  std::swap(fallback_, rhs.fallback_);
+  return *this;
+}
+
+RingBuffer::~RingBuffer() { Unmap(); }
+
+void RingBuffer::Consume(std::size_t length) {
+  read_pos_ += length;
+  if (read_pos_ == write_pos_) {
+    read_pos_ = 0;
+    write_pos_ = 0;
+  } else if (is_mirrored_ && read_pos_ >= capacity_) {
+    // Same bytes in the first mapping
+    read_pos_ -= capacity_;
+    write_pos_ -= capacity_;
+  }
+}
+
+void RingBuffer::Compact() {
+  if (is_mirrored_ || read_pos_ == 0) {
+    return;
+  }
+  std::copy(data_ + read_pos_, data_ + write_pos_, data_);
+  write_pos_ -= read_pos_;
+  read_pos_ = 0;
+}
+
+namespace {
+std::size_t RoundUp(std::size_t size, std::size_t granularity) {
+  return (size + granularity - 1) / granularity * granularity;
+}
+}  // namespace
+
+#ifdef _WIN32
+bool RingBuffer::Mirror(std::size_t min_capacity) {
+  SYSTEM_INFO system_info{};
+  ::GetSystemInfo(&system_info);
+  const auto capacity =
+      RoundUp(min_capacity, system_info.dwAllocationGranularity);
+  const auto capacity64 = static_cast<std::uint64_t>(capacity);
+  const HANDLE mapping = ::CreateFileMappingA(
+      INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+      static_cast<DWORD>(capacity64 >> 32), static_cast<DWORD>(capacity64),
+      nullptr);
+  if (mapping == nullptr) {
+    return false;
+  }
+  // Another thread can claim the reserved address range between releasing it
+  // and mapping the views, so retry a few times
+  constexpr int kMaxAttempts = 8;
+  for (int i = 0; i < kMaxAttempts && data_ == nullptr; ++i) {
+    auto* addr = static_cast<std::uint8_t*>(
+        ::VirtualAlloc(nullptr, 2 * capacity, MEM_RESERVE, PAGE_NOACCESS));
+    if (addr == nullptr) {
+      break;
+    }
+    ::VirtualFree(addr, 0, MEM_RELEASE);
+    void* first = ::MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0,
+                                    capacity, addr);
+    void* second = ::MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0,
+                                     capacity, addr + capacity);
+    if (first == addr && second == addr + capacity) {
+      data_ = addr;
+    } else {
+      if (first != nullptr) {
+        ::UnmapViewOfFile(first);
+      }
+      if (second != nullptr) {
+        ::UnmapViewOfFile(second);
+      }
+    }
+  }
+  // The views keep the mapping alive
+  ::CloseHandle(mapping);
+  if (data_ == nullptr) {
+    return false;
+  }
+  capacity_ = capacity;
+  is_mirrored_ = true;
+  return true;
+}
+
+void RingBuffer::Unmap() {
+  if (is_mirrored_ && data_ != nullptr) {
+    ::UnmapViewOfFile(data_);
+    ::UnmapViewOfFile(data_ + capacity_);
+  }
+  data_ = nullptr;
+}
+#else
+namespace {
+int CreateSharedMemory() {
+#ifdef __linux__
+  return ::memfd_create("databento-ring-buffer", MFD_CLOEXEC);
+#else
+  static std::atomic<unsigned> counter{};
+  const auto name = "/databento-ring-buffer-" + std::to_string(::getpid()) +
+                    "-" + std::to_string(counter++);
+  const int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd != -1) {
+    // Only needed through `fd`
+    ::shm_unlink(name.c_str());
+  }
+  return fd;
+#endif
+}
+}  // namespace
+
+bool RingBuffer::Mirror(std::size_t min_capacity) {
+  const auto page_size = ::sysconf(_SC_PAGESIZE);
+  if (page_size <= 0) {
+    return false;
+  }
+  const auto capacity =
+      RoundUp(min_capacity, static_cast<std::size_t>(page_size));
+  const int fd = CreateSharedMemory();
+  if (fd == -1) {
+    return false;
+  }
+  if (::ftruncate(fd, static_cast<off_t>(capacity)) != 0) {
+    ::close(fd);
+    return false;
+  }
+  // Reserve the address range for both views
+  void* addr = ::mmap(nullptr, 2 * capacity, PROT_NONE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (addr == MAP_FAILED) {
+    ::close(fd);
+    return false;
+  }
+  auto* bytes = static_cast<std::uint8_t*>(addr);
+  const bool is_mapped =
+      ::mmap(bytes, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+             fd, 0) != MAP_FAILED &&
+      ::mmap(bytes + capacity, capacity, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED;
+  // The mappings keep the memory alive
+  ::close(fd);
+  if (!is_mapped) {
+    ::munmap(addr, 2 * capacity);
+    return false;
+  }
+  data_ = bytes;
+  capacity_ = capacity;
+  is_mirrored_ = true;
+  return true;
+}
+
+void RingBuffer::Unmap() {
+  if (is_mirrored_ && data_ != nullptr) {
+    ::munmap(data_, 2 * capacity_);
+  }
+  data_ = nullptr;
+}
+#endif
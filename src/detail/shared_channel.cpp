@@ -1,25 +1,31 @@
 #include "databento/detail/shared_channel.hpp"
 
+#include <algorithm>  // copy, min
+#include <atomic>
 #include <condition_variable>
+#include <cstddef>  // ptrdiff_t
+#include <limits>
 #include <memory>
 #include <mutex>
-#include <sstream>  // stringstream
+#include <sstream>
+#include <vector>
 
-#include "databento/exceptions.hpp"  // DbnResponseError
+#include "databento/exceptions.hpp"  // DbnResponseError, InvalidArgumentError
 
 namespace databento {
 namespace detail {
 class SharedChannel::Channel {
  public:
-  Channel() = default;
+  Channel(std::size_t chunk_size, std::size_t chunk_count);
   Channel(const Channel&) = delete;
   Channel& operator=(const Channel&) = delete;
   Channel(Channel&&) = delete;
   Channel& operator=(Channel&&) = delete;
   ~Channel();
 
-  void Write(const std::uint8_t* data, std::size_t length);
+  bool Write(const std::uint8_t* data, std::size_t length);
   void Finish();
+  void Cancel();
   // Read exactly `length` bytes
   void ReadExact(std::uint8_t* buffer, std::size_t length);
   // Read at most `length` bytes. Returns the number of bytes read. Will only
@@ -27,28 +33,65 @@ class SharedChannel::Channel {
   std::size_t ReadSome(std::uint8_t* buffer, std::size_t length);
 
  private:
-  std::size_t Size();
-
-  // protects all other data members of this class
+  // Blocks until `pred` returns true. Only called after `pred` has returned
+  // false without the lock.
+  template <typename P>
+  void Wait(std::atomic<bool>* is_waiting, P pred);
+  // Wakes the other side if it's waiting. Must be called after the store it
+  // should observe.
+  void Notify(const std::atomic<bool>& is_waiting);
+
+  const std::size_t chunk_size_;
+  const std::size_t capacity_;
+  // A ring of `capacity_` bytes split into chunks, each allocated by the
+  // writer the first time it's written to.
+  std::vector<std::vector<std::uint8_t>> chunks_;
+  // Monotonic byte counts, the difference is the number of buffered bytes.
+  // Each is only modified by one side.
+  std::atomic<std::size_t> read_count_{};
+  std::atomic<std::size_t> write_count_{};
+  std::atomic<bool> is_finished_{};
+  std::atomic<bool> is_cancelled_{};
+  // Only used for blocking when the channel is empty or full. Each side sets
+  // its flag before checking the condition again under `mutex_` so the other
+  // side knows to notify it.
+  std::atomic<bool> is_reader_waiting_{};
+  std::atomic<bool> is_writer_waiting_{};
   std::mutex mutex_;
-  // could use eofbit, but seekg clears this
-  bool is_finished_{false};
   std::condition_variable cv_;
-  std::stringstream stream_;
 };
 }  // namespace detail
 }  // namespace databento
 
 using databento::detail::SharedChannel;
 
-SharedChannel::SharedChannel() : channel_{std::make_shared<Channel>()} {}
+SharedChannel::SharedChannel()
+    : SharedChannel{kDefaultChunkSize, kDefaultChunkCount} {}
 
-void SharedChannel::Write(const std::uint8_t* data, std::size_t length) {
-  channel_->Write(data, length);
+SharedChannel::SharedChannel(std::size_t chunk_size, std::size_t chunk_count) {
+  if (chunk_size == 0) {
+    throw InvalidArgumentError{"SharedChannel::SharedChannel", "chunk_size",
+                               "Must be greater than 0"};
+  }
+  if (chunk_count == 0) {
+    throw InvalidArgumentError{"SharedChannel::SharedChannel", "chunk_count",
+                               "Must be greater than 0"};
+  }
+  if (chunk_count > std::numeric_limits<std::size_t>::max() / chunk_size) {
+    throw InvalidArgumentError{"SharedChannel::SharedChannel", "chunk_count",
+                               "Total size overflows"};
+  }
+  channel_ = std::make_shared<Channel>(chunk_size, chunk_count);
+}
+
+bool SharedChannel::Write(const std::uint8_t* data, std::size_t length) {
+  return channel_->Write(data, length);
 }
 
 void SharedChannel::Finish() { channel_->Finish(); }
 
+void SharedChannel::Cancel() { channel_->Cancel(); }
+
 void SharedChannel::ReadExact(std::uint8_t* buffer, std::size_t length) {
   channel_->ReadExact(buffer, length);
 }
@@ -60,54 +103,113 @@ std::size_t SharedChannel::ReadSome(std::uint8_t* buffer,
   return channel_->ReadSome(buffer, max_length);
 }
 
+SharedChannel::Channel::Channel(std::size_t chunk_size, std::size_t chunk_count)
+    : chunk_size_{chunk_size},
+      capacity_{chunk_size * chunk_count},
+      chunks_(chunk_count) {}
+
 SharedChannel::Channel::~Channel() { Finish(); }
 
-void SharedChannel::Channel::Write(const std::uint8_t* data,
+bool SharedChannel::Channel::Write(const std::uint8_t* data,
                                    std::size_t length) {
-  const std::lock_guard<std::mutex> lock{mutex_};
-  stream_.write(reinterpret_cast<const char*>(data),
-                static_cast<std::streamsize>(length));
-  cv_.notify_one();
+  std::size_t pos{};
+  while (pos < length) {
+    const auto write_count = write_count_.load(std::memory_order_relaxed);
+    const auto has_space = [this, write_count] {
+      return write_count - read_count_.load() < capacity_ ||
+             is_cancelled_.load();
+    };
+    if (!has_space()) {
+      Wait(&is_writer_waiting_, has_space);
+    }
+    if (is_cancelled_.load()) {
+      return false;
+    }
+    // Append to the tail chunk up to its end or the reader's position. The
+    // reader won't touch these bytes until they've been published.
+    auto& chunk = chunks_[(write_count / chunk_size_) % chunks_.size()];
+    if (chunk.empty()) {
+      chunk.resize(chunk_size_);
+    }
+    const auto chunk_pos = write_count % chunk_size_;
+    const auto free_size = capacity_ - (write_count - read_count_.load());
+    const auto size =
+        std::min({chunk_size_ - chunk_pos, free_size, length - pos});
+    std::copy(data + pos, data + pos + size,
+              chunk.begin() + static_cast<std::ptrdiff_t>(chunk_pos));
+    pos += size;
+    write_count_.store(write_count + size);
+    Notify(is_reader_waiting_);
+  }
+  return true;
 }
 
 void SharedChannel::Channel::Finish() {
-  const std::lock_guard<std::mutex> lock{mutex_};
-  is_finished_ = true;
-  cv_.notify_one();
+  is_finished_.store(true);
+  Notify(is_reader_waiting_);
+}
+
+void SharedChannel::Channel::Cancel() {
+  is_cancelled_.store(true);
+  Notify(is_writer_waiting_);
 }
 
 void SharedChannel::Channel::ReadExact(std::uint8_t* buffer,
                                        std::size_t length) {
-  std::unique_lock<std::mutex> lock{mutex_};
-  cv_.wait(lock, [this, length] { return Size() >= length || is_finished_; });
-  if (Size() < length) {
-    std::ostringstream err_msg;
-    err_msg << "Reached end of the stream with only " << Size()
-            << " bytes remaining";
-    throw DbnResponseError{err_msg.str()};
+  std::size_t size{};
+  while (size < length) {
+    const auto read_size = ReadSome(&buffer[size], length - size);
+    if (read_size == 0) {
+      std::ostringstream err_msg;
+      err_msg << "Reached end of the stream with only " << size
+              << " bytes remaining";
+      throw DbnResponseError{err_msg.str()};
+    }
+    size += read_size;
   }
-  stream_.read(reinterpret_cast<char*>(buffer),
-               static_cast<std::streamsize>(length));
 }
 
 std::size_t SharedChannel::Channel::ReadSome(std::uint8_t* buffer,
                                              std::size_t length) {
-  std::unique_lock<std::mutex> lock{mutex_};
-  cv_.wait(lock, [this] { return Size() > 0 || is_finished_; });
-  if (Size() == 0) {
+  const auto read_count = read_count_.load(std::memory_order_relaxed);
+  const auto has_data = [this, read_count] {
+    // `write_count_` must be checked first: all writes happen before finishing
+    return write_count_.load() > read_count || is_finished_.load();
+  };
+  if (!has_data()) {
+    Wait(&is_reader_waiting_, has_data);
+  }
+  const auto write_count = write_count_.load();
+  if (write_count == read_count) {
     return 0;
   }
-  stream_.read(reinterpret_cast<char*>(buffer),
-               static_cast<std::streamsize>(std::min(Size(), length)));
-  return static_cast<std::size_t>(stream_.gcount());
+  // The writer won't touch published bytes until they've been released
+  const auto& chunk = chunks_[(read_count / chunk_size_) % chunks_.size()];
+  const auto chunk_pos = read_count % chunk_size_;
+  const auto read_size =
+      std::min({chunk_size_ - chunk_pos, write_count - read_count, length});
+  const auto chunk_it =
+      chunk.cbegin() + static_cast<std::ptrdiff_t>(chunk_pos);
+  std::copy(chunk_it, chunk_it + static_cast<std::ptrdiff_t>(read_size),
+            buffer);
+  read_count_.store(read_count + read_size);
+  Notify(is_writer_waiting_);
+  return read_size;
 }
 
-// lock_ must be held to call this method
-std::size_t SharedChannel::Channel::Size() {
-  const auto pos = stream_.tellg();
-  stream_.seekg(0, std::ios::end);
-  const auto remaining = stream_.tellg() - pos;
-  // reset state
-  stream_.seekg(pos, std::ios::beg);
-  return static_cast<std::size_t>(remaining);
+template <typename P>
+void SharedChannel::Channel::Wait(std::atomic<bool>* is_waiting, P pred) {
+  std::unique_lock<std::mutex> lock{mutex_};
+  is_waiting->store(true);
+  cv_.wait(lock, pred);
+  is_waiting->store(false);
+}
+
+void SharedChannel::Channel::Notify(const std::atomic<bool>& is_waiting) {
+  // Sequentially consistent with the waiter setting its flag, so either it
+  // observes the preceding store or this observes its flag
+  if (is_waiting.load()) {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    cv_.notify_all();
+  }
 }
@@ -1,30 +1,85 @@
 #include "databento/detail/zstd_stream.hpp"
 
 #include <algorithm>
+#include <array>
+#include <exception>  // exception
+#include <fstream>    // ifstream
+#include <ios>        // ios, streamoff, streamsize
+#include <iterator>   // prev
 #include <sstream>
 #include <utility>  // move
 
 #include "databento/exceptions.hpp"
+#include "databento/file_stream.hpp"
 #include "databento/log.hpp"
 
 using databento::detail::ZstdDecodeStream;
+using databento::detail::ZstdFrameDictionaries;
+
+ZstdFrameDictionaries::ZstdFrameDictionaries(
+    const ZstdDictionarySet* dictionaries)
+    : dictionaries_{dictionaries} {}
+
+void ZstdFrameDictionaries::RefFrameDictionary(ZSTD_DStream* z_dstream,
+                                               const std::uint8_t* frame,
+                                               std::size_t size) {
+  // 0 for frames without a dictionary and skippable frames
+  const auto dict_id = ::ZSTD_getDictID_fromFrame(frame, size);
+  if (dict_id == 0) {
+    return;
+  }
+  auto ddict_it = ddicts_.find(dict_id);
+  if (ddict_it == ddicts_.end()) {
+    const auto* dictionary = dictionaries_->FindById(dict_id);
+    if (dictionary == nullptr) {
+      throw DbnResponseError{"Missing Zstd dictionary with ID " +
+                             std::to_string(dict_id)};
+    }
+    std::unique_ptr<ZSTD_DDict, std::size_t (*)(ZSTD_DDict*)> ddict{
+        ::ZSTD_createDDict(dictionary->Data().data(),
+                           dictionary->Data().size()),
+        ::ZSTD_freeDDict};
+    ddict_it = ddicts_.emplace(dict_id, std::move(ddict)).first;
+  }
+  ::ZSTD_DCtx_refDDict(z_dstream, ddict_it->second.get());
+}
 
 ZstdDecodeStream::ZstdDecodeStream(std::unique_ptr<IReadable> input)
-    : ZstdDecodeStream{std::move(input), {}} {}
+    : ZstdDecodeStream{std::move(input), {}, nullptr} {}
 
 ZstdDecodeStream::ZstdDecodeStream(std::unique_ptr<IReadable> input,
                                    std::vector<std::uint8_t>&& in_buffer)
+    : ZstdDecodeStream{std::move(input), std::move(in_buffer), nullptr} {}
+
+ZstdDecodeStream::ZstdDecodeStream(std::unique_ptr<IReadable> input,
+                                   const ZstdDictionarySet* dictionaries)
+    : ZstdDecodeStream{std::move(input), {}, dictionaries} {}
+
+ZstdDecodeStream::ZstdDecodeStream(std::unique_ptr<IReadable> input,
+                                   std::vector<std::uint8_t>&& in_buffer,
+                                   const ZstdDictionarySet* dictionaries)
     : input_{std::move(input)},
       z_dstream_{::ZSTD_createDStream(), ::ZSTD_freeDStream},
       read_suggestion_{::ZSTD_initDStream(z_dstream_.get())},
       in_buffer_{std::move(in_buffer)},
-      z_in_buffer_{in_buffer_.data(), in_buffer_.size(), 0} {}
+      z_in_buffer_{nullptr, in_buffer_.size(), 0} {
+  if (dictionaries != nullptr) {
+    dictionaries_.reset(new ZstdFrameDictionaries{dictionaries});
+  }
+  // Any initial input is kept at the front of the fixed-size buffer
+  in_buffer_.resize(std::max(in_buffer_.size(), ::ZSTD_DStreamInSize()));
+  z_in_buffer_.src = in_buffer_.data();
+}
 
 void ZstdDecodeStream::ReadExact(std::uint8_t* buffer, std::size_t length) {
   std::size_t size{};
+  std::size_t read_size{};
+  // `ReadSome` only returns 0 at the end of the input, not at the end of each
+  // frame
   do {
-    size += ReadSome(&buffer[size], length - size);
-  } while (size < length && read_suggestion_ != 0);
+    read_size = ReadSome(&buffer[size], length - size);
+    size += read_size;
+  } while (size < length && read_size > 0);
   // check for end of stream without obtaining `length` bytes
   if (size < length) {
     std::ostringstream err_msg;
@@ -34,79 +89,372 @@ void ZstdDecodeStream::ReadExact(std::uint8_t* buffer, std::size_t length) {
   }
 }
 
+void ZstdDecodeStream::Reset(std::unique_ptr<IReadable> input) {
+  input_ = std::move(input);
+  read_suggestion_ = ::ZSTD_initDStream(z_dstream_.get());
+  z_in_buffer_.size = 0;
+  z_in_buffer_.pos = 0;
+  is_frame_start_ = true;
+  is_input_end_ = false;
+  is_output_pending_ = false;
+}
+
+void ZstdDecodeStream::SetWindowLogMax(int window_log_max) {
+  // Kept by `ZSTD_initDStream`, so it applies to every later frame and input
+  const auto res = ::ZSTD_DCtx_setParameter(
+      z_dstream_.get(), ZSTD_d_windowLogMax, window_log_max);
+  if (::ZSTD_isError(res)) {
+    throw InvalidArgumentError{"ZstdDecodeStream::SetWindowLogMax",
+                               "window_log_max", ::ZSTD_getErrorName(res)};
+  }
+}
+
 std::size_t ZstdDecodeStream::ReadSome(std::uint8_t* buffer,
                                        std::size_t max_length) {
+  if (max_length == 0) {
+    return 0;
+  }
   ZSTD_outBuffer z_out_buffer{buffer, max_length, 0};
-  std::size_t read_size = 0;
-  do {
-    const auto unread_input = z_in_buffer_.size - z_in_buffer_.pos;
-    if (unread_input > 0) {
-      std::copy(
-          in_buffer_.cbegin() + static_cast<std::ptrdiff_t>(z_in_buffer_.pos),
-          in_buffer_.cend(), in_buffer_.begin());
-    }
+  while (z_out_buffer.pos == 0) {
     if (read_suggestion_ == 0) {
       // next frame
       read_suggestion_ = ::ZSTD_initDStream(z_dstream_.get());
+      is_frame_start_ = true;
     }
-    const auto new_size = unread_input + read_suggestion_;
-    if (new_size != in_buffer_.size()) {
-      in_buffer_.resize(new_size);
-      z_in_buffer_.src = in_buffer_.data();
+    const auto unread_input = z_in_buffer_.size - z_in_buffer_.pos;
+    const bool needs_dictionary = is_frame_start_ && dictionaries_ != nullptr;
+    if (needs_dictionary &&
+        unread_input < ZstdFrameDictionaries::kMaxFrameHeaderSize &&
+        !is_input_end_) {
+      // Read the whole frame header to find the dictionary ID
+      Refill();
+      continue;
+    }
+    // Zstd may hold decompressed data that didn't fit in the last output
+    // buffer, so only wait for more input once it's been flushed
+    if (unread_input == 0 && !is_output_pending_ && !Refill()) {
+      break;
+    }
+    if (needs_dictionary) {
+      // Input is consumed in place, so the frame starts at the current
+      // position
+      dictionaries_->RefFrameDictionary(z_dstream_.get(),
+                                        &in_buffer_[z_in_buffer_.pos],
+                                        z_in_buffer_.size - z_in_buffer_.pos);
+      is_frame_start_ = false;
     }
-    read_size = input_->ReadSome(&in_buffer_[unread_input], read_suggestion_);
-    z_in_buffer_.size = unread_input + read_size;
-    z_in_buffer_.pos = 0;
-
     read_suggestion_ =
         ::ZSTD_decompressStream(z_dstream_.get(), &z_out_buffer, &z_in_buffer_);
     if (::ZSTD_isError(read_suggestion_)) {
       throw DbnResponseError{std::string{"Zstd error decompressing: "} +
                              ::ZSTD_getErrorName(read_suggestion_)};
     }
-  } while (z_out_buffer.pos == 0 && read_size > 0);
+    is_output_pending_ = z_out_buffer.pos == z_out_buffer.size;
+  }
   return z_out_buffer.pos;
 }
 
+bool ZstdDecodeStream::Refill() {
+  // Only the start of a frame header can be left unread, so this copy is tiny
+  const auto unread_input = z_in_buffer_.size - z_in_buffer_.pos;
+  if (unread_input > 0 && z_in_buffer_.pos > 0) {
+    std::copy(
+        in_buffer_.cbegin() + static_cast<std::ptrdiff_t>(z_in_buffer_.pos),
+        in_buffer_.cbegin() + static_cast<std::ptrdiff_t>(z_in_buffer_.size),
+        in_buffer_.begin());
+  }
+  const auto read_size = input_->ReadSome(&in_buffer_[unread_input],
+                                          in_buffer_.size() - unread_input);
+  z_in_buffer_.size = unread_input + read_size;
+  z_in_buffer_.pos = 0;
+  is_input_end_ = read_size == 0;
+  return !is_input_end_;
+}
+
+namespace {
+// Zstd seekable format constants
+constexpr std::uint32_t kSkippableFrameMagic = 0x184D2A5E;
+constexpr std::uint32_t kSeekableMagic = 0x8F92EAB1;
+constexpr std::size_t kSkippableHeaderSize = 8;
+constexpr std::size_t kSeekTableFooterSize = 9;
+constexpr std::size_t kSeekTableEntrySize = 8;
+constexpr std::size_t kSeekTableChecksumSize = 4;
+constexpr std::uint8_t kSeekTableChecksumFlag = 1 << 7;
+
+template <typename T>
+T ReadLittleEndian(const std::uint8_t* buffer) {
+  T res{};
+  std::copy(buffer, buffer + sizeof(T), reinterpret_cast<std::uint8_t*>(&res));
+  return res;
+}
+
+template <typename T>
+void WriteLittleEndian(T value, std::vector<std::uint8_t>* buffer) {
+  const auto* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+  buffer->insert(buffer->end(), bytes, bytes + sizeof(T));
+}
+}  // namespace
+
+std::vector<databento::detail::ZstdSeekableFrame>
+databento::detail::ReadZstdSeekTable(const std::string& file_path) {
+  std::ifstream file{file_path, std::ios::binary | std::ios::ate};
+  if (file.fail()) {
+    throw InvalidArgumentError{"ReadZstdSeekTable", "file_path",
+                               "Non-existent or invalid file"};
+  }
+  const auto file_size = static_cast<std::uint64_t>(file.tellg());
+  const auto read_at = [&file](std::uint64_t offset, std::uint8_t* buffer,
+                               std::size_t length) {
+    file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+    file.read(reinterpret_cast<char*>(buffer),
+              static_cast<std::streamsize>(length));
+    if (file.fail()) {
+      throw DbnResponseError{"Unexpected end of file reading Zstd seek table"};
+    }
+  };
+  if (file_size < kSkippableHeaderSize + kSeekTableFooterSize) {
+    throw DbnResponseError{"File too small to contain a Zstd seek table"};
+  }
+  std::array<std::uint8_t, kSeekTableFooterSize> footer{};
+  read_at(file_size - kSeekTableFooterSize, footer.data(), footer.size());
+  if (ReadLittleEndian<std::uint32_t>(&footer[5]) != kSeekableMagic) {
+    throw DbnResponseError{"Missing Zstd seekable format footer"};
+  }
+  const auto frame_count = ReadLittleEndian<std::uint32_t>(footer.data());
+  const auto entry_size = kSeekTableEntrySize +
+                          ((footer[4] & kSeekTableChecksumFlag) != 0
+                               ? kSeekTableChecksumSize
+                               : 0);
+  const std::uint64_t table_size = kSkippableHeaderSize +
+                                   std::uint64_t{frame_count} * entry_size +
+                                   kSeekTableFooterSize;
+  if (table_size > file_size) {
+    throw DbnResponseError{"Zstd seek table is larger than the file"};
+  }
+  std::vector<std::uint8_t> table(table_size - kSeekTableFooterSize);
+  read_at(file_size - table_size, table.data(), table.size());
+  if (ReadLittleEndian<std::uint32_t>(table.data()) != kSkippableFrameMagic ||
+      ReadLittleEndian<std::uint32_t>(&table[4]) !=
+          table_size - kSkippableHeaderSize) {
+    throw DbnResponseError{"Invalid Zstd seek table frame header"};
+  }
+  std::vector<ZstdSeekableFrame> frames;
+  frames.reserve(frame_count);
+  std::uint64_t compressed_offset{};
+  std::uint64_t decompressed_offset{};
+  for (std::size_t i = 0; i < frame_count; ++i) {
+    const auto* entry = &table[kSkippableHeaderSize + i * entry_size];
+    const auto compressed_size = ReadLittleEndian<std::uint32_t>(entry);
+    const auto decompressed_size = ReadLittleEndian<std::uint32_t>(&entry[4]);
+    frames.emplace_back(ZstdSeekableFrame{compressed_offset,
+                                          decompressed_offset, compressed_size,
+                                          decompressed_size});
+    compressed_offset += compressed_size;
+    decompressed_offset += decompressed_size;
+  }
+  if (compressed_offset + table_size > file_size) {
+    throw DbnResponseError{"Zstd seek table frames exceed the file size"};
+  }
+  return frames;
+}
+
+using databento::detail::ZstdSeekableDecodeStream;
+
+namespace {
+// Reads from a file owned by the `ZstdSeekableDecodeStream`, so seeking
+// doesn't reopen it.
+class FileReader : public databento::IReadable {
+ public:
+  explicit FileReader(databento::InFileStream* file) : file_{file} {}
+
+  void ReadExact(std::uint8_t* buffer, std::size_t length) override {
+    file_->ReadExact(buffer, length);
+  }
+  std::size_t ReadSome(std::uint8_t* buffer, std::size_t max_length) override {
+    return file_->ReadSome(buffer, max_length);
+  }
+
+ private:
+  databento::InFileStream* file_;
+};
+}  // namespace
+
+ZstdSeekableDecodeStream::ZstdSeekableDecodeStream(
+    const std::string& file_path)
+    : ZstdSeekableDecodeStream{file_path, nullptr} {}
+
+ZstdSeekableDecodeStream::ZstdSeekableDecodeStream(
+    const std::string& file_path, const ZstdDictionarySet* dictionaries)
+    : file_{file_path},
+      dictionaries_{dictionaries},
+      frames_{ReadZstdSeekTable(file_path)} {
+  Seek(0);
+}
+
+std::uint64_t ZstdSeekableDecodeStream::DecompressedSize() const {
+  if (frames_.empty()) {
+    return 0;
+  }
+  return frames_.back().decompressed_offset + frames_.back().decompressed_size;
+}
+
+void ZstdSeekableDecodeStream::Seek(std::uint64_t decompressed_offset) {
+  if (decompressed_offset > DecompressedSize()) {
+    throw InvalidArgumentError{
+        "ZstdSeekableDecodeStream::Seek", "decompressed_offset",
+        "Past the end of the decompressed data of " +
+            std::to_string(DecompressedSize()) + " bytes"};
+  }
+  // Find the last frame starting at or before `decompressed_offset`
+  const auto frame_it = std::upper_bound(
+      frames_.cbegin(), frames_.cend(), decompressed_offset,
+      [](std::uint64_t offset, const ZstdSeekableFrame& frame) {
+        return offset < frame.decompressed_offset;
+      });
+  std::uint64_t compressed_offset{};
+  std::uint64_t skip{decompressed_offset};
+  if (frame_it != frames_.cbegin()) {
+    compressed_offset = std::prev(frame_it)->compressed_offset;
+    skip -= std::prev(frame_it)->decompressed_offset;
+  }
+  file_.Seek(compressed_offset);
+  std::unique_ptr<IReadable> file{new FileReader{&file_}};
+  if (stream_) {
+    // Reuse the decompression context and buffer
+    stream_->Reset(std::move(file));
+  } else {
+    stream_.reset(new ZstdDecodeStream{std::move(file), dictionaries_});
+  }
+  // Discard the start of the frame
+  std::array<std::uint8_t, 4096> discard{};
+  while (skip > 0) {
+    const auto read_size = static_cast<std::size_t>(
+        std::min<std::uint64_t>(skip, discard.size()));
+    stream_->ReadExact(discard.data(), read_size);
+    skip -= read_size;
+  }
+}
+
+void ZstdSeekableDecodeStream::SetWindowLogMax(int window_log_max) {
+  // The decompression context is reused by every seek
+  stream_->SetWindowLogMax(window_log_max);
+}
+
+void ZstdSeekableDecodeStream::ReadExact(std::uint8_t* buffer,
+                                         std::size_t length) {
+  stream_->ReadExact(buffer, length);
+}
+
+std::size_t ZstdSeekableDecodeStream::ReadSome(std::uint8_t* buffer,
+                                               std::size_t max_length) {
+  return stream_->ReadSome(buffer, max_length);
+}
+
 using databento::detail::ZstdCompressStream;
 
+namespace {
+std::size_t ValidateFrameSize(std::size_t frame_size, bool allow_zero) {
+  // Frame sizes are stored as 32-bit integers in the seek table
+  constexpr std::size_t kMaxFrameSize = 1UL << 30;
+  if ((frame_size == 0 && !allow_zero) || frame_size > kMaxFrameSize) {
+    throw databento::InvalidArgumentError{
+        "ZstdCompressStream::ZstdCompressStream", "frame_size",
+        "Must be between 1 byte and 1 GiB"};
+  }
+  return frame_size;
+}
+}  // namespace
+
 ZstdCompressStream::ZstdCompressStream(IWritable* output)
     : ZstdCompressStream{ILogReceiver::Default(), output} {}
 ZstdCompressStream::ZstdCompressStream(ILogReceiver* log_receiver,
                                        IWritable* output)
+    : ZstdCompressStream{log_receiver, output, 0, ZstdCompressOptions{}} {}
+
+ZstdCompressStream::ZstdCompressStream(ILogReceiver* log_receiver,
+                                       IWritable* output,
+                                       std::size_t frame_size)
+    : ZstdCompressStream{log_receiver, output,
+                         ValidateFrameSize(frame_size, false),
+                         ZstdCompressOptions{}} {}
+
+ZstdCompressStream::ZstdCompressStream(ILogReceiver* log_receiver,
+                                       IWritable* output,
+                                       const ZstdCompressOptions& options)
+    : ZstdCompressStream{log_receiver, output, 0, options} {}
+
+ZstdCompressStream::ZstdCompressStream(ILogReceiver* log_receiver,
+                                       IWritable* output,
+                                       std::size_t frame_size,
+                                       const ZstdCompressOptions& options)
     : log_receiver_{log_receiver},
       output_{output},
       z_cstream_{::ZSTD_createCStream(), ::ZSTD_freeCStream},
       in_buffer_{},
       z_in_buffer_{in_buffer_.data(), 0, 0},
       in_size_{::ZSTD_CStreamInSize()},
-      out_buffer_(::ZSTD_CStreamOutSize()) {
+      out_buffer_(::ZSTD_CStreamOutSize()),
+      frame_size_{ValidateFrameSize(frame_size, true)} {
   in_buffer_.reserve(in_size_);
   z_in_buffer_.src = in_buffer_.data();
   // enable checksums
   ::ZSTD_CCtx_setParameter(z_cstream_.get(), ZSTD_c_checksumFlag, 1);
+  SetParameter(ZSTD_c_compressionLevel, options.level, "level");
+  SetParameter(ZSTD_c_enableLongDistanceMatching,
+               options.enable_long_distance_matching ? 1 : 0,
+               "enable_long_distance_matching");
+  SetParameter(ZSTD_c_windowLog, options.window_log, "window_log");
+  if (options.dictionary != nullptr) {
+    const auto& dict_data = options.dictionary->Data();
+    const auto res = ::ZSTD_CCtx_loadDictionary(
+        z_cstream_.get(), dict_data.data(), dict_data.size());
+    if (::ZSTD_isError(res)) {
+      throw InvalidArgumentError{"ZstdCompressStream::ZstdCompressStream",
+                                 "dictionary", ::ZSTD_getErrorName(res)};
+    }
+  }
+  if (options.worker_count < 0) {
+    throw InvalidArgumentError{"ZstdCompressStream::ZstdCompressStream",
+                               "worker_count", "Can't be negative"};
+  }
+  if (options.worker_count > 0) {
+    const auto res = ::ZSTD_CCtx_setParameter(
+        z_cstream_.get(), ZSTD_c_nbWorkers, options.worker_count);
+    if (::ZSTD_isError(res) && log_receiver_) {
+      log_receiver_->Receive(
+          LogLevel::Warning,
+          std::string{"Compressing on the calling thread, libzstd doesn't "
+                      "support multithreading: "} +
+              ::ZSTD_getErrorName(res));
+    }
+  }
 }
 
 ZstdCompressStream::~ZstdCompressStream() {
-  ZSTD_outBuffer z_out_buffer{out_buffer_.data(), out_buffer_.size(), 0};
-  while (true) {
-    const std::size_t remaining = ::ZSTD_compressStream2(
-        z_cstream_.get(), &z_out_buffer, &z_in_buffer_, ::ZSTD_e_end);
-    if (remaining == 0) {
-      break;
+  try {
+    if (frame_size_ > 0) {
+      if (frame_in_size_ > 0) {
+        EndFrame();
+      }
+      WriteSeekTable();
+    } else {
+      Flush(::ZSTD_e_end);
     }
-    if (::ZSTD_isError(remaining) && log_receiver_) {
+  } catch (const std::exception& exc) {
+    if (log_receiver_) {
       log_receiver_->Receive(
           LogLevel::Error,
-          std::string{"Zstd error compressing end of stream: "} +
-              ::ZSTD_getErrorName(remaining));
-      break;
+          std::string{"Error finishing Zstd stream: "} + exc.what());
     }
   }
-  assert(z_in_buffer_.pos == z_in_buffer_.size);
-  // Forward compressed output
-  if (z_out_buffer.pos > 0) {
-    output_->WriteAll(out_buffer_.data(), z_out_buffer.pos);
+}
+
+void ZstdCompressStream::SetParameter(ZSTD_cParameter param, int value,
+                                      const char* param_name) {
+  const auto res = ::ZSTD_CCtx_setParameter(z_cstream_.get(), param, value);
+  if (::ZSTD_isError(res)) {
+    throw InvalidArgumentError{"ZstdCompressStream::ZstdCompressStream",
+                               param_name, ::ZSTD_getErrorName(res)};
   }
 }
 
@@ -114,6 +462,11 @@ void ZstdCompressStream::WriteAll(const std::uint8_t* buffer,
                                   std::size_t length) {
   in_buffer_.insert(in_buffer_.end(), buffer, buffer + length);
   z_in_buffer_ = {in_buffer_.data(), in_buffer_.size(), 0};
+  frame_in_size_ += length;
+  if (frame_size_ > 0 && frame_in_size_ >= frame_size_) {
+    EndFrame();
+    return;
+  }
   // Wait for sufficient data before compressing
   if (in_buffer_.size() >= in_size_) {
     ZSTD_outBuffer z_out_buffer{out_buffer_.data(), out_buffer_.size(), 0};
@@ -134,6 +487,55 @@ void ZstdCompressStream::WriteAll(const std::uint8_t* buffer,
     if (z_out_buffer.pos > 0) {
       // Forward compressed output
       output_->WriteAll(out_buffer_.data(), z_out_buffer.pos);
+      frame_out_size_ += z_out_buffer.pos;
     }
   }
 }
+
+void ZstdCompressStream::Flush(ZSTD_EndDirective directive) {
+  std::size_t remaining{};
+  do {
+    ZSTD_outBuffer z_out_buffer{out_buffer_.data(), out_buffer_.size(), 0};
+    remaining = ::ZSTD_compressStream2(z_cstream_.get(), &z_out_buffer,
+                                       &z_in_buffer_, directive);
+    if (::ZSTD_isError(remaining)) {
+      throw DbnResponseError{std::string{"Zstd error compressing: "} +
+                             ::ZSTD_getErrorName(remaining)};
+    }
+    if (z_out_buffer.pos > 0) {
+      output_->WriteAll(out_buffer_.data(), z_out_buffer.pos);
+      frame_out_size_ += z_out_buffer.pos;
+    }
+  } while (remaining > 0);
+}
+
+void ZstdCompressStream::EndFrame() {
+  Flush(::ZSTD_e_end);
+  in_buffer_.clear();
+  z_in_buffer_ = {in_buffer_.data(), 0, 0};
+  frames_.emplace_back(ZstdSeekableFrame{
+      0, 0, static_cast<std::uint32_t>(frame_out_size_),
+      static_cast<std::uint32_t>(frame_in_size_)});
+  frame_in_size_ = 0;
+  frame_out_size_ = 0;
+}
+
+void ZstdCompressStream::WriteSeekTable() {
+  std::vector<std::uint8_t> table;
+  const auto frame_count = static_cast<std::uint32_t>(frames_.size());
+  table.reserve(kSkippableHeaderSize + frame_count * kSeekTableEntrySize +
+                kSeekTableFooterSize);
+  WriteLittleEndian(kSkippableFrameMagic, &table);
+  WriteLittleEndian(static_cast<std::uint32_t>(
+                        frame_count * kSeekTableEntrySize + kSeekTableFooterSize),
+                    &table);
+  for (const auto& frame : frames_) {
+    WriteLittleEndian(frame.compressed_size, &table);
+    WriteLittleEndian(frame.decompressed_size, &table);
+  }
+  WriteLittleEndian(frame_count, &table);
+  // No checksums: each frame already has its own
+  WriteLittleEndian(std::uint8_t{0}, &table);
+  WriteLittleEndian(kSeekableMagic, &table);
+  output_->WriteAll(table.data(), table.size());
+}
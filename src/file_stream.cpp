@@ -1,7 +1,20 @@
 #include "databento/file_stream.hpp"
 
-#include <ios>  // ios, streamsize
+#ifdef _WIN32
+#include <windows.h>  // CreateFileA, CreateFileMappingA, MapViewOfFile
+#else
+#include <fcntl.h>     // open
+#include <sys/mman.h>  // madvise, mmap, munmap
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // close
+#endif
+
+#include <algorithm>  // copy, min
+#include <cerrno>
+#include <cstring>  // strerror
+#include <ios>      // ios, streamoff, streamsize
 #include <sstream>
+#include <utility>  // swap
 
 #include "databento/exceptions.hpp"
 
@@ -32,6 +45,147 @@ std::size_t InFileStream::ReadSome(std::uint8_t* buffer,
   return static_cast<std::size_t>(stream_.gcount());
 }
 
+void InFileStream::Seek(std::uint64_t offset) {
+  // clear any eofbit
+  stream_.clear();
+  stream_.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+  if (stream_.fail()) {
+    throw InvalidArgumentError{"InFileStream::Seek", "offset",
+                               "Failed to seek to " + std::to_string(offset)};
+  }
+}
+
+using databento::MappedFileStream;
+
+MappedFileStream::MappedFileStream(const std::string& file_path) {
+#ifdef _WIN32
+  const HANDLE file =
+      ::CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                    OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw InvalidArgumentError{"MappedFileStream", "file_path",
+                               "Non-existent or invalid file"};
+  }
+  LARGE_INTEGER file_size{};
+  if (!::GetFileSizeEx(file, &file_size)) {
+    ::CloseHandle(file);
+    throw InvalidArgumentError{"MappedFileStream", "file_path",
+                               "Failed to determine file size"};
+  }
+  size_ = static_cast<std::size_t>(file_size.QuadPart);
+  if (size_ > 0) {
+    // Copy-on-write so records can be handed out as mutable like with other
+    // inputs without modifying the file
+    const HANDLE mapping =
+        ::CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (mapping != nullptr) {
+      data_ = static_cast<std::uint8_t*>(
+          ::MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+      // The view holds a reference to the mapping
+      ::CloseHandle(mapping);
+    }
+  }
+  ::CloseHandle(file);
+  if (size_ > 0 && data_ == nullptr) {
+    throw InvalidArgumentError{"MappedFileStream", "file_path",
+                               "Failed to map file"};
+  }
+#else
+  const int fd = ::open(file_path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw InvalidArgumentError{"MappedFileStream", "file_path",
+                               "Non-existent or invalid file"};
+  }
+  struct stat file_stat {};
+  if (::fstat(fd, &file_stat) == -1) {
+    const auto err = errno;
+    ::close(fd);
+    throw InvalidArgumentError{
+        "MappedFileStream", "file_path",
+        std::string{"Failed to determine file size: "} + std::strerror(err)};
+  }
+  size_ = static_cast<std::size_t>(file_stat.st_size);
+  // `mmap` rejects zero-length mappings
+  if (size_ > 0) {
+    // Copy-on-write so records can be handed out as mutable like with other
+    // inputs without modifying the file
+    void* addr = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                        fd, 0);
+    if (addr == MAP_FAILED) {
+      const auto err = errno;
+      ::close(fd);
+      throw InvalidArgumentError{
+          "MappedFileStream", "file_path",
+          std::string{"Failed to map file: "} + std::strerror(err)};
+    }
+    data_ = static_cast<std::uint8_t*>(addr);
+    // Only a hint, so failure isn't an error
+    ::madvise(addr, size_, MADV_SEQUENTIAL);
+  }
+  // The mapping remains valid after the descriptor is closed
+  ::close(fd);
+#endif
+}
+
+MappedFileStream::MappedFileStream(MappedFileStream&& other) noexcept
+    : data_{other.data_}, size_{other.size_}, pos_{other.pos_} {
+  other.data_ = nullptr;
+  other.size_ = 0;
+  other.pos_ = 0;
+}
+
+MappedFileStream& MappedFileStream::operator=(
+    MappedFileStream&& rhs) noexcept {
+  std::swap(data_, rhs.data_);
+  std::swap(size_, rhs.size_);
+  std::swap(pos_, rhs.pos_);
+  return *this;
+}
+
+MappedFileStream::~MappedFileStream() { Unmap(); }
+
+void MappedFileStream::ReadExact(std::uint8_t* buffer, std::size_t length) {
+  const auto size = ReadSome(buffer, length);
+  if (size != length) {
+    std::ostringstream err_msg;
+    err_msg << "Unexpected end of file, expected " << length << " bytes, got "
+            << size;
+    throw DbnResponseError{err_msg.str()};
+  }
+}
+
+std::size_t MappedFileStream::ReadSome(std::uint8_t* buffer,
+                                       std::size_t max_length) {
+  const auto read_size = std::min(max_length, RemainingSize());
+  std::copy(Peek(), Peek() + read_size, buffer);
+  pos_ += read_size;
+  return read_size;
+}
+
+void MappedFileStream::Consume(std::size_t length) {
+  pos_ += std::min(length, RemainingSize());
+}
+
+void MappedFileStream::Seek(std::size_t offset) {
+  if (offset > size_) {
+    throw InvalidArgumentError{"MappedFileStream::Seek", "offset",
+                               "Past the end of the file of " +
+                                   std::to_string(size_) + " bytes"};
+  }
+  pos_ = offset;
+}
+
+void MappedFileStream::Unmap() {
+  if (data_ != nullptr) {
+#ifdef _WIN32
+    ::UnmapViewOfFile(data_);
+#else
+    ::munmap(data_, size_);
+#endif
+    data_ = nullptr;
+  }
+}
+
 using databento::OutFileStream;
 
 OutFileStream::OutFileStream(const std::string& file_path)
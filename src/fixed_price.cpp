@@ -1,22 +1,62 @@
 #include "databento/fixed_price.hpp"
 
-#include <iomanip>
+#include <array>
+#include <cstring>  // memcpy
+#include <ios>      // streamsize
+#include <system_error>
 
-namespace databento {
-std::ostream& operator<<(std::ostream& stream, FixPx fix_px) {
+#include "text_format.hpp"
+
+namespace {
+constexpr auto kUndefPriceStr = "kUndefPrice";
+constexpr std::size_t kUndefPriceStrLen = 11;
+
+// `out` must have space for `kMaxFixPxLen` characters.
+char* WriteFixPx(char* out, databento::FixPx fix_px) {
   if (fix_px.IsUndefined()) {
-    stream << "kUndefPrice";
-    return stream;
+    std::memcpy(out, kUndefPriceStr, kUndefPriceStrLen);
+    return out + kUndefPriceStrLen;
   }
-  const bool price_neg = (fix_px.val < 0);
-  const int64_t fixed_price_abs = price_neg ? -fix_px.val : fix_px.val;
-  const int64_t price_integer = fixed_price_abs / kFixedPriceScale;
-  const int64_t price_fraction = fixed_price_abs % kFixedPriceScale;
-  if (price_neg) {
-    stream << '-';
+  const std::int64_t px = fix_px.val;
+  if (px < 0) {
+    *out++ = '-';
   }
-  stream << price_integer << '.' << std::setw(9) << std::setfill('0')
-         << price_fraction;
+  // Avoid overflow when negating the minimum value
+  const auto abs_px = px < 0 ? 0 - static_cast<std::uint64_t>(px)
+                             : static_cast<std::uint64_t>(px);
+  constexpr auto kScale =
+      static_cast<std::uint64_t>(databento::kFixedPriceScale);
+  out = databento::detail::WriteUInt(out, abs_px / kScale);
+  *out++ = '.';
+  return databento::detail::WritePaddedUInt(out, abs_px % kScale, 9);
+}
+}  // namespace
+
+namespace databento {
+std::ostream& operator<<(std::ostream& stream, FixPx fix_px) {
+  std::array<char, kMaxFixPxLen> buf;
+  const auto* end = WriteFixPx(buf.data(), fix_px);
+  stream.write(buf.data(), end - buf.data());
   return stream;
 }
+
+std::to_chars_result ToChars(char* first, char* last, FixPx fix_px) {
+  if (static_cast<std::size_t>(last - first) >= kMaxFixPxLen) {
+    return {WriteFixPx(first, fix_px), std::errc{}};
+  }
+  std::array<char, kMaxFixPxLen> buf;
+  const auto len =
+      static_cast<std::size_t>(WriteFixPx(buf.data(), fix_px) - buf.data());
+  if (len > static_cast<std::size_t>(last - first)) {
+    return {last, std::errc::value_too_large};
+  }
+  std::memcpy(first, buf.data(), len);
+  return {first + len, std::errc{}};
+}
+
+std::string PxToString(std::int64_t px) {
+  std::array<char, kMaxFixPxLen> buf;
+  char* end = WriteFixPx(buf.data(), FixPx{px});
+  return {buf.data(), end};
+}
 }  // namespace databento
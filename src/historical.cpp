@@ -1,31 +1,38 @@
 #include "databento/historical.hpp"
 
-#include <dirent.h>  // closedir, opendir
 #include <httplib.h>
 #include <nlohmann/json.hpp>
 
-#include <algorithm>  // find_if
-#include <atomic>     // atomic<bool>
-#include <cstddef>    // size_t
-#include <cstdlib>    // get_env
-#include <exception>  // exception, exception_ptr
-#include <iterator>   // back_inserter
-#include <memory>     // unique_ptr
+#include <algorithm>   // find, find_if, min
+#include <atomic>      // atomic
+#include <chrono>
+#include <cstddef>     // size_t
+#include <cstdint>     // uint64_t
+#include <cstdlib>     // get_env
+#include <exception>   // exception, exception_ptr
+#include <functional>  // function
+#include <iterator>    // back_inserter
+#include <memory>      // unique_ptr
+#include <mutex>       // lock_guard, mutex
+#include <queue>       // priority_queue
+#include <sstream>     // istringstream
 #include <string>
 #include <utility>  // move
+#include <vector>
 
 #include "databento/file_stream.hpp"
-#ifdef _WIN32
-#include <direct.h>  // _mkdir
-#endif
 
 #include "databento/constants.hpp"
 #include "databento/datetime.hpp"
 #include "databento/dbn_decoder.hpp"
 #include "databento/dbn_file_store.hpp"
+#include "databento/dbn_stream_decoder.hpp"
+#include "databento/detail/concurrent_http_streams.hpp"
+#include "databento/detail/file_system.hpp"  // PathJoin, TryCreateDir
 #include "databento/detail/json_helpers.hpp"
 #include "databento/detail/scoped_thread.hpp"
 #include "databento/detail/shared_channel.hpp"
+#include "databento/detail/zstd_stream.hpp"
 #include "databento/enums.hpp"
 #include "databento/exceptions.hpp"  // Exception, JsonResponseError
 #include "databento/log.hpp"
@@ -33,6 +40,8 @@
 #include "databento/timeseries.hpp"
 
 using databento::Historical;
+using databento::detail::PathJoin;
+using databento::detail::TryCreateDir;
 
 namespace {
 std::string BuildBatchPath(const char* slug) {
@@ -55,6 +64,13 @@ constexpr auto kDefaultSTypeIn = databento::SType::RawSymbol;
 constexpr auto kDefaultEncoding = databento::Encoding::Dbn;
 constexpr auto kDefaultCompression = databento::Compression::Zstd;
 constexpr auto kDefaultSTypeOut = databento::SType::InstrumentId;
+// Blocks of each concurrent response decompressed ahead of decoding
+constexpr std::size_t kConcurrentPrefetchBlockCount = 4;
+// Requests with a limit of at most this many records are decoded as they're
+// received, on the thread receiving them
+constexpr std::uint64_t kMaxInlineDecodeLimit = 10000;
+// Bytes of larger responses buffered ahead of decoding
+constexpr std::size_t kThreadedBufferSize = 64 * 1024 * 1024;
 
 databento::BatchJob Parse(const std::string& endpoint,
                           const nlohmann::json& json) {
@@ -112,34 +128,29 @@ databento::BatchJob Parse(const std::string& endpoint,
   return res;
 }
 
-void TryCreateDir(const std::string& dir_name) {
-  if (dir_name.empty()) {
-    return;
-  }
-  const std::unique_ptr<DIR, int (*)(DIR*)> dir{::opendir(dir_name.c_str()),
-                                                &::closedir};
-  if (dir == nullptr) {
-    const int ret =
-#ifdef _WIN32
-        ::_mkdir(dir_name.c_str());
-#else
-        ::mkdir(dir_name.c_str(), 0777);
-#endif
-    if (ret != 0) {
-      throw databento::Exception{std::string{"Unable to create directory "} +
-                                 dir_name + ": " + ::strerror(errno)};
-    }
-  }
-}
-
-std::string PathJoin(const std::string& dir, const std::string& path) {
-  if (dir.empty()) {
-    return path;
+// Parses a UTC timestamp in any of the forms accepted by the API: UNIX
+// nanoseconds, an ISO 8601 date, or an ISO 8601 date and time such as
+// 2022-12-01T00:00:00.000000000Z. Returns false if `str` is in another form.
+bool ParseDateTime(const std::string& str, databento::UnixNanos* ts) {
+  if (!str.empty() &&
+      str.find_first_not_of("0123456789") == std::string::npos) {
+    *ts = databento::UnixNanos{
+        databento::UnixNanos::duration{std::stoull(str)}};
+    return true;
   }
-  if (dir[dir.length() - 1] == '/') {
-    return dir + path;
+  for (const char* format : {"%FT%TZ", "%FT%T", "%FT%RZ", "%FT%R", "%F"}) {
+    std::istringstream stream{str};
+    date::sys_time<std::chrono::nanoseconds> parsed;
+    stream >> date::parse(format, parsed);
+    if (!stream.fail() &&
+        stream.peek() == std::istringstream::traits_type::eof()) {
+      *ts = databento::UnixNanos{
+          std::chrono::duration_cast<databento::UnixNanos::duration>(
+              parsed.time_since_epoch())};
+      return true;
+    }
   }
-  return dir + '/' + path;
+  return false;
 }
 }  // namespace
 
@@ -148,6 +159,7 @@ Historical::Historical(ILogReceiver* log_receiver, std::string key,
     : log_receiver_{log_receiver},
       key_{std::move(key)},
       gateway_{UrlFromGateway(gateway)},
+      port_{},
       client_{log_receiver, key_, gateway_} {}
 
 Historical::Historical(ILogReceiver* log_receiver, std::string key,
@@ -155,6 +167,7 @@ Historical::Historical(ILogReceiver* log_receiver, std::string key,
     : log_receiver_{log_receiver},
       key_{std::move(key)},
       gateway_{std::move(gateway)},
+      port_{port},
       client_{log_receiver, key_, gateway_, port} {}
 
 static const std::string kBatchSubmitJobEndpoint = "Historical::BatchSubmitJob";
@@ -807,26 +820,77 @@ static const std::string kTimeseriesGetRangePath =
 void Historical::TimeseriesGetRange(
     const std::string& dataset, const DateTimeRange<UnixNanos>& datetime_range,
     const std::vector<std::string>& symbols, Schema schema,
-    const RecordCallback& record_callback) {
-  this->TimeseriesGetRange(dataset, datetime_range, symbols, schema,
-                           kDefaultSTypeIn, kDefaultSTypeOut, {}, {},
-                           record_callback);
+    const RecordBatchCallback& record_batch_callback) {
+  this->TimeseriesGetRangeBatches(
+      TimeseriesGetRangeParams(dataset, datetime_range, symbols, schema), {},
+      record_batch_callback);
 }
 void Historical::TimeseriesGetRange(
     const std::string& dataset,
     const DateTimeRange<std::string>& datetime_range,
     const std::vector<std::string>& symbols, Schema schema,
-    const RecordCallback& record_callback) {
-  this->TimeseriesGetRange(dataset, datetime_range, symbols, schema,
-                           kDefaultSTypeIn, kDefaultSTypeOut, {}, {},
-                           record_callback);
+    const RecordBatchCallback& record_batch_callback) {
+  this->TimeseriesGetRangeBatches(
+      TimeseriesGetRangeParams(dataset, datetime_range, symbols, schema), {},
+      record_batch_callback);
 }
 void Historical::TimeseriesGetRange(
     const std::string& dataset, const DateTimeRange<UnixNanos>& datetime_range,
     const std::vector<std::string>& symbols, Schema schema, SType stype_in,
     SType stype_out, std::uint64_t limit,
     const MetadataCallback& metadata_callback,
-    const RecordCallback& record_callback) {
+    const RecordBatchCallback& record_batch_callback) {
+  this->TimeseriesGetRangeBatches(
+      TimeseriesGetRangeParams(dataset, datetime_range, symbols, schema,
+                               stype_in, stype_out, limit),
+      metadata_callback, record_batch_callback);
+}
+void Historical::TimeseriesGetRange(
+    const std::string& dataset,
+    const DateTimeRange<std::string>& datetime_range,
+    const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+    SType stype_out, std::uint64_t limit,
+    const MetadataCallback& metadata_callback,
+    const RecordBatchCallback& record_batch_callback) {
+  this->TimeseriesGetRangeBatches(
+      TimeseriesGetRangeParams(dataset, datetime_range, symbols, schema,
+                               stype_in, stype_out, limit),
+      metadata_callback, record_batch_callback);
+}
+void Historical::TimeseriesGetRangeBatches(
+    const HttplibParams& params, const MetadataCallback& metadata_callback,
+    const RecordBatchCallback& record_batch_callback) {
+  StreamTimeseries(
+      params, metadata_callback,
+      [&record_batch_callback](DbnStreamDecoder& decoder) {
+        while (true) {
+          const auto& records = decoder.DecodeRecords(kMaxRecordBatchSize);
+          if (records.empty()) {
+            return KeepGoing::Continue;
+          }
+          if (record_batch_callback(records) == KeepGoing::Stop) {
+            return KeepGoing::Stop;
+          }
+        }
+      });
+}
+Historical::HttplibParams Historical::TimeseriesGetRangeParams(
+    const std::string& dataset, const DateTimeRange<UnixNanos>& datetime_range,
+    const std::vector<std::string>& symbols, Schema schema) {
+  return TimeseriesGetRangeParams(dataset, datetime_range, symbols, schema,
+                                  kDefaultSTypeIn, kDefaultSTypeOut, {});
+}
+Historical::HttplibParams Historical::TimeseriesGetRangeParams(
+    const std::string& dataset,
+    const DateTimeRange<std::string>& datetime_range,
+    const std::vector<std::string>& symbols, Schema schema) {
+  return TimeseriesGetRangeParams(dataset, datetime_range, symbols, schema,
+                                  kDefaultSTypeIn, kDefaultSTypeOut, {});
+}
+Historical::HttplibParams Historical::TimeseriesGetRangeParams(
+    const std::string& dataset, const DateTimeRange<UnixNanos>& datetime_range,
+    const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+    SType stype_out, std::uint64_t limit) {
   httplib::Params params{
       {"dataset", dataset},
       {"encoding", "dbn"},
@@ -838,16 +902,13 @@ void Historical::TimeseriesGetRange(
       {"stype_out", ToString(stype_out)}};
   detail::SetIfPositive(&params, "end", datetime_range.end);
   detail::SetIfPositive(&params, "limit", limit);
-
-  this->TimeseriesGetRange(params, metadata_callback, record_callback);
+  return params;
 }
-void Historical::TimeseriesGetRange(
+Historical::HttplibParams Historical::TimeseriesGetRangeParams(
     const std::string& dataset,
     const DateTimeRange<std::string>& datetime_range,
     const std::vector<std::string>& symbols, Schema schema, SType stype_in,
-    SType stype_out, std::uint64_t limit,
-    const MetadataCallback& metadata_callback,
-    const RecordCallback& record_callback) {
+    SType stype_out, std::uint64_t limit) {
   httplib::Params params{
       {"dataset", dataset},
       {"encoding", "dbn"},
@@ -859,57 +920,555 @@ void Historical::TimeseriesGetRange(
       {"stype_out", ToString(stype_out)}};
   detail::SetIfNotEmpty(&params, "end", datetime_range.end);
   detail::SetIfPositive(&params, "limit", limit);
+  return params;
+}
+void Historical::StreamTimeseries(
+    const HttplibParams& params, const MetadataCallback& metadata_callback,
+    const std::function<KeepGoing(DbnStreamDecoder&)>& decode_records) {
+  DbnStreamDecoder decoder{log_receiver_};
+  bool is_metadata_decoded{};
+  KeepGoing keep_going{KeepGoing::Continue};
+  // Returns false once `decode_records` returns `KeepGoing::Stop`
+  const auto consume = [&](const std::uint8_t* data, std::size_t length) {
+    decoder.Feed(data, length);
+    if (!is_metadata_decoded) {
+      if (!decoder.HasMetadata()) {
+        return true;
+      }
+      Metadata metadata = decoder.DecodeMetadata();
+      is_metadata_decoded = true;
+      if (metadata_callback) {
+        metadata_callback(std::move(metadata));
+      }
+    }
+    keep_going = decode_records(decoder);
+    return keep_going == KeepGoing::Continue;
+  };
+  if (IsInlineDecodable(params)) {
+    ReceiveTimeseriesInline(params, consume);
+  } else {
+    ReceiveTimeseriesThreaded(params, consume);
+  }
+  if (keep_going == KeepGoing::Continue) {
+    decoder.Finish();
+  }
+}
 
-  this->TimeseriesGetRange(params, metadata_callback, record_callback);
+bool Historical::IsInlineDecodable(const HttplibParams& params) {
+  const auto limit_it = params.find("limit");
+  return limit_it != params.end() &&
+         std::stoull(limit_it->second) <= kMaxInlineDecodeLimit;
 }
-void Historical::TimeseriesGetRange(const HttplibParams& params,
-                                    const MetadataCallback& metadata_callback,
-                                    const RecordCallback& record_callback) {
-  std::atomic<bool> should_continue{true};
-  detail::SharedChannel channel;
+
+void Historical::ReceiveTimeseriesInline(const HttplibParams& params,
+                                         const ChunkCallback& consume) {
   std::exception_ptr exception_ptr{};
-  detail::ScopedThread stream{[this, &channel, &exception_ptr, &params,
-                               &should_continue] {
+  this->client_.GetRawStream(
+      kTimeseriesGetRangePath, params,
+      [&consume, &exception_ptr](const char* data, std::size_t length) {
+        // Cancel the request and rethrow once httplib has returned
+        try {
+          return consume(reinterpret_cast<const std::uint8_t*>(data), length);
+        } catch (const std::exception&) {
+          exception_ptr = std::current_exception();
+          return false;
+        }
+      });
+  if (exception_ptr) {
+    std::rethrow_exception(exception_ptr);
+  }
+}
+
+void Historical::ReceiveTimeseriesThreaded(const HttplibParams& params,
+                                           const ChunkCallback& consume) {
+  detail::SharedChannel channel{
+      detail::SharedChannel::kDefaultChunkSize,
+      kThreadedBufferSize / detail::SharedChannel::kDefaultChunkSize};
+  std::exception_ptr exception_ptr{};
+  detail::ScopedThread stream{[this, &channel, &exception_ptr, &params] {
     try {
       this->client_.GetRawStream(
           kTimeseriesGetRangePath, params,
-          [channel, &should_continue](const char* data,
-                                      std::size_t length) mutable {
-            channel.Write(reinterpret_cast<const std::uint8_t*>(data), length);
-            return should_continue.load();
+          [&channel](const char* data, std::size_t length) {
+            // Returns false once cancelled, cancelling the request
+            return channel.Write(reinterpret_cast<const std::uint8_t*>(data),
+                                 length);
           });
-      channel.Finish();
     } catch (const std::exception&) {
-      channel.Finish();
       // rethrowing here will cause the process to be terminated
       exception_ptr = std::current_exception();
     }
+    channel.Finish();
   }};
   try {
-    DbnDecoder dbn_decoder{log_receiver_, channel};
-    Metadata metadata = dbn_decoder.DecodeMetadata();
-    if (metadata_callback) {
-      metadata_callback(std::move(metadata));
-    }
-    const Record* record;
-    while ((record = dbn_decoder.DecodeRecord()) != nullptr) {
-      if (record_callback(*record) == KeepGoing::Stop) {
-        should_continue = false;
+    std::vector<std::uint8_t> buffer(detail::SharedChannel::kDefaultChunkSize);
+    while (true) {
+      const auto read_size = channel.ReadSome(buffer.data(), buffer.size());
+      if (read_size == 0 || !consume(buffer.data(), read_size)) {
         break;
       }
     }
   } catch (const std::exception&) {
-    should_continue = false;
+    channel.Cancel();
     // wait for thread to finish before checking for exceptions
     stream.Join();
-    // check if there's an exception from stream thread. Thread safe because
-    // `stream` thread has been joined
+    // an error from the request is the likely cause
     if (exception_ptr) {
       std::rethrow_exception(exception_ptr);
     }
-    // otherwise rethrow original exception
     throw;
   }
+  // `consume` may have stopped before the end of the stream
+  channel.Cancel();
+  stream.Join();
+  if (exception_ptr) {
+    std::rethrow_exception(exception_ptr);
+  }
+}
+
+static const std::string kTimeseriesGetRangeParallelEndpoint =
+    "Historical::TimeseriesGetRangeParallel";
+
+void Historical::TimeseriesGetRangeParallel(
+    const std::string& dataset, const DateTimeRange<UnixNanos>& datetime_range,
+    const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+    SType stype_out, const TimeseriesParallelOptions& options,
+    const MetadataCallback& metadata_callback,
+    const RecordCallback& record_callback) {
+  const auto boundaries = TimeseriesSliceBoundaries(
+      dataset, datetime_range, symbols, schema, stype_in, options);
+  std::vector<HttplibParams> params_list;
+  for (std::size_t i = 1; i < boundaries.size(); ++i) {
+    params_list.emplace_back(TimeseriesGetRangeParams(
+        dataset, {boundaries[i - 1], boundaries[i]}, symbols, schema, stype_in,
+        stype_out, {}));
+  }
+  StreamTimeseriesConcurrently(
+      params_list, options.max_buffered_size,
+      [&metadata_callback, &record_callback](
+          const std::vector<std::unique_ptr<DbnDecoder>>& decoders) {
+        Metadata metadata = decoders.front()->DecodeMetadata();
+        for (std::size_t i = 1; i < decoders.size(); ++i) {
+          metadata.Merge(decoders[i]->DecodeMetadata());
+        }
+        if (metadata_callback) {
+          metadata_callback(std::move(metadata));
+        }
+        // The slices are consecutive, so their records are already in order
+        for (const auto& decoder : decoders) {
+          const Record* record;
+          while ((record = decoder->DecodeRecord()) != nullptr) {
+            if (record_callback(*record) == KeepGoing::Stop) {
+              return;
+            }
+          }
+        }
+      });
+}
+
+void Historical::TimeseriesGetRangeParallel(
+    const std::string& dataset,
+    const DateTimeRange<std::string>& datetime_range,
+    const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+    SType stype_out, const TimeseriesParallelOptions& options,
+    const MetadataCallback& metadata_callback,
+    const RecordCallback& record_callback) {
+  // Slicing the range requires its bounds as timestamps
+  DateTimeRange<UnixNanos> nanos_range{UnixNanos{}};
+  if (!ParseDateTime(datetime_range.start, &nanos_range.start)) {
+    throw InvalidArgumentError{kTimeseriesGetRangeParallelEndpoint,
+                               "datetime_range.start",
+                               "Must be UNIX nanoseconds or ISO 8601"};
+  }
+  if (!ParseDateTime(datetime_range.end, &nanos_range.end)) {
+    throw InvalidArgumentError{kTimeseriesGetRangeParallelEndpoint,
+                               "datetime_range.end",
+                               "Must be UNIX nanoseconds or ISO 8601"};
+  }
+  TimeseriesGetRangeParallel(dataset, nanos_range, symbols, schema, stype_in,
+                             stype_out, options, metadata_callback,
+                             record_callback);
+}
+
+std::vector<databento::UnixNanos> Historical::TimeseriesSliceBoundaries(
+    const std::string& dataset, const DateTimeRange<UnixNanos>& datetime_range,
+    const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+    const TimeseriesParallelOptions& options) {
+  if (datetime_range.end <= datetime_range.start) {
+    throw InvalidArgumentError{kTimeseriesGetRangeParallelEndpoint,
+                               "datetime_range",
+                               "End must be set and after start"};
+  }
+  if (options.slice_count == 0) {
+    throw InvalidArgumentError{kTimeseriesGetRangeParallelEndpoint,
+                               "options.slice_count", "Must be greater than 0"};
+  }
+  const bool is_equal_time = options.sizing == SliceSizing::EqualTime;
+  if (!is_equal_time && options.probes_per_slice == 0) {
+    throw InvalidArgumentError{kTimeseriesGetRangeParallelEndpoint,
+                               "options.probes_per_slice",
+                               "Must be greater than 0"};
+  }
+  const auto piece_count = is_equal_time
+                               ? options.slice_count
+                               : options.slice_count * options.probes_per_slice;
+  const std::uint64_t duration =
+      (datetime_range.end - datetime_range.start).count();
+  const std::uint64_t count = piece_count;
+  std::vector<UnixNanos> piece_bounds;
+  for (std::uint64_t i = 0; i <= count; ++i) {
+    // Split to avoid overflow
+    const auto offset = duration / count * i + duration % count * i / count;
+    const UnixNanos bound = datetime_range.start + UnixNanos::duration{offset};
+    // Ranges shorter than `piece_count` nanoseconds have empty pieces
+    if (piece_bounds.empty() || bound > piece_bounds.back()) {
+      piece_bounds.emplace_back(bound);
+    }
+  }
+  if (is_equal_time) {
+    return piece_bounds;
+  }
+  const bool is_record_count = options.sizing == SliceSizing::RecordCount;
+  const auto& probe_endpoint = is_record_count
+                                   ? kMetadataGetRecordCountEndpoint
+                                   : kMetadataGetBillableSizeEndpoint;
+  const auto symbols_param = JoinSymbolStrings(probe_endpoint, symbols);
+  std::vector<HttplibParams> probe_params;
+  for (std::size_t i = 1; i < piece_bounds.size(); ++i) {
+    probe_params.emplace_back(
+        HttplibParams{{"dataset", dataset},
+                      {"start", ToString(piece_bounds[i - 1])},
+                      {"end", ToString(piece_bounds[i])},
+                      {"symbols", symbols_param},
+                      {"schema", ToString(schema)},
+                      {"stype_in", ToString(stype_in)}});
+  }
+  // Probed on as many connections as there are slices
+  const auto sizes = MetadataGetSizesConcurrently(
+      ::BuildMetadataPath(is_record_count ? ".get_record_count"
+                                          : ".get_billable_size"),
+      probe_endpoint, probe_params, options.slice_count);
+  std::uint64_t total{};
+  for (const auto size : sizes) {
+    total += size;
+  }
+  if (total == 0) {
+    std::vector<UnixNanos> boundaries;
+    for (std::size_t i = 0; i < piece_bounds.size();
+         i += options.probes_per_slice) {
+      boundaries.emplace_back(piece_bounds[i]);
+    }
+    if (boundaries.back() != piece_bounds.back()) {
+      boundaries.emplace_back(piece_bounds.back());
+    }
+    return boundaries;
+  }
+  // End a slice at the first piece boundary where the cumulative size reaches
+  // its share of the total
+  std::vector<UnixNanos> boundaries{piece_bounds.front()};
+  std::uint64_t cumulative_size{};
+  std::size_t slice_idx = 1;
+  for (std::size_t i = 0; i < sizes.size(); ++i) {
+    cumulative_size += sizes[i];
+    if (slice_idx < options.slice_count &&
+        cumulative_size * options.slice_count >= total * slice_idx) {
+      boundaries.emplace_back(piece_bounds[i + 1]);
+      while (slice_idx < options.slice_count &&
+             cumulative_size * options.slice_count >= total * slice_idx) {
+        ++slice_idx;
+      }
+    }
+  }
+  if (boundaries.back() != piece_bounds.back()) {
+    boundaries.emplace_back(piece_bounds.back());
+  }
+  return boundaries;
+}
+
+std::vector<std::uint64_t> Historical::MetadataGetSizesConcurrently(
+    const std::string& path, const std::string& endpoint,
+    const std::vector<HttplibParams>& params_list,
+    std::size_t max_connection_count) {
+  std::vector<std::uint64_t> sizes(params_list.size());
+  std::atomic<std::size_t> next_idx{};
+  std::mutex exception_mutex;
+  std::exception_ptr exception_ptr{};
+  const auto request_sizes = [&] {
+    try {
+      const auto client = MakeClient();
+      for (std::size_t i = next_idx++; i < params_list.size(); i = next_idx++) {
+        const nlohmann::json json = client->PostJson(path, params_list[i]);
+        if (!json.is_number_unsigned()) {
+          throw JsonResponseError::TypeMismatch(endpoint, "unsigned number",
+                                                json);
+        }
+        sizes[i] = json;
+      }
+    } catch (const std::exception&) {
+      // Stop the other threads from starting more requests
+      next_idx = params_list.size();
+      const std::lock_guard<std::mutex> lock{exception_mutex};
+      if (!exception_ptr) {
+        exception_ptr = std::current_exception();
+      }
+    }
+  };
+  {
+    std::vector<detail::ScopedThread> threads;
+    const auto thread_count =
+        std::min(max_connection_count, params_list.size());
+    for (std::size_t i = 0; i < thread_count; ++i) {
+      threads.emplace_back(request_sizes);
+    }
+  }
+  if (exception_ptr) {
+    std::rethrow_exception(exception_ptr);
+  }
+  return sizes;
+}
+
+void Historical::StreamTimeseriesConcurrently(
+    const std::vector<HttplibParams>& params_list,
+    std::size_t max_buffered_size, const DecodersCallback& consume) {
+  // Destroyed after `streams` so any prefetching threads see the end of their
+  // channel
+  std::vector<std::unique_ptr<DbnDecoder>> decoders;
+  detail::ConcurrentHttpStreams streams{[this] { return MakeClient(); },
+                                        kTimeseriesGetRangePath, params_list,
+                                        max_buffered_size};
+  try {
+    // Decompress each response on its own thread
+    DbnDecoderOptions options;
+    options.prefetch_block_count = kConcurrentPrefetchBlockCount;
+    for (std::size_t i = 0; i < streams.Size(); ++i) {
+      decoders.emplace_back(new DbnDecoder{
+          log_receiver_,
+          std::unique_ptr<IReadable>{
+              new detail::SharedChannel{streams.Channel(i)}},
+          options});
+    }
+    consume(decoders);
+  } catch (...) {
+    // A failed request ends its channel early, so prefer its error to the
+    // resulting decoding error
+    streams.Stop();
+    streams.RethrowError();
+    throw;
+  }
+  streams.Stop();
+  streams.RethrowError();
+}
+
+static const std::string kTimeseriesGetRangeShardedEndpoint =
+    "Historical::TimeseriesGetRangeSharded";
+
+namespace {
+// Splits `symbols` into up to `shard_count` contiguous shards of nearly equal
+// size.
+std::vector<std::vector<std::string>> ShardSymbols(
+    const std::vector<std::string>& symbols, std::size_t shard_count) {
+  if (shard_count == 0) {
+    throw databento::InvalidArgumentError{kTimeseriesGetRangeShardedEndpoint,
+                                          "options.shard_count",
+                                          "Must be greater than 0"};
+  }
+  if (symbols.empty()) {
+    throw databento::InvalidArgumentError{kTimeseriesGetRangeShardedEndpoint,
+                                          "symbols", "Cannot be empty"};
+  }
+  if (std::find(symbols.begin(), symbols.end(),
+                databento::kAllSymbols.front()) != symbols.end()) {
+    throw databento::InvalidArgumentError{
+        kTimeseriesGetRangeShardedEndpoint, "symbols",
+        "Can't be sharded when requesting all symbols"};
+  }
+  shard_count = std::min(shard_count, symbols.size());
+  std::vector<std::vector<std::string>> shards;
+  for (std::size_t i = 0; i < shard_count; ++i) {
+    const auto begin = symbols.size() * i / shard_count;
+    const auto end = symbols.size() * (i + 1) / shard_count;
+    shards.emplace_back(
+        symbols.begin() + static_cast<std::ptrdiff_t>(begin),
+        symbols.begin() + static_cast<std::ptrdiff_t>(end));
+  }
+  return shards;
+}
+}  // namespace
+
+void Historical::TimeseriesGetRangeSharded(
+    const std::string& dataset, const DateTimeRange<UnixNanos>& datetime_range,
+    const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+    SType stype_out, const TimeseriesShardOptions& options,
+    const MetadataCallback& metadata_callback,
+    const RecordCallback& record_callback) {
+  std::vector<HttplibParams> params_list;
+  for (const auto& shard : ShardSymbols(symbols, options.shard_count)) {
+    params_list.emplace_back(TimeseriesGetRangeParams(
+        dataset, datetime_range, shard, schema, stype_in, stype_out, {}));
+  }
+  TimeseriesGetRangeMerged(params_list, options.max_buffered_size,
+                           metadata_callback, record_callback);
+}
+void Historical::TimeseriesGetRangeSharded(
+    const std::string& dataset,
+    const DateTimeRange<std::string>& datetime_range,
+    const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+    SType stype_out, const TimeseriesShardOptions& options,
+    const MetadataCallback& metadata_callback,
+    const RecordCallback& record_callback) {
+  std::vector<HttplibParams> params_list;
+  for (const auto& shard : ShardSymbols(symbols, options.shard_count)) {
+    params_list.emplace_back(TimeseriesGetRangeParams(
+        dataset, datetime_range, shard, schema, stype_in, stype_out, {}));
+  }
+  TimeseriesGetRangeMerged(params_list, options.max_buffered_size,
+                           metadata_callback, record_callback);
+}
+
+void Historical::TimeseriesGetRangeMerged(
+    const std::vector<HttplibParams>& params_list,
+    std::size_t max_buffered_size, const MetadataCallback& metadata_callback,
+    const RecordCallback& record_callback) {
+  StreamTimeseriesConcurrently(
+      params_list, max_buffered_size,
+      [&metadata_callback, &record_callback](
+          const std::vector<std::unique_ptr<DbnDecoder>>& decoders) {
+        Metadata metadata = decoders.front()->DecodeMetadata();
+        for (std::size_t i = 1; i < decoders.size(); ++i) {
+          metadata.Merge(decoders[i]->DecodeMetadata());
+        }
+        if (metadata_callback) {
+          metadata_callback(std::move(metadata));
+        }
+        // The next record of each response. Each record remains valid until
+        // the next call to `DecodeRecord` on its decoder.
+        struct Head {
+          UnixNanos ts;
+          std::size_t idx;
+          const Record* record;
+        };
+        // Break ties by response to keep the order deterministic
+        const auto is_later = [](const Head& lhs, const Head& rhs) {
+          return lhs.ts != rhs.ts ? lhs.ts > rhs.ts : lhs.idx > rhs.idx;
+        };
+        std::priority_queue<Head, std::vector<Head>, decltype(is_later)> heads{
+            is_later};
+        for (std::size_t i = 0; i < decoders.size(); ++i) {
+          if (const auto* record = decoders[i]->DecodeRecord()) {
+            heads.push(Head{record->IndexTs(), i, record});
+          }
+        }
+        while (!heads.empty()) {
+          const auto head = heads.top();
+          heads.pop();
+          if (record_callback(*head.record) == KeepGoing::Stop) {
+            return;
+          }
+          if (const auto* record = decoders[head.idx]->DecodeRecord()) {
+            heads.push(Head{record->IndexTs(), head.idx, record});
+          }
+        }
+      });
+}
+
+static const std::string kTimeseriesGetRangeCachedEndpoint =
+    "Historical::TimeseriesGetRangeCached";
+
+void Historical::TimeseriesGetRangeCached(
+    const TimeseriesCache& cache, const std::string& dataset,
+    const DateTimeRange<UnixNanos>& datetime_range,
+    const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+    SType stype_out, const MetadataCallback& metadata_callback,
+    const RecordCallback& record_callback) {
+  if (datetime_range.end == UnixNanos{}) {
+    throw InvalidArgumentError{kTimeseriesGetRangeCachedEndpoint,
+                               "datetime_range.end",
+                               "Must be set to cache the response"};
+  }
+  if (datetime_range.end <= datetime_range.start) {
+    throw InvalidArgumentError{kTimeseriesGetRangeCachedEndpoint,
+                               "datetime_range.end", "Must be after start"};
+  }
+  const auto params = TimeseriesGetRangeParams(
+      dataset, datetime_range, symbols, schema, stype_in, stype_out, {});
+  std::vector<TimeseriesCache::Entry> parts;
+  std::vector<std::unique_ptr<DbnFileStore>> stores;
+  // Fetched once a part needs to be requested
+  UnixNanos available_end{};
+  for (auto& part : cache.Plan(kTimeseriesGetRangePath, params,
+                               datetime_range.start, datetime_range.end)) {
+    if (part.file_path.empty()) {
+      // Data past the end of the dataset's available range, which is never
+      // after the current time, may still be added, so isn't requested to
+      // avoid caching it incomplete
+      if (available_end == UnixNanos{}) {
+        const auto range_end = MetadataGetDatasetRange(dataset).end;
+        if (!ParseDateTime(range_end, &available_end)) {
+          throw JsonResponseError::TypeMismatch(
+              kTimeseriesGetRangeCachedEndpoint, "ISO 8601 timestamp string",
+              range_end);
+        }
+      }
+      if (part.start >= available_end) {
+        continue;
+      }
+      part.end = std::min(part.end, available_end);
+      const auto part_params =
+          TimeseriesGetRangeParams(dataset, {part.start, part.end}, symbols,
+                                   schema, stype_in, stype_out, {});
+      part = cache.Store(kTimeseriesGetRangePath, params, part.start, part.end,
+                         [this, &part_params](const std::string& file_path) {
+                           StreamToFile(kTimeseriesGetRangePath, part_params,
+                                        file_path);
+                         });
+    }
+    stores.emplace_back(new DbnFileStore{log_receiver_, part.file_path,
+                                         VersionUpgradePolicy::UpgradeToV2});
+    parts.emplace_back(std::move(part));
+  }
+  if (stores.empty()) {
+    throw InvalidArgumentError{
+        kTimeseriesGetRangeCachedEndpoint, "datetime_range.start",
+        "Must be before the end of the dataset's available range " +
+            ToIso8601(available_end)};
+  }
+  Metadata metadata = stores.front()->GetMetadata();
+  for (std::size_t i = 1; i < stores.size(); ++i) {
+    metadata.Merge(stores[i]->GetMetadata());
+  }
+  // Cached entries may extend past the requested range, and the range is
+  // truncated at the end of the available data
+  metadata.start = datetime_range.start;
+  metadata.end = parts.back().end;
+  if (metadata_callback) {
+    metadata_callback(std::move(metadata));
+  }
+  for (std::size_t i = 0; i < stores.size(); ++i) {
+    while (const auto* record = stores[i]->NextRecord()) {
+      const auto ts = record->IndexTs();
+      // Records without an index timestamp aren't in any part's range, but
+      // mustn't end the part early
+      if (ts.time_since_epoch().count() == kUndefTimestamp ||
+          ts < parts[i].start) {
+        continue;
+      }
+      if (ts >= parts[i].end) {
+        break;
+      }
+      if (record_callback(*record) == KeepGoing::Stop) {
+        return;
+      }
+    }
+  }
+}
+
+std::unique_ptr<databento::detail::HttpClient> Historical::MakeClient() const {
+  if (port_ == 0) {
+    return std::unique_ptr<detail::HttpClient>{
+        new detail::HttpClient{log_receiver_, key_, gateway_}};
+  }
+  return std::unique_ptr<detail::HttpClient>{
+      new detail::HttpClient{log_receiver_, key_, gateway_, port_}};
 }
 
 static const std::string kTimeseriesGetRangeToFileEndpoint =
@@ -969,12 +1528,54 @@ databento::DbnFileStore Historical::TimeseriesGetRangeToFile(
   detail::SetIfPositive(&params, "limit", limit);
   return this->TimeseriesGetRangeToFile(params, file_path);
 }
+databento::DbnFileStore Historical::TimeseriesGetRangeToFile(
+    const std::string& dataset, const DateTimeRange<UnixNanos>& datetime_range,
+    const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+    SType stype_out, std::uint64_t limit, const std::string& file_path,
+    const ZstdCompressOptions& compression) {
+  return this->TimeseriesGetRangeToFile(
+      TimeseriesGetRangeParams(dataset, datetime_range, symbols, schema,
+                               stype_in, stype_out, limit),
+      file_path, compression);
+}
+databento::DbnFileStore Historical::TimeseriesGetRangeToFile(
+    const std::string& dataset,
+    const DateTimeRange<std::string>& datetime_range,
+    const std::vector<std::string>& symbols, Schema schema, SType stype_in,
+    SType stype_out, std::uint64_t limit, const std::string& file_path,
+    const ZstdCompressOptions& compression) {
+  return this->TimeseriesGetRangeToFile(
+      TimeseriesGetRangeParams(dataset, datetime_range, symbols, schema,
+                               stype_in, stype_out, limit),
+      file_path, compression);
+}
 databento::DbnFileStore Historical::TimeseriesGetRangeToFile(
     const HttplibParams& params, const std::string& file_path) {
   StreamToFile(kTimeseriesGetRangePath, params, file_path);
   return DbnFileStore{log_receiver_, file_path,
                       VersionUpgradePolicy::UpgradeToV2};
 }
+databento::DbnFileStore Historical::TimeseriesGetRangeToFile(
+    HttplibParams params, const std::string& file_path,
+    const ZstdCompressOptions& compression) {
+  params.erase("compression");
+  params.emplace("compression", "none");
+  {
+    OutFileStream out_file{file_path};
+    // Finishes the Zstd stream when it goes out of scope
+    detail::ZstdCompressStream compressor{log_receiver_, &out_file,
+                                          compression};
+    this->client_.GetRawStream(
+        kTimeseriesGetRangePath, params,
+        [&compressor](const char* data, std::size_t length) {
+          compressor.WriteAll(reinterpret_cast<const std::uint8_t*>(data),
+                              length);
+          return true;
+        });
+  }
+  return DbnFileStore{log_receiver_, file_path,
+                      VersionUpgradePolicy::UpgradeToV2};
+}
 
 using databento::HistoricalBuilder;
 
@@ -0,0 +1,156 @@
+#include "databento/instrument_index.hpp"
+
+#include <algorithm>  // sort, unique
+#include <array>
+#include <cstring>  // memcmp
+#include <memory>   // unique_ptr
+#include <string>   // to_string
+
+#include "databento/dbn_decoder.hpp"
+#include "databento/enums.hpp"  // VersionUpgradePolicy
+#include "databento/exceptions.hpp"
+#include "databento/file_stream.hpp"
+#include "databento/log.hpp"
+
+using databento::InstrumentIndex;
+
+namespace {
+// Includes the format version
+constexpr auto kInstrumentIndexPrefix = "DBNIIX\x00\x01";
+constexpr std::size_t kInstrumentIndexPrefixLen = 8;
+
+template <typename T>
+void WriteAsBytes(T value, databento::IWritable* output) {
+  output->WriteAll(reinterpret_cast<const std::uint8_t*>(&value), sizeof(T));
+}
+
+template <typename T>
+T ReadAsBytes(databento::IReadable* input) {
+  T value{};
+  input->ReadExact(reinterpret_cast<std::uint8_t*>(&value), sizeof(T));
+  return value;
+}
+}  // namespace
+
+InstrumentIndex::InstrumentIndex(std::uint64_t block_size)
+    : block_size_{block_size} {
+  if (block_size == 0) {
+    throw InvalidArgumentError{"InstrumentIndex::InstrumentIndex",
+                               "block_size", "Must be greater than 0"};
+  }
+}
+
+InstrumentIndex InstrumentIndex::Build(const std::string& dbn_file_path,
+                                       std::uint64_t block_size) {
+  InstrumentIndex index{block_size};
+  // Offsets must refer to the records as stored
+  DbnDecoder decoder{
+      ILogReceiver::Default(),
+      std::unique_ptr<IReadable>{new InFileStream{dbn_file_path}},
+      VersionUpgradePolicy::AsIs};
+  decoder.DecodeMetadata();
+  while (true) {
+    const auto offset = decoder.NextRecordOffset();
+    const auto* record = decoder.DecodeRecord();
+    if (record == nullptr) {
+      break;
+    }
+    index.Add(*record, offset);
+  }
+  return index;
+}
+
+InstrumentIndex InstrumentIndex::ReadFromFile(
+    const std::string& index_file_path) {
+  // Mapped so counts can be checked against the size of the file
+  MappedFileStream input{index_file_path};
+  const auto check_count = [&input](std::uint64_t count,
+                                    std::size_t element_size) {
+    if (count > input.RemainingSize() / element_size) {
+      throw DbnResponseError{
+          "Instrument index file is truncated, expected " +
+          std::to_string(count) + " elements of " +
+          std::to_string(element_size) + " bytes"};
+    }
+  };
+  std::array<char, kInstrumentIndexPrefixLen> prefix{};
+  input.ReadExact(reinterpret_cast<std::uint8_t*>(prefix.data()),
+                  prefix.size());
+  if (std::memcmp(prefix.data(), kInstrumentIndexPrefix,
+                  kInstrumentIndexPrefixLen) != 0) {
+    throw DbnResponseError{"Invalid or unsupported instrument index file"};
+  }
+  InstrumentIndex index{ReadAsBytes<std::uint64_t>(&input)};
+  const auto block_count = ReadAsBytes<std::uint64_t>(&input);
+  check_count(block_count, 2 * sizeof(std::uint64_t));
+  index.blocks_.reserve(static_cast<std::size_t>(block_count));
+  for (std::uint64_t i = 0; i < block_count; ++i) {
+    const auto offset = ReadAsBytes<std::uint64_t>(&input);
+    const auto end_offset = ReadAsBytes<std::uint64_t>(&input);
+    index.blocks_.emplace_back(Block{offset, end_offset});
+  }
+  const auto instrument_count = ReadAsBytes<std::uint64_t>(&input);
+  for (std::uint64_t i = 0; i < instrument_count; ++i) {
+    const auto instrument_id = ReadAsBytes<std::uint32_t>(&input);
+    const auto block_idx_count = ReadAsBytes<std::uint32_t>(&input);
+    check_count(block_idx_count, sizeof(std::uint32_t));
+    auto& posting_list = index.posting_lists_[instrument_id];
+    posting_list.resize(block_idx_count);
+    input.ReadExact(reinterpret_cast<std::uint8_t*>(posting_list.data()),
+                    posting_list.size() * sizeof(std::uint32_t));
+  }
+  return index;
+}
+
+void InstrumentIndex::WriteToFile(const std::string& index_file_path) const {
+  OutFileStream output{index_file_path};
+  output.WriteAll(reinterpret_cast<const std::uint8_t*>(kInstrumentIndexPrefix),
+                  kInstrumentIndexPrefixLen);
+  WriteAsBytes(block_size_, &output);
+  WriteAsBytes<std::uint64_t>(blocks_.size(), &output);
+  for (const auto& block : blocks_) {
+    WriteAsBytes(block.offset, &output);
+    WriteAsBytes(block.end_offset, &output);
+  }
+  WriteAsBytes<std::uint64_t>(posting_lists_.size(), &output);
+  for (const auto& id_and_posting_list : posting_lists_) {
+    const auto& posting_list = id_and_posting_list.second;
+    WriteAsBytes(id_and_posting_list.first, &output);
+    WriteAsBytes(static_cast<std::uint32_t>(posting_list.size()), &output);
+    output.WriteAll(reinterpret_cast<const std::uint8_t*>(posting_list.data()),
+                    posting_list.size() * sizeof(std::uint32_t));
+  }
+}
+
+void InstrumentIndex::Add(const Record& record, std::uint64_t offset) {
+  if (blocks_.empty() || offset >= blocks_.back().offset + block_size_) {
+    blocks_.emplace_back(Block{offset, offset});
+  }
+  blocks_.back().end_offset = offset + record.Size();
+  const auto block_idx = static_cast<std::uint32_t>(blocks_.size() - 1);
+  auto& posting_list = posting_lists_[record.Header().instrument_id];
+  if (posting_list.empty() || posting_list.back() != block_idx) {
+    posting_list.emplace_back(block_idx);
+  }
+}
+
+std::vector<std::size_t> InstrumentIndex::FindBlocks(
+    const std::vector<std::uint32_t>& instrument_ids) const {
+  std::vector<std::size_t> res;
+  for (const auto instrument_id : instrument_ids) {
+    const auto it = posting_lists_.find(instrument_id);
+    if (it != posting_lists_.end()) {
+      res.insert(res.end(), it->second.cbegin(), it->second.cend());
+    }
+  }
+  std::sort(res.begin(), res.end());
+  res.erase(std::unique(res.begin(), res.end()), res.end());
+  return res;
+}
+
+namespace databento {
+bool operator==(const InstrumentIndex::Block& lhs,
+                const InstrumentIndex::Block& rhs) {
+  return lhs.offset == rhs.offset && lhs.end_offset == rhs.end_offset;
+}
+}  // namespace databento
@@ -138,26 +138,8 @@ const databento::Record& LiveBlocking::NextRecord() { return *NextRecord({}); }
 
 const databento::Record* LiveBlocking::NextRecord(
     std::chrono::milliseconds timeout) {
-  // need some unread_bytes
-  const auto unread_bytes = buffer_size_ - buffer_idx_;
-  if (unread_bytes == 0) {
-    const auto read_res = FillBuffer(timeout);
-    if (read_res.status == detail::TcpClient::Status::Timeout) {
-      return nullptr;
-    }
-    if (read_res.status == detail::TcpClient::Status::Closed) {
-      throw DbnResponseError{"Gateway closed the session"};
-    }
-  }
-  // check length
-  while (buffer_size_ - buffer_idx_ < BufferRecordHeader()->Size()) {
-    const auto read_res = FillBuffer(timeout);
-    if (read_res.status == detail::TcpClient::Status::Timeout) {
-      return nullptr;
-    }
-    if (read_res.status == detail::TcpClient::Status::Closed) {
-      throw DbnResponseError{"Gateway closed the session"};
-    }
+  if (!BufferRecord(timeout)) {
+    return nullptr;
   }
   current_record_ = Record{BufferRecordHeader()};
   buffer_idx_ += current_record_.Size();
@@ -167,6 +149,26 @@ const databento::Record* LiveBlocking::NextRecord(
   return &current_record_;
 }
 
+const std::vector<databento::Record>& LiveBlocking::NextRecords(
+    std::chrono::milliseconds timeout) {
+  record_batch_.clear();
+  if (!BufferRecord(timeout)) {
+    return record_batch_;
+  }
+  // take every complete record already in the buffer without refilling it,
+  // which would move the records already in the batch
+  while (buffer_size_ - buffer_idx_ > 0 &&
+         buffer_size_ - buffer_idx_ >= BufferRecordHeader()->Size()) {
+    record_batch_.emplace_back(BufferRecordHeader());
+    buffer_idx_ += record_batch_.back().Size();
+  }
+  // Upgrading is a no-op for all other versions and policies
+  if (version_ == 1 && upgrade_policy_ == VersionUpgradePolicy::UpgradeToV2) {
+    UpgradeBatch();
+  }
+  return record_batch_;
+}
+
 void LiveBlocking::Stop() { client_.Close(); }
 
 void LiveBlocking::Reconnect() {
@@ -351,6 +353,52 @@ std::uint64_t LiveBlocking::DecodeAuthResp() {
   return session_id;
 }
 
+bool LiveBlocking::BufferRecord(std::chrono::milliseconds timeout) {
+  // need some unread_bytes
+  const auto unread_bytes = buffer_size_ - buffer_idx_;
+  if (unread_bytes == 0) {
+    const auto read_res = FillBuffer(timeout);
+    if (read_res.status == detail::TcpClient::Status::Timeout) {
+      return false;
+    }
+    if (read_res.status == detail::TcpClient::Status::Closed) {
+      throw DbnResponseError{"Gateway closed the session"};
+    }
+  }
+  // check length
+  while (buffer_size_ - buffer_idx_ < BufferRecordHeader()->Size()) {
+    const auto read_res = FillBuffer(timeout);
+    if (read_res.status == detail::TcpClient::Status::Timeout) {
+      return false;
+    }
+    if (read_res.status == detail::TcpClient::Status::Closed) {
+      throw DbnResponseError{"Gateway closed the session"};
+    }
+  }
+  return true;
+}
+
+void LiveBlocking::UpgradeBatch() {
+  upgraded_idxs_.clear();
+  batch_compat_buffers_.clear();
+  for (std::size_t i = 0; i < record_batch_.size(); ++i) {
+    const auto rec = DbnDecoder::DecodeRecordCompat(
+        version_, upgrade_policy_, send_ts_out_, &compat_buffer_,
+        record_batch_[i]);
+    if (&rec.Header() != &record_batch_[i].Header()) {
+      upgraded_idxs_.emplace_back(i);
+      batch_compat_buffers_.emplace_back();
+      std::copy(compat_buffer_.cbegin(), compat_buffer_.cend(),
+                batch_compat_buffers_.back().data.begin());
+    }
+  }
+  // `batch_compat_buffers_` is no longer resized so its addresses are stable
+  for (std::size_t i = 0; i < upgraded_idxs_.size(); ++i) {
+    record_batch_[upgraded_idxs_[i]] = Record{
+        reinterpret_cast<RecordHeader*>(batch_compat_buffers_[i].data.data())};
+  }
+}
+
 databento::detail::TcpClient::Result LiveBlocking::FillBuffer(
     std::chrono::milliseconds timeout) {
   // Shift data forward
@@ -114,31 +114,38 @@ void LiveThreaded::SubscribeWithSnapshot(
   impl_->blocking.SubscribeWithSnapshot(symbols, schema, stype_in);
 }
 
-void LiveThreaded::Start(RecordCallback callback) {
-  Start({}, std::move(callback), {});
-}
-
-void LiveThreaded::Start(databento::MetadataCallback metadata_callback,
-                         RecordCallback record_callback) {
-  Start(std::move(metadata_callback), std::move(record_callback), {});
-}
-
-void LiveThreaded::Start(MetadataCallback metadata_callback,
-                         RecordCallback record_callback,
-                         ExceptionCallback exception_callback) {
+bool LiveThreaded::CanStart() const {
   // Deadlock check
   if (std::this_thread::get_id() == impl_->thread_id_) {
     std::ostringstream log_ss;
     log_ss << "[LiveThreaded::Start] Called Start from callback thread, which "
               "would cause a deadlock. Ignoring.";
     impl_->log_receiver->Receive(LogLevel::Warning, log_ss.str());
+    return false;
+  }
+  return true;
+}
+
+void LiveThreaded::Start(const RecordBatchCallback& record_batch_callback) {
+  Start({}, record_batch_callback, {});
+}
+
+void LiveThreaded::Start(MetadataCallback metadata_callback,
+                         RecordBatchCallback record_batch_callback) {
+  Start(std::move(metadata_callback), std::move(record_batch_callback), {});
+}
+
+void LiveThreaded::Start(MetadataCallback metadata_callback,
+                         RecordBatchCallback record_batch_callback,
+                         ExceptionCallback exception_callback) {
+  if (!CanStart()) {
     return;
   }
   // Safe to pass raw pointer because `thread_` cannot outlive `impl_`
-  thread_ = detail::ScopedThread{&LiveThreaded::ProcessingThread, impl_.get(),
-                                 std::move(metadata_callback),
-                                 std::move(record_callback),
-                                 std::move(exception_callback)};
+  thread_ = detail::ScopedThread{
+      &LiveThreaded::BatchProcessingThread, impl_.get(),
+      std::move(metadata_callback), std::move(record_batch_callback),
+      std::move(exception_callback)};
 }
 
 void LiveThreaded::Reconnect() { impl_->blocking.Reconnect(); }
@@ -164,54 +171,39 @@ databento::KeepGoing LiveThreaded::BlockForStop(
   return KeepGoing::Continue;
 }
 
-void LiveThreaded::ProcessingThread(Impl* impl,
-                                    MetadataCallback&& metadata_callback,
-                                    RecordCallback&& record_callback,
-                                    ExceptionCallback&& exception_callback) {
+void LiveThreaded::BatchProcessingThread(
+    Impl* impl, MetadataCallback&& metadata_callback,
+    RecordBatchCallback&& record_batch_callback,
+    ExceptionCallback&& exception_callback) {
   // Thread safety: non-const calls to `blocking` are only performed from this
   // thread
 
-  static constexpr auto kMethodName = "LiveThreaded::ProcessingThread";
+  static constexpr auto kMethodName = "LiveThreaded::BatchProcessingThread";
   constexpr std::chrono::milliseconds kTimeout{50};
 
-  impl->thread_id_ = std::this_thread::get_id();
+  RegisterProcessingThread(impl);
   const auto metadata_cb{std::move(metadata_callback)};
-  const auto record_cb{std::move(record_callback)};
+  const auto record_batch_cb{std::move(record_batch_callback)};
   const auto exception_cb{std::move(exception_callback)};
   // Start loop
-  while (impl->keep_going.load(std::memory_order_relaxed)) {
-    try {
-      auto metadata = impl->blocking.Start();
-      if (metadata_cb) {
-        metadata_cb(std::move(metadata));
-      }
-    } catch (const std::exception& exc) {
-      if (ExceptionHandler(impl, exception_cb, exc, kMethodName,
-                           "Caught exception starting session: ") ==
-          ExceptionAction::Restart) {
-        continue;  // restart Start loop
-      } else {
-        return;
-      }
-    }
-    // NextRecord loop
-    while (impl->keep_going.load(std::memory_order_relaxed)) {
+  while (StartSession(impl, metadata_cb, exception_cb)) {
+    // NextRecords loop
+    while (IsRunning(impl)) {
       try {
-        const Record* rec = impl->blocking.NextRecord(kTimeout);
-        if (rec) {
-          if (record_cb(*rec) == KeepGoing::Stop) {
-            impl->blocking.Stop();
-            impl->NotifyOfStop();
+        const auto& records = impl->blocking.NextRecords(kTimeout);
+        if (!records.empty()) {
+          if (record_batch_cb(records) == KeepGoing::Stop) {
+            StopSession(impl);
             return;
           }
         }  // else timeout
       } catch (const std::exception& exc) {
         if (ExceptionHandler(impl, exception_cb, exc, kMethodName,
-                             "Caught exception reading next record: ") ==
+                             "Caught exception reading next records: ") ==
             ExceptionAction::Restart) {
-          break;  // break out of NextRecord loop, to restart Start loop
+          break;  // break out of NextRecords loop, to restart Start loop
         } else {
-          impl->NotifyOfStop();
+          NotifyOfStop(impl);
           return;
         }
       }
@@ -219,6 +211,49 @@ void LiveThreaded::ProcessingThread(Impl* impl,
   }
 }
 
+void LiveThreaded::RegisterProcessingThread(Impl* impl) {
+  impl->thread_id_ = std::this_thread::get_id();
+}
+
+bool LiveThreaded::IsRunning(const Impl* impl) {
+  return impl->keep_going.load(std::memory_order_relaxed);
+}
+
+bool LiveThreaded::StartSession(Impl* impl,
+                                const MetadataCallback& metadata_callback,
+                                const ExceptionCallback& exception_callback) {
+  static constexpr auto kMethodName = "LiveThreaded::ProcessingThread";
+
+  while (IsRunning(impl)) {
+    try {
+      auto metadata = impl->blocking.Start();
+      if (metadata_callback) {
+        metadata_callback(std::move(metadata));
+      }
+      return true;
+    } catch (const std::exception& exc) {
+      if (ExceptionHandler(impl, exception_callback, exc, kMethodName,
+                           "Caught exception starting session: ") !=
+          ExceptionAction::Restart) {
+        return false;
+      }
+    }
+  }
+  return false;
+}
+
+const databento::Record* LiveThreaded::NextRecord(Impl* impl) {
+  constexpr std::chrono::milliseconds kTimeout{50};
+  return impl->blocking.NextRecord(kTimeout);
+}
+
+void LiveThreaded::StopSession(Impl* impl) {
+  impl->blocking.Stop();
+  impl->NotifyOfStop();
+}
+
+void LiveThreaded::NotifyOfStop(Impl* impl) { impl->NotifyOfStop(); }
+
 LiveThreaded::ExceptionAction LiveThreaded::ExceptionHandler(
     Impl* impl, const ExceptionCallback& exception_callback,
     const std::exception& exc, const char* pretty_function_name,
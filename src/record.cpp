@@ -17,6 +17,51 @@ std::size_t RecordHeader::Size() const {
 
 std::size_t Record::Size() const { return record_->Size(); }
 
+databento::UnixNanos Record::IndexTs() const {
+  switch (RType()) {
+    case RType::Mbo: {
+      return Get<MboMsg>().IndexTs();
+    }
+    case RType::Mbp0: {
+      return Get<TradeMsg>().IndexTs();
+    }
+    case RType::Mbp1: {
+      return Get<Mbp1Msg>().IndexTs();
+    }
+    case RType::Mbp10: {
+      return Get<Mbp10Msg>().IndexTs();
+    }
+    case RType::Bbo1S:  // fallthrough
+    case RType::Bbo1M: {
+      return Get<BboMsg>().IndexTs();
+    }
+    case RType::Cmbp1:  // fallthrough
+    case RType::Tcbbo: {
+      return Get<Cmbp1Msg>().IndexTs();
+    }
+    case RType::Cbbo1S:  // fallthrough
+    case RType::Cbbo1M: {
+      return Get<CbboMsg>().IndexTs();
+    }
+    case RType::Status: {
+      return Get<StatusMsg>().IndexTs();
+    }
+    case RType::InstrumentDef: {
+      // `ts_recv` directly follows the header in every DBN version
+      return Get<InstrumentDefMsg>().IndexTs();
+    }
+    case RType::Imbalance: {
+      return Get<ImbalanceMsg>().IndexTs();
+    }
+    case RType::Statistics: {
+      return Get<StatMsg>().IndexTs();
+    }
+    default: {
+      return Header().ts_event;
+    }
+  }
+}
+
 std::size_t Record::SizeOfSchema(const Schema schema) {
   switch (schema) {
     case Schema::Mbo: {
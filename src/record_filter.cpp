@@ -0,0 +1,28 @@
+#include "databento/record_filter.hpp"
+
+#include <algorithm>  // fill, sort
+#include <utility>    // move
+
+#include "databento/exceptions.hpp"
+
+using databento::RecordFilter;
+
+RecordFilter::RecordFilter(const std::vector<RType>& rtypes,
+                           std::vector<std::uint32_t> instrument_ids,
+                           UnixNanos start, UnixNanos end)
+    : matches_all_{false},
+      instrument_ids_{std::move(instrument_ids)},
+      start_{start},
+      end_{end} {
+  if (end < start) {
+    throw InvalidArgumentError{"RecordFilter::RecordFilter", "end",
+                               "Must not be before start"};
+  }
+  if (rtypes.empty()) {
+    std::fill(rtypes_.begin(), rtypes_.end(), true);
+  }
+  for (const auto rtype : rtypes) {
+    rtypes_[static_cast<std::uint8_t>(rtype)] = true;
+  }
+  std::sort(instrument_ids_.begin(), instrument_ids_.end());
+}
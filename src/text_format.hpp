@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>  // memcpy
+
+// Formatting of integers directly into a character buffer without iostreams or
+// allocation. Every function writes to `out`, which must have enough space,
+// and returns the end of what was written.
+namespace databento {
+namespace detail {
+// The maximum number of characters written by `WriteInt` or `WriteUInt`.
+constexpr std::size_t kMaxIntLen = 20;
+
+constexpr char kDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// Writes exactly `width` digits of `value`, zero-padded.
+inline char* WritePaddedUInt(char* out, std::uint64_t value,
+                             std::size_t width) {
+  char* it = out + width;
+  while (it - out >= 2) {
+    it -= 2;
+    std::memcpy(it, &kDigitPairs[(value % 100) * 2], 2);
+    value /= 100;
+  }
+  if (it != out) {
+    *--it = static_cast<char>('0' + value % 10);
+  }
+  return out + width;
+}
+
+inline char* WriteUInt(char* out, std::uint64_t value) {
+  char buf[kMaxIntLen];
+  char* it = buf + kMaxIntLen;
+  while (value >= 100) {
+    it -= 2;
+    std::memcpy(it, &kDigitPairs[(value % 100) * 2], 2);
+    value /= 100;
+  }
+  if (value >= 10) {
+    it -= 2;
+    std::memcpy(it, &kDigitPairs[value * 2], 2);
+  } else {
+    *--it = static_cast<char>('0' + value);
+  }
+  const auto len = static_cast<std::size_t>(buf + kMaxIntLen - it);
+  std::memcpy(out, it, len);
+  return out + len;
+}
+
+inline char* WriteInt(char* out, std::int64_t value) {
+  if (value < 0) {
+    *out++ = '-';
+    // Avoid overflow when negating the minimum value
+    return WriteUInt(out, 0 - static_cast<std::uint64_t>(value));
+  }
+  return WriteUInt(out, static_cast<std::uint64_t>(value));
+}
+}  // namespace detail
+}  // namespace databento
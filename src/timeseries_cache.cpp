@@ -0,0 +1,258 @@
+#include "databento/timeseries_cache.hpp"
+
+#include <dirent.h>  // closedir, opendir, readdir
+
+#include <algorithm>  // max, min, sort, unique
+#include <cerrno>
+#include <cstdint>  // uint64_t
+#include <cstdio>   // remove, rename
+#include <cstring>  // strerror
+#include <exception>
+#include <fstream>
+#include <iomanip>  // setfill, setw
+#include <iterator>  // istreambuf_iterator
+#include <memory>    // unique_ptr
+#include <random>
+#include <sstream>
+#include <utility>  // move, pair
+#include <vector>
+
+#include "databento/detail/file_system.hpp"  // PathJoin, TryCreateDir
+#include "databento/exceptions.hpp"          // Exception, InvalidArgumentError
+
+using databento::TimeseriesCache;
+using databento::detail::PathJoin;
+using databento::detail::TryCreateDir;
+
+namespace {
+constexpr auto kQueryFileName = "query";
+
+// FNV-1a
+std::uint64_t Hash(const std::string& str) {
+  std::uint64_t hash = 0xcbf29ce484222325;
+  for (const char c : str) {
+    hash ^= static_cast<std::uint8_t>(c);
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+std::string ToHex(std::uint64_t value) {
+  std::ostringstream ss;
+  ss << std::hex << std::setfill('0') << std::setw(16) << value;
+  return ss.str();
+}
+
+std::string SortSymbols(const std::string& symbols) {
+  std::vector<std::string> split;
+  std::istringstream ss{symbols};
+  std::string symbol;
+  while (std::getline(ss, symbol, ',')) {
+    split.emplace_back(std::move(symbol));
+  }
+  std::sort(split.begin(), split.end());
+  split.erase(std::unique(split.begin(), split.end()), split.end());
+  std::string res;
+  for (const auto& s : split) {
+    if (!res.empty()) {
+      res += ',';
+    }
+    res += s;
+  }
+  return res;
+}
+
+std::string EntrySuffix(const TimeseriesCache::Params& params) {
+  const auto compression_it = params.find("compression");
+  return compression_it != params.end() && compression_it->second == "zstd"
+             ? ".dbn.zst"
+             : ".dbn";
+}
+
+std::string EntryFileName(databento::UnixNanos start, databento::UnixNanos end,
+                          const std::string& suffix) {
+  return std::to_string(start.time_since_epoch().count()) + '_' +
+         std::to_string(end.time_since_epoch().count()) + suffix;
+}
+
+bool ParseTimestamp(const std::string& str, databento::UnixNanos* ts) {
+  if (str.empty() ||
+      str.find_first_not_of("0123456789") != std::string::npos) {
+    return false;
+  }
+  try {
+    *ts = databento::UnixNanos{
+        databento::UnixNanos::duration{std::stoull(str)}};
+  } catch (const std::exception&) {
+    return false;
+  }
+  return true;
+}
+
+// Parses the time range from an entry's file name. Returns false for other
+// files, including temporary ones.
+bool ParseEntryFileName(const std::string& file_name,
+                        const std::string& suffix, databento::UnixNanos* start,
+                        databento::UnixNanos* end) {
+  if (file_name.size() <= suffix.size() ||
+      file_name.compare(file_name.size() - suffix.size(), suffix.size(),
+                        suffix) != 0) {
+    return false;
+  }
+  const auto range = file_name.substr(0, file_name.size() - suffix.size());
+  const auto separator = range.find('_');
+  return separator != std::string::npos &&
+         ParseTimestamp(range.substr(0, separator), start) &&
+         ParseTimestamp(range.substr(separator + 1), end) && *start < *end;
+}
+
+// A path next to `file_path` unique between processes, for writing a file
+// before renaming it to `file_path`
+std::string TempPath(const std::string& file_path) {
+  std::random_device random;
+  return file_path + '.' +
+         ToHex((static_cast<std::uint64_t>(random()) << 32) | random()) +
+         ".tmp";
+}
+
+// Renames `temp_path` to `file_path`. Another process may have stored an
+// identical file already, in which case renaming fails on Windows.
+void Commit(const std::string& temp_path, const std::string& file_path) {
+  if (std::rename(temp_path.c_str(), file_path.c_str()) != 0) {
+    const auto err = errno;
+    std::remove(temp_path.c_str());
+    if (!std::ifstream{file_path}.good()) {
+      throw databento::Exception{"Unable to write " + file_path + ": " +
+                                 ::strerror(err)};
+    }
+  }
+}
+}  // namespace
+
+TimeseriesCache::TimeseriesCache(std::string dir) : dir_{std::move(dir)} {
+  if (dir_.empty()) {
+    throw InvalidArgumentError{"TimeseriesCache::TimeseriesCache", "dir",
+                               "Cannot be empty"};
+  }
+}
+
+std::string TimeseriesCache::CanonicalQuery(const std::string& url_path,
+                                            const Params& params) {
+  std::vector<std::pair<std::string, std::string>> sorted;
+  for (const auto& param : params) {
+    if (param.first == "start" || param.first == "end") {
+      continue;
+    }
+    sorted.emplace_back(param.first, param.first == "symbols"
+                                         ? SortSymbols(param.second)
+                                         : param.second);
+  }
+  std::sort(sorted.begin(), sorted.end());
+  std::string res = url_path;
+  char separator = '?';
+  for (const auto& param : sorted) {
+    res += separator;
+    res += param.first;
+    res += '=';
+    res += param.second;
+    separator = '&';
+  }
+  return res;
+}
+
+std::vector<TimeseriesCache::Entry> TimeseriesCache::Plan(
+    const std::string& url_path, const Params& params, UnixNanos start,
+    UnixNanos end) const {
+  if (params.count("limit") != 0) {
+    throw InvalidArgumentError{"TimeseriesCache::Plan", "params",
+                               "Can't cache a request with a limit"};
+  }
+  const auto query_dir = QueryDir(CanonicalQuery(url_path, params), false);
+  const auto suffix = EntrySuffix(params);
+  std::vector<Entry> cached;
+  const std::unique_ptr<DIR, int (*)(DIR*)> dir{::opendir(query_dir.c_str()),
+                                                &::closedir};
+  if (dir != nullptr) {
+    while (const auto* dir_entry = ::readdir(dir.get())) {
+      Entry entry;
+      if (ParseEntryFileName(dir_entry->d_name, suffix, &entry.start,
+                             &entry.end) &&
+          entry.start < end && entry.end > start) {
+        entry.file_path = PathJoin(query_dir, dir_entry->d_name);
+        cached.emplace_back(std::move(entry));
+      }
+    }
+  }
+  std::sort(cached.begin(), cached.end(),
+            [](const Entry& lhs, const Entry& rhs) {
+              return lhs.start < rhs.start;
+            });
+  std::vector<Entry> plan;
+  auto cached_it = cached.cbegin();
+  while (start < end) {
+    // The entry reaching furthest among those starting by `start`. Entries
+    // passed over here end before the one chosen, so are never needed later.
+    auto best_it = cached.cend();
+    for (; cached_it != cached.cend() && cached_it->start <= start;
+         ++cached_it) {
+      if (best_it == cached.cend() || cached_it->end > best_it->end) {
+        best_it = cached_it;
+      }
+    }
+    if (best_it != cached.cend() && best_it->end > start) {
+      const auto part_end = std::min(best_it->end, end);
+      plan.emplace_back(Entry{start, part_end, best_it->file_path});
+      start = part_end;
+    } else {
+      const auto gap_end =
+          cached_it == cached.cend() ? end : std::min(cached_it->start, end);
+      plan.emplace_back(Entry{start, gap_end, {}});
+      start = gap_end;
+    }
+  }
+  return plan;
+}
+
+TimeseriesCache::Entry TimeseriesCache::Store(
+    const std::string& url_path, const Params& params, UnixNanos start,
+    UnixNanos end,
+    const std::function<void(const std::string&)>& write) const {
+  const auto query_dir = QueryDir(CanonicalQuery(url_path, params), true);
+  const auto file_path =
+      PathJoin(query_dir, EntryFileName(start, end, EntrySuffix(params)));
+  const auto temp_path = TempPath(file_path);
+  try {
+    write(temp_path);
+  } catch (...) {
+    std::remove(temp_path.c_str());
+    throw;
+  }
+  Commit(temp_path, file_path);
+  return Entry{start, end, file_path};
+}
+
+std::string TimeseriesCache::QueryDir(const std::string& canonical_query,
+                                      bool create) const {
+  const auto query_dir = PathJoin(dir_, ToHex(Hash(canonical_query)));
+  const auto query_file_path = PathJoin(query_dir, kQueryFileName);
+  std::ifstream query_file{query_file_path};
+  if (query_file.good()) {
+    const std::string existing_query{
+        std::istreambuf_iterator<char>{query_file},
+        std::istreambuf_iterator<char>{}};
+    if (existing_query != canonical_query) {
+      throw Exception{"Cache directory " + query_dir + " belongs to query " +
+                      existing_query + ", not " + canonical_query};
+    }
+  } else if (create) {
+    TryCreateDir(dir_);
+    TryCreateDir(query_dir);
+    const auto temp_path = TempPath(query_file_path);
+    {
+      std::ofstream temp_file{temp_path};
+      temp_file << canonical_query;
+    }
+    Commit(temp_path, query_file_path);
+  }
+  return query_dir;
+}
@@ -0,0 +1,128 @@
+#include "databento/ts_index.hpp"
+
+#include <algorithm>  // lower_bound, max
+#include <array>
+#include <cstring>  // strncmp
+#include <memory>   // unique_ptr
+#include <string>   // to_string
+
+#include "databento/constants.hpp"  // kUndefTimestamp
+#include "databento/dbn_decoder.hpp"
+#include "databento/enums.hpp"  // VersionUpgradePolicy
+#include "databento/exceptions.hpp"
+#include "databento/file_stream.hpp"
+#include "databento/log.hpp"
+
+using databento::TsIndex;
+
+namespace {
+// Includes the format version
+constexpr auto kTsIndexPrefix = "DBNTSIX\x01";
+constexpr std::size_t kTsIndexPrefixLen = 8;
+
+template <typename T>
+void WriteAsBytes(T value, databento::IWritable* output) {
+  output->WriteAll(reinterpret_cast<const std::uint8_t*>(&value), sizeof(T));
+}
+
+template <typename T>
+T ReadAsBytes(databento::IReadable* input) {
+  T value{};
+  input->ReadExact(reinterpret_cast<std::uint8_t*>(&value), sizeof(T));
+  return value;
+}
+}  // namespace
+
+TsIndex::TsIndex(std::uint64_t block_size) : block_size_{block_size} {
+  if (block_size == 0) {
+    throw InvalidArgumentError{"TsIndex::TsIndex", "block_size",
+                               "Must be greater than 0"};
+  }
+}
+
+TsIndex TsIndex::Build(const std::string& dbn_file_path,
+                       std::uint64_t block_size) {
+  TsIndex index{block_size};
+  // Offsets must refer to the records as stored
+  DbnDecoder decoder{
+      ILogReceiver::Default(),
+      std::unique_ptr<IReadable>{new InFileStream{dbn_file_path}},
+      VersionUpgradePolicy::AsIs};
+  decoder.DecodeMetadata();
+  while (true) {
+    const auto offset = decoder.NextRecordOffset();
+    const auto* record = decoder.DecodeRecord();
+    if (record == nullptr) {
+      break;
+    }
+    index.Add(*record, offset);
+  }
+  return index;
+}
+
+TsIndex TsIndex::ReadFromFile(const std::string& index_file_path) {
+  // Mapped so the entry count can be checked against the size of the file
+  MappedFileStream input{index_file_path};
+  std::array<char, kTsIndexPrefixLen> prefix{};
+  input.ReadExact(reinterpret_cast<std::uint8_t*>(prefix.data()),
+                  prefix.size());
+  if (std::strncmp(prefix.data(), kTsIndexPrefix, kTsIndexPrefixLen) != 0) {
+    throw DbnResponseError{"Invalid or unsupported timestamp index file"};
+  }
+  TsIndex index{ReadAsBytes<std::uint64_t>(&input)};
+  const auto count = ReadAsBytes<std::uint64_t>(&input);
+  constexpr std::size_t kEntrySize = 2 * sizeof(std::uint64_t);
+  if (count > input.RemainingSize() / kEntrySize) {
+    throw DbnResponseError{"Timestamp index file is truncated, expected " +
+                           std::to_string(count) + " entries"};
+  }
+  index.entries_.reserve(static_cast<std::size_t>(count));
+  for (std::uint64_t i = 0; i < count; ++i) {
+    const auto max_ts = ReadAsBytes<std::uint64_t>(&input);
+    const auto offset = ReadAsBytes<std::uint64_t>(&input);
+    index.entries_.emplace_back(
+        Entry{UnixNanos{std::chrono::nanoseconds{max_ts}}, offset});
+  }
+  return index;
+}
+
+void TsIndex::WriteToFile(const std::string& index_file_path) const {
+  OutFileStream output{index_file_path};
+  output.WriteAll(reinterpret_cast<const std::uint8_t*>(kTsIndexPrefix),
+                  kTsIndexPrefixLen);
+  WriteAsBytes(block_size_, &output);
+  WriteAsBytes<std::uint64_t>(entries_.size(), &output);
+  for (const auto& entry : entries_) {
+    WriteAsBytes(entry.max_ts.time_since_epoch().count(), &output);
+    WriteAsBytes(entry.offset, &output);
+  }
+}
+
+void TsIndex::Add(const Record& record, std::uint64_t offset) {
+  const auto ts = record.IndexTs();
+  if (entries_.empty() || offset >= entries_.back().offset + block_size_) {
+    entries_.emplace_back(
+        Entry{entries_.empty() ? UnixNanos{} : entries_.back().max_ts, offset});
+  }
+  // Ignore unset timestamps, which would otherwise be the maximum of every
+  // following block
+  if (ts.time_since_epoch().count() != kUndefTimestamp) {
+    entries_.back().max_ts = std::max(entries_.back().max_ts, ts);
+  }
+}
+
+std::size_t TsIndex::Find(UnixNanos ts) const {
+  // `max_ts` is nondecreasing
+  const auto it = std::lower_bound(
+      entries_.cbegin(), entries_.cend(), ts,
+      [](const Entry& entry, UnixNanos target) {
+        return entry.max_ts < target;
+      });
+  return static_cast<std::size_t>(it - entries_.cbegin());
+}
+
+namespace databento {
+bool operator==(const TsIndex::Entry& lhs, const TsIndex::Entry& rhs) {
+  return lhs.max_ts == rhs.max_ts && lhs.offset == rhs.offset;
+}
+}  // namespace databento
@@ -0,0 +1,110 @@
+#include "databento/zstd_dictionary.hpp"
+
+#include <zdict.h>
+#include <zstd.h>
+
+#include <array>
+#include <memory>   // unique_ptr
+#include <utility>  // move
+
+#include "databento/dbn_decoder.hpp"
+#include "databento/enums.hpp"  // VersionUpgradePolicy
+#include "databento/exceptions.hpp"
+#include "databento/file_stream.hpp"
+#include "databento/log.hpp"
+
+using databento::ZstdDictionary;
+
+ZstdDictionary::ZstdDictionary(std::vector<std::uint8_t> data)
+    : data_{std::move(data)},
+      id_{::ZSTD_getDictID_fromDict(data_.data(), data_.size())} {
+  if (data_.empty()) {
+    throw InvalidArgumentError{"ZstdDictionary::ZstdDictionary", "data",
+                               "Can't be empty"};
+  }
+}
+
+ZstdDictionary ZstdDictionary::Train(
+    const std::vector<std::uint8_t>& samples,
+    const std::vector<std::size_t>& sample_sizes, std::size_t max_size) {
+  std::vector<std::uint8_t> data(max_size);
+  const auto size = ::ZDICT_trainFromBuffer(
+      data.data(), data.size(), samples.data(), sample_sizes.data(),
+      static_cast<unsigned>(sample_sizes.size()));
+  if (::ZDICT_isError(size)) {
+    throw InvalidArgumentError{
+        "ZstdDictionary::Train", "samples",
+        std::string{"Failed to train Zstd dictionary: "} +
+            ::ZDICT_getErrorName(size)};
+  }
+  data.resize(size);
+  return ZstdDictionary{std::move(data)};
+}
+
+ZstdDictionary ZstdDictionary::Train(const std::string& dbn_file_path,
+                                     std::size_t sample_size,
+                                     std::size_t max_size) {
+  if (sample_size == 0) {
+    throw InvalidArgumentError{"ZstdDictionary::Train", "sample_size",
+                               "Must be greater than 0"};
+  }
+  // Train on the records as they'll be stored
+  DbnDecoder decoder{
+      ILogReceiver::Default(),
+      std::unique_ptr<IReadable>{new InFileStream{dbn_file_path}},
+      VersionUpgradePolicy::AsIs};
+  decoder.DecodeMetadata();
+  std::vector<std::uint8_t> samples;
+  std::vector<std::size_t> sample_sizes{0};
+  while (const auto* record = decoder.DecodeRecord()) {
+    if (sample_sizes.back() >= sample_size) {
+      sample_sizes.emplace_back(0);
+    }
+    const auto* bytes =
+        reinterpret_cast<const std::uint8_t*>(&record->Header());
+    samples.insert(samples.end(), bytes, bytes + record->Size());
+    sample_sizes.back() += record->Size();
+  }
+  return Train(samples, sample_sizes, max_size);
+}
+
+ZstdDictionary ZstdDictionary::ReadFromFile(const std::string& dict_file_path) {
+  InFileStream input{dict_file_path};
+  std::vector<std::uint8_t> data;
+  std::array<std::uint8_t, 4096> buffer{};
+  while (const auto read_size = input.ReadSome(buffer.data(), buffer.size())) {
+    data.insert(data.end(), buffer.cbegin(),
+                buffer.cbegin() + static_cast<std::ptrdiff_t>(read_size));
+  }
+  return ZstdDictionary{std::move(data)};
+}
+
+void ZstdDictionary::WriteToFile(const std::string& dict_file_path) const {
+  OutFileStream output{dict_file_path};
+  output.WriteAll(data_.data(), data_.size());
+}
+
+using databento::ZstdDictionarySet;
+
+void ZstdDictionarySet::Add(Schema schema, ZstdDictionary dictionary) {
+  if (dictionary.Id() == 0) {
+    throw InvalidArgumentError{"ZstdDictionarySet::Add", "dictionary",
+                               "Must have an ID so readers can find it"};
+  }
+  dictionaries_.erase(schema);
+  dictionaries_.emplace(schema, std::move(dictionary));
+}
+
+const ZstdDictionary* ZstdDictionarySet::Find(Schema schema) const {
+  const auto it = dictionaries_.find(schema);
+  return it == dictionaries_.end() ? nullptr : &it->second;
+}
+
+const ZstdDictionary* ZstdDictionarySet::FindById(std::uint32_t id) const {
+  for (const auto& schema_and_dictionary : dictionaries_) {
+    if (schema_and_dictionary.second.Id() == id) {
+      return &schema_and_dictionary.second;
+    }
+  }
+  return nullptr;
+}
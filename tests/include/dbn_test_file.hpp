@@ -0,0 +1,186 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>  // size_t
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>  // move
+#include <vector>
+
+#include "databento/constants.hpp"  // kDbnVersion, kFixedPriceScale, kSymbolCstrLen
+#include "databento/datetime.hpp"   // UnixNanos
+#include "databento/dbn.hpp"        // Metadata
+#include "databento/dbn_encoder.hpp"
+#include "databento/detail/zstd_stream.hpp"  // ZstdCompressStream
+#include "databento/enums.hpp"               // Compression, Schema, SType
+#include "databento/file_stream.hpp"         // OutFileStream
+#include "databento/flag_set.hpp"
+#include "databento/instrument_index.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"  // MboMsg, TradeMsg
+#include "databento/ts_index.hpp"
+#include "databento/zstd_compress_options.hpp"
+
+namespace databento {
+namespace test {
+// Returns the metadata of a generated DBN file of `schema` records between
+// `start` and `end`.
+inline Metadata GenTestMetadata(std::string dataset, Schema schema,
+                                UnixNanos start, UnixNanos end,
+                                std::vector<std::string> symbols) {
+  return Metadata{kDbnVersion,
+                  std::move(dataset),
+                  false,
+                  schema,
+                  start,
+                  end,
+                  {},
+                  false,
+                  SType::RawSymbol,
+                  SType::InstrumentId,
+                  false,
+                  kSymbolCstrLen,
+                  std::move(symbols),
+                  {},
+                  {},
+                  {}};
+}
+
+// Returns the trade at `idx` in a generated sequence of trades for
+// `instrument_id` at `ts`. Prices aren't monotonic.
+inline TradeMsg GenTrade(std::uint32_t idx, std::uint32_t instrument_id,
+                         UnixNanos ts) {
+  return TradeMsg{
+      RecordHeader{sizeof(TradeMsg) / RecordHeader::kLengthMultiplier,
+                   RType::Mbp0, 2, instrument_id, ts},
+      static_cast<std::int64_t>(100 + idx % 13) * kFixedPriceScale,
+      idx + 1,
+      Action::Trade,
+      idx % 2 == 0 ? Side::Bid : Side::Ask,
+      {},
+      0,
+      ts,
+      TimeDeltaNanos{static_cast<std::int32_t>(idx)},
+      idx};
+}
+
+// Returns the trade at `idx` in a generated sequence of trades one
+// nanosecond apart.
+inline TradeMsg GenTrade(std::uint32_t idx) {
+  return GenTrade(
+      idx, idx % 7,
+      UnixNanos{std::chrono::nanoseconds{1704067200000000000 + idx}});
+}
+
+// Returns the metadata of a file of the first `count` trades from `GenTrade`.
+inline Metadata GenTradesMetadata(std::uint32_t count) {
+  return GenTestMetadata(dataset::kXnasItch, Schema::Trades,
+                         GenTrade(0).ts_recv, GenTrade(count).ts_recv, {});
+}
+
+// Returns an MBO record with every field set.
+inline MboMsg GenMbo() {
+  return MboMsg{
+      RecordHeader{sizeof(MboMsg) / RecordHeader::kLengthMultiplier,
+                   RType::Mbo, 1, 5482,
+                   UnixNanos{std::chrono::nanoseconds{1704067200000000000}}},
+      7,
+      -1500000000,
+      10,
+      FlagSet{FlagSet::kLast},
+      3,
+      Action::Add,
+      Side::Ask,
+      UnixNanos{std::chrono::nanoseconds{1704067200123456789}},
+      TimeDeltaNanos{-25},
+      42};
+}
+
+// Returns the MBO record at `idx` in a generated sequence with an index
+// timestamp of `ts`. The other fields vary like real data, so they compress
+// like it.
+inline MboMsg GenMbo(std::uint32_t idx, UnixNanos ts) {
+  return MboMsg{
+      RecordHeader{sizeof(MboMsg) / RecordHeader::kLengthMultiplier,
+                   RType::Mbo, 1, 5482, ts - std::chrono::nanoseconds{5}},
+      std::uint64_t{idx} * 7919 % 100003,
+      (4500 + std::int64_t{idx % 17}) * kFixedPriceScale / 4,
+      1 + idx % 5,
+      {},
+      0,
+      idx % 3 == 0 ? Action::Cancel : Action::Add,
+      idx % 2 == 0 ? Side::Bid : Side::Ask,
+      ts,
+      {},
+      idx};
+}
+
+struct DbnTestFileOptions {
+  Compression compression{Compression::None};
+  // With Zstd compression, a nonzero `frame_size` writes the seekable format,
+  // starting a new frame once at least `frame_size` bytes are written.
+  std::size_t frame_size{};
+  ZstdCompressOptions zstd_options{};
+  // Filled in while encoding if not null
+  TsIndex* ts_index{};
+  InstrumentIndex* instrument_index{};
+};
+
+// Returns options for writing the Zstd seekable format with frames of at least
+// `frame_size` bytes, or an uncompressed file if `frame_size` is 0.
+inline DbnTestFileOptions FrameSizeTestFileOptions(std::size_t frame_size) {
+  DbnTestFileOptions options;
+  options.compression = frame_size == 0 ? Compression::None : Compression::Zstd;
+  options.frame_size = frame_size;
+  return options;
+}
+
+// Writes a DBN file at `file_path` with `metadata` and the records encoded by
+// `encode_records`.
+inline void WriteDbnTestFile(
+    const std::string& file_path, const Metadata& metadata,
+    const std::function<void(DbnEncoder*)>& encode_records,
+    const DbnTestFileOptions& options) {
+  OutFileStream file{file_path};
+  if (options.compression == Compression::None) {
+    DbnEncoder encoder{metadata, &file, options.ts_index,
+                       options.instrument_index};
+    encode_records(&encoder);
+    return;
+  }
+  detail::ZstdCompressStream zstd{ILogReceiver::Default(), &file,
+                                  options.frame_size, options.zstd_options};
+  DbnEncoder encoder{metadata, &zstd, options.ts_index,
+                     options.instrument_index};
+  encode_records(&encoder);
+}
+
+// Writes a DBN file at `file_path` with `metadata` and `count` records, each
+// returned by `gen_record` from its index.
+template <typename F>
+void WriteGenDbnTestFile(const std::string& file_path, const Metadata& metadata,
+                         std::uint32_t count, const F& gen_record,
+                         const DbnTestFileOptions& options) {
+  WriteDbnTestFile(
+      file_path, metadata,
+      [count, &gen_record](DbnEncoder* encoder) {
+        for (std::uint32_t i = 0; i < count; ++i) {
+          auto record = gen_record(i);
+          encoder->EncodeRecord(Record{&record.hd});
+        }
+      },
+      options);
+}
+
+// Writes a DBN file at `file_path` of the first `count` trades from
+// `GenTrade`.
+inline void WriteTradesTestFile(const std::string& file_path,
+                                std::uint32_t count,
+                                const DbnTestFileOptions& options = {}) {
+  WriteGenDbnTestFile(
+      file_path, GenTradesMetadata(count), count,
+      [](std::uint32_t idx) { return GenTrade(idx); }, options);
+}
+}  // namespace test
+}  // namespace databento
@@ -3,8 +3,10 @@
 #include <httplib.h>
 #include <nlohmann/json.hpp>
 
+#include <functional>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "databento/detail/scoped_thread.hpp"
 
@@ -33,15 +35,27 @@ class MockHttpServer {
   void MockPostJson(const std::string& path,
                     const std::map<std::string, std::string>& params,
                     const nlohmann::json& json);
+  // Responds with the result of `make_json` for the request's form params.
+  void MockPostJson(
+      const std::string& path,
+      const std::function<nlohmann::json(const httplib::Params&)>& make_json);
   void MockStreamDbn(const std::string& path,
                      const std::map<std::string, std::string>& params,
                      const std::string& dbn_path);
+  // Streams the file in `dbn_paths` keyed by the value of the query param
+  // `param`.
+  void MockStreamDbnByParam(
+      const std::string& path, const std::string& param,
+      const std::map<std::string, std::string>& dbn_paths);
 
  private:
   static void CheckParams(const std::map<std::string, std::string>& params,
                           const httplib::Request& req);
   static void CheckFormParams(const std::map<std::string, std::string>& params,
                               const httplib::Request& req);
+  static std::vector<char> ReadFile(const std::string& file_path);
+  static void SetDbnContent(const std::vector<char>& buffer,
+                            httplib::Response& resp);
 
   httplib::Server server_{};
   const int port_{};
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <dirent.h>  // closedir, opendir, readdir
 #include <gtest/gtest.h>  // EXPECT_EQ
 
 #include <cassert>  // assert
 #include <cstdio>   // remove
 #include <fstream>  // ifstream
+#include <memory>   // unique_ptr
 #include <string>
 #include <utility>  // move
 
@@ -43,4 +45,49 @@ class TempFile {
  private:
   std::string path_;
 };
+
+// A RAII for a directory that's removed along with its contents when the class
+// goes out of scope. The directory itself isn't created.
+class TempDirectory {
+ public:
+  explicit TempDirectory(std::string path) : path_{std::move(path)} {}
+  TempDirectory(const TempDirectory&) = delete;
+  TempDirectory& operator=(const TempDirectory&) = delete;
+  TempDirectory(TempDirectory&&) = default;
+  TempDirectory& operator=(TempDirectory&&) = default;
+  ~TempDirectory() {
+    if (!path_.empty()) {
+      Remove(path_);
+    }
+  }
+
+  const std::string& Path() const { return path_; }
+
+ private:
+  static void Remove(const std::string& path) {
+    {
+      const std::unique_ptr<DIR, int (*)(DIR*)> dir{::opendir(path.c_str()),
+                                                    &::closedir};
+      if (dir == nullptr) {
+        return;
+      }
+      while (const auto* dir_entry = ::readdir(dir.get())) {
+        const std::string name{dir_entry->d_name};
+        if (name == "." || name == "..") {
+          continue;
+        }
+        const auto entry_path = path + '/' + name;
+        // Fails for directories
+        if (std::remove(entry_path.c_str()) != 0) {
+          Remove(entry_path);
+        }
+      }
+    }
+    const int ret = std::remove(path.c_str());
+    EXPECT_EQ(ret, 0) << "TempDirectory couldn't remove directory at " << path
+                      << ": " << ::strerror(errno);
+  }
+
+  std::string path_;
+};
 }  // namespace databento
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "databento/columnar_file.hpp"
+#include "databento/constants.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_columnar_reader.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "dbn_test_file.hpp"
+#include "temp_file.hpp"
+
+namespace databento {
+namespace test {
+namespace {
+constexpr std::uint32_t kRecordCount = 1000;
+constexpr std::size_t kChunkSize = 400;
+
+void WriteColumnarTrades(const std::string& dbn_path,
+                         const std::string& columnar_path) {
+  WriteTradesTestFile(dbn_path, kRecordCount);
+  DbnColumnarReader reader{ILogReceiver::Default(), dbn_path, kChunkSize};
+  ColumnarFileWriter writer{ILogReceiver::Default(), columnar_path,
+                            reader.GetMetadata()};
+  TradeColumns columns;
+  while (reader.NextChunk(&columns)) {
+    writer.WriteRowGroup(columns);
+  }
+  writer.Finish();
+}
+}  // namespace
+
+TEST(ColumnarFileTests, TestRoundTrip) {
+  const TempFile dbn_file{TEST_BUILD_DIR "/columnar-round-trip.dbn"};
+  const TempFile columnar_file{TEST_BUILD_DIR "/columnar-round-trip.dbncol"};
+  WriteColumnarTrades(dbn_file.Path(), columnar_file.Path());
+
+  ColumnarFileReader target{columnar_file.Path()};
+  EXPECT_EQ(target.GetMetadata(), GenTradesMetadata(kRecordCount));
+  ASSERT_EQ(target.RowGroups().size(), 3);
+  EXPECT_EQ(target.RowGroups()[0].row_count, kChunkSize);
+  EXPECT_EQ(target.RowGroups()[2].row_count, 200);
+  TradeColumns columns;
+  std::uint32_t idx{};
+  for (std::size_t i = 0; i < target.RowGroups().size(); ++i) {
+    target.ReadRowGroup(i, &columns);
+    ASSERT_EQ(columns.Size(), target.RowGroups()[i].row_count);
+    for (std::size_t j = 0; j < columns.Size(); ++j, ++idx) {
+      const auto expected = GenTrade(idx);
+      EXPECT_EQ(columns.publisher_id[j], expected.hd.publisher_id);
+      EXPECT_EQ(columns.instrument_id[j], expected.hd.instrument_id);
+      EXPECT_EQ(columns.ts_event[j], expected.hd.ts_event);
+      EXPECT_EQ(columns.price[j], expected.price);
+      EXPECT_EQ(columns.size[j], expected.size);
+      EXPECT_EQ(columns.action[j], expected.action);
+      EXPECT_EQ(columns.side[j], expected.side);
+      EXPECT_EQ(columns.ts_recv[j], expected.ts_recv);
+      EXPECT_EQ(columns.ts_in_delta[j], expected.ts_in_delta);
+      EXPECT_EQ(columns.sequence[j], expected.sequence);
+    }
+  }
+  EXPECT_EQ(idx, kRecordCount);
+}
+
+TEST(ColumnarFileTests, TestStatistics) {
+  const TempFile dbn_file{TEST_BUILD_DIR "/columnar-stats.dbn"};
+  const TempFile columnar_file{TEST_BUILD_DIR "/columnar-stats.dbncol"};
+  WriteColumnarTrades(dbn_file.Path(), columnar_file.Path());
+
+  ColumnarFileReader target{columnar_file.Path()};
+  const auto ts_recv_idx = target.ColumnIndex("ts_recv");
+  const auto price_idx = target.ColumnIndex("price");
+  const auto& second_group = target.RowGroups()[1];
+  EXPECT_TRUE(second_group.columns[ts_recv_idx].is_unsigned);
+  EXPECT_EQ(second_group.columns[ts_recv_idx].unsigned_min,
+            GenTrade(kChunkSize).ts_recv.time_since_epoch().count());
+  EXPECT_EQ(second_group.columns[ts_recv_idx].unsigned_max,
+            GenTrade(2 * kChunkSize - 1).ts_recv.time_since_epoch().count());
+  EXPECT_FALSE(second_group.columns[price_idx].is_unsigned);
+  EXPECT_EQ(second_group.columns[ts_recv_idx].encoding,
+            ColumnEncoding::DeltaZstd);
+  EXPECT_EQ(second_group.columns[price_idx].min, 100 * kFixedPriceScale);
+  EXPECT_EQ(second_group.columns[price_idx].max, 112 * kFixedPriceScale);
+  EXPECT_EQ(second_group.columns[target.ColumnIndex("size")].encoding,
+            ColumnEncoding::Zstd);
+  EXPECT_THROW(target.ColumnIndex("bid_px"), InvalidArgumentError);
+}
+
+TEST(ColumnarFileTests, TestSelectColumns) {
+  const TempFile dbn_file{TEST_BUILD_DIR "/columnar-select.dbn"};
+  const TempFile columnar_file{TEST_BUILD_DIR "/columnar-select.dbncol"};
+  WriteColumnarTrades(dbn_file.Path(), columnar_file.Path());
+
+  ColumnarFileReader target{columnar_file.Path()};
+  target.SelectColumns({"price", "ts_recv"});
+  TradeColumns columns;
+  target.ReadRowGroup(1, &columns);
+  ASSERT_EQ(columns.price.size(), kChunkSize);
+  ASSERT_EQ(columns.ts_recv.size(), kChunkSize);
+  EXPECT_TRUE(columns.size.empty());
+  EXPECT_TRUE(columns.ts_event.empty());
+  EXPECT_EQ(columns.price[0], GenTrade(kChunkSize).price);
+  EXPECT_EQ(columns.ts_recv[0], GenTrade(kChunkSize).ts_recv);
+  // Reset the selection
+  target.SelectColumns({});
+  target.ReadRowGroup(1, &columns);
+  EXPECT_EQ(columns.size.size(), kChunkSize);
+  EXPECT_THROW(target.SelectColumns({"bid_px"}), InvalidArgumentError);
+}
+
+TEST(ColumnarFileTests, TestMismatchedColumns) {
+  const TempFile dbn_file{TEST_BUILD_DIR "/columnar-mismatch.dbn"};
+  const TempFile columnar_file{TEST_BUILD_DIR "/columnar-mismatch.dbncol"};
+  WriteColumnarTrades(dbn_file.Path(), columnar_file.Path());
+
+  ColumnarFileReader target{columnar_file.Path()};
+  MboColumns columns;
+  EXPECT_THROW(target.ReadRowGroup(0, &columns), InvalidArgumentError);
+  TradeColumns trades;
+  EXPECT_THROW(target.ReadRowGroup(3, &trades), InvalidArgumentError);
+}
+
+TEST(ColumnarFileTests, TestUnsignedStatistics) {
+  constexpr auto kMaxOrderId = std::numeric_limits<std::uint64_t>::max();
+  const TempFile columnar_file{TEST_BUILD_DIR "/columnar-unsigned.dbncol"};
+  {
+    ColumnarFileWriter writer{ILogReceiver::Default(), columnar_file.Path(),
+                              GenTradesMetadata(kRecordCount)};
+    MboColumns columns;
+    for (const auto order_id : {std::uint64_t{1}, kMaxOrderId,
+                                std::uint64_t{1} << 63}) {
+      auto mbo = GenMbo();
+      mbo.order_id = order_id;
+      columns.Append(mbo);
+    }
+    auto mbo = GenMbo();
+    mbo.ts_recv = UnixNanos{std::chrono::nanoseconds{kUndefTimestamp}};
+    columns.Append(mbo);
+    writer.WriteRowGroup(columns);
+  }
+
+  ColumnarFileReader target{columnar_file.Path()};
+  const auto& row_group = target.RowGroups()[0];
+  const auto& order_id = row_group.columns[target.ColumnIndex("order_id")];
+  ASSERT_TRUE(order_id.is_unsigned);
+  EXPECT_EQ(order_id.unsigned_min, std::uint64_t{1});
+  EXPECT_EQ(order_id.unsigned_max, kMaxOrderId);
+  const auto& ts_recv = row_group.columns[target.ColumnIndex("ts_recv")];
+  ASSERT_TRUE(ts_recv.is_unsigned);
+  EXPECT_EQ(ts_recv.unsigned_min,
+            GenMbo().ts_recv.time_since_epoch().count());
+  EXPECT_EQ(ts_recv.unsigned_max, kUndefTimestamp);
+  EXPECT_EQ(row_group.columns[target.ColumnIndex("price")].min,
+            GenMbo().price);
+}
+
+TEST(ColumnarFileTests, TestWriteMismatchedLengths) {
+  const TempFile columnar_file{TEST_BUILD_DIR "/columnar-lengths.dbncol"};
+  ColumnarFileWriter target{ILogReceiver::Default(), columnar_file.Path(),
+                            GenTradesMetadata(kRecordCount)};
+  TradeColumns columns;
+  columns.Append(GenTrade(0));
+  columns.price.emplace_back(0);
+  EXPECT_THROW(target.WriteRowGroup(columns), InvalidArgumentError);
+  OhlcvColumns ohlcv;
+  target.WriteRowGroup(ohlcv);
+  EXPECT_THROW(target.WriteRowGroup(columns), InvalidArgumentError);
+}
+
+TEST(ColumnarFileTests, TestReadDbnFile) {
+  EXPECT_THROW(ColumnarFileReader{TEST_BUILD_DIR "/data/test_data.mbo.dbn"},
+               DbnResponseError);
+}
+}  // namespace test
+}  // namespace databento
@@ -1,5 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <array>
+#include <chrono>
+#include <string>
+#include <system_error>
+
+#include "databento/constants.hpp"
 #include "databento/datetime.hpp"
 
 namespace databento {
@@ -11,5 +17,51 @@ TEST(DateFromIso8601IntTests, TestValid) {
 TEST(DateFromIso8601IntTests, TestPadding) {
   ASSERT_EQ(databento::DateFromIso8601Int(20190801), "2019-08-01");
 }
+
+TEST(ToIso8601Tests, TestString) {
+  EXPECT_EQ(ToIso8601(UnixNanos{}), "1970-01-01T00:00:00.000000000Z");
+  EXPECT_EQ(ToIso8601(UnixNanos{std::chrono::nanoseconds{1709251199999999999}}),
+            "2024-02-29T23:59:59.999999999Z");
+  EXPECT_EQ(ToIso8601(UnixNanos{std::chrono::nanoseconds{kUndefTimestamp}}),
+            "UNDEF_TIMESTAMP");
+}
+
+TEST(ToIso8601Tests, TestChars) {
+  std::array<char, kIso8601Len> buf{};
+  const UnixNanos ts{std::chrono::nanoseconds{1704067200000000001}};
+  auto res = ToIso8601(buf.data(), buf.data() + buf.size(), ts);
+  ASSERT_EQ(res.ec, std::errc{});
+  EXPECT_EQ(std::string(buf.data(), res.ptr), "2024-01-01T00:00:00.000000001Z");
+  // Same day uses the cached date
+  res = ToIso8601(buf.data(), buf.data() + buf.size(),
+                  ts + std::chrono::hours{23});
+  ASSERT_EQ(res.ec, std::errc{});
+  EXPECT_EQ(std::string(buf.data(), res.ptr), "2024-01-01T23:00:00.000000001Z");
+  // Next day
+  res = ToIso8601(buf.data(), buf.data() + buf.size(),
+                  ts + std::chrono::hours{24});
+  ASSERT_EQ(res.ec, std::errc{});
+  EXPECT_EQ(std::string(buf.data(), res.ptr), "2024-01-02T00:00:00.000000001Z");
+  res = ToIso8601(buf.data(), buf.data() + buf.size() - 1, ts);
+  EXPECT_EQ(res.ec, std::errc::value_too_large);
+}
+
+TEST(ToCharsTests, TestUnixNanos) {
+  std::array<char, 20> buf{};
+  const UnixNanos ts{std::chrono::nanoseconds{1704067200000000001}};
+  auto res = ToChars(buf.data(), buf.data() + buf.size(), ts);
+  ASSERT_EQ(res.ec, std::errc{});
+  EXPECT_EQ(std::string(buf.data(), res.ptr), ToString(ts));
+  res = ToChars(buf.data(), buf.data() + 5, ts);
+  EXPECT_EQ(res.ec, std::errc::value_too_large);
+}
+
+TEST(ToCharsTests, TestTimeDeltaNanos) {
+  std::array<char, 11> buf{};
+  const TimeDeltaNanos delta{-1234};
+  const auto res = ToChars(buf.data(), buf.data() + buf.size(), delta);
+  ASSERT_EQ(res.ec, std::errc{});
+  EXPECT_EQ(std::string(buf.data(), res.ptr), "-1234");
+}
 }  // namespace test
 }  // namespace databento
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "databento/constants.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_columnar_reader.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "dbn_test_file.hpp"
+#include "temp_file.hpp"
+
+namespace databento {
+namespace test {
+namespace {
+constexpr std::uint32_t kRecordCount = 1000;
+
+void WriteTrades(const std::string& file_path) {
+  WriteTradesTestFile(file_path, kRecordCount);
+}
+
+template <typename T>
+bool IsAligned(const Column<T>& column) {
+  return reinterpret_cast<std::uintptr_t>(column.data()) % kColumnAlignment ==
+         0;
+}
+}  // namespace
+
+TEST(DbnColumnarReaderTests, TestChunks) {
+  const TempFile temp_file{TEST_BUILD_DIR "/columnar-reader.dbn"};
+  WriteTrades(temp_file.Path());
+  DbnColumnarReader target{ILogReceiver::Default(), temp_file.Path(), 300};
+  EXPECT_EQ(target.GetMetadata().schema, Schema::Trades);
+  TradeColumns columns;
+  std::vector<std::size_t> chunk_sizes;
+  std::uint32_t idx{};
+  const std::int64_t* price_data{};
+  while (target.NextChunk(&columns)) {
+    chunk_sizes.emplace_back(columns.Size());
+    EXPECT_TRUE(IsAligned(columns.price));
+    EXPECT_TRUE(IsAligned(columns.ts_recv));
+    EXPECT_TRUE(IsAligned(columns.side));
+    // Storage is reused between chunks
+    if (price_data != nullptr) {
+      EXPECT_EQ(columns.price.data(), price_data);
+    }
+    price_data = columns.price.data();
+    for (std::size_t i = 0; i < columns.Size(); ++i, ++idx) {
+      const auto expected = GenTrade(idx);
+      EXPECT_EQ(columns.instrument_id[i], expected.hd.instrument_id);
+      EXPECT_EQ(columns.ts_event[i], expected.hd.ts_event);
+      EXPECT_EQ(columns.price[i], expected.price);
+      EXPECT_EQ(columns.size[i], expected.size);
+      EXPECT_EQ(columns.action[i], expected.action);
+      EXPECT_EQ(columns.side[i], expected.side);
+      EXPECT_EQ(columns.ts_recv[i], expected.ts_recv);
+      EXPECT_EQ(columns.ts_in_delta[i], expected.ts_in_delta);
+      EXPECT_EQ(columns.sequence[i], expected.sequence);
+    }
+  }
+  EXPECT_EQ(chunk_sizes, (std::vector<std::size_t>{300, 300, 300, 100}));
+  EXPECT_EQ(columns.Size(), 0);
+}
+
+TEST(DbnColumnarReaderTests, TestMbo) {
+  const auto file_path = TEST_BUILD_DIR "/data/test_data.mbo.dbn.zst";
+  std::vector<MboMsg> expected;
+  DbnFileStore{file_path}.Replay<MboMsg>([&expected](const MboMsg& mbo) {
+    expected.emplace_back(mbo);
+    return KeepGoing::Continue;
+  });
+  ASSERT_FALSE(expected.empty());
+  DbnColumnarReader target{ILogReceiver::Default(), file_path, 1024};
+  MboColumns columns;
+  ASSERT_TRUE(target.NextChunk(&columns));
+  ASSERT_EQ(columns.Size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(columns.order_id[i], expected[i].order_id);
+    EXPECT_EQ(columns.price[i], expected[i].price);
+    EXPECT_EQ(columns.size[i], expected[i].size);
+    EXPECT_EQ(columns.flags[i], expected[i].flags);
+    EXPECT_EQ(columns.channel_id[i], expected[i].channel_id);
+    EXPECT_EQ(columns.side[i], expected[i].side);
+    EXPECT_EQ(columns.ts_recv[i], expected[i].ts_recv);
+  }
+  EXPECT_FALSE(target.NextChunk(&columns));
+}
+
+TEST(DbnColumnarReaderTests, TestMbp1) {
+  const auto file_path = TEST_BUILD_DIR "/data/test_data.mbp-1.v1.dbn";
+  std::vector<Mbp1Msg> expected;
+  DbnFileStore{file_path}.Replay<Mbp1Msg>([&expected](const Mbp1Msg& mbp1) {
+    expected.emplace_back(mbp1);
+    return KeepGoing::Continue;
+  });
+  ASSERT_FALSE(expected.empty());
+  DbnColumnarReader target{ILogReceiver::Default(), file_path, 1};
+  Mbp1Columns columns;
+  for (const auto& mbp1 : expected) {
+    ASSERT_TRUE(target.NextChunk(&columns));
+    ASSERT_EQ(columns.Size(), 1);
+    EXPECT_EQ(columns.price[0], mbp1.price);
+    EXPECT_EQ(columns.bid_px[0], mbp1.levels[0].bid_px);
+    EXPECT_EQ(columns.ask_px[0], mbp1.levels[0].ask_px);
+    EXPECT_EQ(columns.bid_sz[0], mbp1.levels[0].bid_sz);
+    EXPECT_EQ(columns.ask_ct[0], mbp1.levels[0].ask_ct);
+  }
+  EXPECT_FALSE(target.NextChunk(&columns));
+}
+
+TEST(DbnColumnarReaderTests, TestOhlcv) {
+  const auto file_path = TEST_BUILD_DIR "/data/test_data.ohlcv-1m.dbn";
+  std::vector<OhlcvMsg> expected;
+  DbnFileStore{file_path}.Replay<OhlcvMsg>([&expected](const OhlcvMsg& ohlcv) {
+    expected.emplace_back(ohlcv);
+    return KeepGoing::Continue;
+  });
+  ASSERT_FALSE(expected.empty());
+  DbnColumnarReader target{ILogReceiver::Default(), file_path, 1024};
+  OhlcvColumns columns;
+  ASSERT_TRUE(target.NextChunk(&columns));
+  ASSERT_EQ(columns.Size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(columns.ts_event[i], expected[i].hd.ts_event);
+    EXPECT_EQ(columns.open[i], expected[i].open);
+    EXPECT_EQ(columns.high[i], expected[i].high);
+    EXPECT_EQ(columns.low[i], expected[i].low);
+    EXPECT_EQ(columns.close[i], expected[i].close);
+    EXPECT_EQ(columns.volume[i], expected[i].volume);
+  }
+}
+
+TEST(DbnColumnarReaderTests, TestSkipsOtherRecordTypes) {
+  DbnColumnarReader target{ILogReceiver::Default(),
+                           TEST_BUILD_DIR "/data/test_data.mbo.dbn", 1024};
+  TradeColumns columns;
+  EXPECT_FALSE(target.NextChunk(&columns));
+  EXPECT_EQ(columns.Size(), 0);
+}
+
+TEST(DbnColumnarReaderTests, TestZeroChunkSize) {
+  EXPECT_THROW(DbnColumnarReader(ILogReceiver::Default(),
+                                 TEST_BUILD_DIR "/data/test_data.mbo.dbn", 0),
+               InvalidArgumentError);
+}
+}  // namespace test
+}  // namespace databento
@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "databento/constants.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_csv_encoder.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/flag_set.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "databento/v1.hpp"
+#include "databento/with_ts_out.hpp"
+#include "dbn_test_file.hpp"
+#include "mock/mock_io.hpp"
+
+namespace databento {
+namespace test {
+namespace {
+constexpr auto kTradesHeader =
+    "ts_recv,ts_event,rtype,publisher_id,instrument_id,action,side,depth,"
+    "price,size,flags,ts_in_delta,sequence\n";
+
+std::string ToString(const mock::MockIo& io) {
+  const auto& contents = io.GetContents();
+  return {contents.cbegin(), contents.cend()};
+}
+}  // namespace
+
+TEST(DbnCsvEncoderTests, TestEncodeMbo) {
+  mock::MockIo io;
+  {
+    DbnCsvEncoder target{ILogReceiver::Default(), Schema::Mbo, &io};
+    target.EncodeRecord(GenMbo());
+  }
+  EXPECT_EQ(ToString(io),
+            "ts_recv,ts_event,rtype,publisher_id,instrument_id,action,side,"
+            "price,size,channel_id,order_id,flags,ts_in_delta,sequence\n"
+            "1704067200123456789,1704067200000000000,160,1,5482,A,A,"
+            "-1500000000,10,3,7,128,-25,42\n");
+}
+
+TEST(DbnCsvEncoderTests, TestEncodePretty) {
+  mock::MockIo io;
+  {
+    DbnCsvEncoder target{ILogReceiver::Default(), Schema::Mbo, &io, true,
+                         true};
+    target.EncodeRecord(GenMbo());
+    auto undef = GenMbo();
+    undef.price = kUndefPrice;
+    undef.ts_recv = UnixNanos{std::chrono::nanoseconds{kUndefTimestamp}};
+    target.EncodeRecord(undef);
+  }
+  const auto output = ToString(io);
+  const auto first_line_end = output.find('\n');
+  EXPECT_EQ(output.substr(first_line_end + 1),
+            "2024-01-01T00:00:00.123456789Z,2024-01-01T00:00:00.000000000Z,"
+            "160,1,5482,A,A,-1.500000000,10,3,7,128,-25,42\n"
+            ",2024-01-01T00:00:00.000000000Z,160,1,5482,A,A,,10,3,7,128,-25,"
+            "42\n");
+}
+
+TEST(DbnCsvEncoderTests, TestMbp10Header) {
+  mock::MockIo io;
+  { DbnCsvEncoder target{ILogReceiver::Default(), Schema::Mbp10, &io}; }
+  const auto output = ToString(io);
+  EXPECT_NE(output.find(",sequence,bid_px_00,ask_px_00,bid_sz_00,"),
+            output.npos);
+  EXPECT_NE(output.find(",bid_ct_09,ask_ct_09\n"), output.npos);
+}
+
+TEST(DbnCsvEncoderTests, TestSkipsOtherRecordTypes) {
+  mock::MockIo io;
+  {
+    DbnCsvEncoder target{ILogReceiver::Default(), Schema::Trades, &io};
+    target.EncodeRecord(GenMbo());
+  }
+  EXPECT_EQ(ToString(io), kTradesHeader);
+}
+
+TEST(DbnCsvEncoderTests, TestParallelMatchesSerial) {
+  std::vector<TradeMsg> trades;
+  for (std::uint32_t i = 0; i < 10000; ++i) {
+    trades.emplace_back(GenTrade(i));
+  }
+  std::vector<Record> records;
+  for (auto& trade : trades) {
+    records.emplace_back(&trade.hd);
+  }
+  mock::MockIo serial_io;
+  mock::MockIo parallel_io;
+  {
+    DbnCsvEncoder serial{ILogReceiver::Default(), Schema::Trades, &serial_io,
+                         true, true};
+    DbnCsvEncoder parallel{ILogReceiver::Default(), Schema::Trades,
+                           &parallel_io, true, true};
+    serial.EncodeRecords(records);
+    parallel.EncodeRecords(records, 4);
+    // Reuses the thread blocks
+    serial.EncodeRecords(records);
+    parallel.EncodeRecords(records, 3);
+    EXPECT_THROW(parallel.EncodeRecords(records, 0), InvalidArgumentError);
+  }
+  const auto output = ToString(serial_io);
+  EXPECT_EQ(output, ToString(parallel_io));
+  EXPECT_EQ(output.find(kTradesHeader), 0);
+  EXPECT_NE(output.find("\n2024-01-01T00:00:00.000009999Z,"
+                        "2024-01-01T00:00:00.000009999Z,0,2,3,T,A,0,"
+                        "102.000000000,10000,0,9999,9999\n"),
+            output.npos);
+}
+
+TEST(DbnCsvEncoderTests, TestEncodeDefinition) {
+  InstrumentDefMsg def{};
+  def.hd = RecordHeader{
+      sizeof(InstrumentDefMsg) / RecordHeader::kLengthMultiplier,
+      RType::InstrumentDef, 1, 5482,
+      UnixNanos{std::chrono::nanoseconds{1704067200000000000}}};
+  def.ts_recv = UnixNanos{std::chrono::nanoseconds{1704067200123456789}};
+  def.min_price_increment = kFixedPriceScale / 4;
+  def.expiration = UnixNanos{std::chrono::nanoseconds{kUndefTimestamp}};
+  def.raw_symbol = {'E', 'S', 'M', '4'};
+  def.group = {'E', 'S', ',', '"', 'Q', '"'};
+  def.security_update_action = SecurityUpdateAction::Add;
+  def.instrument_class = InstrumentClass::Future;
+  def.user_defined_instrument = UserDefinedInstrument::No;
+  def.tick_rule = 3;
+  mock::MockIo io;
+  {
+    DbnCsvEncoder target{ILogReceiver::Default(), Schema::Definition, &io,
+                         true, true};
+    target.EncodeRecord(def);
+    // Other DBN versions are skipped
+    v1::InstrumentDefMsg def_v1{};
+    def_v1.hd = RecordHeader{
+        sizeof(v1::InstrumentDefMsg) / RecordHeader::kLengthMultiplier,
+        RType::InstrumentDef, 0, 0, UnixNanos{}};
+    target.EncodeRecord(def_v1);
+  }
+  const auto output = ToString(io);
+  const auto first_line_end = output.find('\n');
+  const auto header = output.substr(0, first_line_end);
+  EXPECT_EQ(header.find("ts_recv,ts_event,rtype,publisher_id,instrument_id,"
+                        "raw_symbol,security_update_action,instrument_class,"
+                        "min_price_increment,"),
+            0);
+  const auto line = output.substr(first_line_end + 1);
+  EXPECT_EQ(line.find("2024-01-01T00:00:00.123456789Z,"
+                      "2024-01-01T00:00:00.000000000Z,19,1,5482,ESM4,A,F,"
+                      "0.250000000,0.000000000,,"),
+            0);
+  EXPECT_NE(line.find(",,,,\"ES,\"\"Q\"\"\",,,,,,,,"), line.npos);
+  EXPECT_EQ(line.substr(line.size() - 9), ",N,0,0,3\n");
+  EXPECT_EQ(line.find('\n'), line.size() - 1);
+}
+
+TEST(DbnCsvEncoderTests, TestEncodeTsOut) {
+  const WithTsOut<MboMsg> rec{
+      GenMbo(), UnixNanos{std::chrono::nanoseconds{1704067200200000000}}};
+  auto metadata = GenTestMetadata("GLBX.MDP3", Schema::Mbo, {}, {}, {});
+  metadata.ts_out = true;
+  mock::MockIo io;
+  {
+    DbnCsvEncoder target{ILogReceiver::Default(), metadata, &io, false,
+                         false};
+    target.EncodeRecord(rec);
+    // Records without a `ts_out` leave it empty
+    target.EncodeRecord(GenMbo());
+  }
+  EXPECT_EQ(ToString(io),
+            "ts_recv,ts_event,rtype,publisher_id,instrument_id,action,side,"
+            "price,size,channel_id,order_id,flags,ts_in_delta,sequence,"
+            "ts_out\n"
+            "1704067200123456789,1704067200000000000,160,1,5482,A,A,"
+            "-1500000000,10,3,7,128,-25,42,1704067200200000000\n"
+            "1704067200123456789,1704067200000000000,160,1,5482,A,A,"
+            "-1500000000,10,3,7,128,-25,42,\n");
+
+  mock::MockIo no_ts_out_io;
+  DbnCsvEncoder no_ts_out{ILogReceiver::Default(), Schema::Mbo,
+                          &no_ts_out_io};
+  EXPECT_THROW(no_ts_out.EncodeRecord(rec), InvalidArgumentError);
+}
+
+TEST(DbnCsvEncoderTests, TestUnsupportedSchema) {
+  mock::MockIo io;
+  EXPECT_THROW(
+      DbnCsvEncoder(ILogReceiver::Default(), static_cast<Schema>(13), &io),
+      InvalidArgumentError);
+  auto metadata = GenTestMetadata("GLBX.MDP3", Schema::Mbo, {}, {}, {});
+  metadata.has_mixed_schema = true;
+  EXPECT_THROW(
+      DbnCsvEncoder(ILogReceiver::Default(), metadata, &io, false, false),
+      InvalidArgumentError);
+}
+}  // namespace test
+}  // namespace databento
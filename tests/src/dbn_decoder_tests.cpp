@@ -1,6 +1,7 @@
 #include <date/date.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>  // equal
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
@@ -18,6 +19,7 @@
 #include "databento/dbn.hpp"
 #include "databento/dbn_decoder.hpp"
 #include "databento/dbn_encoder.hpp"
+#include "databento/dbn_file_store.hpp"
 #include "databento/detail/scoped_thread.hpp"
 #include "databento/detail/shared_channel.hpp"
 #include "databento/detail/zstd_stream.hpp"
@@ -28,8 +30,12 @@
 #include "databento/iwritable.hpp"
 #include "databento/log.hpp"
 #include "databento/record.hpp"
+#include "databento/record_filter.hpp"
+#include "databento/timeseries.hpp"
 #include "databento/with_ts_out.hpp"
+#include "dbn_test_file.hpp"
 #include "mock/mock_io.hpp"
+#include "temp_file.hpp"
 
 namespace databento {
 namespace test {
@@ -213,6 +219,58 @@ TEST_F(DbnDecoderTests, TestUpgradeMbp1WithTsOut) {
   ASSERT_EQ(&orig, &upgraded);
 }
 
+TEST_F(DbnDecoderTests, TestMappedEncodedFileDecodesInPlace) {
+  const TempFile temp_file{testing::TempDir() + "/TestMappedEncodedFile.dbn"};
+  constexpr std::uint32_t kRecordCount = 10;
+  // A single symbol makes the unpadded metadata length a multiple of 8 plus 7
+  const auto metadata = GenTestMetadata(
+      dataset::kGlbxMdp3, Schema::Trades, UnixNanos{},
+      UnixNanos{std::chrono::nanoseconds{kRecordCount}}, {"ESH1"});
+  WriteGenDbnTestFile(
+      temp_file.Path(), metadata, kRecordCount,
+      [](std::uint32_t idx) { return GenTrade(idx); }, {});
+  std::unique_ptr<MappedFileStream> file_stream{
+      new MappedFileStream{temp_file.Path()}};
+  const auto* mapping_begin = file_stream->Peek();
+  const auto* mapping_end = mapping_begin + file_stream->Size();
+  DbnDecoder target{logger_.get(),
+                    std::unique_ptr<IReadable>{std::move(file_stream)}};
+  EXPECT_EQ(target.DecodeMetadata(), metadata);
+  std::uint32_t record_count{};
+  while (const auto* record = target.DecodeRecord()) {
+    const auto* bytes =
+        reinterpret_cast<const std::uint8_t*>(&record->Header());
+    EXPECT_GE(bytes, mapping_begin);
+    EXPECT_LE(bytes + record->Size(), mapping_end);
+    EXPECT_EQ(record->Get<TradeMsg>().sequence, record_count);
+    ++record_count;
+  }
+  EXPECT_EQ(record_count, kRecordCount);
+}
+
+TEST_F(DbnDecoderTests, TestSmallBufferWrapsAround) {
+  const TempFile temp_file{testing::TempDir() + "/TestSmallBufferWraps.dbn"};
+  // Many pages of records whose size doesn't divide the page size, so the
+  // records fill the buffer several times and some straddle its end
+  constexpr std::uint32_t kRecordCount = 10000;
+  static_assert(4096 % sizeof(TradeMsg) != 0,
+                "Records must not evenly divide a page");
+  WriteTradesTestFile(temp_file.Path(), kRecordCount);
+  DbnDecoderOptions options;
+  options.buffer_size = 1020;
+  DbnDecoder target{
+      logger_.get(),
+      std::unique_ptr<IReadable>{new InFileStream{temp_file.Path()}}, options};
+  target.DecodeMetadata();
+  std::uint32_t idx{};
+  while (const auto* record = target.DecodeRecord()) {
+    ASSERT_TRUE(record->Holds<TradeMsg>());
+    EXPECT_EQ(record->Get<TradeMsg>(), GenTrade(idx));
+    ++idx;
+  }
+  EXPECT_EQ(idx, kRecordCount);
+}
+
 class DbnDecoderSchemaTests
     : public DbnDecoderTests,
       public testing::WithParamInterface<std::pair<const char*, std::uint8_t>> {
@@ -1260,6 +1318,333 @@ TEST_P(DbnIdentityTests, TestIdentity) {
   ASSERT_EQ(file_decoder.DecodeRecord(), nullptr);
 }
 
+TEST_P(DbnIdentityTests, TestMappedFileMatchesBuffered) {
+  const auto version = std::get<0>(GetParam());
+  const auto schema = std::get<1>(GetParam());
+  const auto compression = std::get<2>(GetParam());
+  const auto file_name =
+      std::string{TEST_BUILD_DIR "/data/test_data."} + ToString(schema) +
+      (version == 1 ? ".v1" : "") +
+      (compression == Compression::Zstd ? ".dbn.zst" : ".dbn");
+  DbnDecoder file_decoder{
+      logger_.get(), std::unique_ptr<IReadable>{new InFileStream{file_name}},
+      VersionUpgradePolicy::UpgradeToV2};
+  DbnDecoder mapped_decoder{
+      logger_.get(),
+      std::unique_ptr<IReadable>{new MappedFileStream{file_name}},
+      VersionUpgradePolicy::UpgradeToV2};
+  EXPECT_EQ(file_decoder.DecodeMetadata(), mapped_decoder.DecodeMetadata());
+  while (auto* file_record = file_decoder.DecodeRecord()) {
+    auto* mapped_record = mapped_decoder.DecodeRecord();
+    ASSERT_NE(mapped_record, nullptr);
+    ASSERT_EQ(file_record->Size(), mapped_record->Size());
+    const auto* file_bytes =
+        reinterpret_cast<const std::uint8_t*>(&file_record->Header());
+    const auto* mapped_bytes =
+        reinterpret_cast<const std::uint8_t*>(&mapped_record->Header());
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(mapped_bytes) %
+                  alignof(RecordHeader),
+              0);
+    EXPECT_TRUE(
+        std::equal(file_bytes, file_bytes + file_record->Size(), mapped_bytes));
+  }
+  ASSERT_EQ(mapped_decoder.DecodeRecord(), nullptr);
+}
+
+TEST_P(DbnIdentityTests, TestDecodeRecordsMatchesDecodeRecord) {
+  const auto version = std::get<0>(GetParam());
+  const auto schema = std::get<1>(GetParam());
+  const auto compression = std::get<2>(GetParam());
+  const auto file_name =
+      std::string{TEST_BUILD_DIR "/data/test_data."} + ToString(schema) +
+      (version == 1 ? ".v1" : "") +
+      (compression == Compression::Zstd ? ".dbn.zst" : ".dbn");
+  DbnDecoder record_decoder{
+      logger_.get(), std::unique_ptr<IReadable>{new InFileStream{file_name}},
+      VersionUpgradePolicy::UpgradeToV2};
+  DbnDecoder file_batch_decoder{
+      logger_.get(), std::unique_ptr<IReadable>{new InFileStream{file_name}},
+      VersionUpgradePolicy::UpgradeToV2};
+  DbnDecoder mapped_batch_decoder{
+      logger_.get(),
+      std::unique_ptr<IReadable>{new MappedFileStream{file_name}},
+      VersionUpgradePolicy::UpgradeToV2};
+  const auto metadata = record_decoder.DecodeMetadata();
+  EXPECT_EQ(file_batch_decoder.DecodeMetadata(), metadata);
+  EXPECT_EQ(mapped_batch_decoder.DecodeMetadata(), metadata);
+  EXPECT_TRUE(file_batch_decoder.DecodeRecords(0).empty());
+  for (auto* batch_decoder : {&file_batch_decoder, &mapped_batch_decoder}) {
+    DbnDecoder expected_decoder{
+        logger_.get(), std::unique_ptr<IReadable>{new InFileStream{file_name}},
+        VersionUpgradePolicy::UpgradeToV2};
+    expected_decoder.DecodeMetadata();
+    while (true) {
+      const auto& batch = batch_decoder->DecodeRecords(3);
+      ASSERT_LE(batch.size(), 3U);
+      if (batch.empty()) {
+        break;
+      }
+      for (const auto& rec : batch) {
+        const auto* expected_rec = expected_decoder.DecodeRecord();
+        ASSERT_NE(expected_rec, nullptr);
+        ASSERT_EQ(rec.Size(), expected_rec->Size());
+        const auto* expected_bytes =
+            reinterpret_cast<const std::uint8_t*>(&expected_rec->Header());
+        const auto* bytes =
+            reinterpret_cast<const std::uint8_t*>(&rec.Header());
+        EXPECT_EQ(
+            reinterpret_cast<std::uintptr_t>(bytes) % alignof(RecordHeader),
+            0);
+        EXPECT_TRUE(std::equal(expected_bytes,
+                               expected_bytes + expected_rec->Size(), bytes));
+      }
+    }
+    ASSERT_EQ(expected_decoder.DecodeRecord(), nullptr);
+  }
+  // Mixing single and batch decoding
+  while (record_decoder.DecodeRecord() != nullptr) {
+  }
+  EXPECT_TRUE(record_decoder.DecodeRecords(10).empty());
+}
+
+TEST_P(DbnIdentityTests, TestSmallBufferMatchesDefault) {
+  const auto version = std::get<0>(GetParam());
+  const auto schema = std::get<1>(GetParam());
+  const auto compression = std::get<2>(GetParam());
+  const auto file_name =
+      std::string{TEST_BUILD_DIR "/data/test_data."} + ToString(schema) +
+      (version == 1 ? ".v1" : "") +
+      (compression == Compression::Zstd ? ".dbn.zst" : ".dbn");
+  DbnDecoder default_decoder{
+      logger_.get(), std::unique_ptr<IReadable>{new InFileStream{file_name}},
+      VersionUpgradePolicy::UpgradeToV2};
+  // Rounded up to a page, which is larger than these files. See
+  // `TestSmallBufferWrapsAround` for records straddling the end of the buffer.
+  DbnDecoderOptions options;
+  options.buffer_size = 1020;
+  DbnDecoder small_decoder{
+      logger_.get(), std::unique_ptr<IReadable>{new InFileStream{file_name}},
+      options};
+  EXPECT_EQ(default_decoder.DecodeMetadata(), small_decoder.DecodeMetadata());
+  while (auto* default_record = default_decoder.DecodeRecord()) {
+    auto* small_record = small_decoder.DecodeRecord();
+    ASSERT_NE(small_record, nullptr);
+    ASSERT_EQ(default_record->Size(), small_record->Size());
+    const auto* default_bytes =
+        reinterpret_cast<const std::uint8_t*>(&default_record->Header());
+    const auto* small_bytes =
+        reinterpret_cast<const std::uint8_t*>(&small_record->Header());
+    EXPECT_TRUE(std::equal(default_bytes,
+                           default_bytes + default_record->Size(),
+                           small_bytes));
+  }
+  ASSERT_EQ(small_decoder.DecodeRecord(), nullptr);
+}
+
+TEST_P(DbnIdentityTests, TestPrefetchMatchesDefault) {
+  const auto version = std::get<0>(GetParam());
+  const auto schema = std::get<1>(GetParam());
+  const auto compression = std::get<2>(GetParam());
+  const auto file_name =
+      std::string{TEST_BUILD_DIR "/data/test_data."} + ToString(schema) +
+      (version == 1 ? ".v1" : "") +
+      (compression == Compression::Zstd ? ".dbn.zst" : ".dbn");
+  DbnDecoder default_decoder{
+      logger_.get(), std::unique_ptr<IReadable>{new InFileStream{file_name}},
+      VersionUpgradePolicy::UpgradeToV2};
+  DbnFileStoreOptions options;
+  options.buffer_size = 1024;
+  options.prefetch_block_count = 2;
+  DbnFileStore prefetch_store{logger_.get(), file_name, options};
+  EXPECT_EQ(default_decoder.DecodeMetadata(), prefetch_store.GetMetadata());
+  while (auto* default_record = default_decoder.DecodeRecord()) {
+    auto* prefetch_record = prefetch_store.NextRecord();
+    ASSERT_NE(prefetch_record, nullptr);
+    ASSERT_EQ(default_record->Size(), prefetch_record->Size());
+    const auto* default_bytes =
+        reinterpret_cast<const std::uint8_t*>(&default_record->Header());
+    const auto* prefetch_bytes =
+        reinterpret_cast<const std::uint8_t*>(&prefetch_record->Header());
+    EXPECT_TRUE(std::equal(default_bytes,
+                           default_bytes + default_record->Size(),
+                           prefetch_bytes));
+  }
+  ASSERT_EQ(prefetch_store.NextRecord(), nullptr);
+}
+
+TEST_P(DbnIdentityTests, TestBatchReplayMatchesReplay) {
+  const auto version = std::get<0>(GetParam());
+  const auto schema = std::get<1>(GetParam());
+  const auto compression = std::get<2>(GetParam());
+  const auto file_name =
+      std::string{TEST_BUILD_DIR "/data/test_data."} + ToString(schema) +
+      (version == 1 ? ".v1" : "") +
+      (compression == Compression::Zstd ? ".dbn.zst" : ".dbn");
+  std::vector<std::vector<std::uint8_t>> expected;
+  DbnFileStore{logger_.get(), file_name, VersionUpgradePolicy::UpgradeToV2}
+      .Replay([&expected](const Record& rec) {
+        const auto* bytes = reinterpret_cast<const std::uint8_t*>(&rec.Header());
+        expected.emplace_back(bytes, bytes + rec.Size());
+        return KeepGoing::Continue;
+      });
+  std::vector<std::vector<std::uint8_t>> res;
+  DbnFileStore{logger_.get(), file_name, VersionUpgradePolicy::UpgradeToV2}
+      .Replay([&res](const std::vector<Record>& records) {
+        EXPECT_FALSE(records.empty());
+        for (const auto& rec : records) {
+          const auto* bytes =
+              reinterpret_cast<const std::uint8_t*>(&rec.Header());
+          res.emplace_back(bytes, bytes + rec.Size());
+        }
+        return KeepGoing::Continue;
+      });
+  EXPECT_EQ(res, expected);
+}
+
+TEST_P(DbnIdentityTests, TestFilterMatchesManualFilter) {
+  const auto version = std::get<0>(GetParam());
+  const auto schema = std::get<1>(GetParam());
+  const auto compression = std::get<2>(GetParam());
+  const auto file_name =
+      std::string{TEST_BUILD_DIR "/data/test_data."} + ToString(schema) +
+      (version == 1 ? ".v1" : "") +
+      (compression == Compression::Zstd ? ".dbn.zst" : ".dbn");
+  using Key = std::tuple<RType, std::uint32_t, UnixNanos>;
+  const auto to_key = [](const Record& rec) {
+    return Key{rec.RType(), rec.Header().instrument_id, rec.Header().ts_event};
+  };
+  std::vector<Key> all_keys;
+  {
+    DbnDecoder decoder{logger_.get(),
+                       std::unique_ptr<IReadable>{new InFileStream{file_name}},
+                       VersionUpgradePolicy::UpgradeToV2};
+    decoder.DecodeMetadata();
+    while (const auto* rec = decoder.DecodeRecord()) {
+      all_keys.emplace_back(to_key(*rec));
+    }
+  }
+  if (all_keys.size() < 2) {
+    return;
+  }
+  const auto& target_key = all_keys[all_keys.size() / 2];
+  const RecordFilter filter{{std::get<0>(target_key)},
+                            {std::get<1>(target_key), 0},
+                            std::get<2>(all_keys[1]),
+                            std::get<2>(all_keys.back())};
+  std::vector<Key> expected;
+  for (const auto& key : all_keys) {
+    if (std::get<0>(key) == std::get<0>(target_key) &&
+        (std::get<1>(key) == std::get<1>(target_key) ||
+         std::get<1>(key) == 0) &&
+        std::get<2>(key) >= std::get<2>(all_keys[1]) &&
+        std::get<2>(key) < std::get<2>(all_keys.back())) {
+      expected.emplace_back(key);
+    }
+  }
+
+  DbnDecoder record_decoder{
+      logger_.get(), std::unique_ptr<IReadable>{new InFileStream{file_name}},
+      VersionUpgradePolicy::UpgradeToV2};
+  record_decoder.DecodeMetadata();
+  record_decoder.SetFilter(filter);
+  std::vector<Key> res;
+  while (const auto* rec = record_decoder.DecodeRecord()) {
+    res.emplace_back(to_key(*rec));
+  }
+  EXPECT_EQ(res, expected);
+
+  DbnDecoderOptions options;
+  options.buffer_size = 1020;
+  DbnDecoder file_batch_decoder{
+      logger_.get(), std::unique_ptr<IReadable>{new InFileStream{file_name}},
+      options};
+  DbnDecoder mapped_batch_decoder{
+      logger_.get(),
+      std::unique_ptr<IReadable>{new MappedFileStream{file_name}},
+      VersionUpgradePolicy::UpgradeToV2};
+  for (auto* batch_decoder : {&file_batch_decoder, &mapped_batch_decoder}) {
+    batch_decoder->DecodeMetadata();
+    batch_decoder->SetFilter(filter);
+    res.clear();
+    while (true) {
+      const auto& batch = batch_decoder->DecodeRecords(2);
+      if (batch.empty()) {
+        break;
+      }
+      for (const auto& rec : batch) {
+        res.emplace_back(to_key(rec));
+      }
+    }
+    EXPECT_EQ(res, expected);
+  }
+}
+
+TEST_F(DbnDecoderTests, TestBufferSizeTooSmall) {
+  const auto file_path = TEST_BUILD_DIR "/data/test_data.mbo.dbn";
+  ASSERT_THROW(
+      DbnDecoder(logger_.get(),
+                 std::unique_ptr<IReadable>{new InFileStream{file_path}},
+                 DbnDecoderOptions{VersionUpgradePolicy::UpgradeToV2, 512, 0,
+                                   nullptr}),
+      InvalidArgumentError);
+}
+
+TEST_F(DbnDecoderTests, TestSkipTo) {
+  const auto file_path = TEST_BUILD_DIR "/data/test_data.mbo.dbn.zst";
+  std::vector<std::uint64_t> offsets;
+  std::vector<MboMsg> expected;
+  DbnDecoder all{logger_.get(),
+                 std::unique_ptr<IReadable>{new InFileStream{file_path}}};
+  all.DecodeMetadata();
+  while (true) {
+    offsets.emplace_back(all.NextRecordOffset());
+    const auto* rec = all.DecodeRecord();
+    if (rec == nullptr) {
+      break;
+    }
+    expected.emplace_back(rec->Get<MboMsg>());
+  }
+  ASSERT_GE(expected.size(), 2);
+
+  DbnDecoder target{logger_.get(),
+                    std::unique_ptr<IReadable>{new InFileStream{file_path}}};
+  target.DecodeMetadata();
+  target.SkipTo(offsets[1]);
+  EXPECT_EQ(target.NextRecordOffset(), offsets[1]);
+  const auto* rec = target.DecodeRecord();
+  ASSERT_NE(rec, nullptr);
+  EXPECT_EQ(rec->Get<MboMsg>(), expected[1]);
+  EXPECT_THROW(target.SkipTo(offsets[0]), InvalidArgumentError);
+  target.SkipTo(offsets.back());
+  EXPECT_EQ(target.DecodeRecord(), nullptr);
+}
+
+TEST_F(DbnDecoderTests, TestTypedReplay) {
+  const auto file_path = TEST_BUILD_DIR "/data/test_data.mbo.dbn.zst";
+  std::vector<MboMsg> expected;
+  DbnFileStore{file_path}.Replay([&expected](const Record& rec) {
+    expected.emplace_back(rec.Get<MboMsg>());
+    return KeepGoing::Continue;
+  });
+  ASSERT_FALSE(expected.empty());
+  std::vector<MboMsg> mbo_records;
+  DbnFileStore{file_path}.Replay<MboMsg>([&mbo_records](const MboMsg& mbo) {
+    mbo_records.emplace_back(mbo);
+    return KeepGoing::Continue;
+  });
+  EXPECT_EQ(mbo_records, expected);
+  std::size_t trade_count{};
+  bool has_metadata{};
+  DbnFileStore{file_path}.Replay<TradeMsg>(
+      [&has_metadata](Metadata&&) { has_metadata = true; },
+      [&trade_count](const TradeMsg&) {
+        ++trade_count;
+        return KeepGoing::Continue;
+      });
+  EXPECT_TRUE(has_metadata);
+  EXPECT_EQ(trade_count, 0);
+}
+
 TEST_F(DbnDecoderTests, TestDbnIdentityWithTsOut) {}
 }  // namespace test
 }  // namespace databento
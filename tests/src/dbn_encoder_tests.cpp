@@ -9,7 +9,10 @@
 #include "databento/dbn.hpp"
 #include "databento/dbn_decoder.hpp"
 #include "databento/dbn_encoder.hpp"
+#include "databento/file_stream.hpp"
 #include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "databento/zstd_compress_options.hpp"
 #include "mock/mock_io.hpp"
 
 namespace databento {
@@ -44,5 +47,32 @@ TEST(DbnEncoderTests, TestEncodeDecodeMetadataIdentity) {
   const auto res = decoder.DecodeMetadata();
   ASSERT_EQ(res, metadata);
 }
+
+TEST(DbnEncoderTests, TestEncodeCompressed) {
+  const std::string file_path = TEST_BUILD_DIR "/data/test_data.mbo.dbn";
+  mock::MockIo io{};
+  {
+    DbnDecoder decoder{ILogReceiver::Default(), InFileStream{file_path}};
+    ZstdCompressOptions compression;
+    compression.level = 9;
+    compression.worker_count = 2;
+    compression.enable_long_distance_matching = true;
+    DbnEncoder target{decoder.DecodeMetadata(), &io, compression};
+    while (const auto* rec = decoder.DecodeRecord()) {
+      target.EncodeRecord(*rec);
+    }
+  }
+  DbnDecoder expected{ILogReceiver::Default(), InFileStream{file_path}};
+  DbnDecoder decoder{ILogReceiver::Default(), std::unique_ptr<IReadable>(
+                                                  new mock::MockIo{
+                                                      std::move(io)})};
+  EXPECT_EQ(decoder.DecodeMetadata(), expected.DecodeMetadata());
+  while (const auto* expected_rec = expected.DecodeRecord()) {
+    const auto* rec = decoder.DecodeRecord();
+    ASSERT_NE(rec, nullptr);
+    EXPECT_EQ(rec->Get<MboMsg>(), expected_rec->Get<MboMsg>());
+  }
+  EXPECT_EQ(decoder.DecodeRecord(), nullptr);
+}
 }  // namespace test
 }  // namespace databento
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "databento/constants.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn_json_encoder.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/flag_set.hpp"
+#include "databento/record.hpp"
+#include "databento/v1.hpp"
+#include "databento/v3.hpp"
+#include "databento/with_ts_out.hpp"
+#include "dbn_test_file.hpp"
+
+namespace databento {
+namespace test {
+class DbnJsonEncoderTests : public testing::Test {
+ protected:
+  template <typename R>
+  std::string Encode(const DbnJsonEncoder& target, const R& rec) {
+    const auto size = target.EncodeRecord(rec, buffer_.data(), buffer_.size());
+    return {buffer_.data(), size};
+  }
+
+  std::array<char, kMaxJsonLineLen> buffer_{};
+};
+
+TEST_F(DbnJsonEncoderTests, TestEncodeMbo) {
+  const DbnJsonEncoder target;
+  EXPECT_EQ(Encode(target, GenMbo()),
+            R"({"ts_recv":"1704067200123456789","hd":{"ts_event":)"
+            R"("1704067200000000000","rtype":160,"publisher_id":1,)"
+            R"("instrument_id":5482},"action":"A","side":"A","price":)"
+            R"("-1500000000","size":10,"channel_id":3,"order_id":"7",)"
+            R"("flags":128,"ts_in_delta":-25,"sequence":42})"
+            "\n");
+}
+
+TEST_F(DbnJsonEncoderTests, TestEncodePretty) {
+  const DbnJsonEncoder target{true, true};
+  auto mbo = GenMbo();
+  EXPECT_EQ(Encode(target, mbo),
+            R"({"ts_recv":"2024-01-01T00:00:00.123456789Z","hd":{"ts_event":)"
+            R"("2024-01-01T00:00:00.000000000Z","rtype":160,"publisher_id":1,)"
+            R"("instrument_id":5482},"action":"A","side":"A","price":)"
+            R"("-1.500000000","size":10,"channel_id":3,"order_id":"7",)"
+            R"("flags":128,"ts_in_delta":-25,"sequence":42})"
+            "\n");
+  mbo.price = kUndefPrice;
+  mbo.ts_recv = UnixNanos{std::chrono::nanoseconds{kUndefTimestamp}};
+  const auto json = Encode(target, mbo);
+  EXPECT_NE(json.find(R"("ts_recv":null,)"), json.npos);
+  EXPECT_NE(json.find(R"("price":null,)"), json.npos);
+}
+
+TEST_F(DbnJsonEncoderTests, TestEncodeLevels) {
+  Mbp10Msg mbp10{};
+  mbp10.hd = RecordHeader{sizeof(Mbp10Msg) / RecordHeader::kLengthMultiplier,
+                          RType::Mbp10, 1, 2, UnixNanos{}};
+  for (std::size_t i = 0; i < mbp10.levels.size(); ++i) {
+    mbp10.levels[i].bid_px = static_cast<std::int64_t>(i);
+  }
+  const DbnJsonEncoder target;
+  const auto json = Encode(target, mbp10);
+  EXPECT_NE(json.find(R"("levels":[{"bid_px":"0","ask_px":"0","bid_sz":0,)"),
+            json.npos);
+  EXPECT_NE(json.find(R"(},{"bid_px":"9",)"), json.npos);
+  EXPECT_EQ(json.substr(json.size() - 4), "}]}\n");
+}
+
+TEST_F(DbnJsonEncoderTests, TestEscapesStrings) {
+  ErrorMsg error{};
+  error.hd = RecordHeader{sizeof(ErrorMsg) / RecordHeader::kLengthMultiplier,
+                          RType::Error, 0, 0, UnixNanos{}};
+  const std::string err = "Bad \"symbol\"\\\n";
+  err.copy(error.err.data(), err.size());
+  error.code = 3;
+  error.is_last = 1;
+  const DbnJsonEncoder target;
+  EXPECT_EQ(Encode(target, error),
+            R"({"hd":{"ts_event":"0","rtype":21,"publisher_id":0,)"
+            R"("instrument_id":0},"err":"Bad \"symbol\"\\\u000a","code":3,)"
+            R"("is_last":1})"
+            "\n");
+}
+
+TEST_F(DbnJsonEncoderTests, TestEncodeDefinition) {
+  InstrumentDefMsg def{};
+  def.hd = RecordHeader{
+      sizeof(InstrumentDefMsg) / RecordHeader::kLengthMultiplier,
+      RType::InstrumentDef, 1, 5482, UnixNanos{}};
+  def.min_price_increment = kFixedPriceScale / 4;
+  def.raw_symbol = {'E', 'S', 'M', '4'};
+  def.security_update_action = SecurityUpdateAction::Add;
+  def.instrument_class = InstrumentClass::Future;
+  def.tick_rule = 3;
+  const DbnJsonEncoder target{true, false};
+  const auto json = Encode(target, def);
+  EXPECT_EQ(json.find(R"({"ts_recv":"0","hd":{"ts_event":"0","rtype":19,)"
+                      R"("publisher_id":1,"instrument_id":5482},)"
+                      R"("raw_symbol":"ESM4","security_update_action":"A",)"
+                      R"("instrument_class":"F","min_price_increment":)"
+                      R"("0.250000000",)"),
+            0);
+  EXPECT_NE(json.find(R"(,"currency":"",)"), json.npos);
+  EXPECT_EQ(json.substr(json.size() - 15), R"("tick_rule":3})"
+                                           "\n");
+
+  // Upgraded to the current version
+  v1::InstrumentDefMsg def_v1{};
+  def_v1.hd = RecordHeader{
+      sizeof(v1::InstrumentDefMsg) / RecordHeader::kLengthMultiplier,
+      RType::InstrumentDef, 1, 5482, UnixNanos{}};
+  EXPECT_EQ(Encode(target, def_v1), Encode(target, def_v1.ToV2()));
+}
+
+TEST_F(DbnJsonEncoderTests, TestEncodeTsOut) {
+  const WithTsOut<MboMsg> rec{GenMbo(),
+                              UnixNanos{std::chrono::nanoseconds{1234}}};
+  const DbnJsonEncoder target;
+  const auto json = Encode(target, rec);
+  EXPECT_EQ(json.substr(json.size() - 31),
+            R"("sequence":42,"ts_out":"1234"})"
+            "\n");
+  // Only written for `Record`s if enabled
+  const Record record{const_cast<RecordHeader*>(&rec.rec.hd)};
+  EXPECT_EQ(Encode(target, record), Encode(target, GenMbo()));
+  const DbnJsonEncoder ts_out_target{false, false, true};
+  EXPECT_EQ(Encode(ts_out_target, record), json);
+  EXPECT_EQ(Encode(ts_out_target, GenMbo()), Encode(target, GenMbo()));
+}
+
+TEST_F(DbnJsonEncoderTests, TestUnsupportedRecord) {
+  v3::InstrumentDefMsg def{};
+  def.hd = RecordHeader{
+      sizeof(v3::InstrumentDefMsg) / RecordHeader::kLengthMultiplier,
+      RType::InstrumentDef, 0, 0, UnixNanos{}};
+  const DbnJsonEncoder target;
+  EXPECT_THROW(Encode(target, def), InvalidArgumentError);
+}
+
+TEST_F(DbnJsonEncoderTests, TestBufferTooSmall) {
+  const DbnJsonEncoder target;
+  EXPECT_THROW(target.EncodeRecord(GenMbo(), buffer_.data(), 100),
+               InvalidArgumentError);
+}
+}  // namespace test
+}  // namespace databento
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>  // equal, min
+#include <cstddef>
+#include <cstdint>
+#include <fstream>   // ifstream
+#include <iterator>  // istreambuf_iterator
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "databento/dbn_decoder.hpp"
+#include "databento/dbn_stream_decoder.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/file_stream.hpp"
+#include "databento/ireadable.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+
+namespace databento {
+namespace test {
+namespace {
+std::string FileName(std::uint8_t version, Schema schema,
+                     Compression compression) {
+  return std::string{TEST_BUILD_DIR "/data/test_data."} + ToString(schema) +
+         (version == 1 ? ".v1" : "") +
+         (compression == Compression::Zstd ? ".dbn.zst" : ".dbn");
+}
+
+std::vector<std::uint8_t> ReadBytes(const std::string& file_name) {
+  std::ifstream input{file_name, std::ios::binary};
+  return {std::istreambuf_iterator<char>{input},
+          std::istreambuf_iterator<char>{}};
+}
+
+void ExpectRecordEq(const Record& rec, const Record& expected_rec) {
+  ASSERT_EQ(rec.Size(), expected_rec.Size());
+  const auto* expected_bytes =
+      reinterpret_cast<const std::uint8_t*>(&expected_rec.Header());
+  const auto* bytes = reinterpret_cast<const std::uint8_t*>(&rec.Header());
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(bytes) % alignof(RecordHeader),
+            0);
+  EXPECT_TRUE(
+      std::equal(expected_bytes, expected_bytes + expected_rec.Size(), bytes));
+}
+}  // namespace
+
+class DbnStreamDecoderIdentityTests
+    : public testing::TestWithParam<
+          std::tuple<std::uint8_t, Schema, Compression, std::size_t>> {
+ protected:
+  std::unique_ptr<ILogReceiver> logger_{new NullLogReceiver};
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    TestFiles, DbnStreamDecoderIdentityTests,
+    testing::Combine(testing::Values(1, 2),
+                     testing::Values(Schema::Mbo, Schema::Mbp10,
+                                     Schema::Definition, Schema::Statistics),
+                     testing::Values(Compression::None, Compression::Zstd),
+                     // Chunk sizes smaller than the prelude, a record, and
+                     // larger than the whole file
+                     testing::Values(1, 7, 100, 4096, 1 << 20)),
+    [](const testing::TestParamInfo<
+        std::tuple<std::uint8_t, Schema, Compression, std::size_t>>&
+           test_info) {
+      std::string schema_str = ToString(std::get<1>(test_info.param));
+      for (auto& c : schema_str) {
+        if (c == '-') {
+          c = '_';
+        }
+      }
+      return schema_str + "_" + ToString(std::get<2>(test_info.param)) +
+             "_DBNv" + std::to_string(std::get<0>(test_info.param)) + "_" +
+             std::to_string(std::get<3>(test_info.param));
+    });
+
+TEST_P(DbnStreamDecoderIdentityTests, TestDecodeRecordMatchesDbnDecoder) {
+  const auto file_name = FileName(std::get<0>(GetParam()),
+                                  std::get<1>(GetParam()),
+                                  std::get<2>(GetParam()));
+  const auto chunk_size = std::get<3>(GetParam());
+  const auto bytes = ReadBytes(file_name);
+  ASSERT_FALSE(bytes.empty());
+  DbnDecoder expected_decoder{
+      logger_.get(), std::unique_ptr<IReadable>{new InFileStream{file_name}},
+      VersionUpgradePolicy::UpgradeToV2};
+  const auto expected_metadata = expected_decoder.DecodeMetadata();
+
+  DbnStreamDecoder target{logger_.get(), VersionUpgradePolicy::UpgradeToV2};
+  bool is_metadata_decoded{};
+  for (std::size_t pos = 0; pos < bytes.size(); pos += chunk_size) {
+    target.Feed(&bytes[pos], std::min(chunk_size, bytes.size() - pos));
+    if (!is_metadata_decoded) {
+      if (!target.HasMetadata()) {
+        continue;
+      }
+      EXPECT_EQ(target.DecodeMetadata(), expected_metadata);
+      is_metadata_decoded = true;
+    }
+    const Record* rec;
+    while ((rec = target.DecodeRecord()) != nullptr) {
+      const auto* expected_rec = expected_decoder.DecodeRecord();
+      ASSERT_NE(expected_rec, nullptr);
+      ExpectRecordEq(*rec, *expected_rec);
+    }
+  }
+  ASSERT_TRUE(is_metadata_decoded);
+  target.Finish();
+  EXPECT_EQ(expected_decoder.DecodeRecord(), nullptr);
+}
+
+TEST_P(DbnStreamDecoderIdentityTests, TestDecodeRecordsMatchesDbnDecoder) {
+  const auto file_name = FileName(std::get<0>(GetParam()),
+                                  std::get<1>(GetParam()),
+                                  std::get<2>(GetParam()));
+  const auto chunk_size = std::get<3>(GetParam());
+  const auto bytes = ReadBytes(file_name);
+  DbnDecoder expected_decoder{
+      logger_.get(), std::unique_ptr<IReadable>{new InFileStream{file_name}},
+      VersionUpgradePolicy::UpgradeToV2};
+  expected_decoder.DecodeMetadata();
+
+  DbnStreamDecoder target{logger_.get()};
+  bool is_metadata_decoded{};
+  for (std::size_t pos = 0; pos < bytes.size(); pos += chunk_size) {
+    target.Feed(&bytes[pos], std::min(chunk_size, bytes.size() - pos));
+    if (!is_metadata_decoded) {
+      if (!target.HasMetadata()) {
+        continue;
+      }
+      target.DecodeMetadata();
+      is_metadata_decoded = true;
+    }
+    while (true) {
+      const auto& batch = target.DecodeRecords(3);
+      ASSERT_LE(batch.size(), 3U);
+      if (batch.empty()) {
+        break;
+      }
+      for (const auto& rec : batch) {
+        const auto* expected_rec = expected_decoder.DecodeRecord();
+        ASSERT_NE(expected_rec, nullptr);
+        ExpectRecordEq(rec, *expected_rec);
+      }
+    }
+  }
+  target.Finish();
+  EXPECT_EQ(expected_decoder.DecodeRecord(), nullptr);
+}
+
+TEST(DbnStreamDecoderTests, TestFinishBeforeMetadata) {
+  const auto bytes = ReadBytes(FileName(2, Schema::Mbo, Compression::None));
+  DbnStreamDecoder target{ILogReceiver::Default()};
+  target.Feed(bytes.data(), 10);
+  EXPECT_FALSE(target.HasMetadata());
+  EXPECT_THROW(target.DecodeMetadata(), DbnResponseError);
+  EXPECT_THROW(target.Finish(), DbnResponseError);
+}
+
+TEST(DbnStreamDecoderTests, TestInvalidInput) {
+  const std::vector<std::uint8_t> bytes{'N', 'O', 'P', 'E', 0, 0, 0, 0};
+  DbnStreamDecoder target{ILogReceiver::Default()};
+  EXPECT_THROW(target.Feed(bytes.data(), bytes.size()), DbnResponseError);
+}
+}  // namespace test
+}  // namespace databento
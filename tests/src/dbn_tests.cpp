@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "databento/constants.hpp"
 #include "databento/datetime.hpp"
@@ -50,5 +54,53 @@ TEST(DbnTests, TestMetadataToString) {
     }
 })");
 }
+
+TEST(DbnTests, TestMetadataMerge) {
+  const auto make_metadata = [](std::int64_t start_s, std::int64_t end_s,
+                                std::vector<std::string> symbols,
+                                std::vector<std::string> not_found,
+                                std::vector<SymbolMapping> mappings) {
+    return Metadata{kDbnVersion,
+                    dataset::kGlbxMdp3,
+                    false,
+                    Schema::Trades,
+                    UnixNanos{std::chrono::seconds{start_s}},
+                    UnixNanos{std::chrono::seconds{end_s}},
+                    {},
+                    false,
+                    SType::RawSymbol,
+                    SType::InstrumentId,
+                    false,
+                    kSymbolCstrLen,
+                    std::move(symbols),
+                    {},
+                    std::move(not_found),
+                    std::move(mappings)};
+  };
+  const auto jun_1 = date::year{2022} / 6 / 1;
+  const auto jun_2 = date::year{2022} / 6 / 2;
+  const auto jun_3 = date::year{2022} / 6 / 3;
+  auto target = make_metadata(
+      100, 200, {"NGG3", "NGQ4", "NGZ9"}, {"NGQ4", "NGZ9"},
+      {{"NGG3", {{jun_1, jun_2, "3"}}}, {"NGQ4", {}}, {"NGZ9", {}}});
+  target.Merge(make_metadata(
+      200, 300, {"NGG3", "NGQ4", "NGZ9", "NGH5"}, {"NGZ9"},
+      {{"NGG3", {{jun_1, jun_2, "3"}, {jun_2, jun_3, "3"}}},
+       {"NGQ4", {{jun_2, jun_3, "4"}}},
+       {"NGH5", {{jun_2, jun_3, "5"}}}}));
+  EXPECT_EQ(target.start, UnixNanos{std::chrono::seconds{100}});
+  EXPECT_EQ(target.end, UnixNanos{std::chrono::seconds{300}});
+  EXPECT_EQ(target.symbols,
+            (std::vector<std::string>{"NGG3", "NGQ4", "NGZ9", "NGH5"}));
+  EXPECT_EQ(target.partial, std::vector<std::string>{"NGQ4"});
+  EXPECT_EQ(target.not_found, std::vector<std::string>{"NGZ9"});
+  ASSERT_EQ(target.mappings.size(), 4);
+  EXPECT_EQ(target.mappings[0],
+            (SymbolMapping{"NGG3", {{jun_1, jun_3, "3"}}}));
+  EXPECT_EQ(target.mappings[1],
+            (SymbolMapping{"NGQ4", {{jun_2, jun_3, "4"}}}));
+  EXPECT_EQ(target.mappings[3],
+            (SymbolMapping{"NGH5", {{jun_2, jun_3, "5"}}}));
+}
 }  // namespace test
 }  // namespace databento
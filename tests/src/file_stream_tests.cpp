@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>  // any_of, equal
 #include <cstdint>
 
 #include "databento/exceptions.hpp"
@@ -33,6 +34,52 @@ TEST(InFileStreamTests, TestReadSomeLessThanMax) {
                           [](std::uint8_t byte) { return byte != 0; }));
 }
 
+TEST(MappedFileStreamTests, TestReadExactInsufficient) {
+  const std::string file_path =
+      TEST_BUILD_DIR "/data/test_data.ohlcv-1d.v1.dbn";
+  MappedFileStream target{file_path};
+  std::vector<std::uint8_t> buffer(1024);  // File is less than 1KiB
+  try {
+    target.ReadExact(buffer.data(), buffer.size());
+    FAIL() << "Expected throw";
+  } catch (const databento::Exception& exc) {
+    ASSERT_STREQ(exc.what(),
+                 "Unexpected end of file, expected 1024 bytes, got 206");
+  }
+}
+
+TEST(MappedFileStreamTests, TestPeekMatchesInFileStream) {
+  const std::string file_path =
+      TEST_BUILD_DIR "/data/test_data.ohlcv-1d.v1.dbn";
+  MappedFileStream target{file_path};
+  InFileStream input{file_path};
+  std::vector<std::uint8_t> buffer(1024);
+  const auto read_size = input.ReadSome(buffer.data(), buffer.size());
+  ASSERT_EQ(target.Size(), read_size);
+  ASSERT_EQ(target.RemainingSize(), read_size);
+  EXPECT_TRUE(std::equal(buffer.cbegin(), buffer.cbegin() + read_size,
+                         target.Peek()));
+  target.Consume(8);
+  EXPECT_EQ(target.RemainingSize(), read_size - 8);
+  std::vector<std::uint8_t> rest(read_size - 8);
+  target.ReadExact(rest.data(), rest.size());
+  EXPECT_TRUE(std::equal(rest.cbegin(), rest.cend(), buffer.cbegin() + 8));
+  EXPECT_EQ(target.ReadSome(buffer.data(), buffer.size()), 0);
+}
+
+TEST(MappedFileStreamTests, TestEmptyFile) {
+  TempFile temp_file{"empty"};
+  { OutFileStream out{temp_file.Path()}; }
+  MappedFileStream target{temp_file.Path()};
+  EXPECT_EQ(target.Size(), 0);
+  std::uint8_t byte{};
+  EXPECT_EQ(target.ReadSome(&byte, 1), 0);
+}
+
+TEST(MappedFileStreamTests, TestNonExistentFile) {
+  ASSERT_THROW(MappedFileStream{"not-a-file"}, InvalidArgumentError);
+}
+
 TEST(OutFileStreamTests, TestWriteAllCanBeRead) {
   constexpr auto data = "abcdefgh";
   TempFile temp_file{"out"};
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+#include "databento/constants.hpp"
+#include "databento/fixed_price.hpp"
+
+namespace databento {
+namespace test {
+namespace {
+std::string FormatPx(std::int64_t px) {
+  std::array<char, kMaxFixPxLen> buf{};
+  const auto res = ToChars(buf.data(), buf.data() + buf.size(), FixPx{px});
+  EXPECT_EQ(res.ec, std::errc{});
+  return {buf.data(), res.ptr};
+}
+}  // namespace
+
+TEST(FixedPriceTests, TestToChars) {
+  EXPECT_EQ(FormatPx(0), "0.000000000");
+  EXPECT_EQ(FormatPx(1), "0.000000001");
+  EXPECT_EQ(FormatPx(123456789012), "123.456789012");
+  EXPECT_EQ(FormatPx(-1500000000), "-1.500000000");
+  EXPECT_EQ(FormatPx(std::numeric_limits<std::int64_t>::max() - 1),
+            "9223372036.854775806");
+  EXPECT_EQ(FormatPx(std::numeric_limits<std::int64_t>::min()),
+            "-9223372036.854775808");
+  EXPECT_EQ(FormatPx(kUndefPrice), "kUndefPrice");
+}
+
+TEST(FixedPriceTests, TestToCharsTooSmall) {
+  std::array<char, 11> buf{};
+  EXPECT_EQ(
+      ToChars(buf.data(), buf.data() + buf.size(), FixPx{15000000000}).ec,
+      std::errc::value_too_large);
+  // Fits exactly
+  const auto res =
+      ToChars(buf.data(), buf.data() + buf.size(), FixPx{1500000000});
+  ASSERT_EQ(res.ec, std::errc{});
+  EXPECT_EQ(std::string(buf.data(), res.ptr), "1.500000000");
+}
+
+TEST(FixedPriceTests, TestMatchesStreamOp) {
+  std::ostringstream ss;
+  ss << FixPx{-42000000001};
+  EXPECT_EQ(ss.str(), "-42.000000001");
+  EXPECT_EQ(PxToString(-42000000001), ss.str());
+}
+}  // namespace test
+}  // namespace databento
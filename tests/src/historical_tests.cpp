@@ -5,22 +5,29 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <cstdlib>
+#include <map>
 #include <stdexcept>  // logic_error
-#include <utility>    // move
+#include <string>
+#include <utility>  // move
+#include <vector>
 
 #include "databento/constants.hpp"
 #include "databento/datetime.hpp"
 #include "databento/dbn.hpp"
+#include "databento/dbn_encoder.hpp"
 #include "databento/dbn_file_store.hpp"
 #include "databento/enums.hpp"
 #include "databento/exceptions.hpp"  // Exception
+#include "databento/file_stream.hpp"
 #include "databento/historical.hpp"
 #include "databento/log.hpp"
 #include "databento/metadata.hpp"
 #include "databento/record.hpp"
 #include "databento/symbology.hpp"  // kAllSymbols
 #include "databento/timeseries.hpp"
+#include "databento/timeseries_cache.hpp"
 #include "mock/mock_http_server.hpp"
 #include "temp_file.hpp"
 
@@ -41,6 +48,55 @@ constexpr auto kApiKey = "HIST_SECRET";
 
 class HistoricalTests : public ::testing::Test {
  protected:
+  // Writes trades with the given `ts_recv` offsets from `kSliceStart` to a DBN
+  // file, like the response to one slice of a parallel request or one shard of
+  // a sharded request
+  static void WriteSlice(const std::string& file_path, std::int64_t start,
+                         std::int64_t end,
+                         const std::vector<std::int64_t>& ts_offsets,
+                         const std::string& symbol = "ESH1",
+                         std::uint32_t instrument_id = 5482) {
+    const Metadata metadata{
+        kDbnVersion,
+        dataset::kGlbxMdp3,
+        false,
+        Schema::Trades,
+        UnixNanos{std::chrono::nanoseconds{kSliceStart + start}},
+        UnixNanos{std::chrono::nanoseconds{kSliceStart + end}},
+        {},
+        false,
+        SType::RawSymbol,
+        SType::InstrumentId,
+        false,
+        kSymbolCstrLen,
+        {symbol},
+        {},
+        {},
+        {{symbol,
+          {{date::year{2020} / 12 / 28, date::year{2020} / 12 / 29,
+            std::to_string(instrument_id)}}}}};
+    OutFileStream file{file_path};
+    DbnEncoder encoder{metadata, &file};
+    for (const auto ts_offset : ts_offsets) {
+      const UnixNanos ts{std::chrono::nanoseconds{kSliceStart + ts_offset}};
+      TradeMsg trade{
+          RecordHeader{sizeof(TradeMsg) / RecordHeader::kLengthMultiplier,
+                       RType::Mbp0, 1, instrument_id, ts},
+          100 * kFixedPriceScale,
+          1,
+          Action::Trade,
+          Side::Bid,
+          {},
+          0,
+          ts,
+          {},
+          static_cast<std::uint32_t>(ts_offset)};
+      encoder.EncodeRecord(Record{&trade.hd});
+    }
+  }
+
+  static constexpr std::int64_t kSliceStart = 1609160400000000000;
+
   mock::MockHttpServer mock_server_{kApiKey};
   std::unique_ptr<ILogReceiver> logger_{new NullLogReceiver};
 };
@@ -670,6 +726,59 @@ TEST_F(HistoricalTests, TestTimeseriesGetRange_NoMetadataCallback) {
   EXPECT_EQ(mbo_records.size(), 2);
 }
 
+TEST_F(HistoricalTests, TestTimeseriesGetRange_Typed) {
+  mock_server_.MockStreamDbn("/v0/timeseries.get_range",
+                             {{"dataset", dataset::kGlbxMdp3},
+                              {"start", "2022-10-21T13:30"},
+                              {"end", "2022-10-21T20:00"},
+                              {"symbols", "CYZ2"},
+                              {"schema", "tbbo"},
+                              {"encoding", "dbn"},
+                              {"stype_in", "raw_symbol"},
+                              {"stype_out", "instrument_id"}},
+                             TEST_BUILD_DIR "/data/test_data.tbbo.dbn.zst");
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target{logger_.get(), kApiKey, "localhost",
+                               static_cast<std::uint16_t>(port)};
+  std::vector<TbboMsg> tbbo_records;
+  target.TimeseriesGetRange<TbboMsg>(
+      dataset::kGlbxMdp3, {"2022-10-21T13:30", "2022-10-21T20:00"}, {"CYZ2"},
+      Schema::Tbbo, [&tbbo_records](const TbboMsg& tbbo) {
+        tbbo_records.emplace_back(tbbo);
+        return KeepGoing::Continue;
+      });
+  EXPECT_EQ(tbbo_records.size(), 2);
+}
+
+TEST_F(HistoricalTests, TestTimeseriesGetRange_Batches) {
+  mock_server_.MockStreamDbn("/v0/timeseries.get_range",
+                             {{"dataset", dataset::kGlbxMdp3},
+                              {"start", "2022-10-21T13:30"},
+                              {"end", "2022-10-21T20:00"},
+                              {"symbols", "CYZ2"},
+                              {"schema", "tbbo"},
+                              {"encoding", "dbn"},
+                              {"stype_in", "raw_symbol"},
+                              {"stype_out", "instrument_id"}},
+                             TEST_BUILD_DIR "/data/test_data.tbbo.dbn.zst");
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target{logger_.get(), kApiKey, "localhost",
+                               static_cast<std::uint16_t>(port)};
+  std::vector<TbboMsg> tbbo_records;
+  target.TimeseriesGetRange(
+      dataset::kGlbxMdp3, {"2022-10-21T13:30", "2022-10-21T20:00"}, {"CYZ2"},
+      Schema::Tbbo, [&tbbo_records](const std::vector<Record>& records) {
+        EXPECT_FALSE(records.empty());
+        for (const auto& record : records) {
+          tbbo_records.emplace_back(record.Get<TbboMsg>());
+        }
+        return KeepGoing::Continue;
+      });
+  EXPECT_EQ(tbbo_records.size(), 2);
+}
+
 // should get helpful message if there's a problem with the request
 TEST_F(HistoricalTests, TestTimeseriesGetRange_BadRequest) {
   const nlohmann::json resp{
@@ -771,6 +880,378 @@ TEST_F(HistoricalTests, TestTimeseriesGetRangeToFile) {
   ASSERT_EQ(counter, 2);
 }
 
+TEST_F(HistoricalTests, TestTimeseriesGetRangeToFileCompressLocally) {
+  mock_server_.MockStreamDbn("/v0/timeseries.get_range",
+                             {{"dataset", dataset::kGlbxMdp3},
+                              {"symbols", "CYZ2"},
+                              {"schema", "tbbo"},
+                              {"encoding", "dbn"},
+                              {"compression", "none"}},
+                             TEST_BUILD_DIR "/data/test_data.tbbo.dbn");
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target{logger_.get(), kApiKey, "localhost",
+                               static_cast<std::uint16_t>(port)};
+  const TempFile temp_file{testing::TempDir() +
+                           "/TestTimeseriesGetRangeToFileCompressLocally"};
+  ZstdCompressOptions compression;
+  compression.level = 3;
+  compression.worker_count = 2;
+  compression.enable_long_distance_matching = true;
+  DbnFileStore bento = target.TimeseriesGetRangeToFile(
+      dataset::kGlbxMdp3, {"2022-10-21T13:30", "2022-10-21T20:00"}, {"CYZ2"},
+      Schema::Tbbo, SType::RawSymbol, SType::InstrumentId, {},
+      temp_file.Path(), compression);
+  std::size_t counter{};
+  bento.Replay([&counter](const Record&) {
+    ++counter;
+    return KeepGoing::Continue;
+  });
+  ASSERT_EQ(counter, 2);
+}
+
+TEST_F(HistoricalTests, TestTimeseriesGetRangeParallel_EqualTime) {
+  const TempFile slice0{testing::TempDir() + "/TestParallelEqualTime0.dbn"};
+  const TempFile slice1{testing::TempDir() + "/TestParallelEqualTime1.dbn"};
+  const TempFile slice2{testing::TempDir() + "/TestParallelEqualTime2.dbn"};
+  WriteSlice(slice0.Path(), 0, 1000, {0, 500, 999});
+  WriteSlice(slice1.Path(), 1000, 2000, {1000, 1500});
+  WriteSlice(slice2.Path(), 2000, 3000, {2000, 2999});
+  mock_server_.MockStreamDbnByParam(
+      "/v0/timeseries.get_range", "start",
+      {{std::to_string(kSliceStart), slice0.Path()},
+       {std::to_string(kSliceStart + 1000), slice1.Path()},
+       {std::to_string(kSliceStart + 2000), slice2.Path()}});
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target{logger_.get(), kApiKey, "localhost",
+                               static_cast<std::uint16_t>(port)};
+  TimeseriesParallelOptions options;
+  options.slice_count = 3;
+  std::unique_ptr<Metadata> metadata_ptr;
+  std::vector<std::uint32_t> sequences;
+  target.TimeseriesGetRangeParallel(
+      dataset::kGlbxMdp3,
+      {UnixNanos{std::chrono::nanoseconds{kSliceStart}},
+       UnixNanos{std::chrono::nanoseconds{kSliceStart + 3000}}},
+      {"ESH1"}, Schema::Trades, SType::RawSymbol, SType::InstrumentId, options,
+      [&metadata_ptr](Metadata&& metadata) {
+        EXPECT_EQ(metadata_ptr, nullptr);
+        metadata_ptr.reset(new Metadata(std::move(metadata)));
+      },
+      [&metadata_ptr, &sequences](const Record& record) {
+        EXPECT_NE(metadata_ptr, nullptr);
+        sequences.emplace_back(record.Get<TradeMsg>().sequence);
+        return KeepGoing::Continue;
+      });
+  ASSERT_NE(metadata_ptr, nullptr);
+  EXPECT_EQ(metadata_ptr->start,
+            UnixNanos{std::chrono::nanoseconds{kSliceStart}});
+  EXPECT_EQ(metadata_ptr->end,
+            UnixNanos{std::chrono::nanoseconds{kSliceStart + 3000}});
+  EXPECT_EQ(metadata_ptr->symbols, std::vector<std::string>{"ESH1"});
+  ASSERT_EQ(metadata_ptr->mappings.size(), 1);
+  EXPECT_EQ(metadata_ptr->mappings[0].intervals.size(), 1);
+  EXPECT_EQ(sequences, (std::vector<std::uint32_t>{0, 500, 999, 1000, 1500,
+                                                   2000, 2999}));
+}
+
+TEST_F(HistoricalTests, TestTimeseriesGetRangeParallel_RecordCount) {
+  const TempFile slice0{testing::TempDir() + "/TestParallelRecordCount0.dbn"};
+  const TempFile slice1{testing::TempDir() + "/TestParallelRecordCount1.dbn"};
+  WriteSlice(slice0.Path(), 0, 750, {0, 100});
+  WriteSlice(slice1.Path(), 750, 3000, {750, 2000});
+  // Most records are in the first quarter, so it's a slice of its own
+  const std::map<std::string, std::uint64_t> counts{
+      {std::to_string(kSliceStart), 6},
+      {std::to_string(kSliceStart + 750), 1},
+      {std::to_string(kSliceStart + 1500), 1},
+      {std::to_string(kSliceStart + 2250), 0}};
+  mock_server_.MockPostJson(
+      "/v0/metadata.get_record_count",
+      [counts](const httplib::Params& params) -> nlohmann::json {
+        return counts.at(params.find("start")->second);
+      });
+  mock_server_.MockStreamDbnByParam(
+      "/v0/timeseries.get_range", "start",
+      {{std::to_string(kSliceStart), slice0.Path()},
+       {std::to_string(kSliceStart + 750), slice1.Path()}});
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target{logger_.get(), kApiKey, "localhost",
+                               static_cast<std::uint16_t>(port)};
+  TimeseriesParallelOptions options;
+  options.slice_count = 2;
+  options.sizing = SliceSizing::RecordCount;
+  options.probes_per_slice = 2;
+  std::vector<std::uint32_t> sequences;
+  target.TimeseriesGetRangeParallel(
+      dataset::kGlbxMdp3,
+      {UnixNanos{std::chrono::nanoseconds{kSliceStart}},
+       UnixNanos{std::chrono::nanoseconds{kSliceStart + 3000}}},
+      {"ESH1"}, Schema::Trades, SType::RawSymbol, SType::InstrumentId, options,
+      {}, [&sequences](const Record& record) {
+        sequences.emplace_back(record.Get<TradeMsg>().sequence);
+        return KeepGoing::Continue;
+      });
+  EXPECT_EQ(sequences, (std::vector<std::uint32_t>{0, 100, 750, 2000}));
+}
+
+TEST_F(HistoricalTests, TestTimeseriesGetRangeParallel_Stop) {
+  const TempFile slice0{testing::TempDir() + "/TestParallelStop0.dbn"};
+  const TempFile slice1{testing::TempDir() + "/TestParallelStop1.dbn"};
+  WriteSlice(slice0.Path(), 0, 1000, {0, 500});
+  WriteSlice(slice1.Path(), 1000, 2000, {1000, 1500});
+  mock_server_.MockStreamDbnByParam(
+      "/v0/timeseries.get_range", "start",
+      {{std::to_string(kSliceStart), slice0.Path()},
+       {std::to_string(kSliceStart + 1000), slice1.Path()}});
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target{logger_.get(), kApiKey, "localhost",
+                               static_cast<std::uint16_t>(port)};
+  TimeseriesParallelOptions options;
+  options.slice_count = 2;
+  std::uint32_t call_count{};
+  target.TimeseriesGetRangeParallel(
+      dataset::kGlbxMdp3,
+      {UnixNanos{std::chrono::nanoseconds{kSliceStart}},
+       UnixNanos{std::chrono::nanoseconds{kSliceStart + 2000}}},
+      {"ESH1"}, Schema::Trades, SType::RawSymbol, SType::InstrumentId, options,
+      {}, [&call_count](const Record&) {
+        ++call_count;
+        return call_count == 3 ? KeepGoing::Stop : KeepGoing::Continue;
+      });
+  EXPECT_EQ(call_count, 3);
+}
+
+TEST_F(HistoricalTests, TestTimeseriesGetRangeParallel_BadRequest) {
+  const nlohmann::json resp{{"detail", "Invalid symbol."}};
+  mock_server_.MockBadRequest("/v0/timeseries.get_range", resp);
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target{logger_.get(), kApiKey, "localhost",
+                               static_cast<std::uint16_t>(port)};
+  const auto parallel_get_range = [&target](UnixNanos end) {
+    target.TimeseriesGetRangeParallel(
+        dataset::kGlbxMdp3,
+        {UnixNanos{std::chrono::nanoseconds{kSliceStart}}, end}, {"ESH1"},
+        Schema::Trades, SType::RawSymbol, SType::InstrumentId, {}, {},
+        [](const Record&) { return KeepGoing::Continue; });
+  };
+  EXPECT_THROW(
+      parallel_get_range(UnixNanos{std::chrono::nanoseconds{kSliceStart + 10}}),
+      HttpResponseError);
+  // The end must be set to split the range
+  EXPECT_THROW(parallel_get_range(UnixNanos{}), InvalidArgumentError);
+}
+
+TEST_F(HistoricalTests, TestTimeseriesGetRangeParallel_StringRange) {
+  const TempFile slice0{testing::TempDir() + "/TestParallelStringRange0.dbn"};
+  const TempFile slice1{testing::TempDir() + "/TestParallelStringRange1.dbn"};
+  WriteSlice(slice0.Path(), 0, 1000, {0, 500});
+  WriteSlice(slice1.Path(), 1000, 2000, {1000, 1500});
+  mock_server_.MockStreamDbnByParam(
+      "/v0/timeseries.get_range", "start",
+      {{std::to_string(kSliceStart), slice0.Path()},
+       {std::to_string(kSliceStart + 1000), slice1.Path()}});
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target{logger_.get(), kApiKey, "localhost",
+                               static_cast<std::uint16_t>(port)};
+  TimeseriesParallelOptions options;
+  options.slice_count = 2;
+  std::vector<std::uint32_t> sequences;
+  target.TimeseriesGetRangeParallel(
+      dataset::kGlbxMdp3,
+      {std::to_string(kSliceStart), std::to_string(kSliceStart + 2000)},
+      {"ESH1"}, Schema::Trades, SType::RawSymbol, SType::InstrumentId, options,
+      {}, [&sequences](const Record& record) {
+        sequences.emplace_back(record.Get<TradeMsg>().sequence);
+        return KeepGoing::Continue;
+      });
+  EXPECT_EQ(sequences, (std::vector<std::uint32_t>{0, 500, 1000, 1500}));
+  // The range can only be sliced if its bounds are timestamps
+  EXPECT_THROW(
+      target.TimeseriesGetRangeParallel(
+          dataset::kGlbxMdp3, {"yesterday", "today"}, {"ESH1"},
+          Schema::Trades, SType::RawSymbol, SType::InstrumentId, options, {},
+          [](const Record&) { return KeepGoing::Continue; }),
+      InvalidArgumentError);
+}
+
+TEST_F(HistoricalTests, TestTimeseriesGetRangeSharded) {
+  const TempFile shard0{testing::TempDir() + "/TestSharded0.dbn"};
+  const TempFile shard1{testing::TempDir() + "/TestSharded1.dbn"};
+  WriteSlice(shard0.Path(), 0, 3000, {0, 1000, 1000, 2500}, "ESH1", 5482);
+  WriteSlice(shard1.Path(), 0, 3000, {500, 1000, 2999}, "NQH1", 7);
+  mock_server_.MockStreamDbnByParam(
+      "/v0/timeseries.get_range", "symbols",
+      {{"ESH1", shard0.Path()}, {"NQH1", shard1.Path()}});
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target{logger_.get(), kApiKey, "localhost",
+                               static_cast<std::uint16_t>(port)};
+  TimeseriesShardOptions options;
+  options.shard_count = 2;
+  std::unique_ptr<Metadata> metadata_ptr;
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> records;
+  target.TimeseriesGetRangeSharded(
+      dataset::kGlbxMdp3,
+      {UnixNanos{std::chrono::nanoseconds{kSliceStart}},
+       UnixNanos{std::chrono::nanoseconds{kSliceStart + 3000}}},
+      {"ESH1", "NQH1"}, Schema::Trades, SType::RawSymbol, SType::InstrumentId,
+      options,
+      [&metadata_ptr](Metadata&& metadata) {
+        EXPECT_EQ(metadata_ptr, nullptr);
+        metadata_ptr.reset(new Metadata(std::move(metadata)));
+      },
+      [&metadata_ptr, &records](const Record& record) {
+        EXPECT_NE(metadata_ptr, nullptr);
+        const auto& trade = record.Get<TradeMsg>();
+        records.emplace_back(trade.sequence, trade.hd.instrument_id);
+        return KeepGoing::Continue;
+      });
+  ASSERT_NE(metadata_ptr, nullptr);
+  EXPECT_EQ(metadata_ptr->symbols,
+            (std::vector<std::string>{"ESH1", "NQH1"}));
+  ASSERT_EQ(metadata_ptr->mappings.size(), 2);
+  EXPECT_EQ(metadata_ptr->mappings[0].raw_symbol, "ESH1");
+  EXPECT_EQ(metadata_ptr->mappings[1].raw_symbol, "NQH1");
+  // Ties are broken by shard
+  const std::vector<std::pair<std::uint32_t, std::uint32_t>> expected{
+      {0, 5482},    {500, 7},     {1000, 5482}, {1000, 5482},
+      {1000, 7},    {2500, 5482}, {2999, 7}};
+  EXPECT_EQ(records, expected);
+}
+
+TEST_F(HistoricalTests, TestTimeseriesGetRangeSharded_Stop) {
+  const TempFile shard0{testing::TempDir() + "/TestShardedStop0.dbn"};
+  const TempFile shard1{testing::TempDir() + "/TestShardedStop1.dbn"};
+  WriteSlice(shard0.Path(), 0, 2000, {0, 1000}, "ESH1", 5482);
+  WriteSlice(shard1.Path(), 0, 2000, {500, 1500}, "NQH1", 7);
+  mock_server_.MockStreamDbnByParam(
+      "/v0/timeseries.get_range", "symbols",
+      {{"ESH1", shard0.Path()}, {"NQH1", shard1.Path()}});
+  const auto port = mock_server_.ListenOnThread();
+
+  databento::Historical target{logger_.get(), kApiKey, "localhost",
+                               static_cast<std::uint16_t>(port)};
+  std::vector<std::uint32_t> sequences;
+  target.TimeseriesGetRangeSharded(
+      dataset::kGlbxMdp3,
+      {UnixNanos{std::chrono::nanoseconds{kSliceStart}},
+       UnixNanos{std::chrono::nanoseconds{kSliceStart + 2000}}},
+      {"ESH1", "NQH1"}, Schema::Trades, SType::RawSymbol, SType::InstrumentId,
+      {}, {}, [&sequences](const Record& record) {
+        sequences.emplace_back(record.Get<TradeMsg>().sequence);
+        return sequences.size() == 3 ? KeepGoing::Stop : KeepGoing::Continue;
+      });
+  EXPECT_EQ(sequences, (std::vector<std::uint32_t>{0, 500, 1000}));
+}
+
+TEST_F(HistoricalTests, TestTimeseriesGetRangeSharded_InvalidSymbols) {
+  databento::Historical target{logger_.get(), kApiKey,
+                               HistoricalGateway::Bo1};
+  const auto sharded_get_range = [&target](
+                                     const std::vector<std::string>& symbols,
+                                     std::size_t shard_count) {
+    TimeseriesShardOptions options;
+    options.shard_count = shard_count;
+    target.TimeseriesGetRangeSharded(
+        dataset::kGlbxMdp3, {"2022-10-21T13:30", "2022-10-21T20:00"}, symbols,
+        Schema::Trades, SType::RawSymbol, SType::InstrumentId, options, {},
+        [](const Record&) { return KeepGoing::Continue; });
+  };
+  EXPECT_THROW(sharded_get_range({}, 2), InvalidArgumentError);
+  EXPECT_THROW(sharded_get_range({"ESH1", "ALL_SYMBOLS"}, 2),
+               InvalidArgumentError);
+  EXPECT_THROW(sharded_get_range({"ESH1"}, 0), InvalidArgumentError);
+}
+
+TEST_F(HistoricalTests, TestTimeseriesGetRangeCached) {
+  const TempDirectory cache_dir{testing::TempDir() + "/TestCached"};
+  const TimeseriesCache cache{cache_dir.Path()};
+  // The end of the dataset's available range
+  static constexpr std::int64_t kAvailableEnd = 2600;
+  const nlohmann::json dataset_range{
+      {"start", ToIso8601(UnixNanos{std::chrono::nanoseconds{kSliceStart}})},
+      {"end", ToIso8601(UnixNanos{
+                  std::chrono::nanoseconds{kSliceStart + kAvailableEnd}})}};
+  const auto cached_get_range = [&cache, this](std::int64_t start,
+                                               std::int64_t end, int port) {
+    databento::Historical target{logger_.get(), kApiKey, "localhost",
+                                 static_cast<std::uint16_t>(port)};
+    std::unique_ptr<Metadata> metadata_ptr;
+    std::vector<std::uint32_t> sequences;
+    target.TimeseriesGetRangeCached(
+        cache, dataset::kGlbxMdp3,
+        {UnixNanos{std::chrono::nanoseconds{kSliceStart + start}},
+         UnixNanos{std::chrono::nanoseconds{kSliceStart + end}}},
+        {"ESH1"}, Schema::Trades, SType::RawSymbol, SType::InstrumentId,
+        [&metadata_ptr](Metadata&& metadata) {
+          metadata_ptr.reset(new Metadata(std::move(metadata)));
+        },
+        [&sequences](const Record& record) {
+          sequences.emplace_back(record.Get<TradeMsg>().sequence);
+          return KeepGoing::Continue;
+        });
+    EXPECT_NE(metadata_ptr, nullptr);
+    if (metadata_ptr) {
+      EXPECT_EQ(metadata_ptr->start,
+                UnixNanos{std::chrono::nanoseconds{kSliceStart + start}});
+      EXPECT_EQ(metadata_ptr->end,
+                UnixNanos{std::chrono::nanoseconds{
+                    kSliceStart + std::min(end, kAvailableEnd)}});
+    }
+    return sequences;
+  };
+
+  const TempFile slice0{testing::TempDir() + "/TestCached0.dbn"};
+  WriteSlice(slice0.Path(), 0, 2000, {0, 500, 1500});
+  mock_server_.MockGetJson("/v0/metadata.get_dataset_range",
+                           {{"dataset", dataset::kGlbxMdp3}}, dataset_range);
+  mock_server_.MockStreamDbnByParam("/v0/timeseries.get_range", "start",
+                                    {{std::to_string(kSliceStart),
+                                      slice0.Path()}});
+  const auto port = mock_server_.ListenOnThread();
+  EXPECT_EQ(cached_get_range(0, 2000, port),
+            (std::vector<std::uint32_t>{0, 500, 1500}));
+
+  // Only the uncached part of the range is requested
+  const TempFile slice1{testing::TempDir() + "/TestCached1.dbn"};
+  WriteSlice(slice1.Path(), 2000, 3000, {2000, 2500});
+  mock::MockHttpServer uncached_server{kApiKey};
+  uncached_server.MockGetJson("/v0/metadata.get_dataset_range",
+                              {{"dataset", dataset::kGlbxMdp3}},
+                              dataset_range);
+  uncached_server.MockStreamDbnByParam("/v0/timeseries.get_range", "start",
+                                       {{std::to_string(kSliceStart + 2000),
+                                         slice1.Path()}});
+  const auto uncached_port = uncached_server.ListenOnThread();
+  // The part after the available range isn't requested
+  EXPECT_EQ(cached_get_range(1000, 3000, uncached_port),
+            (std::vector<std::uint32_t>{1500, 2000, 2500}));
+  // Fully cached, so any request would fail
+  EXPECT_EQ(cached_get_range(400, 2600, uncached_port),
+            (std::vector<std::uint32_t>{500, 1500, 2000, 2500}));
+  // Nothing is available
+  EXPECT_THROW(cached_get_range(kAvailableEnd, 3000, uncached_port),
+               InvalidArgumentError);
+}
+
+TEST_F(HistoricalTests, TestTimeseriesGetRangeCached_NoEnd) {
+  const TimeseriesCache cache{testing::TempDir() + "/TestCachedNoEnd"};
+  databento::Historical target{logger_.get(), kApiKey, HistoricalGateway::Bo1};
+  EXPECT_THROW(target.TimeseriesGetRangeCached(
+                   cache, dataset::kGlbxMdp3,
+                   {UnixNanos{std::chrono::nanoseconds{kSliceStart}}, {}},
+                   {"ESH1"}, Schema::Trades, SType::RawSymbol,
+                   SType::InstrumentId, {},
+                   [](const Record&) { return KeepGoing::Continue; }),
+               InvalidArgumentError);
+}
+
 TEST(JsonImplementationTests,
      TestParsingNumberNotPreciselyRepresentableAsDouble) {
   auto const number_json = nlohmann::json::parse("1609160400000711344");
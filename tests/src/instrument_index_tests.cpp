@@ -0,0 +1,278 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "databento/constants.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/detail/zstd_stream.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/file_stream.hpp"
+#include "databento/instrument_index.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "databento/timeseries.hpp"
+#include "databento/ts_index.hpp"
+#include "dbn_test_file.hpp"
+#include "temp_file.hpp"
+
+namespace databento {
+namespace test {
+namespace {
+constexpr std::uint32_t kRecordCount = 10000;
+constexpr std::uint64_t kBlockSize = 4096;
+constexpr std::uint32_t kRareInstrumentId = 99;
+constexpr std::uint32_t kRareStart = 5000;
+constexpr std::uint32_t kRareEnd = 5100;
+
+// Most records cycle through five instruments, a contiguous run belongs to a
+// rarely-traded one
+std::uint32_t InstrumentIdForIdx(std::uint32_t idx) {
+  return idx >= kRareStart && idx < kRareEnd ? kRareInstrumentId : idx % 5;
+}
+
+UnixNanos TsForIdx(std::uint32_t idx) {
+  return UnixNanos{std::chrono::nanoseconds{1704067200000000000 + idx * 10}};
+}
+
+Metadata GenMetadata() {
+  return GenTestMetadata(dataset::kXnasItch, Schema::Trades, TsForIdx(0),
+                         TsForIdx(kRecordCount), {});
+}
+
+TradeMsg GenRecord(std::uint32_t idx) {
+  return GenTrade(idx, InstrumentIdForIdx(idx), TsForIdx(idx));
+}
+
+// `frame_size` of 0 writes an uncompressed file
+void WriteFile(const std::string& file_path, std::size_t frame_size,
+               TsIndex* ts_index, InstrumentIndex* instrument_index) {
+  auto options = FrameSizeTestFileOptions(frame_size);
+  options.ts_index = ts_index;
+  options.instrument_index = instrument_index;
+  WriteGenDbnTestFile(file_path, GenMetadata(), kRecordCount, GenRecord,
+                      options);
+}
+
+std::vector<std::uint32_t> CollectSequences(DbnFileStore* store) {
+  std::vector<std::uint32_t> res;
+  while (const auto* record = store->NextRecord()) {
+    res.emplace_back(record->Get<TradeMsg>().sequence);
+  }
+  return res;
+}
+
+std::vector<std::uint32_t> ExpectedSequences(
+    std::uint32_t start, const std::vector<std::uint32_t>& instrument_ids) {
+  std::vector<std::uint32_t> res;
+  for (std::uint32_t i = start; i < kRecordCount; ++i) {
+    for (const auto instrument_id : instrument_ids) {
+      if (InstrumentIdForIdx(i) == instrument_id) {
+        res.emplace_back(i);
+      }
+    }
+  }
+  return res;
+}
+
+void CheckSelectInstruments(const std::string& file_path,
+                            const DbnFileStoreOptions& options) {
+  {
+    DbnFileStore target{ILogReceiver::Default(), file_path, options};
+    target.SelectInstruments({kRareInstrumentId});
+    EXPECT_EQ(CollectSequences(&target),
+              ExpectedSequences(0, {kRareInstrumentId}));
+  }
+  {
+    DbnFileStore target{ILogReceiver::Default(), file_path, options};
+    target.SelectInstruments({kRareInstrumentId, 3, 404});
+    EXPECT_EQ(CollectSequences(&target),
+              ExpectedSequences(0, {3, kRareInstrumentId}));
+  }
+  {
+    DbnFileStore target{ILogReceiver::Default(), file_path, options};
+    target.SelectInstruments({kRareInstrumentId, 3, 404});
+    std::vector<std::uint32_t> res;
+    std::size_t batch_count{};
+    target.Replay([&res, &batch_count](const std::vector<Record>& records) {
+      EXPECT_FALSE(records.empty());
+      ++batch_count;
+      for (const auto& record : records) {
+        res.emplace_back(record.Get<TradeMsg>().sequence);
+      }
+      return KeepGoing::Continue;
+    });
+    EXPECT_EQ(res, ExpectedSequences(0, {3, kRareInstrumentId}));
+    // The selected records of each block are batched together
+    EXPECT_LT(batch_count, res.size() / 10);
+  }
+  {
+    DbnFileStore target{ILogReceiver::Default(), file_path, options};
+    target.SelectInstruments({404});
+    EXPECT_EQ(target.NextRecord(), nullptr);
+  }
+}
+}  // namespace
+
+TEST(InstrumentIndexTests, TestEncoderIndexMatchesBuild) {
+  const TempFile temp_file{TEST_BUILD_DIR "/instrument-index.dbn"};
+  InstrumentIndex index{kBlockSize};
+  WriteFile(temp_file.Path(), 0, nullptr, &index);
+  ASSERT_GT(index.Blocks().size(), 10);
+  EXPECT_EQ(index.PostingLists().size(), 6);
+  EXPECT_EQ(index.PostingLists().at(0).size(), index.Blocks().size());
+  EXPECT_LE(index.PostingLists().at(kRareInstrumentId).size(), 3);
+  const auto built = InstrumentIndex::Build(temp_file.Path(), kBlockSize);
+  EXPECT_EQ(built.BlockSize(), kBlockSize);
+  EXPECT_EQ(built.Blocks(), index.Blocks());
+  EXPECT_EQ(built.PostingLists(), index.PostingLists());
+}
+
+TEST(InstrumentIndexTests, TestWriteReadFileIdentity) {
+  const TempFile temp_file{TEST_BUILD_DIR "/instrument-index.dbn"};
+  const TempFile index_file{TEST_BUILD_DIR "/instrument-index.dbn.iidx"};
+  InstrumentIndex index{kBlockSize};
+  WriteFile(temp_file.Path(), 0, nullptr, &index);
+  index.WriteToFile(index_file.Path());
+  const auto res = InstrumentIndex::ReadFromFile(index_file.Path());
+  EXPECT_EQ(res.BlockSize(), index.BlockSize());
+  EXPECT_EQ(res.Blocks(), index.Blocks());
+  EXPECT_EQ(res.PostingLists(), index.PostingLists());
+  EXPECT_THROW(TsIndex::ReadFromFile(index_file.Path()), DbnResponseError);
+}
+
+TEST(InstrumentIndexTests, TestReadFromFileTruncated) {
+  const TempFile index_file{TEST_BUILD_DIR "/instrument-index.dbn.iidx"};
+  const auto write_index = [&index_file](std::uint64_t block_count,
+                                         std::uint32_t posting_list_size) {
+    OutFileStream output{index_file.Path()};
+    output.WriteAll(reinterpret_cast<const std::uint8_t*>("DBNIIX\x00\x01"),
+                    8);
+    const auto write = [&output](const auto& value) {
+      output.WriteAll(reinterpret_cast<const std::uint8_t*>(&value),
+                      sizeof(value));
+    };
+    write(kBlockSize);
+    write(block_count);
+    // A single block
+    write(std::uint64_t{0});
+    write(std::uint64_t{64});
+    // A single instrument
+    write(std::uint64_t{1});
+    write(std::uint32_t{5});
+    write(posting_list_size);
+    write(std::uint32_t{0});
+  };
+  write_index(1, 1);
+  EXPECT_EQ(InstrumentIndex::ReadFromFile(index_file.Path()).Blocks().size(),
+            1);
+  // Counts far larger than the file
+  write_index(std::uint64_t{1} << 60, 1);
+  EXPECT_THROW(InstrumentIndex::ReadFromFile(index_file.Path()),
+               DbnResponseError);
+  write_index(1, 1 << 30);
+  EXPECT_THROW(InstrumentIndex::ReadFromFile(index_file.Path()),
+               DbnResponseError);
+}
+
+TEST(InstrumentIndexTests, TestFindBlocks) {
+  InstrumentIndex target{kBlockSize};
+  EXPECT_TRUE(target.FindBlocks({1}).empty());
+  const TempFile temp_file{TEST_BUILD_DIR "/instrument-index.dbn"};
+  WriteFile(temp_file.Path(), 0, nullptr, &target);
+  const auto rare_blocks = target.FindBlocks({kRareInstrumentId, 404});
+  EXPECT_EQ(rare_blocks,
+            std::vector<std::size_t>(
+                target.PostingLists().at(kRareInstrumentId).cbegin(),
+                target.PostingLists().at(kRareInstrumentId).cend()));
+  EXPECT_EQ(target.FindBlocks({kRareInstrumentId, 1}).size(),
+            target.Blocks().size());
+}
+
+TEST(InstrumentIndexTests, TestSelectInstruments) {
+  const TempFile temp_file{TEST_BUILD_DIR "/instrument-index.dbn"};
+  InstrumentIndex index{kBlockSize};
+  WriteFile(temp_file.Path(), 0, nullptr, &index);
+  DbnFileStoreOptions store_options;
+  store_options.instrument_index = &index;
+  CheckSelectInstruments(temp_file.Path(), store_options);
+}
+
+TEST(InstrumentIndexTests, TestSelectInstrumentsSeekableZstd) {
+  const TempFile temp_file{TEST_BUILD_DIR "/instrument-index.dbn.zst"};
+  InstrumentIndex index{kBlockSize};
+  WriteFile(temp_file.Path(), 1 << 14, nullptr, &index);
+  DbnFileStoreOptions store_options;
+  store_options.instrument_index = &index;
+  CheckSelectInstruments(temp_file.Path(), store_options);
+}
+
+TEST(InstrumentIndexTests, TestSelectInstrumentsMapped) {
+  const TempFile temp_file{TEST_BUILD_DIR "/instrument-index.dbn"};
+  InstrumentIndex index{kBlockSize};
+  WriteFile(temp_file.Path(), 0, nullptr, &index);
+  DbnFileStoreOptions store_options;
+  store_options.buffer_size = 1024;
+  store_options.mapped = true;
+  store_options.instrument_index = &index;
+  CheckSelectInstruments(temp_file.Path(), store_options);
+}
+
+TEST(InstrumentIndexTests, TestSelectInstrumentsPrefetchParallel) {
+  const TempFile temp_file{TEST_BUILD_DIR "/instrument-index.dbn.zst"};
+  InstrumentIndex index{kBlockSize};
+  WriteFile(temp_file.Path(), 1 << 14, nullptr, &index);
+  DbnFileStoreOptions store_options;
+  store_options.prefetch_block_count = 2;
+  store_options.decompress_thread_count = 2;
+  store_options.instrument_index = &index;
+  CheckSelectInstruments(temp_file.Path(), store_options);
+}
+
+TEST(InstrumentIndexTests, TestSelectInstrumentsZstd) {
+  const TempFile temp_file{TEST_BUILD_DIR "/instrument-index.dbn.zst"};
+  InstrumentIndex index{kBlockSize};
+  // Without a seek table, selected blocks are reached by skipping forward
+  DbnTestFileOptions options;
+  options.compression = Compression::Zstd;
+  options.instrument_index = &index;
+  WriteGenDbnTestFile(temp_file.Path(), GenMetadata(), kRecordCount, GenRecord,
+                      options);
+  DbnFileStoreOptions store_options;
+  store_options.instrument_index = &index;
+  CheckSelectInstruments(temp_file.Path(), store_options);
+}
+
+TEST(InstrumentIndexTests, TestSelectInstrumentsWithSeekTo) {
+  const TempFile temp_file{TEST_BUILD_DIR "/instrument-index.dbn"};
+  TsIndex ts_index{kBlockSize};
+  InstrumentIndex instrument_index{kBlockSize};
+  WriteFile(temp_file.Path(), 0, &ts_index, &instrument_index);
+  DbnFileStoreOptions options;
+  options.ts_index = &ts_index;
+  options.instrument_index = &instrument_index;
+  DbnFileStore target{ILogReceiver::Default(), temp_file.Path(), options};
+  target.SelectInstruments({2, kRareInstrumentId});
+  target.SeekTo(TsForIdx(5050));
+  EXPECT_EQ(CollectSequences(&target),
+            ExpectedSequences(5050, {2, kRareInstrumentId}));
+  target.SeekTo(TsForIdx(7000));
+  target.SelectInstruments({});
+  EXPECT_EQ(CollectSequences(&target).size(), kRecordCount - 7000);
+}
+
+TEST(InstrumentIndexTests, TestSelectInstrumentsWithoutIndex) {
+  const TempFile temp_file{TEST_BUILD_DIR "/instrument-index.dbn"};
+  WriteFile(temp_file.Path(), 0, nullptr, nullptr);
+  DbnFileStore target{temp_file.Path()};
+  EXPECT_THROW(target.SelectInstruments({1}), Exception);
+}
+}  // namespace test
+}  // namespace databento
@@ -269,6 +269,36 @@ TEST_F(LiveBlockingTests, TestNextRecord) {
   }
 }
 
+TEST_F(LiveBlockingTests, TestNextRecords) {
+  constexpr auto kTsOut = false;
+  const auto kRecCount = 12;
+  constexpr OhlcvMsg kRec{DummyHeader<OhlcvMsg>(RType::Ohlcv1M), 1, 2, 3, 4, 5};
+  const mock::MockLsgServer mock_server{
+      dataset::kXnasItch, kTsOut, [kRec, kRecCount](mock::MockLsgServer& self) {
+        self.Accept();
+        self.Authenticate();
+        for (size_t i = 0; i < kRecCount; ++i) {
+          self.SendRecord(kRec);
+        }
+      }};
+
+  LiveBlocking target = builder_.SetDataset(dataset::kXnasItch)
+                            .SetSendTsOut(kTsOut)
+                            .SetAddress(kLocalhost, mock_server.Port())
+                            .BuildBlocking();
+  std::size_t count{};
+  while (count < kRecCount) {
+    const auto& records = target.NextRecords({});
+    ASSERT_FALSE(records.empty());
+    for (const auto& rec : records) {
+      ASSERT_TRUE(rec.Holds<OhlcvMsg>()) << "Failed on record " << count;
+      EXPECT_EQ(rec.Get<OhlcvMsg>(), kRec);
+      ++count;
+    }
+  }
+  EXPECT_EQ(count, kRecCount);
+}
+
 TEST_F(LiveBlockingTests, TestNextRecordTimeout) {
   constexpr std::chrono::milliseconds kTimeout{50};
   constexpr auto kTsOut = false;
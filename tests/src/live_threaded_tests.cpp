@@ -7,6 +7,7 @@
 #include <iostream>
 #include <memory>
 #include <thread>  // this_thread
+#include <vector>
 
 #include "databento/constants.hpp"
 #include "databento/datetime.hpp"
@@ -79,6 +80,89 @@ TEST_F(LiveThreadedTests, TestBasic) {
   target.BlockForStop();
 }
 
+TEST_F(LiveThreadedTests, TestTypedStart) {
+  const MboMsg kRec{DummyHeader<MboMsg>(RType::Mbo),
+                    1,
+                    2,
+                    3,
+                    {},
+                    4,
+                    Action::Add,
+                    Side::Bid,
+                    UnixNanos{},
+                    TimeDeltaNanos{},
+                    100};
+  const TradeMsg kTrade{DummyHeader<TradeMsg>(RType::Mbp0),
+                        1,
+                        2,
+                        Action::Trade,
+                        Side::Ask,
+                        {},
+                        0,
+                        UnixNanos{},
+                        TimeDeltaNanos{},
+                        3};
+  constexpr auto kHeartbeatInterval = std::chrono::seconds{5};
+  const mock::MockLsgServer mock_server{
+      dataset::kGlbxMdp3, kTsOut, kHeartbeatInterval,
+      [&kRec, &kTrade](mock::MockLsgServer& self) {
+        self.Accept();
+        self.Authenticate();
+        self.Start();
+        self.SendRecord(kTrade);
+        self.SendRecord(kRec);
+        self.SendRecord(kTrade);
+        self.SendRecord(kRec);
+      }};
+
+  LiveThreaded target = builder_.SetDataset(dataset::kGlbxMdp3)
+                            .SetSendTsOut(kTsOut)
+                            .SetHeartbeatInterval(kHeartbeatInterval)
+                            .SetAddress(kLocalhost, mock_server.Port())
+                            .BuildThreaded();
+  std::uint32_t call_count{};
+  target.Start<MboMsg>([&call_count, &kRec](const MboMsg& mbo) {
+    ++call_count;
+    EXPECT_EQ(mbo, kRec);
+    return call_count < 2 ? KeepGoing::Continue : KeepGoing::Stop;
+  });
+  target.BlockForStop();
+  EXPECT_EQ(call_count, 2);
+}
+
+TEST_F(LiveThreadedTests, TestBatchStart) {
+  constexpr auto kRecCount = 10;
+  constexpr OhlcvMsg kRec{DummyHeader<OhlcvMsg>(RType::Ohlcv1S), 1, 2, 3, 4, 5};
+  constexpr auto kHeartbeatInterval = std::chrono::seconds{5};
+  const mock::MockLsgServer mock_server{
+      dataset::kXnasItch, kTsOut, kHeartbeatInterval,
+      [&kRec](mock::MockLsgServer& self) {
+        self.Accept();
+        self.Authenticate();
+        self.Start();
+        for (std::size_t i = 0; i < kRecCount; ++i) {
+          self.SendRecord(kRec);
+        }
+      }};
+
+  LiveThreaded target = builder_.SetDataset(dataset::kXnasItch)
+                            .SetSendTsOut(kTsOut)
+                            .SetHeartbeatInterval(kHeartbeatInterval)
+                            .SetAddress(kLocalhost, mock_server.Port())
+                            .BuildThreaded();
+  std::size_t record_count{};
+  target.Start([&record_count, &kRec](const std::vector<Record>& records) {
+    EXPECT_FALSE(records.empty());
+    for (const auto& rec : records) {
+      EXPECT_EQ(rec.Get<OhlcvMsg>(), kRec);
+      ++record_count;
+    }
+    return record_count < kRecCount ? KeepGoing::Continue : KeepGoing::Stop;
+  });
+  target.BlockForStop();
+  EXPECT_EQ(record_count, kRecCount);
+}
+
 TEST_F(LiveThreadedTests, TestTimeoutRecovery) {
   const MboMsg kRec{DummyHeader<MboMsg>(RType::Mbo),
                     1,
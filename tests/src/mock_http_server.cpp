@@ -55,6 +55,22 @@ void MockHttpServer::MockGetJson(
   });
 }
 
+void MockHttpServer::MockPostJson(
+    const std::string& path,
+    const std::function<nlohmann::json(const httplib::Params&)>& make_json) {
+  server_.Post(path, [make_json](const httplib::Request& req,
+                                 httplib::Response& resp) {
+    if (!req.has_header("Authorization")) {
+      resp.status = 401;
+      return;
+    }
+    httplib::Params form_params;
+    httplib::detail::parse_query_text(req.body, form_params);
+    resp.set_content(make_json(form_params).dump(), "application/json");
+    resp.status = 200;
+  });
+}
+
 void MockHttpServer::MockPostJson(
     const std::string& path,
     const std::map<std::string, std::string>& form_params,
@@ -75,40 +91,70 @@ void MockHttpServer::MockPostJson(
 void MockHttpServer::MockStreamDbn(
     const std::string& path, const std::map<std::string, std::string>& params,
     const std::string& dbn_path) {
-  constexpr std::size_t kChunkSize = 32;
-
-  // Read contents into buffer
-  std::ifstream input_file{dbn_path, std::ios::binary | std::ios::ate};
-  const auto size = static_cast<std::size_t>(input_file.tellg());
-  input_file.seekg(0, std::ios::beg);
-  std::vector<char> buffer(size);
-  input_file.read(buffer.data(), static_cast<std::streamsize>(size));
-
-  // Serve
-  server_.Get(path, [buffer, kChunkSize, params](const httplib::Request& req,
-                                                 httplib::Response& resp) {
+  const auto buffer = ReadFile(dbn_path);
+  server_.Get(path, [buffer, params](const httplib::Request& req,
+                                     httplib::Response& resp) {
     if (!req.has_header("Authorization")) {
       resp.status = 401;
       return;
     }
     CheckParams(params, req);
-    resp.status = 200;
-    resp.set_header("Content-Disposition", "attachment; filename=test.dbn.zst");
-    resp.set_content_provider(
-        "application/octet-stream",
-        [buffer, kChunkSize](const std::size_t offset,
-                             httplib::DataSink& sink) {
-          if (offset < buffer.size()) {
-            sink.write(&buffer[offset],
-                       std::min(kChunkSize, buffer.size() - offset));
-          } else {
-            sink.done();
-          }
-          return true;
-        });
+    SetDbnContent(buffer, resp);
+  });
+}
+
+void MockHttpServer::MockStreamDbnByParam(
+    const std::string& path, const std::string& param,
+    const std::map<std::string, std::string>& dbn_paths) {
+  std::map<std::string, std::vector<char>> buffers;
+  for (const auto& value_and_path : dbn_paths) {
+    buffers.emplace(value_and_path.first, ReadFile(value_and_path.second));
+  }
+  server_.Get(path, [buffers, param](const httplib::Request& req,
+                                     httplib::Response& resp) {
+    if (!req.has_header("Authorization")) {
+      resp.status = 401;
+      return;
+    }
+    const auto buffer_it = buffers.find(req.get_param_value(param));
+    if (buffer_it == buffers.end()) {
+      ADD_FAILURE() << "Unexpected query param value for " << param << ": "
+                    << req.get_param_value(param);
+      resp.status = 404;
+      return;
+    }
+    SetDbnContent(buffer_it->second, resp);
   });
 }
 
+std::vector<char> MockHttpServer::ReadFile(const std::string& file_path) {
+  std::ifstream input_file{file_path, std::ios::binary | std::ios::ate};
+  const auto size = static_cast<std::size_t>(input_file.tellg());
+  input_file.seekg(0, std::ios::beg);
+  std::vector<char> buffer(size);
+  input_file.read(buffer.data(), static_cast<std::streamsize>(size));
+  return buffer;
+}
+
+void MockHttpServer::SetDbnContent(const std::vector<char>& buffer,
+                                   httplib::Response& resp) {
+  constexpr std::size_t kChunkSize = 32;
+
+  resp.status = 200;
+  resp.set_header("Content-Disposition", "attachment; filename=test.dbn.zst");
+  resp.set_content_provider(
+      "application/octet-stream",
+      [buffer, kChunkSize](const std::size_t offset, httplib::DataSink& sink) {
+        if (offset < buffer.size()) {
+          sink.write(&buffer[offset],
+                     std::min(kChunkSize, buffer.size() - offset));
+        } else {
+          sink.done();
+        }
+        return true;
+      });
+}
+
 void MockHttpServer::CheckParams(
     const std::map<std::string, std::string>& params,
     const httplib::Request& req) {
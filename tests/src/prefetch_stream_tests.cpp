@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>  // iota
+#include <vector>
+
+#include "databento/detail/prefetch_stream.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/ireadable.hpp"
+#include "mock/mock_io.hpp"
+
+namespace databento {
+namespace detail {
+namespace test {
+namespace {
+// Returns its input in small chunks then throws
+class ThrowingReadable : public IReadable {
+ public:
+  void ReadExact(std::uint8_t*, std::size_t) override {}
+  std::size_t ReadSome(std::uint8_t* buffer, std::size_t) override {
+    if (read_count_++ < 3) {
+      *buffer = static_cast<std::uint8_t>(read_count_);
+      return 1;
+    }
+    throw DbnResponseError{"read failed"};
+  }
+
+ private:
+  int read_count_{};
+};
+}  // namespace
+
+TEST(PrefetchStreamTests, TestIdentity) {
+  std::vector<std::uint8_t> source_data(100000);
+  std::iota(source_data.begin(), source_data.end(), std::uint8_t{});
+  std::unique_ptr<databento::test::mock::MockIo> mock_io{
+      new databento::test::mock::MockIo};
+  mock_io->WriteAll(source_data.data(), source_data.size());
+
+  PrefetchStream target{std::move(mock_io), 1000, 4};
+  std::vector<std::uint8_t> res(source_data.size());
+  target.ReadExact(res.data(), 10);
+  std::size_t size = 10;
+  while (size < res.size()) {
+    const auto read_size = target.ReadSome(&res[size], 3333);
+    ASSERT_GT(read_size, 0);
+    size += read_size;
+  }
+  EXPECT_EQ(res, source_data);
+  std::uint8_t byte{};
+  EXPECT_EQ(target.ReadSome(&byte, 1), 0);
+  EXPECT_THROW(target.ReadExact(&byte, 1), DbnResponseError);
+}
+
+TEST(PrefetchStreamTests, TestRethrowsAfterDeliveringData) {
+  PrefetchStream target{std::unique_ptr<IReadable>{new ThrowingReadable},
+                        100, 2};
+  std::vector<std::uint8_t> res(3);
+  target.ReadExact(res.data(), res.size());
+  EXPECT_EQ(res, (std::vector<std::uint8_t>{1, 2, 3}));
+  std::uint8_t byte{};
+  EXPECT_THROW(target.ReadSome(&byte, 1), DbnResponseError);
+}
+
+TEST(PrefetchStreamTests, TestDestroyBeforeConsuming) {
+  std::vector<std::uint8_t> source_data(100000);
+  std::unique_ptr<databento::test::mock::MockIo> mock_io{
+      new databento::test::mock::MockIo};
+  mock_io->WriteAll(source_data.data(), source_data.size());
+  // Blocks while the queue is full and must stop on destruction
+  PrefetchStream target{std::move(mock_io), 100, 2};
+  std::uint8_t byte{};
+  EXPECT_EQ(target.ReadSome(&byte, 1), 1);
+}
+}  // namespace test
+}  // namespace detail
+}  // namespace databento
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "databento/datetime.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/record.hpp"
+#include "databento/record_filter.hpp"
+
+namespace databento {
+namespace test {
+TEST(RecordFilterTests, TestDefaultMatchesAll) {
+  const RecordFilter target;
+  EXPECT_TRUE(target.MatchesAll());
+  EXPECT_TRUE(target.Matches(RecordHeader{0, RType::Mbo, 1, 2, {}}));
+}
+
+TEST(RecordFilterTests, TestMatches) {
+  const UnixNanos start{std::chrono::nanoseconds{100}};
+  const UnixNanos end{std::chrono::nanoseconds{200}};
+  const RecordFilter target{{RType::Mbp0, RType::Mbp1}, {10, 5}, start, end};
+  EXPECT_FALSE(target.MatchesAll());
+  EXPECT_TRUE(target.Matches(RecordHeader{0, RType::Mbp0, 1, 5, start}));
+  EXPECT_TRUE(target.Matches(
+      RecordHeader{0, RType::Mbp1, 1, 10, end - std::chrono::nanoseconds{1}}));
+  EXPECT_FALSE(target.Matches(RecordHeader{0, RType::Mbo, 1, 5, start}));
+  EXPECT_FALSE(target.Matches(RecordHeader{0, RType::Mbp0, 1, 6, start}));
+  EXPECT_FALSE(target.Matches(RecordHeader{0, RType::Mbp0, 1, 5, end}));
+  EXPECT_FALSE(target.Matches(
+      RecordHeader{0, RType::Mbp0, 1, 5, start - std::chrono::nanoseconds{1}}));
+}
+
+TEST(RecordFilterTests, TestEmptySetsMatchAny) {
+  const RecordFilter target{{}, {}, {}, UnixNanos::max()};
+  EXPECT_FALSE(target.MatchesAll());
+  EXPECT_TRUE(target.Matches(RecordHeader{0, RType::Status, 1, 123, {}}));
+  EXPECT_TRUE(target.Matches(RecordHeader{0, RType::Mbo, 1, 456, {}}));
+}
+
+TEST(RecordFilterTests, TestInvalidRange) {
+  EXPECT_THROW(RecordFilter({}, {}, UnixNanos{std::chrono::nanoseconds{2}},
+                            UnixNanos{std::chrono::nanoseconds{1}}),
+               InvalidArgumentError);
+}
+}  // namespace test
+}  // namespace databento
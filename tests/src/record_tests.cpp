@@ -2,12 +2,18 @@
 
 #include <chrono>
 #include <cstdint>
+#include <string>
+#include <vector>
 
 #include "databento/constants.hpp"
 #include "databento/datetime.hpp"  // TimeDeltaNanos, UnixNanos
 #include "databento/enums.hpp"
 #include "databento/publishers.hpp"
 #include "databento/record.hpp"
+#include "databento/record_visit.hpp"
+#include "databento/v1.hpp"
+#include "databento/v3.hpp"
+#include "databento/with_ts_out.hpp"
 
 namespace databento {
 namespace test {
@@ -283,5 +289,90 @@ TEST(RecordTests, TestImbalanceMsgToString) {
     significant_imbalance = 'N'
 })");
 }
+
+TEST(RecordTests, TestVisitTypedHandlers) {
+  TradeMsg trade{};
+  trade.hd = RecordHeader{sizeof(TradeMsg) / RecordHeader::kLengthMultiplier,
+                          RType::Mbp0, 1, 2, {}};
+  v1::InstrumentDefMsg def_v1{};
+  def_v1.hd = RecordHeader{
+      sizeof(v1::InstrumentDefMsg) / RecordHeader::kLengthMultiplier,
+      RType::InstrumentDef, 1, 3, {}};
+  InstrumentDefMsg def_v2{};
+  def_v2.hd =
+      RecordHeader{sizeof(InstrumentDefMsg) / RecordHeader::kLengthMultiplier,
+                   RType::InstrumentDef, 1, 4, {}};
+  WithTsOut<InstrumentDefMsg> def_v2_ts_out{def_v2, {}};
+  v3::InstrumentDefMsg def_v3{};
+  def_v3.hd = RecordHeader{
+      sizeof(v3::InstrumentDefMsg) / RecordHeader::kLengthMultiplier,
+      RType::InstrumentDef, 1, 5, {}};
+  v1::ErrorMsg error_v1{};
+  error_v1.hd =
+      RecordHeader{sizeof(v1::ErrorMsg) / RecordHeader::kLengthMultiplier,
+                   RType::Error, 1, 0, {}};
+  ErrorMsg error_v2{};
+  error_v2.hd = RecordHeader{sizeof(ErrorMsg) / RecordHeader::kLengthMultiplier,
+                             RType::Error, 1, 0, {}};
+  OhlcvMsg ohlcv{};
+  ohlcv.hd = RecordHeader{sizeof(OhlcvMsg) / RecordHeader::kLengthMultiplier,
+                          RType::Ohlcv1H, 1, 6, {}};
+
+  std::vector<std::string> res;
+  const auto visitor = Overloaded{
+      [&res](const TradeMsg& rec) {
+        res.emplace_back("trade " + std::to_string(rec.hd.instrument_id));
+      },
+      [&res](const v1::InstrumentDefMsg& rec) {
+        res.emplace_back("def v1 " + std::to_string(rec.hd.instrument_id));
+      },
+      [&res](const InstrumentDefMsg& rec) {
+        res.emplace_back("def v2 " + std::to_string(rec.hd.instrument_id));
+      },
+      [&res](const v3::InstrumentDefMsg& rec) {
+        res.emplace_back("def v3 " + std::to_string(rec.hd.instrument_id));
+      },
+      [&res](const v1::ErrorMsg&) { res.emplace_back("error v1"); },
+      [&res](const ErrorMsg&) { res.emplace_back("error v2"); },
+  };
+  for (auto* hd : {&trade.hd, &def_v1.hd, &def_v2.hd, &def_v2_ts_out.rec.hd,
+                   &def_v3.hd, &error_v1.hd, &error_v2.hd, &ohlcv.hd}) {
+    Record{hd}.Visit(visitor);
+  }
+  // Unhandled OHLCV record is skipped
+  EXPECT_EQ(res, (std::vector<std::string>{"trade 2", "def v1 3", "def v2 4",
+                                           "def v2 4", "def v3 5", "error v1",
+                                           "error v2"}));
+}
+
+TEST(RecordTests, TestVisitRecordFallback) {
+  MboMsg mbo{};
+  mbo.hd = RecordHeader{sizeof(MboMsg) / RecordHeader::kLengthMultiplier,
+                        RType::Mbo, 1, 2, {}};
+  StatMsg stat{};
+  stat.hd = RecordHeader{sizeof(StatMsg) / RecordHeader::kLengthMultiplier,
+                         RType::Statistics, 1, 3, {}};
+  // Header of an rtype unknown to this version of the library
+  RecordHeader unknown{sizeof(RecordHeader) / RecordHeader::kLengthMultiplier,
+                       static_cast<RType>(0xFE), 1, 4, {}};
+  int mbo_count{};
+  std::vector<std::uint32_t> fallback_ids;
+  for (auto* hd : {&mbo.hd, &stat.hd, &unknown}) {
+    Record{hd}.Visit(
+        Overloaded{[&mbo_count](const MboMsg&) { ++mbo_count; },
+                   [&fallback_ids](const Record& rec) {
+                     fallback_ids.emplace_back(rec.Header().instrument_id);
+                   }});
+  }
+  EXPECT_EQ(mbo_count, 1);
+  EXPECT_EQ(fallback_ids, (std::vector<std::uint32_t>{3, 4}));
+  // Generic handlers receive the concrete type
+  std::vector<std::size_t> sizes;
+  for (auto* hd : {&mbo.hd, &stat.hd}) {
+    Record{hd}.Visit(
+        [&sizes](const auto& rec) { sizes.emplace_back(sizeof(rec)); });
+  }
+  EXPECT_EQ(sizes, (std::vector<std::size_t>{sizeof(MboMsg), sizeof(StatMsg)}));
+}
 }  // namespace test
 }  // namespace databento
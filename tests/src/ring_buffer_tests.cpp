@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>  // copy, fill_n
+#include <cstddef>
+#include <cstdint>
+#include <numeric>  // iota
+#include <utility>  // move
+#include <vector>
+
+#include "databento/detail/ring_buffer.hpp"
+
+namespace databento {
+namespace detail {
+namespace test {
+TEST(RingBufferTests, TestCapacityAtLeastRequested) {
+  const RingBuffer target{1000};
+  EXPECT_GE(target.Capacity(), 1000);
+  EXPECT_EQ(target.ReadableSize(), 0);
+  EXPECT_EQ(target.WritableSize(), target.Capacity());
+}
+
+TEST(RingBufferTests, TestCommitAndConsume) {
+  RingBuffer target{1024};
+  const std::vector<std::uint8_t> input{1, 2, 3, 4, 5, 6};
+  std::copy(input.begin(), input.end(), target.WriteBegin());
+  target.Commit(input.size());
+  ASSERT_EQ(target.ReadableSize(), input.size());
+  EXPECT_TRUE(std::equal(input.begin(), input.end(), target.ReadBegin()));
+  target.Consume(2);
+  ASSERT_EQ(target.ReadableSize(), 4);
+  EXPECT_EQ(*target.ReadBegin(), 3);
+  target.Consume(4);
+  EXPECT_EQ(target.ReadableSize(), 0);
+  EXPECT_EQ(target.WritableSize(), target.Capacity());
+}
+
+TEST(RingBufferTests, TestWrapIsContiguous) {
+  RingBuffer target{1024};
+  const auto capacity = target.Capacity();
+  // Leave 10 unread bytes at the end of the buffer
+  std::fill_n(target.WriteBegin(), capacity, std::uint8_t{0});
+  target.Commit(capacity);
+  target.Consume(capacity - 10);
+  target.Compact();
+  ASSERT_EQ(target.ReadableSize(), 10);
+  ASSERT_EQ(target.WritableSize(), capacity - 10);
+  std::vector<std::uint8_t> input(100);
+  std::iota(input.begin(), input.end(), std::uint8_t{1});
+  const auto* write_begin = target.WriteBegin();
+  std::copy(input.begin(), input.end(), target.WriteBegin());
+  target.Commit(input.size());
+  target.Consume(10);
+  ASSERT_EQ(target.ReadableSize(), input.size());
+  EXPECT_TRUE(std::equal(input.begin(), input.end(), target.ReadBegin()));
+  if (target.IsMirrored()) {
+    // Bytes written past the end are read back through the first mapping
+    EXPECT_EQ(target.ReadBegin() + capacity, write_begin);
+  }
+}
+
+TEST(RingBufferTests, TestMove) {
+  RingBuffer buffer{1024};
+  *buffer.WriteBegin() = 42;
+  buffer.Commit(1);
+  RingBuffer target{std::move(buffer)};
+  ASSERT_EQ(target.ReadableSize(), 1);
+  EXPECT_EQ(*target.ReadBegin(), 42);
+  RingBuffer other{2048};
+  other = std::move(target);
+  ASSERT_EQ(other.ReadableSize(), 1);
+  EXPECT_EQ(*other.ReadBegin(), 42);
+}
+}  // namespace test
+}  // namespace detail
+}  // namespace databento
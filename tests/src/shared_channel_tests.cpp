@@ -1,8 +1,11 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <string>
 #include <thread>
 #include <vector>
@@ -83,6 +86,65 @@ TEST_F(SharedChannelTests, TestReadSome) {
 
   ASSERT_EQ(res, "parsestreamtestssomelast");
 }
+
+TEST(SharedChannelBoundedTests, TestWriteBlocksWhenFull) {
+  SharedChannel target{4, 2};
+  const std::string input{"abcdefghijklmnopqrstuvwxyz"};
+  std::atomic<bool> is_written{};
+  ScopedThread write_thread{[&target, &input, &is_written] {
+    EXPECT_TRUE(
+        target.Write(reinterpret_cast<const std::uint8_t*>(input.data()),
+                     input.size()));
+    is_written = true;
+    target.Finish();
+  }};
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  // Only 8 bytes fit in the channel
+  EXPECT_FALSE(is_written);
+  std::array<std::uint8_t, 5> buffer{};
+  std::string res;
+  while (const auto read_size = target.ReadSome(buffer.data(), buffer.size())) {
+    res.append(reinterpret_cast<const char*>(buffer.data()), read_size);
+  }
+  EXPECT_TRUE(is_written);
+  EXPECT_EQ(res, input);
+}
+
+TEST(SharedChannelBoundedTests, TestSmallWritesShareChunks) {
+  SharedChannel target{8, 2};
+  // Bounded by bytes rather than the number of writes
+  for (const char c : std::string{"abcdefghijklmnop"}) {
+    ASSERT_TRUE(target.Write(reinterpret_cast<const std::uint8_t*>(&c), 1));
+  }
+  std::array<std::uint8_t, 16> buffer{};
+  // Reads stop at the end of a chunk
+  ASSERT_EQ(target.ReadSome(buffer.data(), buffer.size()), 8);
+  ASSERT_EQ(target.ReadSome(&buffer[8], buffer.size() - 8), 8);
+  EXPECT_EQ(std::string(buffer.begin(), buffer.end()), "abcdefghijklmnop");
+  target.Finish();
+  EXPECT_EQ(target.ReadSome(buffer.data(), buffer.size()), 0);
+}
+
+TEST(SharedChannelBoundedTests, TestCancelUnblocksWriter) {
+  SharedChannel target{4, 1};
+  std::atomic<bool> res{true};
+  ScopedThread write_thread{[&target, &res] {
+    res = target.Write(reinterpret_cast<const std::uint8_t*>("blocked"), 7);
+  }};
+  std::array<std::uint8_t, 4> buffer{};
+  target.ReadExact(buffer.data(), 2);
+  target.Cancel();
+  write_thread = ScopedThread{};
+  EXPECT_FALSE(res);
+  EXPECT_FALSE(target.Write(reinterpret_cast<const std::uint8_t*>("x"), 1));
+}
+
+TEST(SharedChannelBoundedTests, TestInvalidSizes) {
+  EXPECT_THROW(SharedChannel(0, 1), InvalidArgumentError);
+  EXPECT_THROW(SharedChannel(1, 0), InvalidArgumentError);
+  EXPECT_THROW(SharedChannel(2, std::numeric_limits<std::size_t>::max()),
+               InvalidArgumentError);
+}
 }  // namespace test
 }  // namespace detail
 }  // namespace databento
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "databento/datetime.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/timeseries_cache.hpp"
+#include "temp_file.hpp"
+
+namespace databento {
+namespace test {
+namespace {
+UnixNanos Ts(std::uint64_t nanos) {
+  return UnixNanos{UnixNanos::duration{nanos}};
+}
+
+void WriteEntry(const std::string& file_path) {
+  std::ofstream{file_path} << "DBN";
+}
+}  // namespace
+
+class TimeseriesCacheTests : public testing::Test {
+ protected:
+  const TempDirectory dir_{testing::TempDir() + "/TimeseriesCacheTests"};
+  const TimeseriesCache::Params params_{{"dataset", "GLBX.MDP3"},
+                                        {"compression", "zstd"},
+                                        {"symbols", "ESH1,NQH1"},
+                                        {"schema", "trades"},
+                                        {"start", "0"},
+                                        {"end", "100"}};
+  TimeseriesCache target_{dir_.Path()};
+};
+
+TEST_F(TimeseriesCacheTests, TestCanonicalQuery) {
+  const TimeseriesCache::Params reordered{{"symbols", "NQH1,ESH1,ESH1"},
+                                          {"schema", "trades"},
+                                          {"start", "50"},
+                                          {"compression", "zstd"},
+                                          {"dataset", "GLBX.MDP3"}};
+  const auto query = TimeseriesCache::CanonicalQuery("/v0/path", params_);
+  EXPECT_EQ(query,
+            "/v0/path?compression=zstd&dataset=GLBX.MDP3&schema=trades&"
+            "symbols=ESH1,NQH1");
+  EXPECT_EQ(TimeseriesCache::CanonicalQuery("/v0/path", reordered), query);
+  EXPECT_NE(TimeseriesCache::CanonicalQuery("/v0/other", params_), query);
+}
+
+TEST_F(TimeseriesCacheTests, TestPlanEmpty) {
+  const auto plan = target_.Plan("/v0/path", params_, Ts(0), Ts(100));
+  ASSERT_EQ(plan.size(), 1);
+  EXPECT_EQ(plan[0].start, Ts(0));
+  EXPECT_EQ(plan[0].end, Ts(100));
+  EXPECT_TRUE(plan[0].file_path.empty());
+}
+
+TEST_F(TimeseriesCacheTests, TestPlanSplitsCachedAndUncached) {
+  const auto entry0 =
+      target_.Store("/v0/path", params_, Ts(10), Ts(50), WriteEntry);
+  // Overlaps `entry0`, as when stored concurrently by another process
+  const auto entry1 =
+      target_.Store("/v0/path", params_, Ts(40), Ts(70), WriteEntry);
+  const auto entry2 =
+      target_.Store("/v0/path", params_, Ts(80), Ts(90), WriteEntry);
+  // Entries of other queries are ignored
+  target_.Store("/v0/other", params_, Ts(0), Ts(100), WriteEntry);
+
+  const auto plan = target_.Plan("/v0/path", params_, Ts(0), Ts(100));
+  ASSERT_EQ(plan.size(), 6);
+  const std::vector<std::uint64_t> expected_bounds{0, 10, 50, 70, 80, 90, 100};
+  const std::vector<std::string> expected_paths{
+      "", entry0.file_path, entry1.file_path, "", entry2.file_path, ""};
+  for (std::size_t i = 0; i < plan.size(); ++i) {
+    EXPECT_EQ(plan[i].start, Ts(expected_bounds[i]));
+    EXPECT_EQ(plan[i].end, Ts(expected_bounds[i + 1]));
+    EXPECT_EQ(plan[i].file_path, expected_paths[i]);
+  }
+
+  const auto inner_plan = target_.Plan("/v0/path", params_, Ts(20), Ts(45));
+  ASSERT_EQ(inner_plan.size(), 1);
+  EXPECT_EQ(inner_plan[0].start, Ts(20));
+  EXPECT_EQ(inner_plan[0].end, Ts(45));
+  EXPECT_EQ(inner_plan[0].file_path, entry0.file_path);
+}
+
+TEST_F(TimeseriesCacheTests, TestStoreFailureLeavesNoEntry) {
+  EXPECT_THROW(target_.Store("/v0/path", params_, Ts(0), Ts(100),
+                             [](const std::string& file_path) {
+                               WriteEntry(file_path);
+                               throw std::runtime_error{"Request failed"};
+                             }),
+               std::runtime_error);
+  const auto plan = target_.Plan("/v0/path", params_, Ts(0), Ts(100));
+  ASSERT_EQ(plan.size(), 1);
+  EXPECT_TRUE(plan[0].file_path.empty());
+}
+
+TEST_F(TimeseriesCacheTests, TestPlanWithLimit) {
+  auto params = params_;
+  params.emplace("limit", "10");
+  EXPECT_THROW(target_.Plan("/v0/path", params, Ts(0), Ts(100)),
+               InvalidArgumentError);
+}
+}  // namespace test
+}  // namespace databento
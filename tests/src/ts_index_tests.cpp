@@ -0,0 +1,248 @@
+#include <date/date.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>  // pair
+#include <vector>
+
+#include "databento/constants.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/detail/zstd_stream.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/file_stream.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "databento/timeseries.hpp"
+#include "databento/ts_index.hpp"
+#include "dbn_test_file.hpp"
+#include "temp_file.hpp"
+
+namespace databento {
+namespace test {
+namespace {
+constexpr std::int64_t kRecordCount = 10000;
+constexpr std::uint64_t kBlockSize = 4096;
+constexpr std::int64_t kStartTs = 1704067200000000000;
+
+// Several records share each timestamp
+UnixNanos TsForIdx(std::int64_t idx) {
+  return UnixNanos{std::chrono::nanoseconds{kStartTs + (idx / 3) * 10}};
+}
+
+Metadata GenMetadata() {
+  return GenTestMetadata(dataset::kGlbxMdp3, Schema::Mbo, TsForIdx(0),
+                         TsForIdx(kRecordCount + 2), {"ESH4"});
+}
+
+MboMsg GenRecord(std::uint32_t idx) { return GenMbo(idx, TsForIdx(idx)); }
+
+// `frame_size` of 0 writes an uncompressed file
+TsIndex WriteFile(const std::string& file_path, std::size_t frame_size) {
+  TsIndex index{kBlockSize};
+  auto options = FrameSizeTestFileOptions(frame_size);
+  options.ts_index = &index;
+  WriteGenDbnTestFile(file_path, GenMetadata(), kRecordCount, GenRecord,
+                      options);
+  return index;
+}
+
+void WriteNonSeekableZstdFile(const std::string& file_path) {
+  DbnTestFileOptions options;
+  options.compression = Compression::Zstd;
+  WriteGenDbnTestFile(file_path, GenMetadata(), kRecordCount, GenRecord,
+                      options);
+}
+
+void CheckSeekTo(const std::string& file_path, const TsIndex& index,
+                 DbnFileStoreOptions options = {}) {
+  options.ts_index = &index;
+  DbnFileStore target{ILogReceiver::Default(), file_path, options};
+  for (const std::int64_t idx : {4000, 0, 9999, 1, 3001, 7342}) {
+    target.SeekTo(TsForIdx(idx));
+    // First record with the timestamp
+    const auto expected_idx = idx - idx % 3;
+    const auto* rec = target.NextRecord();
+    ASSERT_NE(rec, nullptr);
+    EXPECT_EQ(rec->Get<MboMsg>().sequence, expected_idx);
+    EXPECT_EQ(rec->IndexTs(), TsForIdx(idx));
+    std::int64_t count{1};
+    while (target.NextRecord() != nullptr) {
+      ++count;
+    }
+    EXPECT_EQ(count, kRecordCount - expected_idx);
+  }
+  // Between timestamps
+  target.SeekTo(TsForIdx(300) + std::chrono::nanoseconds{1});
+  ASSERT_NE(target.NextRecord(), nullptr);
+  target.SeekTo(TsForIdx(300) + std::chrono::nanoseconds{1});
+  std::int64_t count{};
+  target.Replay([&count](const Record& rec) {
+    EXPECT_EQ(rec.Get<MboMsg>().sequence, 303 + count);
+    ++count;
+    return KeepGoing::Continue;
+  });
+  EXPECT_EQ(count, kRecordCount - 303);
+  target.SeekTo(TsForIdx(300) + std::chrono::nanoseconds{1});
+  count = 0;
+  target.Replay([&count](const std::vector<Record>& records) {
+    for (const auto& rec : records) {
+      EXPECT_EQ(rec.Get<MboMsg>().sequence, 303 + count);
+      ++count;
+    }
+    return KeepGoing::Continue;
+  });
+  EXPECT_EQ(count, kRecordCount - 303);
+  // Past the end
+  target.SeekTo(TsForIdx(kRecordCount + 2));
+  EXPECT_EQ(target.NextRecord(), nullptr);
+}
+}  // namespace
+
+TEST(TsIndexTests, TestEncoderIndexMatchesBuild) {
+  const TempFile temp_file{TEST_BUILD_DIR "/ts-index.dbn"};
+  const auto index = WriteFile(temp_file.Path(), 0);
+  ASSERT_GT(index.Entries().size(), 100);
+  for (std::size_t i = 1; i < index.Entries().size(); ++i) {
+    EXPECT_GE(index.Entries()[i].offset,
+              index.Entries()[i - 1].offset + kBlockSize);
+    EXPECT_GE(index.Entries()[i].max_ts, index.Entries()[i - 1].max_ts);
+  }
+  const auto built = TsIndex::Build(temp_file.Path(), kBlockSize);
+  EXPECT_EQ(built.BlockSize(), kBlockSize);
+  EXPECT_EQ(built.Entries(), index.Entries());
+
+  const TempFile zst_file{TEST_BUILD_DIR "/ts-index.dbn.zst"};
+  const auto zst_index = WriteFile(zst_file.Path(), 1 << 14);
+  EXPECT_EQ(zst_index.Entries(), index.Entries());
+  EXPECT_EQ(TsIndex::Build(zst_file.Path(), kBlockSize).Entries(),
+            index.Entries());
+}
+
+TEST(TsIndexTests, TestWriteReadFileIdentity) {
+  const TempFile temp_file{TEST_BUILD_DIR "/ts-index.dbn"};
+  const TempFile index_file{TEST_BUILD_DIR "/ts-index.dbn.tsidx"};
+  const auto index = WriteFile(temp_file.Path(), 0);
+  index.WriteToFile(index_file.Path());
+  const auto res = TsIndex::ReadFromFile(index_file.Path());
+  EXPECT_EQ(res.BlockSize(), index.BlockSize());
+  EXPECT_EQ(res.Entries(), index.Entries());
+}
+
+TEST(TsIndexTests, TestReadFromFileInvalid) {
+  const TempFile temp_file{TEST_BUILD_DIR "/ts-index.dbn"};
+  WriteFile(temp_file.Path(), 0);
+  EXPECT_THROW(TsIndex::ReadFromFile(temp_file.Path()), DbnResponseError);
+}
+
+TEST(TsIndexTests, TestReadFromFileTruncated) {
+  const TempFile index_file{TEST_BUILD_DIR "/ts-index.dbn.tsidx"};
+  {
+    OutFileStream output{index_file.Path()};
+    output.WriteAll(reinterpret_cast<const std::uint8_t*>("DBNTSIX\x01"), 8);
+    // Block size, then an entry count far larger than the file
+    for (const std::uint64_t value : {kBlockSize, std::uint64_t{1} << 60}) {
+      output.WriteAll(reinterpret_cast<const std::uint8_t*>(&value),
+                      sizeof(value));
+    }
+  }
+  EXPECT_THROW(TsIndex::ReadFromFile(index_file.Path()), DbnResponseError);
+}
+
+TEST(TsIndexTests, TestFind) {
+  TsIndex target{kBlockSize};
+  EXPECT_EQ(target.Find(TsForIdx(0)), 0);
+  const TempFile temp_file{TEST_BUILD_DIR "/ts-index.dbn"};
+  const auto index = WriteFile(temp_file.Path(), 0);
+  EXPECT_EQ(index.Find(UnixNanos{}), 0);
+  EXPECT_EQ(index.Find(TsForIdx(kRecordCount + 2)), index.Entries().size());
+  const auto entry_idx = index.Find(TsForIdx(5000));
+  ASSERT_LT(entry_idx, index.Entries().size());
+  EXPECT_GE(index.Entries()[entry_idx].max_ts, TsForIdx(5000));
+  ASSERT_GT(entry_idx, 0);
+  EXPECT_LT(index.Entries()[entry_idx - 1].max_ts, TsForIdx(5000));
+}
+
+TEST(TsIndexTests, TestSeekTo) {
+  const TempFile temp_file{TEST_BUILD_DIR "/ts-index.dbn"};
+  const auto index = WriteFile(temp_file.Path(), 0);
+  CheckSeekTo(temp_file.Path(), index);
+}
+
+TEST(TsIndexTests, TestSeekToSeekableZstd) {
+  const TempFile temp_file{TEST_BUILD_DIR "/ts-index.dbn.zst"};
+  const auto index = WriteFile(temp_file.Path(), 1 << 14);
+  CheckSeekTo(temp_file.Path(), index);
+}
+
+TEST(TsIndexTests, TestSeekToMapped) {
+  const TempFile temp_file{TEST_BUILD_DIR "/ts-index.dbn"};
+  const auto index = WriteFile(temp_file.Path(), 0);
+  DbnFileStoreOptions options;
+  options.mapped = true;
+  CheckSeekTo(temp_file.Path(), index, options);
+}
+
+TEST(TsIndexTests, TestSeekToSeekableZstdPrefetch) {
+  const TempFile temp_file{TEST_BUILD_DIR "/ts-index.dbn.zst"};
+  const auto index = WriteFile(temp_file.Path(), 1 << 14);
+  DbnFileStoreOptions options;
+  options.buffer_size = 1024;
+  options.prefetch_block_count = 2;
+  options.mapped = true;
+  CheckSeekTo(temp_file.Path(), index, options);
+}
+
+TEST(TsIndexTests, TestSeekToZstd) {
+  const TempFile temp_file{TEST_BUILD_DIR "/ts-index.dbn.zst"};
+  WriteNonSeekableZstdFile(temp_file.Path());
+  CheckSeekTo(temp_file.Path(),
+              TsIndex::Build(temp_file.Path(), kBlockSize));
+}
+
+TEST(TsIndexTests, TestSeekToSkipsUndefTimestamps) {
+  const TempFile temp_file{TEST_BUILD_DIR "/ts-index.dbn"};
+  TsIndex index{kBlockSize};
+  DbnTestFileOptions options;
+  options.ts_index = &index;
+  // Every tenth record has no index timestamp
+  WriteGenDbnTestFile(temp_file.Path(), GenMetadata(), kRecordCount,
+                      [](std::uint32_t idx) {
+                        auto mbo = GenRecord(idx);
+                        if (idx % 10 == 5) {
+                          mbo.ts_recv = UnixNanos{
+                              std::chrono::nanoseconds{kUndefTimestamp}};
+                        }
+                        return mbo;
+                      },
+                      options);
+  DbnFileStoreOptions store_options;
+  store_options.ts_index = &index;
+  DbnFileStore target{ILogReceiver::Default(), temp_file.Path(),
+                      store_options};
+  // Pairs of the index of the record to seek to and the index of the first
+  // record with its timestamp. Each is preceded by a record without one.
+  for (const auto& idxs : std::vector<std::pair<std::int64_t, std::uint32_t>>{
+           {8, 6}, {4006, 4006}, {9997, 9996}}) {
+    target.SeekTo(TsForIdx(idxs.first));
+    const auto* rec = target.NextRecord();
+    ASSERT_NE(rec, nullptr);
+    EXPECT_EQ(rec->Get<MboMsg>().sequence, idxs.second);
+  }
+}
+
+TEST(TsIndexTests, TestSeekToWithoutIndex) {
+  const TempFile temp_file{TEST_BUILD_DIR "/ts-index.dbn"};
+  WriteFile(temp_file.Path(), 0);
+  DbnFileStore target{temp_file.Path()};
+  EXPECT_THROW(target.SeekTo(TsForIdx(0)), Exception);
+}
+}  // namespace test
+}  // namespace databento
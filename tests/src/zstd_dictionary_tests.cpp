@@ -0,0 +1,273 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "databento/constants.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_decoder.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/dbn_file_store.hpp"
+#include "databento/dbn_stream_decoder.hpp"
+#include "databento/detail/parallel_zstd_stream.hpp"
+#include "databento/detail/zstd_stream.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/file_stream.hpp"
+#include "databento/ireadable.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "databento/timeseries.hpp"
+#include "databento/zstd_compress_options.hpp"
+#include "databento/zstd_dictionary.hpp"
+#include "dbn_test_file.hpp"
+#include "temp_file.hpp"
+
+namespace databento {
+namespace test {
+namespace {
+constexpr std::int64_t kRecordCount = 10000;
+constexpr std::size_t kFrameSize = 1024;
+constexpr std::size_t kMaxDictSize = 16 * 1024;
+constexpr std::int64_t kStartTs = 1704067200000000000;
+
+Metadata GenMetadata() {
+  return GenTestMetadata(
+      dataset::kGlbxMdp3, Schema::Mbo,
+      UnixNanos{std::chrono::nanoseconds{kStartTs}},
+      UnixNanos{std::chrono::nanoseconds{kStartTs + kRecordCount}}, {"ESH4"});
+}
+
+MboMsg GenRecord(std::uint32_t idx) {
+  return GenMbo(idx, UnixNanos{std::chrono::nanoseconds{kStartTs + idx * 997}});
+}
+
+// `frame_size` of 0 writes an uncompressed file
+void WriteFile(const std::string& file_path, std::size_t frame_size,
+               const ZstdCompressOptions& zstd_options) {
+  auto options = FrameSizeTestFileOptions(frame_size);
+  options.zstd_options = zstd_options;
+  WriteGenDbnTestFile(file_path, GenMetadata(), kRecordCount, GenRecord,
+                      options);
+}
+
+// The total size of the compressed frames, excluding the seek table
+std::uint64_t CompressedSize(const std::string& file_path) {
+  const auto frames = detail::ReadZstdSeekTable(file_path);
+  return frames.back().compressed_offset + frames.back().compressed_size;
+}
+
+ZstdDictionary TrainDictionary() {
+  const TempFile dbn_file{testing::TempDir() + "/TrainDictionary.dbn"};
+  WriteFile(dbn_file.Path(), 0, {});
+  return ZstdDictionary::Train(dbn_file.Path(), kFrameSize, kMaxDictSize);
+}
+
+void CheckRecords(DbnDecoder* decoder) {
+  EXPECT_EQ(decoder->DecodeMetadata(), GenMetadata());
+  for (std::int64_t i = 0; i < kRecordCount; ++i) {
+    const auto* rec = decoder->DecodeRecord();
+    ASSERT_NE(rec, nullptr);
+    EXPECT_EQ(rec->Get<MboMsg>(), GenRecord(i));
+  }
+  EXPECT_EQ(decoder->DecodeRecord(), nullptr);
+}
+}  // namespace
+
+TEST(ZstdDictionaryTests, TestTrainAndReadWrite) {
+  const auto dictionary = TrainDictionary();
+  EXPECT_NE(dictionary.Id(), 0U);
+  EXPECT_LE(dictionary.Data().size(), kMaxDictSize);
+  const TempFile dict_file{testing::TempDir() + "/TestTrainAndReadWrite.dict"};
+  dictionary.WriteToFile(dict_file.Path());
+  const auto res = ZstdDictionary::ReadFromFile(dict_file.Path());
+  EXPECT_EQ(res.Id(), dictionary.Id());
+  EXPECT_EQ(res.Data(), dictionary.Data());
+}
+
+TEST(ZstdDictionaryTests, TestTrainTooFewSamples) {
+  const std::vector<std::uint8_t> samples(100, 1);
+  EXPECT_THROW(ZstdDictionary::Train(samples, {100}, kMaxDictSize),
+               InvalidArgumentError);
+}
+
+TEST(ZstdDictionaryTests, TestSetFind) {
+  ZstdDictionarySet target;
+  EXPECT_EQ(target.Find(Schema::Mbo), nullptr);
+  target.Add(Schema::Mbo, TrainDictionary());
+  const auto* dictionary = target.Find(Schema::Mbo);
+  ASSERT_NE(dictionary, nullptr);
+  EXPECT_EQ(target.FindById(dictionary->Id()), dictionary);
+  EXPECT_EQ(target.FindById(dictionary->Id() + 1), nullptr);
+  EXPECT_EQ(target.Find(Schema::Trades), nullptr);
+  // Raw content dictionaries don't have an ID
+  EXPECT_THROW(
+      target.Add(Schema::Trades, ZstdDictionary{std::vector<std::uint8_t>(
+                                     1024, 1)}),
+      InvalidArgumentError);
+}
+
+TEST(ZstdDictionaryTests, TestSmallFramesIdentity) {
+  ZstdDictionarySet dictionaries;
+  dictionaries.Add(Schema::Mbo, TrainDictionary());
+  const TempFile plain_file{testing::TempDir() + "/TestSmallFramesPlain.zst"};
+  const TempFile dict_file{testing::TempDir() + "/TestSmallFramesDict.zst"};
+  WriteFile(plain_file.Path(), kFrameSize, {});
+  ZstdCompressOptions options;
+  options.dictionary = dictionaries.Find(Schema::Mbo);
+  WriteFile(dict_file.Path(), kFrameSize, options);
+  EXPECT_EQ(detail::ReadZstdSeekTable(dict_file.Path()).size(),
+            detail::ReadZstdSeekTable(plain_file.Path()).size());
+  EXPECT_LT(CompressedSize(dict_file.Path()),
+            CompressedSize(plain_file.Path()));
+
+  DbnDecoder decoder{ILogReceiver::Default(),
+                     std::unique_ptr<IReadable>{new detail::ZstdDecodeStream{
+                         std::unique_ptr<IReadable>{
+                             new InFileStream{dict_file.Path()}},
+                         &dictionaries}}};
+  CheckRecords(&decoder);
+  // Frames without a dictionary can still be read
+  DbnDecoder plain_decoder{
+      ILogReceiver::Default(),
+      std::unique_ptr<IReadable>{new detail::ZstdDecodeStream{
+          std::unique_ptr<IReadable>{new InFileStream{plain_file.Path()}},
+          &dictionaries}}};
+  CheckRecords(&plain_decoder);
+}
+
+TEST(ZstdDictionaryTests, TestSeekableWithDictionary) {
+  ZstdDictionarySet dictionaries;
+  dictionaries.Add(Schema::Mbo, TrainDictionary());
+  const TempFile dict_file{testing::TempDir() + "/TestSeekableDict.zst"};
+  ZstdCompressOptions options;
+  options.dictionary = dictionaries.Find(Schema::Mbo);
+  WriteFile(dict_file.Path(), kFrameSize, options);
+  detail::ZstdSeekableDecodeStream target{dict_file.Path(), &dictionaries};
+  const auto frames = target.Frames();
+  ASSERT_GT(frames.size(), 2U);
+  // Frames hold whole records
+  target.Seek(frames[2].decompressed_offset);
+  MboMsg first{};
+  target.ReadExact(reinterpret_cast<std::uint8_t*>(&first), sizeof(first));
+  MboMsg second{};
+  target.ReadExact(reinterpret_cast<std::uint8_t*>(&second), sizeof(second));
+  EXPECT_EQ(second.sequence, first.sequence + 1);
+  EXPECT_EQ(second, GenRecord(second.sequence));
+}
+
+TEST(ZstdDictionaryTests, TestDbnFileStoreWithDictionary) {
+  ZstdDictionarySet dictionaries;
+  dictionaries.Add(Schema::Mbo, TrainDictionary());
+  const TempFile dict_file{testing::TempDir() + "/TestFileStoreDict.zst"};
+  ZstdCompressOptions options;
+  options.dictionary = dictionaries.Find(Schema::Mbo);
+  WriteFile(dict_file.Path(), kFrameSize, options);
+  DbnFileStoreOptions store_options;
+  store_options.dictionaries = &dictionaries;
+  for (const std::size_t prefetch_block_count : {0, 2}) {
+    store_options.prefetch_block_count = prefetch_block_count;
+    DbnFileStore target{ILogReceiver::Default(), dict_file.Path(),
+                        store_options};
+    EXPECT_EQ(target.GetMetadata(), GenMetadata());
+    std::int64_t count{};
+    target.Replay([&count](const Record& record) {
+      EXPECT_EQ(record.Get<MboMsg>(), GenRecord(count));
+      ++count;
+      return KeepGoing::Continue;
+    });
+    EXPECT_EQ(count, kRecordCount);
+  }
+}
+
+TEST(ZstdDictionaryTests, TestDbnFileStoreParallelWithDictionary) {
+  ZstdDictionarySet dictionaries;
+  dictionaries.Add(Schema::Mbo, TrainDictionary());
+  const TempFile dict_file{testing::TempDir() + "/TestParallelDict.zst"};
+  const TempFile plain_file{testing::TempDir() + "/TestParallelPlain.dbn"};
+  ZstdCompressOptions options;
+  options.dictionary = dictionaries.Find(Schema::Mbo);
+  WriteFile(dict_file.Path(), kFrameSize, options);
+  // Uncompressed files are read without decompression threads
+  WriteFile(plain_file.Path(), 0, {});
+  DbnFileStoreOptions store_options;
+  store_options.decompress_thread_count = 3;
+  store_options.dictionaries = &dictionaries;
+  for (const auto& file_path : {dict_file.Path(), plain_file.Path()}) {
+    DbnFileStore target{ILogReceiver::Default(), file_path, store_options};
+    EXPECT_EQ(target.GetMetadata(), GenMetadata());
+    std::int64_t count{};
+    target.Replay([&count](const Record& record) {
+      EXPECT_EQ(record.Get<MboMsg>(), GenRecord(count));
+      ++count;
+      return KeepGoing::Continue;
+    });
+    EXPECT_EQ(count, kRecordCount);
+  }
+}
+
+TEST(ZstdDictionaryTests, TestDbnStreamDecoderWithDictionary) {
+  ZstdDictionarySet dictionaries;
+  dictionaries.Add(Schema::Mbo, TrainDictionary());
+  const TempFile dict_file{testing::TempDir() + "/TestStreamDecoderDict.zst"};
+  ZstdCompressOptions options;
+  options.dictionary = dictionaries.Find(Schema::Mbo);
+  WriteFile(dict_file.Path(), kFrameSize, options);
+  std::ifstream file{dict_file.Path(), std::ios::binary};
+  const std::vector<std::uint8_t> input{std::istreambuf_iterator<char>{file},
+                                        std::istreambuf_iterator<char>{}};
+
+  DbnStreamDecoder target{ILogReceiver::Default(),
+                          VersionUpgradePolicy::UpgradeToV2, &dictionaries};
+  bool has_metadata{};
+  std::int64_t count{};
+  // Small feeds split frame headers
+  constexpr std::size_t kFeedSize = 7;
+  for (std::size_t pos = 0; pos < input.size(); pos += kFeedSize) {
+    target.Feed(&input[pos], std::min(kFeedSize, input.size() - pos));
+    if (!has_metadata && target.HasMetadata()) {
+      EXPECT_EQ(target.DecodeMetadata(), GenMetadata());
+      has_metadata = true;
+    }
+    if (has_metadata) {
+      while (const auto* record = target.DecodeRecord()) {
+        EXPECT_EQ(record->Get<MboMsg>(), GenRecord(count));
+        ++count;
+      }
+    }
+  }
+  target.Finish();
+  EXPECT_EQ(count, kRecordCount);
+}
+
+TEST(ZstdDictionaryTests, TestMissingDictionary) {
+  ZstdDictionarySet dictionaries;
+  dictionaries.Add(Schema::Mbo, TrainDictionary());
+  const TempFile dict_file{testing::TempDir() + "/TestMissingDict.zst"};
+  ZstdCompressOptions options;
+  options.dictionary = dictionaries.Find(Schema::Mbo);
+  WriteFile(dict_file.Path(), kFrameSize, options);
+  const ZstdDictionarySet empty;
+  const std::vector<const ZstdDictionarySet*> missing{&empty, nullptr};
+  for (const auto* available : missing) {
+    detail::ZstdDecodeStream target{
+        std::unique_ptr<IReadable>{new InFileStream{dict_file.Path()}},
+        available};
+    std::vector<std::uint8_t> buffer(kFrameSize);
+    EXPECT_THROW(target.ReadExact(buffer.data(), buffer.size()),
+                 DbnResponseError);
+    detail::ParallelZstdDecodeStream parallel{dict_file.Path(), 2, available};
+    EXPECT_THROW(parallel.ReadExact(buffer.data(), buffer.size()),
+                 DbnResponseError);
+  }
+}
+}  // namespace test
+}  // namespace databento
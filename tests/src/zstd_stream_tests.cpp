@@ -1,16 +1,26 @@
 #include <gtest/gtest.h>
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "databento/compat.hpp"
+#include "databento/dbn_decoder.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/detail/parallel_zstd_stream.hpp"
 #include "databento/detail/zstd_stream.hpp"
 #include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
 #include "databento/file_stream.hpp"
 #include "databento/ireadable.hpp"
+#include "databento/log.hpp"
+#include "databento/zstd_compress_options.hpp"
 #include "mock/mock_io.hpp"
+#include "temp_file.hpp"
 
 namespace databento {
 namespace detail {
@@ -50,6 +60,346 @@ TEST(ZstdStreamTests, TestIdentity) {
       new databento::test::mock::MockIo{std::move(mock_io)}}};
   decode.ReadExact(res.data(), size);
 }
+
+TEST(ZstdStreamTests, TestSmallReadsAndReset) {
+  std::vector<std::int64_t> source_data;
+  for (std::int64_t i = 0; i < 100000; ++i) {
+    source_data.emplace_back(i);
+  }
+  const auto size = source_data.size() * sizeof(std::int64_t);
+  databento::test::mock::MockIo mock_io;
+  {
+    ZstdCompressStream compressor{&mock_io};
+    compressor.WriteAll(reinterpret_cast<const std::uint8_t*>(
+                            source_data.data()),
+                        size);
+  }
+  ZstdDecodeStream target{std::unique_ptr<IReadable>{
+      new databento::test::mock::MockIo{mock_io}}};
+  for (int pass = 0; pass < 2; ++pass) {
+    // Output buffers much smaller than a block leave decompressed data
+    // buffered in Zstd between reads
+    std::vector<std::uint8_t> res;
+    std::array<std::uint8_t, 3> buffer{};
+    std::size_t read_size{};
+    do {
+      read_size = target.ReadSome(buffer.data(), buffer.size());
+      res.insert(res.end(), buffer.cbegin(),
+                 buffer.cbegin() + static_cast<std::ptrdiff_t>(read_size));
+    } while (read_size > 0);
+    ASSERT_EQ(res.size(), size);
+    EXPECT_EQ(std::memcmp(res.data(), source_data.data(), size), 0);
+    target.Reset(std::unique_ptr<IReadable>{
+        new databento::test::mock::MockIo{mock_io}});
+  }
+}
+
+TEST(ZstdStreamTests, TestSeekableIdentity) {
+  std::vector<std::int64_t> source_data;
+  for (std::int64_t i = 0; i < 100000; ++i) {
+    source_data.emplace_back(i);
+  }
+  const auto size = source_data.size() * sizeof(std::int64_t);
+  const TempFile temp_file{TEST_BUILD_DIR "/seekable.zst"};
+  {
+    OutFileStream out_file{temp_file.Path()};
+    ZstdCompressStream compressor{ILogReceiver::Default(), &out_file, 8000};
+    for (auto it = source_data.begin(); it != source_data.end(); it += 100) {
+      compressor.WriteAll(reinterpret_cast<const std::uint8_t*>(&*it),
+                          100 * sizeof(std::int64_t));
+    }
+  }
+  const auto frames = ReadZstdSeekTable(temp_file.Path());
+  ASSERT_EQ(frames.size(), 100);
+  for (const auto& frame : frames) {
+    EXPECT_EQ(frame.decompressed_size, 8000);
+  }
+  // Readable as regular Zstd, skipping the seek table
+  std::vector<std::int64_t> res(source_data.size());
+  ZstdDecodeStream decode{
+      std::unique_ptr<IReadable>{new InFileStream{temp_file.Path()}}};
+  decode.ReadExact(reinterpret_cast<std::uint8_t*>(res.data()), size);
+  EXPECT_EQ(res, source_data);
+  std::uint8_t byte{};
+  EXPECT_EQ(decode.ReadSome(&byte, 1), 0);
+
+  ZstdSeekableDecodeStream target{temp_file.Path()};
+  ASSERT_EQ(target.DecompressedSize(), size);
+  for (const std::int64_t i : {54321, 0, 99999, 1000, 40000}) {
+    target.Seek(static_cast<std::uint64_t>(i) * sizeof(std::int64_t));
+    std::int64_t val{};
+    target.ReadExact(reinterpret_cast<std::uint8_t*>(&val), sizeof(val));
+    EXPECT_EQ(val, i);
+  }
+  // Reads continue across frames
+  target.Seek(999 * sizeof(std::int64_t));
+  std::array<std::int64_t, 2> vals{};
+  target.ReadExact(reinterpret_cast<std::uint8_t*>(vals.data()),
+                   sizeof(vals));
+  EXPECT_EQ(vals[0], 999);
+  EXPECT_EQ(vals[1], 1000);
+  EXPECT_THROW(target.Seek(size + 1), InvalidArgumentError);
+}
+
+TEST(ZstdStreamTests, TestCompressOptionsIdentity) {
+  std::vector<std::int64_t> source_data;
+  for (std::int64_t i = 0; i < 100000; ++i) {
+    source_data.emplace_back(i % 1000);
+  }
+  const auto size = source_data.size() * sizeof(std::int64_t);
+  ZstdCompressOptions options;
+  options.level = 3;
+  options.worker_count = 2;
+  options.enable_long_distance_matching = true;
+  options.window_log = 20;
+  databento::test::mock::MockIo mock_io;
+  {
+    ZstdCompressStream compressor{ILogReceiver::Default(), &mock_io, options};
+    for (auto it = source_data.begin(); it != source_data.end(); it += 1000) {
+      compressor.WriteAll(reinterpret_cast<const std::uint8_t*>(&*it),
+                          1000 * sizeof(std::int64_t));
+    }
+  }
+  EXPECT_LT(mock_io.GetContents().size(), size / 100);
+  std::vector<std::int64_t> res(source_data.size());
+  ZstdDecodeStream decode{std::unique_ptr<IReadable>{
+      new databento::test::mock::MockIo{std::move(mock_io)}}};
+  decode.ReadExact(reinterpret_cast<std::uint8_t*>(res.data()), size);
+  EXPECT_EQ(res, source_data);
+}
+
+TEST(ZstdStreamTests, TestCompressOptionsLargeWindow) {
+  std::vector<std::int64_t> source_data;
+  for (std::int64_t i = 0; i < 50000; ++i) {
+    source_data.emplace_back(i);
+  }
+  const auto size = source_data.size() * sizeof(std::int64_t);
+  ZstdCompressOptions options;
+  options.level = 1;
+  // Larger than the default decoder window limit. Writing more than one
+  // compressor input buffer keeps Zstd from shrinking the window to the input
+  // size, while the memory it uses stays proportional to the input
+  options.window_log = 28;
+  databento::test::mock::MockIo mock_io;
+  {
+    ZstdCompressStream compressor{ILogReceiver::Default(), &mock_io, options};
+    for (auto it = source_data.begin(); it != source_data.end(); it += 1000) {
+      compressor.WriteAll(reinterpret_cast<const std::uint8_t*>(&*it),
+                          1000 * sizeof(std::int64_t));
+    }
+  }
+  std::vector<std::int64_t> res(source_data.size());
+  // Rejected unless the reader opts in
+  ZstdDecodeStream default_decode{
+      std::unique_ptr<IReadable>{new databento::test::mock::MockIo{mock_io}}};
+  EXPECT_THROW(
+      default_decode.ReadExact(reinterpret_cast<std::uint8_t*>(res.data()),
+                               size),
+      DbnResponseError);
+  ZstdDecodeStream decode{std::unique_ptr<IReadable>{
+      new databento::test::mock::MockIo{std::move(mock_io)}}};
+  decode.SetWindowLogMax(28);
+  decode.ReadExact(reinterpret_cast<std::uint8_t*>(res.data()), size);
+  EXPECT_EQ(res, source_data);
+  EXPECT_THROW(decode.SetWindowLogMax(100), InvalidArgumentError);
+}
+
+TEST(ZstdStreamTests, TestCompressOptionsSeekable) {
+  std::vector<std::int64_t> source_data;
+  for (std::int64_t i = 0; i < 100000; ++i) {
+    source_data.emplace_back(i);
+  }
+  const TempFile temp_file{TEST_BUILD_DIR "/seekable_options.zst"};
+  {
+    OutFileStream out_file{temp_file.Path()};
+    ZstdCompressOptions options;
+    options.level = 1;
+    options.worker_count = 2;
+    ZstdCompressStream compressor{ILogReceiver::Default(), &out_file, 80000,
+                                  options};
+    for (auto it = source_data.begin(); it != source_data.end(); it += 100) {
+      compressor.WriteAll(reinterpret_cast<const std::uint8_t*>(&*it),
+                          100 * sizeof(std::int64_t));
+    }
+  }
+  ASSERT_EQ(ReadZstdSeekTable(temp_file.Path()).size(), 10);
+  ZstdSeekableDecodeStream target{temp_file.Path()};
+  target.Seek(54321 * sizeof(std::int64_t));
+  std::int64_t val{};
+  target.ReadExact(reinterpret_cast<std::uint8_t*>(&val), sizeof(val));
+  EXPECT_EQ(val, 54321);
+}
+
+TEST(ZstdStreamTests, TestCompressOptionsInvalid) {
+  databento::test::mock::MockIo mock_io;
+  ZstdCompressOptions options;
+  options.window_log = 100;
+  EXPECT_THROW(
+      (ZstdCompressStream{ILogReceiver::Default(), &mock_io, options}),
+      InvalidArgumentError);
+  options.window_log = 0;
+  options.worker_count = -1;
+  EXPECT_THROW(
+      (ZstdCompressStream{ILogReceiver::Default(), &mock_io, options}),
+      InvalidArgumentError);
+  EXPECT_TRUE(mock_io.GetContents().empty());
+}
+
+TEST(ZstdStreamTests, TestReadSeekTableNotSeekable) {
+  ASSERT_THROW(ReadZstdSeekTable(TEST_BUILD_DIR "/data/test_data.mbo.dbn.zst"),
+               DbnResponseError);
+}
+
+TEST(ZstdStreamTests, TestParallelIdentity) {
+  std::vector<std::int64_t> source_data;
+  for (std::int64_t i = 0; i < 100000; ++i) {
+    source_data.emplace_back(i);
+  }
+  const auto size = source_data.size() * sizeof(std::int64_t);
+  const TempFile temp_file{TEST_BUILD_DIR "/parallel.zst"};
+  {
+    OutFileStream out_file{temp_file.Path()};
+    ZstdCompressStream compressor{ILogReceiver::Default(), &out_file, 8000};
+    for (auto it = source_data.begin(); it != source_data.end(); it += 100) {
+      compressor.WriteAll(reinterpret_cast<const std::uint8_t*>(&*it),
+                          100 * sizeof(std::int64_t));
+    }
+  }
+  ParallelZstdDecodeStream target{temp_file.Path(), 4};
+  std::vector<std::int64_t> res(source_data.size());
+  auto* res_bytes = reinterpret_cast<std::uint8_t*>(res.data());
+  target.ReadExact(res_bytes, 10);
+  std::size_t read_size = 10;
+  while (read_size < size) {
+    const auto chunk_size = target.ReadSome(&res_bytes[read_size], 3000);
+    ASSERT_GT(chunk_size, 0);
+    read_size += chunk_size;
+  }
+  EXPECT_EQ(res, source_data);
+  std::uint8_t byte{};
+  EXPECT_EQ(target.ReadSome(&byte, 1), 0);
+}
+
+TEST(ZstdStreamTests, TestParallelMultiFrameFile) {
+  const std::string file_path =
+      TEST_BUILD_DIR "/data/multi-frame.definition.v1.dbn.zst";
+  ZstdDecodeStream expected{
+      std::unique_ptr<IReadable>{new InFileStream{file_path}}};
+  ParallelZstdDecodeStream target{file_path, 3};
+  for (std::size_t i = 0; i < 8; ++i) {
+    InstrumentDefMsgV1 expected_def;
+    expected.ReadExact(reinterpret_cast<std::uint8_t*>(&expected_def),
+                       sizeof(expected_def));
+    InstrumentDefMsgV1 def;
+    target.ReadExact(reinterpret_cast<std::uint8_t*>(&def), sizeof(def));
+    EXPECT_EQ(def, expected_def);
+  }
+  std::uint8_t byte{};
+  EXPECT_EQ(target.ReadSome(&byte, 1), 0);
+}
+
+TEST(ZstdStreamTests, TestParallelSeekableDbn) {
+  const std::string file_path = TEST_BUILD_DIR "/data/test_data.mbo.dbn";
+  const TempFile temp_file{TEST_BUILD_DIR "/parallel.mbo.dbn.zst"};
+  {
+    DbnDecoder decoder{ILogReceiver::Default(), InFileStream{file_path}};
+    OutFileStream out_file{temp_file.Path()};
+    ZstdCompressStream compressor{ILogReceiver::Default(), &out_file, 64};
+    DbnEncoder encoder{decoder.DecodeMetadata(), &compressor};
+    while (const auto* rec = decoder.DecodeRecord()) {
+      encoder.EncodeRecord(*rec);
+    }
+  }
+  EXPECT_GT(ReadZstdSeekTable(temp_file.Path()).size(), 1);
+  DbnDecoder expected{ILogReceiver::Default(), InFileStream{file_path}};
+  DbnDecoder target{ILogReceiver::Default(),
+                    std::unique_ptr<IReadable>{
+                        new ParallelZstdDecodeStream{temp_file.Path(), 3}}};
+  EXPECT_EQ(target.DecodeMetadata(), expected.DecodeMetadata());
+  while (const auto* expected_rec = expected.DecodeRecord()) {
+    const auto* rec = target.DecodeRecord();
+    ASSERT_NE(rec, nullptr);
+    EXPECT_EQ(rec->Get<MboMsg>(), expected_rec->Get<MboMsg>());
+  }
+  EXPECT_EQ(target.DecodeRecord(), nullptr);
+}
+
+TEST(ZstdStreamTests, TestHasMultipleZstdFrames) {
+  EXPECT_TRUE(HasMultipleZstdFrames(TEST_BUILD_DIR
+                                    "/data/multi-frame.definition.v1.dbn.zst"));
+  EXPECT_FALSE(HasMultipleZstdFrames(TEST_BUILD_DIR
+                                     "/data/test_data.mbo.dbn.zst"));
+  const TempFile temp_file{TEST_BUILD_DIR "/multiple_frames.zst"};
+  {
+    OutFileStream out_file{temp_file.Path()};
+    ZstdCompressStream compressor{ILogReceiver::Default(), &out_file, 64};
+    const std::array<std::uint8_t, 100> data{};
+    compressor.WriteAll(data.data(), data.size());
+  }
+  // A single frame of data followed by the seek table
+  EXPECT_FALSE(HasMultipleZstdFrames(temp_file.Path()));
+}
+
+TEST(ZstdStreamTests, TestParallelLargeWindow) {
+  std::vector<std::int64_t> source_data;
+  for (std::int64_t i = 0; i < 50000; ++i) {
+    source_data.emplace_back(i);
+  }
+  const auto size = source_data.size() * sizeof(std::int64_t);
+  const TempFile temp_file{TEST_BUILD_DIR "/parallel_large_window.zst"};
+  {
+    OutFileStream out_file{temp_file.Path()};
+    ZstdCompressOptions options;
+    options.level = 1;
+    options.window_log = 28;
+    ZstdCompressStream compressor{ILogReceiver::Default(), &out_file, 200000,
+                                  options};
+    for (auto it = source_data.begin(); it != source_data.end(); it += 1000) {
+      compressor.WriteAll(reinterpret_cast<const std::uint8_t*>(&*it),
+                          1000 * sizeof(std::int64_t));
+    }
+  }
+  std::vector<std::int64_t> res(source_data.size());
+  {
+    ParallelZstdDecodeStream target{temp_file.Path(), 2};
+    EXPECT_THROW(
+        target.ReadExact(reinterpret_cast<std::uint8_t*>(res.data()), size),
+        DbnResponseError);
+  }
+  ParallelZstdDecodeStream target{temp_file.Path(), 2, nullptr, 28};
+  target.ReadExact(reinterpret_cast<std::uint8_t*>(res.data()), size);
+  EXPECT_EQ(res, source_data);
+  EXPECT_THROW((ParallelZstdDecodeStream{temp_file.Path(), 2, nullptr, 100}),
+               InvalidArgumentError);
+}
+
+TEST(ZstdStreamTests, TestParallelCorruptContentSize) {
+  // Frames claiming an impossibly large content size, each with a single raw
+  // block
+  constexpr std::uint8_t kBlockSize = 4;
+  const std::vector<std::uint8_t> frame{
+      0x28, 0xB5, 0x2F, 0xFD,  // magic number
+      0xE0,                    // single segment, 8-byte content size
+      0,    0,    0,    0,    0, 0, 0, 0x40,
+      (kBlockSize << 3) | 1, 0, 0,  // last raw block
+      1,    2,    3,    4};
+  const TempFile temp_file{TEST_BUILD_DIR "/parallel_corrupt.zst"};
+  {
+    OutFileStream out_file{temp_file.Path()};
+    out_file.WriteAll(frame.data(), frame.size());
+    out_file.WriteAll(frame.data(), frame.size());
+  }
+  ParallelZstdDecodeStream target{temp_file.Path(), 2};
+  std::uint8_t byte{};
+  EXPECT_THROW(target.ReadSome(&byte, 1), DbnResponseError);
+}
+
+TEST(ZstdStreamTests, TestParallelNotZstd) {
+  ParallelZstdDecodeStream target{TEST_BUILD_DIR "/data/test_data.mbo.dbn",
+                                  2};
+  std::uint8_t byte{};
+  EXPECT_THROW(target.ReadSome(&byte, 1), DbnResponseError);
+}
 }  // namespace test
 }  // namespace detail
 }  // namespace databento